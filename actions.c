@@ -0,0 +1,255 @@
+// User Actions (What The Menu Does, Shared By "./main" And "./loadgen")
+// Every Call Opens Its Own Connection (publisher() / subscriberRetained()), One Action At A Time Per Process
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "constants.h"
+#include "publisher.h"
+#include "subscriber.h"
+#include "messages.h"
+#include "events.h"
+#include "agent.h"
+#include "conversations.h"
+#include "actions.h"
+
+// Parameters
+
+ConversationManager conversations; // Every Conversation Over One Connection
+
+
+// Actions
+
+// Set User Status (Online / Offline)
+void setStatus(const char* username, const char* status)
+{
+    // [USERNAME]:[STATUS]
+    char topic[1024];
+    char payload[512];
+
+    snprintf(topic, sizeof(topic), "USERS/%s", username);
+    snprintf(payload, sizeof(payload), "%s:%s", username, status);
+
+    publisher(username, topic, payload, 1);
+}
+
+// Get Users Status (Online / Offline)
+void getUsers(const char* username, LinkedList* status_list, int print_status)
+{ 
+    // print_status: 1 = Print, 0 = Don't Print
+    listClear(status_list);
+    subscriberRetained(username, "USERS/+", status_list);
+    if (print_status)
+    {
+        listPrintStatus(status_list);
+    }
+}
+
+// Get Groups (Name / Leader / Members)
+void getGroups(const char* username, LinkedList* groups_list, int print_groups)
+{
+    // print_groups: 1 = Print, 0 = Don't Print
+    listClear(groups_list);
+    subscriberRetained(username, "GROUPS/+", groups_list);
+    if (print_groups)
+    {
+        listPrintGroups(groups_list);
+    }
+}
+
+// Get Requests
+void getRequests(const char* username, LinkedList* requests_list, int print_requests)
+{
+    // print_requests: 1 = Print, 0 = Don't Print
+    listClear(requests_list);
+    char temp[128];
+    snprintf(temp, sizeof(temp), "%s_Control/REQUESTS/+", username);
+    subscriberRetained(username, temp, requests_list);
+    if (print_requests)
+    {
+        listPrintRequests(requests_list);
+    }
+}
+
+// Get History
+void getHistory(const char* username, LinkedList* history_list, int print_history)
+{
+    // print_history: 1 = Print, 0 = Don't Print
+    listClear(history_list);
+    char temp[128];
+    snprintf(temp, sizeof(temp), "%s_Control/HISTORY/+", username);
+    subscriberRetained(username, temp, history_list);
+    if (print_history)
+    {
+        listPrintHistory(history_list, username);
+    }
+}
+
+// Get Chats (Name)
+void getChats(const char* username, LinkedList* history_list, int print_chats)
+{
+    // print_chats: 1 = Print, 0 = Don't Print
+    listClear(history_list);
+    char temp[128];
+    snprintf(temp, sizeof(temp), "%s_Control/HISTORY/+", username);
+    subscriberRetained(username, temp, history_list);
+    if (print_chats)
+    {
+        listPrintChats(history_list, username);
+    }
+}
+
+// Send An Event To [TARGET]_Control (Configured Wire Format, events.h)
+void sendEvent(const char* username, const char* target, EventType type, const char* field0, const char* field1, const char* field2)
+{
+    char topic[512]; // Topic = [TARGET]_Control
+    char* payload = eventPack(EVENT_WIRE_CURRENT, type, field0, field1, field2);
+    if (!payload)
+        return;
+
+    snprintf(topic, sizeof(topic), "%s_Control", target);
+    publisher(username, topic, payload, 0);
+    free(payload);
+}
+
+// Record An Event On [USERNAME]_Control/HISTORY/[TEXT EVENT] (Retained, Topic Keyed By The Readable Form)
+void recordEvent(const char* username, EventType type, const char* field0, const char* field1, const char* field2)
+{
+    char* key = eventPack(EVENT_WIRE_TEXT, type, field0, field1, field2);
+    char* payload = eventPack(EVENT_WIRE_CURRENT, type, field0, field1, field2);
+
+    if (key && payload)
+    {
+        size_t size = strlen(username) + strlen(key) + sizeof("_Control/HISTORY/");
+        char* topic = malloc(size);
+        if (topic)
+        {
+            snprintf(topic, size, "%s_Control/HISTORY/%s", username, key);
+            publisher(username, topic, payload, 1);
+            free(topic);
+        }
+    }
+
+    free(key);
+    free(payload);
+}
+
+// Create Group (Name / Leader / Members)
+void setGroup(const char* groupname, const char* username)
+{
+    // [GROUP_NAME]:[LEADER]:[MEMBER1;MEMBER2;...]
+    char topic[1024];
+    char payload[512];
+    char link[256];
+
+    // Publish On Groups
+    snprintf(topic, sizeof(topic), "GROUPS/%s", groupname);
+    snprintf(payload, sizeof(payload), "%s:%s:%s;", groupname, username, username); // Leader Is The First Member
+
+    publisher(username, topic, payload, 1);
+
+    // Publish On History
+    char timestamp[100];
+    time_t now = time(NULL);
+    struct tm *t = localtime(&now);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H-%M-%S", t);
+
+    snprintf(link, sizeof(link), "%s|%s", groupname, timestamp);
+    recordEvent(username, EVENT_GROUP_CREATED, groupname, link, NULL);
+
+    // Subscribe On Conversation Topic (Shared Conversations Connection)
+    conversationsAdd(&conversations, groupname, link, 1);
+}
+
+// Request User Coversation
+void requestUser(const char* username, const char* user)
+{
+    sendEvent(username, user, EVENT_USER_REQUEST, username, NULL, NULL); // USER_REQUEST:[USERNAME]
+    recordEvent(username, EVENT_USER_REQUEST_SENT, user, NULL, NULL); // USER_REQUEST_SENT:[TARGET_USER]
+}
+
+// Request User Coversation
+void requestGroup(const char* username, const char* leader, const char* group)
+{
+    sendEvent(username, leader, EVENT_GROUP_REQUEST, group, username, NULL); // GROUP_REQUEST:[GROUPNAME];[USERNAME]
+    recordEvent(username, EVENT_GROUP_REQUEST_SENT, group, leader, NULL); // GROUP_REQUEST_SENT:[GROUPNAME];[LEADER]
+}
+
+// Respond Group Coversation
+void respondUser(const char* username, const char* user, const char* link, const char* my_response)
+{
+    if (strcmp(my_response, "ACEITAR") == 0) // ACCEPTED
+    {
+        sendEvent(username, user, EVENT_USER_ACCEPTED, username, link, NULL); // USER_ACCEPTED:[USERNAME];[TOPIC]
+        recordEvent(username, EVENT_USER_ACCEPTED, user, link, NULL); // USER_ACCEPTED:[USER];[TOPIC]
+    }
+    else // REJECTED
+    {
+        sendEvent(username, user, EVENT_USER_REJECTED, username, NULL, NULL); // USER_REJECTED:[USERNAME]
+        recordEvent(username, EVENT_USER_REJECTED, user, NULL, NULL); // USER_REJECTED:[USER]
+    }
+}
+
+// Respond Group Coversation
+void respondGroup(const char* username, const char* group, const char* user, const char* link, const LinkedList* groups_list, const char* my_response)
+{
+    char *group_info; // Message = [GROUPNAME]:[USERNAME]:[MEMBER];
+    char *group_info_new; // Message = [GROUPNAME]:[USERNAME]:[MEMBER];[MEMBER]; (No Size Limit, Groups Past MAX_GROUP_MEMBERS Included)
+    char group_topic[512]; // Topic = GROUPS/[GROUPNAME]
+
+    if (strcmp(my_response, "ACEITAR") == 0) // ACCEPTED
+    {
+        // Update "GROUPS/" (Skipped When The Group Is Missing From groups_list: Publishing Only The New Member Would Drop The Others)
+        group_info = listGetGroup(groups_list, group, username);
+        if (group_info)
+        {
+            size_t size = strlen(group_info) + strlen(user) + 2;
+            group_info_new = malloc(size);
+            if (group_info_new)
+            {
+                snprintf(group_topic, sizeof(group_topic), "GROUPS/%s", group);
+                snprintf(group_info_new, size, "%s%s;", group_info, user);
+                publisher(username, group_topic, group_info_new, 1);
+                free(group_info_new);
+            }
+            listFreeResult(group_info);
+        }
+
+        sendEvent(username, user, EVENT_GROUP_ACCEPTED, group, username, link); // GROUP_ACCEPTED:[GROUPNAME];[USERNAME];[TOPIC]
+        recordEvent(username, EVENT_GROUP_ACCEPTED, group, user, NULL); // GROUP_ACCEPTED:[GROUPNAME];[USER]
+    }
+    else // REJECTED
+    {
+        sendEvent(username, user, EVENT_GROUP_REJECTED, group, username, NULL); // GROUP_REJECTED:[GROUPNAME];[USERNAME]
+        recordEvent(username, EVENT_GROUP_REJECTED, group, user, NULL); // GROUP_REJECTED:[GROUPNAME];[USER]
+    }
+}
+
+// Create Conversation Topic By Sending "WATING_USER"
+void createConversation(const char* username, const char* user, const char* link)
+{
+    char topic[1024];
+
+    snprintf(topic, sizeof(topic), "CHATS/%s", link);
+
+    conversationsAdd(&conversations, user, link, 0);
+    publisherDirty(username, topic, "WAITING_USER", 1);
+}
+
+// Monitor Control Topic ([USER]_Control) > Used With Threads
+void monitorControl(const char* username, volatile int* online)
+{
+    char control_username[72];
+    snprintf(control_username, sizeof(control_username), "%s_Control", username);
+
+    agentControl(control_username, &conversations, online); // Accepted Chats Are Subscribed Right Away
+}
+
+// Process Request
+void processRequest(const char* username, const char* request)
+{
+    char topic[512]; // Topic = [USERNAME]_Control/REQUESTS/[REQUEST]
+    snprintf(topic, sizeof(topic), "%s_Control/REQUESTS/%s", username, request);
+    publisher(username, topic, "", 1); // Publish Empty Payload To Remove Retained Message
+}
@@ -0,0 +1,41 @@
+#ifndef ACTIONS_H
+#define ACTIONS_H
+
+#include "messages.h"
+#include "events.h"
+#include "conversations.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* User Actions */
+// What The Menu Does On Behalf Of [USERNAME] (Statuses, Groups, Requests, Responses, History)
+// One Logged-In User Per Process: publisher() / subscriberRetained() Keep Global Flags, conversations Is That User's Manager
+extern ConversationManager conversations;
+
+/* Core Functions */
+void setStatus(const char* username, const char* status);
+void getUsers(const char* username, LinkedList* status_list, int print_status);
+void getGroups(const char* username, LinkedList* groups_list, int print_groups);
+void getRequests(const char* username, LinkedList* requests_list, int print_requests);
+void getHistory(const char* username, LinkedList* history_list, int print_history);
+void getChats(const char* username, LinkedList* history_list, int print_chats);
+void sendEvent(const char* username, const char* target, EventType type, const char* field0, const char* field1, const char* field2);
+void recordEvent(const char* username, EventType type, const char* field0, const char* field1, const char* field2);
+
+/* Higher Level Functions */
+void setGroup(const char* groupname, const char* username);
+void requestUser(const char* username, const char* user);
+void requestGroup(const char* username, const char* leader, const char* group);
+void respondUser(const char* username, const char* user, const char* link, const char* my_response);
+void respondGroup(const char* username, const char* group, const char* user, const char* link, const LinkedList* groups_list, const char* my_response);
+void createConversation(const char* username, const char* user, const char* link);
+void monitorControl(const char* username, volatile int* online);
+void processRequest(const char* username, const char* request);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ACTIONS_H
@@ -3,10 +3,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 #include "MQTTAsync.h"
+#include "transport.h"
 #include "constants.h"
+#include "memory.h"
 #include "messages.h"
+#include "events.h"
+#include "envelope.h"
 #include "subscriber.h"
+#include "agent.h"
 
 #if !defined(_WIN32)
 #include <unistd.h>
@@ -25,8 +31,14 @@ typedef struct
     MQTTAsync client;
     char username_a[64];
     char topic_a[64];
-    LinkedList* message_list;
+    ConversationManager* conversations; // Shared Chat Connection (Accepted Chats Are Subscribed There)
     volatile int* online;
+    LinkedList work; // Received Events Waiting For The Worker (Adopted Payloads, Bounded: LIST_BLOCK)
+    pthread_t worker;
+    AgentBatch* batch; // Worker's Publish Batch (Allocated Before It Starts)
+    volatile int stopping; // Worker Drains The Queue And Exits
+    pthread_mutex_t intake_lock; // Guards inline_events Against An Insert In Progress
+    int inline_events; // Queue Closed (Shutting Down): The Callback Handles Events Itself Until The Disconnect
 } Context_a;
 
 // Flags
@@ -77,7 +89,7 @@ void connectionLost_a(void *context_, char *cause) // Connection Lost
 	conn_opts.context = context;
 
 	// Try To Connect Again
-	if ((rc = MQTTAsync_connect(client, &conn_opts)) != MQTTASYNC_SUCCESS)
+	if ((rc = transportConnect(client, &conn_opts)) != MQTTASYNC_SUCCESS)
 	{
 		printf("AGENT: Failed to start connect, return code %d\n", rc);
 		finished_agent = 1;
@@ -95,7 +107,7 @@ void publishMessage(MQTTAsync client, const char* topic, const char* payload, in
     pubmsg.retained = retained;
 
     int rc;
-    if ((rc = MQTTAsync_sendMessage(client, topic, &pubmsg, &opts)) != MQTTASYNC_SUCCESS)
+    if ((rc = transportSendMessage(client, topic, &pubmsg, &opts)) != MQTTASYNC_SUCCESS)
     {
         printf("               [LOG] AGENT: Failed to start sendMessage, return code %d\n", rc);
     }
@@ -105,114 +117,304 @@ void publishMessage(MQTTAsync client, const char* topic, const char* payload, in
     }
 }
 
-int messageArrived_a(void *context_, char *topic_name, int topic_len, MQTTAsync_message *message) // Message Arrived
+// Publish Batch (Filled By The Event Handlers, Sent Together Once The Worker Drained Its Batch)
+// A Retained Topic Written Twice In One Batch (Replayed Duplicates) Is Sent Once With The Last Payload
+
+static void batchAdd_a(AgentBatch* batch, char* topic, char* payload, int retained) // Takes Ownership Of topic / payload
 {
-    Context_a* context = (Context_a*)context_;
+    for (int i = 0; retained && i < batch->count; i++)
+    {
+        AgentPublish* publish = &batch->publishes[i];
+        if (publish->retained && strcmp(publish->topic, topic) == 0)
+        {
+            free(publish->payload);
+            publish->payload = payload;
+            free(topic);
+            return;
+        }
+    }
 
-    // Ensure Payload Is Nul-Terminated
+    if (batch->count == (int)(sizeof(batch->publishes) / sizeof(batch->publishes[0]))) // Never Expected: Send Right Away
+    {
+        publishMessage((MQTTAsync)batch->client, topic, payload, retained);
+        free(topic);
+        free(payload);
+        return;
+    }
 
-    char buf[1024];
-    int len = message->payloadlen;
-    if (len >= (int)sizeof(buf)) len = sizeof(buf) - 1;
-    memcpy(buf, message->payload, len);
-    buf[len] = '\0';
+    batch->publishes[batch->count].topic = topic;
+    batch->publishes[batch->count].payload = payload;
+    batch->publishes[batch->count].retained = retained;
+    batch->count++;
+}
 
-    if (LOG_ENABLED)
+void agentFlush(AgentBatch* batch)
+{
+    for (int i = 0; i < batch->count; i++)
     {
-    printf("\n               [LOG] AGENT: Message arrived\n");
-    printf("               [LOG]      Topic: %s\n", topic_name);
-    printf("               [LOG]    Message: %s\n\n", buf);
+        publishMessage((MQTTAsync)batch->client, batch->publishes[i].topic, batch->publishes[i].payload, batch->publishes[i].retained);
+        free(batch->publishes[i].topic);
+        free(batch->publishes[i].payload);
     }
+    batch->count = 0;
+}
 
-    char reply_topic[2048];
+// Event Handlers (Dispatched By Type, events.h, On The Worker Thread)
 
-    // Message Type
-    
-    if (strstr(buf, "USER_REQUEST") != NULL) // User Conversation Request | USER_REQUEST:[USERNAME]
-    { 
-        if (LOG_ENABLED)
-            printf("               [LOG] AGENT: User request received. %s\n", buf);
+// Stores "type" (With The Fields Of "event") Retained On [USER]_Control/[FOLDER]/[TEXT EVENT]
+// The Topic Uses The Readable Form, The Payload The Configured Wire Format
+static void recordEvent_a(AgentBatch* batch, const char* folder, EventType type, const Event* event)
+{
+    const char* control_topic = batch->control_topic; // [USER]_Control
+    char* key = eventRepack(EVENT_WIRE_TEXT, type, event);
+    char* payload = eventRepack(EVENT_WIRE_CURRENT, type, event);
+    char* topic = NULL;
+
+    if (key && payload)
+    {
+        size_t size = strlen(control_topic) + strlen(folder) + strlen(key) + 3;
+        if ((topic = malloc(size)))
+        {
+            snprintf(topic, size, "%s/%s/%s", control_topic, folder, key);
+            batchAdd_a(batch, topic, payload, 1);
+            payload = NULL; // Owned By The Batch
+        }
+    }
+
+    free(key);
+    free(payload);
+}
+
+static void onRequest_a(const Event* event, void* batch_) // USER_REQUEST:[USERNAME] | GROUP_REQUEST:[GROUPNAME];[USERNAME]
+{
+    AgentBatch* batch = (AgentBatch*)batch_;
+
+    if (LOG_ENABLED)
+        printf("               [LOG] AGENT: %s received\n", event_schema[event->type].name);
+
+    recordEvent_a(batch, "REQUESTS", event->type, event); // [USER]_Control/REQUESTS/[REQUEST_BODY]
+}
+
+static void onResponse_a(const Event* event, void* batch_) // *_ACCEPTED / *_REJECTED -> HISTORY / *_REQUEST_ACCEPTED / *_REQUEST_REJECTED
+{
+    AgentBatch* batch = (AgentBatch*)batch_;
+
+    if (LOG_ENABLED)
+        printf("               [LOG] AGENT: %s received\n", event_schema[event->type].name);
+
+    recordEvent_a(batch, "HISTORY", event_schema[event->type].recorded_as, event); // [USER]_Control/HISTORY/[REQUEST_BODY]
+
+    // Opens A Conversation (Its Recorded Form Has A Chat Link): The Owner Subscribes It (on_chat)
+
+    EventType recorded = event_schema[event->type].recorded_as;
+    char name[64];
+    char link[512];
+    if (recorded == EVENT_NONE || event_schema[recorded].chat_link < 0 ||
+        !eventField(event, 0, name, sizeof(name)) || !eventField(event, event_schema[recorded].chat_link, link, sizeof(link)))
+        return;
 
-        snprintf(reply_topic, sizeof(reply_topic), "%s/REQUESTS/%s", topic_name, buf); // [USER]_Control/REQUESTS/[REQUEST_BODY]
+    if (batch->on_chat)
+        batch->on_chat(batch->owner, name, link, event_schema[recorded].is_group);
 
-        publishMessage(context->client, reply_topic, buf, 1);
+    if (event->type == EVENT_USER_ACCEPTED) // USER_ACCEPTED:[USERNAME];[TOPIC] > Confirm Conversation Topic Creation By Sending ""
+    {
+        size_t size = strlen(link) + sizeof("CHATS/");
+        char* topic = malloc(size);
+        char* empty = calloc(1, 1);
+        if (topic && empty)
+        {
+            snprintf(topic, size, "CHATS/%s", link);
+            batchAdd_a(batch, topic, empty, 1);
+        }
+        else
+        {
+            free(topic);
+            free(empty);
+        }
     }
-    else if (strstr(buf, "GROUP_REQUEST") != NULL) // Group Conversation Request | GROUP_REQUEST:[GROUPNAME];[USERNAME]
+}
+
+static uint64_t hexField_a(const Event* event, int index)
+{
+    char text[24];
+    if (!eventField(event, index, text, sizeof(text)))
+        return 0;
+    return strtoull(text, NULL, 16);
+}
+
+static void onPing_a(const Event* event, void* batch_) // PING:[USERNAME];[T1] > PONG:[OWN USERNAME];[T1];[T2] To [USERNAME]_Control
+{
+    AgentBatch* batch = (AgentBatch*)batch_;
+    char pinger[64];
+    char t1[24];
+    if (!eventField(event, 0, pinger, sizeof(pinger)) || !eventField(event, 1, t1, sizeof(t1)))
+        return;
+
+    char username[64]; // [USER]_Control > [USER]
+    int len = (int)strlen(batch->control_topic) - (int)(sizeof("_Control") - 1);
+    snprintf(username, sizeof(username), "%.*s", len > 0 ? len : 0, batch->control_topic);
+
+    EnvelopeTime now; // T2 Doubles As The Reply Time (Sent With This Batch)
+    char t2[24];
+    envelopeNow(&now);
+    snprintf(t2, sizeof(t2), "%llx", (unsigned long long)now.mono_us);
+
+    size_t size = strlen(pinger) + sizeof("_Control");
+    char* topic = malloc(size);
+    char* payload = eventPack(EVENT_WIRE_CURRENT, EVENT_PONG, username, t1, t2);
+    if (topic && payload)
     {
-        if (LOG_ENABLED)
-            printf("               [LOG] AGENT: Group request received. %s\n", buf);
-        snprintf(reply_topic, sizeof(reply_topic), "%s/REQUESTS/%s", topic_name, buf); // [USER]_Control/REQUESTS/[REQUEST_BODY]
+        snprintf(topic, size, "%s_Control", pinger);
+        batchAdd_a(batch, topic, payload, 0);
+    }
+    else
+    {
+        free(topic);
+        free(payload);
+    }
+}
+
+static void onPong_a(const Event* event, void* batch_) // PONG:[PEER];[T1];[T2] > Clock Offset Sample (envelope.h)
+{
+    (void)batch_;
+    char peer[64];
+    if (!eventField(event, 0, peer, sizeof(peer)))
+        return;
+
+    EnvelopeTime now;
+    envelopeNow(&now);
+    peerClockSample(peer, hexField_a(event, 1), hexField_a(event, 2), now.mono_us);
 
-        publishMessage(context->client, reply_topic, buf, 1);
+    if (LOG_ENABLED)
+    {
+        int64_t offset_us;
+        if (peerClockOffset(peer, &offset_us))
+            printf("               [LOG] AGENT: Clock offset of %s is %lld us\n", peer, (long long)offset_us);
     }
-    else if (strstr(buf, "USER_ACCEPTED") != NULL) // User Conversation Accepted | USER_ACCEPTED:[USERNAME];[TOPIC]
+}
+
+static const EventHandler handlers_a[EVENT_COUNT] = {
+    [EVENT_USER_REQUEST] = onRequest_a,
+    [EVENT_GROUP_REQUEST] = onRequest_a,
+    [EVENT_USER_ACCEPTED] = onResponse_a,
+    [EVENT_GROUP_ACCEPTED] = onResponse_a,
+    [EVENT_USER_REJECTED] = onResponse_a,
+    [EVENT_GROUP_REJECTED] = onResponse_a,
+    [EVENT_PING] = onPing_a,
+    [EVENT_PONG] = onPong_a,
+};
+
+// 1 If The Payload Is An Event The Agent Handles (Checked Before Queueing)
+int agentAccepts(const char* payload, int len)
+{
+    Event event;
+    return eventDecode(payload, len, &event) && handlers_a[event.type];
+}
+
+// Decodes And Handles One Event (Decoding Again Is A Zero-Copy Scan, Cheaper Than Carrying The Event Through A Queue)
+int agentHandle(AgentBatch* batch, const char* payload, int len)
+{
+    Event event;
+    if (!eventDecode(payload, len, &event))
+        return 0;
+    return eventDispatch(&event, handlers_a, batch);
+}
+
+static void openChat_a(void* owner, const char* name, const char* link, int is_group) // One SUBSCRIBE On The Shared Connection
+{
+    conversationsAdd((ConversationManager*)owner, name, link, is_group);
+}
+
+static void releaseMessage_a(void* message_) // Worker Done With The Event
+{
+    MQTTAsync_message* message = (MQTTAsync_message*)message_;
+    transportFreeMessage(&message);
+}
+
+// Worker: Handles Queued Events In Batches (Up To AGENT_BATCH_MAX), Their Publishes Sent Together After Each Batch
+static AgentBatch* newBatch_a(Context_a* context)
+{
+    AgentBatch* batch = calloc(1, sizeof(AgentBatch));
+    if (!batch)
+        return NULL;
+    batch->client = context->client;
+    batch->control_topic = context->topic_a;
+    batch->on_chat = openChat_a;
+    batch->owner = context->conversations;
+    return batch;
+}
+
+static void* agentWorker_a(void* context_)
+{
+    Context_a* context = (Context_a*)context_;
+    AgentBatch* batch = context->batch;
+    MessageView view;
+
+    while (!context->stopping || listGetStats(&context->work).count > 0)
     {
+        if (!listWaitView(&context->work, &view, DELAY_100_MS_MS))
+            continue;
+
+        int handled = 0;
+        do
+        {
+            agentHandle(batch, view.data, view.length);
+            viewRelease(&view);
+        } while (++handled < AGENT_BATCH_MAX && listPopView(&context->work, &view));
+
         if (LOG_ENABLED)
-            printf("               [LOG] AGENT: User accept received. %s\n", buf);
-
-        char* old_type = strtok(buf, ":");
-        char* user = strtok(NULL, ";");
-        char* link = strtok(NULL, ";");
-        char new_type[512];
-        snprintf(new_type, sizeof(new_type), "USER_REQUEST_ACCEPTED:%s;%s", user, link);
-        snprintf(reply_topic, sizeof(reply_topic), "%s/HISTORY/%s", topic_name, new_type); // [USER]_Control/HISTORY/[REQUEST_BODY]
-        
-        publishMessage(context->client, reply_topic, new_type, 1);
-
-        snprintf(reply_topic, sizeof(reply_topic), "CHATS/%s", link);
-        // subscriberDirty(context->username_a, reply_topic, NULL);
-        listInsert(context->message_list, reply_topic);
-
-        // Confirm Conversation Topic Creation By Sending ""
-        publishMessage(context->client, reply_topic, "", 1);
+            printf("               [LOG] AGENT: Batch of %d events, %d publishes\n", handled, batch->count);
+        agentFlush(batch);
     }
-    else if (strstr(buf, "GROUP_ACCEPTED") != NULL) // Group Conversation Accepted | GROUP_ACCEPTED:[GROUPNAME];[USERNAME];[TOPIC]
+
+    return NULL;
+}
+
+int messageArrived_a(void *context_, char *topic_name, int topic_len, MQTTAsync_message *message) // Message Arrived
+{
+    Context_a* context = (Context_a*)context_;
+
+    if (LOG_ENABLED)
     {
-        if (LOG_ENABLED)
-            printf("               [LOG] AGENT: Group accept received. %s\n", buf);
-
-        char* old_type = strtok(buf, ":");
-        char* group = strtok(NULL, ";");
-        char* user = strtok(NULL, ";");
-        char* link = strtok(NULL, ";");
-        char new_type[512];
-        snprintf(new_type, sizeof(new_type), "GROUP_REQUEST_ACCEPTED:%s;%s;%s", group, user, link);
-        snprintf(reply_topic, sizeof(reply_topic), "%s/HISTORY/%s", topic_name, new_type); // [USER]_Control/HISTORY/[REQUEST_BODY]
-        
-        publishMessage(context->client, reply_topic, new_type, 1);
+    printf("\n               [LOG] AGENT: Message arrived\n");
+    printf("               [LOG]      Topic: %s\n", topic_name);
+    printf("               [LOG]    Message: %.*s\n\n", message->payloadlen, (char*)message->payload);
     }
-    else if (strstr(buf, "USER_REJECTED") != NULL) // User Conversation Rejected | USER_REJECTED:[USERNAME]
+
+    // Decode Only (One Pass Over The Payload, See events.h), The Worker Does The Publishing
+    // So A Replayed Backlog Never Keeps This Thread From Reading Acks And New Messages
+
+    if (agentAccepts((const char*)message->payload, message->payloadlen))
     {
-        if (LOG_ENABLED)
-            printf("               [LOG] AGENT: User reject received. %s\n", buf);
-
-        char* old_type = strtok(buf, ":");
-        char* user = strtok(NULL, ";");
-        char new_type[512];
-        snprintf(new_type, sizeof(new_type), "USER_REQUEST_REJECTED:%s", user);
-        snprintf(reply_topic, sizeof(reply_topic), "%s/HISTORY/%s", topic_name, new_type); // [USER]_Control/HISTORY/[REQUEST_BODY]
-        
-        publishMessage(context->client, reply_topic, new_type, 1);
+        pthread_mutex_lock(&context->intake_lock);
+        if (!context->inline_events)
+        {
+            MessageBuffer* buffer = bufferAdopt((char*)message->payload, message->payloadlen, releaseMessage_a, message);
+            listInsertView(&context->work, buffer, buffer ? buffer->data : NULL, message->payloadlen); // Blocks When The Worker Lags
+            bufferRelease(buffer);
+            message = NULL;
+        }
+        pthread_mutex_unlock(&context->intake_lock);
+
+        if (message) // Shutting Down: Handled Here, Published Before The Disconnect (An Acked Event Is Never Dropped)
+        {
+            AgentBatch* batch = newBatch_a(context);
+            if (batch)
+            {
+                agentHandle(batch, (const char*)message->payload, message->payloadlen);
+                agentFlush(batch);
+                free(batch);
+            }
+            transportFreeMessage(&message);
+        }
     }
-    else if (strstr(buf, "GROUP_REJECTED") != NULL) // Group Conversation Rejected | GROUP_REJECTED:[GROUPNAME];[USERNAME]
+    else
     {
         if (LOG_ENABLED)
-            printf("               [LOG] AGENT: Group reject received. %s\n", buf);
-
-        char* old_type = strtok(buf, ":");
-        char* group = strtok(NULL, ";");
-        char* user = strtok(NULL, ";");
-        char new_type[512];
-        snprintf(new_type, sizeof(new_type), "GROUP_REQUEST_REJECTED:%s;%s", group, user);
-        snprintf(reply_topic, sizeof(reply_topic), "%s/HISTORY/%s", topic_name, new_type); // [USER]_Control/HISTORY/[REQUEST_BODY]
-        
-        publishMessage(context->client, reply_topic, new_type, 1);
+            printf("               [LOG] AGENT: Unknown or malformed event ignored\n");
+        transportFreeMessage(&message);
     }
 
-	// Memory Management
-    MQTTAsync_freeMessage(&message);
-    MQTTAsync_free(topic_name);
-
     return 1;
 }
 
@@ -272,7 +474,7 @@ void onConnect_a(void* context_, MQTTAsync_successData* response) // Connected S
     opts.context = context;
 
     // Subscribe To Topic
-    if ((rc = MQTTAsync_subscribe(client, context->topic_a, QOS, &opts)) != MQTTASYNC_SUCCESS)
+    if ((rc = transportSubscribe(client, context->topic_a, QOS, &opts)) != MQTTASYNC_SUCCESS)
     {
         if (LOG_ENABLED)
             printf("               [LOG] AGENT: Failed to start subscribe, return code %d\n", rc);
@@ -280,9 +482,57 @@ void onConnect_a(void* context_, MQTTAsync_successData* response) // Connected S
     }
 }
 
+// Helpers
+
+static int startWorker_a(Context_a* context) // 0 = No Worker (The Caller Fails: Queued Events Would Never Be Handled)
+{
+    context->batch = newBatch_a(context);
+    if (!context->batch)
+        return 0;
+
+    listInit(&context->work);
+    listSetName(&context->work, "control");
+    listSetLimit(&context->work, AGENT_QUEUE_MAX, LIST_BLOCK); // Backpressure Onto The Callback Thread (And The Broker)
+    context->stopping = 0;
+    context->inline_events = 0;
+    pthread_mutex_init(&context->intake_lock, NULL);
+    if (pthread_create(&context->worker, NULL, agentWorker_a, context) != 0)
+    {
+        pthread_mutex_destroy(&context->intake_lock);
+        listDestroy(&context->work);
+        free(context->batch);
+        return 0;
+    }
+    return 1;
+}
+
+// Closes The Queue First (Later Events Are Handled By The Callback), Then Lets The Worker Drain It And Joins
+// The Subscription Stays (Persistent Session: Events Sent While Offline Wait At The Broker), So Call Before The Disconnect
+static void stopWorker_a(Context_a* context)
+{
+    pthread_mutex_lock(&context->intake_lock); // Waits For An Insert In Progress (The Worker Is Still Draining)
+    context->inline_events = 1;
+    pthread_mutex_unlock(&context->intake_lock);
+
+    context->stopping = 1;
+    pthread_join(context->worker, NULL);
+    free(context->batch);
+    context->batch = NULL;
+}
+
+static int account_context_a = -1; // memoryAccountCached()
+
+static void freeContext_a(Context_a* context) // After transportDestroy (No More Callbacks)
+{
+    listDestroy(&context->work);
+    pthread_mutex_destroy(&context->intake_lock);
+    memoryAdd(memoryAccountCached(&account_context_a, "Context_a"), -(long)sizeof(Context_a), -1);
+    free(context);
+}
+
 // Main Functions
 
-int agentControl(const char* username_a, LinkedList* control_list, volatile int* online) // Subscribe To A Retained Topic (Not Mantain Connection)
+int agentControl(const char* username_a, ConversationManager* conversations, volatile int* online) // Subscribe To A Retained Topic (Not Mantain Connection)
 {
 	MQTTAsync client; // Client (Handler) | Connection To Broker
 	MQTTAsync_connectOptions conn_opts = MQTTAsync_connectOptions_initializer; // Connection Options (... = [Default Initializer Macro])
@@ -298,7 +548,7 @@ int agentControl(const char* username_a, LinkedList* control_list, volatile int*
 
 	// Create Client
 
-    if ((rc = MQTTAsync_create(&client, ADDRESS, username_a, MQTTCLIENT_PERSISTENCE_NONE, NULL)) != MQTTASYNC_SUCCESS)
+    if ((rc = transportCreate(&client, ADDRESS, username_a, MQTTCLIENT_PERSISTENCE_NONE, NULL)) != MQTTASYNC_SUCCESS)
 	{
         if (LOG_ENABLED)
             printf("               [LOG] AGENT: Failed to create client, return code %d\n", rc);
@@ -309,23 +559,37 @@ int agentControl(const char* username_a, LinkedList* control_list, volatile int*
 
     Context_a* context = malloc(sizeof(Context_a));
     if (!context) {
-        MQTTAsync_destroy(&client);
+        transportDestroy(&client);
         return EXIT_FAILURE;
     }
+    memoryAdd(memoryAccountCached(&account_context_a, "Context_a"), sizeof(Context_a), 1);
 
     context->client = client; // Client
     strcpy(context->username_a, username_a); // Username
     strcpy(context->topic_a, username_a); // Topic
-    context->message_list = control_list; // Status (Message) List
+    context->conversations = conversations; // Shared Chat Connection
+
+    // Start The Worker (Publishes On Behalf Of The Callback Thread)
+
+    if (!startWorker_a(context))
+    {
+        if (LOG_ENABLED)
+            printf("               [LOG] AGENT: Failed to start worker\n");
+        memoryAdd(memoryAccountCached(&account_context_a, "Context_a"), -(long)sizeof(Context_a), -1);
+        free(context);
+        transportDestroy(&client);
+        return EXIT_FAILURE;
+    }
 
     // Set Callbacks
 
-    if ((rc = MQTTAsync_setCallbacks(client, context, connectionLost_a, messageArrived_a, NULL)) != MQTTASYNC_SUCCESS)
+    if ((rc = transportSetCallbacks(client, context, connectionLost_a, messageArrived_a, NULL)) != MQTTASYNC_SUCCESS)
 	{
         if (LOG_ENABLED)
             printf("               [LOG] AGENT: Failed to set callbacks, return code %d\n", rc);
-        free(context);
-        MQTTAsync_destroy(&client);
+        stopWorker_a(context);
+        transportDestroy(&client);
+        freeContext_a(context);
         return EXIT_FAILURE;
     }
 
@@ -339,11 +603,12 @@ int agentControl(const char* username_a, LinkedList* control_list, volatile int*
 
 	// Connect To Broker
 
-    if ((rc = MQTTAsync_connect(client, &conn_opts)) != MQTTASYNC_SUCCESS) {
+    if ((rc = transportConnect(client, &conn_opts)) != MQTTASYNC_SUCCESS) {
         if (LOG_ENABLED)
             printf("               [LOG] AGENT: Failed to start connect, return code %d\n", rc);
-        free(context);
-        MQTTAsync_destroy(&client);
+        stopWorker_a(context);
+        transportDestroy(&client);
+        freeContext_a(context);
         return EXIT_FAILURE;
     }
 
@@ -365,26 +630,29 @@ int agentControl(const char* username_a, LinkedList* control_list, volatile int*
         #endif
     }
 
+    stopWorker_a(context); // Queue Closed And Drained, Last Batch Handed To The Client Before Disconnecting
+
     if (finished_agent) {
         if (LOG_ENABLED)
             printf("               [LOG] AGENT: Client Destroyed\n");
-        MQTTAsync_destroy(&client);
-        free(context);
+        transportDestroy(&client);
+        freeContext_a(context);
         return EXIT_FAILURE;
     }
 
 	// Disconnection Parameters
 
+	disc_opts.timeout = DELAY_5_SEC_MS; // Lets The Last Batch Complete
 	disc_opts.onSuccess = onDisconnect_a;
 	disc_opts.onFailure = onDisconnectFailure_a;
 
 	// Disconnect To Broker
 
-    if ((rc = MQTTAsync_disconnect(client, &disc_opts)) != MQTTASYNC_SUCCESS) {
+    if ((rc = transportDisconnect(client, &disc_opts)) != MQTTASYNC_SUCCESS) {
         if (LOG_ENABLED)
             printf("               [LOG] AGENT: Failed to start disconnect, return code %d\n", rc);
-        MQTTAsync_destroy(&client);
-        free(context);
+        transportDestroy(&client);
+        freeContext_a(context);
         return EXIT_FAILURE;
     }
 
@@ -399,7 +667,7 @@ int agentControl(const char* username_a, LinkedList* control_list, volatile int*
         #endif
  	}
 
-    MQTTAsync_destroy(&client);
-    free(context);
+    transportDestroy(&client);
+    freeContext_a(context);
     return rc;
 }
\ No newline at end of file
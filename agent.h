@@ -2,15 +2,44 @@
 #define AGENT_H
 
 #include "messages.h"
+#include "conversations.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Constants */
+#define AGENT_QUEUE_MAX 1024 // Events Waiting For The Worker (The Callback Thread Blocks When Full)
+#define AGENT_BATCH_MAX 64 // Events Handled Per Batch (Their Publishes Are Sent Together)
+
+/* Agent Core (Shared By agentControl() And The Gateway) */
+// Handles [USER]_Control Events: Requests > REQUESTS/, Responses > HISTORY/, Accepted Chats > on_chat()
+// Publishes Are Collected In The Batch And Sent By agentFlush() (Retained Topics Written Twice Are Sent Once)
+typedef void (*AgentChatHook)(void* owner, const char* name, const char* link, int is_group);
+
+typedef struct AgentPublish {
+    char* topic;
+    char* payload;
+    int retained;
+} AgentPublish;
+
+typedef struct AgentBatch {
+    void* client; // MQTTAsync The Publishes Go Out On
+    const char* control_topic; // [USER]_Control Of The Events Being Handled
+    AgentChatHook on_chat; // Conversation Opened (NULL = Nothing To Do)
+    void* owner; // Passed To on_chat
+    AgentPublish publishes[AGENT_BATCH_MAX * 2]; // Up To Two Publishes Per Event
+    int count;
+} AgentBatch;
+
 /* Function Declarations */
-int agentControl(const char* username_a, LinkedList* control_list, volatile int* online);
+int agentControl(const char* username_a, ConversationManager* conversations, volatile int* online);
 void* monitorControlThread(void* arg);
 
+int agentAccepts(const char* payload, int len);
+int agentHandle(AgentBatch* batch, const char* payload, int len);
+void agentFlush(AgentBatch* batch);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,487 @@
+// Attachments
+// Files Are Mapped (mmap) And Streamed In ATTACHMENT_CHUNK_SIZE Frames With At Most ATTACHMENT_WINDOW Unacknowledged,
+// The Receiver Writes Each Frame Straight Into Its Place In The File (pwrite) | Neither Side Keeps The File In The Heap
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "MQTTAsync.h"
+#include "transport.h"
+#include "constants.h"
+#include "chunk.h"
+#include "envelope.h"
+#include "attachment.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#include <windows.h>
+#endif
+
+#if defined(_WRS_KERNEL)
+#include <OsWrapper.h>
+#endif
+
+#define CHECKSUM_INIT  14695981039346656037ULL
+#define CHECKSUM_PRIME 1099511628211ULL
+
+// Send Window (Frames Acknowledged By The Broker Free A Place)
+
+typedef struct SendWindow {
+    pthread_mutex_t lock;
+    pthread_cond_t acked;
+    int in_flight;
+    int failed;
+} SendWindow;
+
+// Function Prototypes
+
+void onSend_f(void* context_, MQTTAsync_successData* response);
+void onSendFailure_f(void* context_, MQTTAsync_failureData* response);
+
+// Callbacks
+
+void onSend_f(void* context_, MQTTAsync_successData* response) // Frame Acknowledged
+{
+    SendWindow* window = (SendWindow*)context_;
+    pthread_mutex_lock(&window->lock);
+    window->in_flight--;
+    pthread_cond_signal(&window->acked);
+    pthread_mutex_unlock(&window->lock);
+}
+
+void onSendFailure_f(void* context_, MQTTAsync_failureData* response) // Frame Lost
+{
+    SendWindow* window = (SendWindow*)context_;
+    if (LOG_ENABLED)
+        printf("               [LOG] ATTACHMENT: Send failed, rc %d\n", response ? response->code : 0);
+    pthread_mutex_lock(&window->lock);
+    window->in_flight--;
+    window->failed = 1;
+    pthread_cond_signal(&window->acked);
+    pthread_mutex_unlock(&window->lock);
+}
+
+// Helpers
+
+uint64_t attachmentChecksum(const void* data, size_t len) // FNV-1a 64
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    uint64_t hash = CHECKSUM_INIT;
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= bytes[i];
+        hash *= CHECKSUM_PRIME;
+    }
+    return hash;
+}
+
+// Waits Until At Most limit Frames Are Unacknowledged | 0 = Failed / Broker Stalled For DELAY_10_SEC
+static int windowWait(SendWindow* window, int limit)
+{
+    struct timespec deadline;
+    int ok = 1;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += DELAY_10_SEC_MS / 1000;
+
+    pthread_mutex_lock(&window->lock);
+    while (window->in_flight > limit && !window->failed)
+    {
+        if (pthread_cond_timedwait(&window->acked, &window->lock, &deadline) != 0)
+            break;
+    }
+    ok = window->in_flight <= limit && !window->failed;
+    pthread_mutex_unlock(&window->lock);
+    return ok;
+}
+
+static int publishFrame(MQTTAsync client, const char* topic, const char* data, int len, SendWindow* window)
+{
+    MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer; // Response Options (... = [Default Initializer Macro])
+    MQTTAsync_message pubmsg = MQTTAsync_message_initializer; // Message Object (... = [Default Initializer Macro])
+    int rc;
+
+    opts.onSuccess = onSend_f;
+    opts.onFailure = onSendFailure_f;
+    opts.context = window;
+    pubmsg.payload = (void*)data;
+    pubmsg.payloadlen = len;
+    pubmsg.qos = QOS_CHAT; // Acknowledged (Drives The Window), Duplicates Ignored By The Receiver
+    pubmsg.retained = 0;
+
+    pthread_mutex_lock(&window->lock);
+    window->in_flight++;
+    pthread_mutex_unlock(&window->lock);
+
+    if ((rc = transportSendMessage(client, topic, &pubmsg, &opts)) != MQTTASYNC_SUCCESS)
+    {
+        if (LOG_ENABLED)
+            printf("               [LOG] ATTACHMENT: Failed to start sendMessage, return code %d\n", rc);
+        pthread_mutex_lock(&window->lock);
+        window->in_flight--;
+        window->failed = 1;
+        pthread_mutex_unlock(&window->lock);
+    }
+    return rc == MQTTASYNC_SUCCESS;
+}
+
+// Last Path Component, Made Safe To Use As A File Name
+static void safeName(const char* path, int len, char* out, size_t size)
+{
+    const char* start = path;
+    for (int i = 0; i < len; i++)
+        if (path[i] == '/' || path[i] == '\\')
+            start = path + i + 1;
+    len -= (int)(start - path);
+
+    size_t n = 0;
+    if (len == 0 || start[0] == '.')
+        out[n++] = '_';
+    for (int i = 0; i < len && n < size - 1; i++)
+    {
+        unsigned char c = (unsigned char)start[i];
+        out[n++] = (c < 0x20 || c == 0x7F || c == ':' || c == ';') ? '_' : (char)c;
+    }
+    out[n] = '\0';
+}
+
+#if !defined(_WIN32)
+
+static const char* attachmentDir(void)
+{
+    const char* dir = getenv("CHATMQTT_ANEXOS");
+    if (!dir || !*dir)
+        dir = ATTACHMENT_DIR;
+    mkdir(dir, 0700); // Already There Is Fine
+    return dir;
+}
+
+static void partPath(char* out, size_t size, uint64_t id)
+{
+    snprintf(out, size, "%s/.%llx.part", attachmentDir(), (unsigned long long)id);
+}
+
+static void slotDrop(IncomingAttachment* slot, int remove_part)
+{
+    if (slot->fd >= 0)
+        close(slot->fd);
+    if (remove_part)
+    {
+        char path[1024];
+        partPath(path, sizeof(path), slot->id);
+        unlink(path);
+    }
+    free(slot->have);
+    memset(slot, 0, sizeof(*slot));
+    slot->fd = -1;
+}
+
+static int isDone(const AttachmentReceiver* receiver, uint64_t id)
+{
+    for (int i = 0; i < ATTACHMENT_IN_FLIGHT; i++)
+        if (receiver->done[i] == id)
+            return 1;
+    return 0;
+}
+
+// Finds The Transfer, Or Starts It In A Free / The Oldest Slot (Older Transfers Dropped Past ATTACHMENT_DISK_BUDGET)
+static IncomingAttachment* slotGet(AttachmentReceiver* receiver, uint64_t id, uint64_t size)
+{
+    IncomingAttachment* slot = NULL;
+    time_t now = time(NULL);
+
+    for (int i = 0; i < ATTACHMENT_IN_FLIGHT; i++)
+    {
+        IncomingAttachment* s = &receiver->slots[i];
+        if (s->id && difftime(now, s->updated) > ATTACHMENT_TIMEOUT_S)
+            slotDrop(s, 1);
+        if (s->id == id)
+            return s->size == size ? s : NULL;
+        if (!slot || (slot->id && (!s->id || s->updated < slot->updated)))
+            slot = s;
+    }
+
+    if (slot->id)
+        slotDrop(slot, 1);
+
+    // The Sizes Come From The Peer And Frames Land At Any Offset: Each Part Can Reach Its Declared Size On Disk
+    for (;;)
+    {
+        uint64_t declared = size;
+        IncomingAttachment* oldest = NULL;
+        for (int i = 0; i < ATTACHMENT_IN_FLIGHT; i++)
+        {
+            IncomingAttachment* s = &receiver->slots[i];
+            if (!s->id)
+                continue;
+            declared += s->size;
+            if (!oldest || s->updated < oldest->updated)
+                oldest = s;
+        }
+        if (declared <= (uint64_t)ATTACHMENT_DISK_BUDGET || !oldest)
+            break;
+        slotDrop(oldest, 1);
+    }
+
+    char path[1024];
+    partPath(path, sizeof(path), id);
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0)
+        return NULL;
+
+    unsigned char* have = calloc((size_t)((size + ATTACHMENT_CHUNK_SIZE - 1) / ATTACHMENT_CHUNK_SIZE + 7) / 8, 1);
+    if (!have)
+    {
+        close(fd);
+        unlink(path);
+        return NULL;
+    }
+
+    slot->id = id;
+    slot->fd = fd;
+    slot->size = size;
+    slot->received = 0;
+    slot->have = have;
+    slot->has_manifest = 0;
+    slot->updated = now;
+    return slot;
+}
+
+// Every Frame And The Manifest Arrived: Verify The Checksum And Move The File Into Place
+static int slotFinish(AttachmentReceiver* receiver, IncomingAttachment* slot, char* notice, size_t notice_size)
+{
+    const char* dir = attachmentDir();
+    char part[1024];
+    char path[1024];
+    int result = ATTACHMENT_CORRUPTED;
+
+    partPath(part, sizeof(part), slot->id);
+
+    void* map = mmap(NULL, (size_t)slot->size, PROT_READ, MAP_PRIVATE, slot->fd, 0);
+    if (map != MAP_FAILED)
+    {
+        madvise(map, (size_t)slot->size, MADV_SEQUENTIAL);
+        if (attachmentChecksum(map, (size_t)slot->size) == slot->checksum)
+            result = ATTACHMENT_COMPLETE;
+        munmap(map, (size_t)slot->size);
+    }
+
+    if (result == ATTACHMENT_COMPLETE)
+    {
+        snprintf(path, sizeof(path), "%s/%s", dir, slot->name);
+        if (access(path, F_OK) == 0) // Keep Existing Files
+            snprintf(path, sizeof(path), "%s/%llx_%s", dir, (unsigned long long)slot->id, slot->name);
+        if (rename(part, path) != 0)
+            result = ATTACHMENT_CORRUPTED;
+    }
+
+    if (result == ATTACHMENT_COMPLETE)
+        snprintf(notice, notice_size, "--- Anexo Recebido: %s (%llu Bytes) ---", path, (unsigned long long)slot->size);
+    else
+        snprintf(notice, notice_size, "--- Anexo Corrompido, Descartado: %s ---", slot->name);
+
+    receiver->done[receiver->done_next] = slot->id;
+    receiver->done_next = (receiver->done_next + 1) % ATTACHMENT_IN_FLIGHT;
+    slotDrop(slot, result != ATTACHMENT_COMPLETE);
+    return result;
+}
+
+// Main Functions
+
+// Streams path To [CONVERSATION_TOPIC]/files/[ID] (Blocks Until The Broker Acknowledged Every Frame)
+int attachmentSend(void* client, const char* conversation_topic, const char* path)
+{
+    struct stat st;
+    char name[ATTACHMENT_NAME_MAX];
+    char topic[1024];
+    int ok = 1;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        printf("Arquivo Não Encontrado: %s\n", path);
+        return EXIT_FAILURE;
+    }
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0 || st.st_size > ATTACHMENT_MAX_SIZE)
+    {
+        printf("Arquivo Inválido (Vazio, Não Regular Ou Maior Que %lld Bytes): %s\n", (long long)ATTACHMENT_MAX_SIZE, path);
+        close(fd);
+        return EXIT_FAILURE;
+    }
+
+    size_t size = (size_t)st.st_size;
+    const char* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        perror("Attachment mmap Failed");
+        return EXIT_FAILURE;
+    }
+    madvise((void*)map, size, MADV_SEQUENTIAL);
+
+    SendWindow* window = calloc(1, sizeof(SendWindow));
+    char* frame = malloc(CHUNK_HEADER_MAX + ATTACHMENT_CHUNK_SIZE); // One Frame Staged At A Time (Paho Copies It)
+    if (!window || !frame)
+    {
+        free(window);
+        free(frame);
+        munmap((void*)map, size);
+        return EXIT_FAILURE;
+    }
+    pthread_mutex_init(&window->lock, NULL);
+    pthread_cond_init(&window->acked, NULL);
+
+    uint64_t id = chunkTransferId();
+    safeName(path, (int)strlen(path), name, sizeof(name));
+    snprintf(topic, sizeof(topic), "%s" ATTACHMENT_TOPIC "%llx", conversation_topic, (unsigned long long)id);
+
+    printf("Enviando Anexo: %s (%llu Bytes)...\n", name, (unsigned long long)size);
+
+    // Manifest, Then The Data Frames
+
+    int frame_len = snprintf(frame, CHUNK_HEADER_MAX + ATTACHMENT_CHUNK_SIZE, ATTACHMENT_PREFIX "%llx;%llu;%llx;%s",
+                             (unsigned long long)id, (unsigned long long)size, (unsigned long long)attachmentChecksum(map, size), name);
+    ok = publishFrame((MQTTAsync)client, topic, frame, frame_len, window);
+
+    for (size_t offset = 0; ok && offset < size; offset += ATTACHMENT_CHUNK_SIZE)
+    {
+        int part = (size - offset < ATTACHMENT_CHUNK_SIZE) ? (int)(size - offset) : ATTACHMENT_CHUNK_SIZE;
+        ok = windowWait(window, ATTACHMENT_WINDOW - 1);
+        if (ok)
+        {
+            frame_len = chunkEncode(frame, CHUNK_HEADER_MAX + ATTACHMENT_CHUNK_SIZE, id, (uint32_t)offset, (uint32_t)size, map + offset, part);
+            ok = publishFrame((MQTTAsync)client, topic, frame, frame_len, window);
+        }
+    }
+
+    ok = windowWait(window, 0) && ok;
+
+    // Memory Management (A Stalled Window Is Left Allocated: Its Callbacks May Still Run)
+
+    free(frame);
+    munmap((void*)map, size);
+    pthread_mutex_lock(&window->lock);
+    int idle = window->in_flight == 0;
+    pthread_mutex_unlock(&window->lock);
+    if (idle)
+    {
+        pthread_cond_destroy(&window->acked);
+        pthread_mutex_destroy(&window->lock);
+        free(window);
+    }
+
+    if (ok)
+        printf("Anexo Enviado: %s\n", name);
+    else
+        printf("Falha Ao Enviar O Anexo: %s\n", name);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void attachmentInit(AttachmentReceiver* receiver)
+{
+    memset(receiver, 0, sizeof(*receiver));
+    for (int i = 0; i < ATTACHMENT_IN_FLIGHT; i++)
+        receiver->slots[i].fd = -1;
+}
+
+void attachmentFree(AttachmentReceiver* receiver) // Unfinished Transfers Are Discarded
+{
+    for (int i = 0; i < ATTACHMENT_IN_FLIGHT; i++)
+        if (receiver->slots[i].id)
+            slotDrop(&receiver->slots[i], 1);
+}
+
+// Handles One Message Of A CHATS/[LINK]/files/[ID] Topic
+int attachmentFeed(AttachmentReceiver* receiver, const char* payload, int len, char* notice, size_t notice_size)
+{
+    IncomingAttachment* slot;
+    ChunkFrame frame;
+
+    if (chunkParse(payload, len, &frame)) // Data Frame
+    {
+        uint64_t expected = (frame.total - frame.offset < ATTACHMENT_CHUNK_SIZE) ? frame.total - frame.offset : ATTACHMENT_CHUNK_SIZE;
+        if (frame.total > (uint64_t)ATTACHMENT_MAX_SIZE || frame.offset % ATTACHMENT_CHUNK_SIZE != 0 || (uint64_t)frame.len != expected)
+            return ATTACHMENT_REJECTED;
+        if ((uint32_t)(frame.id >> 32) == envelopeSession() || isDone(receiver, frame.id)) // Our Own Echo / Late Duplicate
+            return ATTACHMENT_PENDING;
+        if (!(slot = slotGet(receiver, frame.id, frame.total)))
+            return ATTACHMENT_REJECTED;
+
+        uint64_t index = frame.offset / ATTACHMENT_CHUNK_SIZE;
+        if (!(slot->have[index / 8] & (1u << (index % 8))))
+        {
+            for (int written = 0; written < frame.len; )
+            {
+                ssize_t rc = pwrite(slot->fd, frame.data + written, frame.len - written, (off_t)frame.offset + written);
+                if (rc < 0 && errno == EINTR)
+                    continue;
+                if (rc <= 0)
+                {
+                    slotDrop(slot, 1);
+                    return ATTACHMENT_REJECTED;
+                }
+                written += (int)rc;
+            }
+            slot->have[index / 8] |= (unsigned char)(1u << (index % 8));
+            slot->received += frame.len;
+        }
+    }
+    else if (len > (int)sizeof(ATTACHMENT_PREFIX) - 1 && memcmp(payload, ATTACHMENT_PREFIX, sizeof(ATTACHMENT_PREFIX) - 1) == 0) // Manifest
+    {
+        char header[128];
+        unsigned long long id, size, checksum;
+        int consumed = 0;
+
+        snprintf(header, sizeof(header), "%.*s", len < (int)sizeof(header) - 1 ? len : (int)sizeof(header) - 1, payload);
+        if (sscanf(header, ATTACHMENT_PREFIX "%llx;%llu;%llx;%n", &id, &size, &checksum, &consumed) != 3 || consumed == 0 ||
+            id == 0 || size == 0 || size > (unsigned long long)ATTACHMENT_MAX_SIZE)
+            return ATTACHMENT_REJECTED;
+        if ((uint32_t)(id >> 32) == envelopeSession() || isDone(receiver, id))
+            return ATTACHMENT_PENDING;
+        if (!(slot = slotGet(receiver, id, size)))
+            return ATTACHMENT_REJECTED;
+
+        slot->has_manifest = 1;
+        slot->checksum = checksum;
+        safeName(payload + consumed, len - consumed, slot->name, sizeof(slot->name));
+    }
+    else
+    {
+        return ATTACHMENT_REJECTED;
+    }
+
+    slot->updated = time(NULL);
+    if (slot->has_manifest && slot->received == slot->size)
+        return slotFinish(receiver, slot, notice, notice_size);
+    return ATTACHMENT_PENDING;
+}
+
+#else
+
+int attachmentSend(void* client, const char* conversation_topic, const char* path)
+{
+    printf("Anexos Não Suportados Nesta Plataforma.\n");
+    return EXIT_FAILURE;
+}
+
+void attachmentInit(AttachmentReceiver* receiver)
+{
+    memset(receiver, 0, sizeof(*receiver));
+}
+
+void attachmentFree(AttachmentReceiver* receiver)
+{
+}
+
+int attachmentFeed(AttachmentReceiver* receiver, const char* payload, int len, char* notice, size_t notice_size)
+{
+    return ATTACHMENT_REJECTED;
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef ATTACHMENT_H
+#define ATTACHMENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Constants */
+#define ATTACHMENT_TOPIC       "/files/" // CHATS/[LINK]/files/[ID]
+#define ATTACHMENT_PREFIX      "#F1;" // Manifest Version 1
+#define ATTACHMENT_CHUNK_SIZE  (32 * 1024) // Data Bytes Per Frame
+#define ATTACHMENT_WINDOW      16 // Frames Published But Not Yet Acknowledged By The Broker
+#define ATTACHMENT_MAX_SIZE    (1024LL * 1024 * 1024) // Largest File Accepted
+#define ATTACHMENT_IN_FLIGHT   4 // Files Received At Once (Oldest Dropped When Full)
+#define ATTACHMENT_DISK_BUDGET ATTACHMENT_MAX_SIZE // Declared Sizes Of The Files Received At Once, Summed (Oldest Dropped Past It)
+#define ATTACHMENT_TIMEOUT_S   120 // Transfers Without Progress For This Long Are Dropped
+#define ATTACHMENT_DIR         "anexos" // Where Received Files Are Written (CHATMQTT_ANEXOS Overrides)
+#define ATTACHMENT_NAME_MAX    128
+
+/* Attachment Messages (Published On CHATS/[LINK]/files/[ID]) */
+// Manifest > "#F1;[ID];[SIZE];[CHECKSUM];[NAME]"             | [CHECKSUM] > FNV-1a 64 Of The File (Hex)
+// Data     > "#C1;[ID];[OFFSET];[SIZE];[DATA]" (chunk.h)     | [OFFSET] Multiple Of ATTACHMENT_CHUNK_SIZE
+// Any Order, Duplicates Ignored | The File Is Kept Once Every Frame And The Manifest Arrived And The Checksum Matches
+
+typedef struct IncomingAttachment {
+    uint64_t id; // 0 = Free Slot
+    int fd; // "[DIR]/.[ID].part" (Sparse, Grows Up To size As Frames Land)
+    uint64_t size;
+    uint64_t received; // Bytes Written (Each Frame Counted Once)
+    unsigned char* have; // One Bit Per Frame
+    int has_manifest;
+    uint64_t checksum;
+    char name[ATTACHMENT_NAME_MAX];
+    time_t updated;
+} IncomingAttachment;
+
+typedef struct AttachmentReceiver {
+    IncomingAttachment slots[ATTACHMENT_IN_FLIGHT];
+    uint64_t done[ATTACHMENT_IN_FLIGHT]; // Recently Finished Transfers (Late Duplicate Frames Are Ignored)
+    int done_next;
+} AttachmentReceiver;
+
+/* Feed Results */
+#define ATTACHMENT_REJECTED  -1
+#define ATTACHMENT_PENDING    0
+#define ATTACHMENT_COMPLETE   1 // notice Holds The Line Shown In The Conversation
+#define ATTACHMENT_CORRUPTED  2 // notice Too, Nothing Kept
+
+/* Core Functions */
+uint64_t attachmentChecksum(const void* data, size_t len);
+int attachmentSend(void* client, const char* conversation_topic, const char* path);
+
+void attachmentInit(AttachmentReceiver* receiver);
+void attachmentFree(AttachmentReceiver* receiver);
+int attachmentFeed(AttachmentReceiver* receiver, const char* payload, int len, char* notice, size_t notice_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ATTACHMENT_H
@@ -0,0 +1,736 @@
+// Compilation Command: "gcc bench.c actions.c publisher.c subscriber.c agent.c messages.c events.c conversations.c envelope.c chunk.c attachment.c broker.c transport.c stats.c trace.c memory.c -o bench -lpaho-mqtt3as -pthread"
+// Excecution Command: "./bench [-b BROKER] [-s SCENARIOS] [-n PUBLISHES] [-m CHAT_MESSAGES] [-r SIZES] [-k HANDSHAKES] [-j]"
+//
+// Latency / Throughput Benchmarks (What A User Feels, Through The Same Functions "./main" Uses)
+// - publish   > publisher() Call Until It Returns (Connect, Send, Disconnect)
+// - chat      > conversationsSend() Until The Line Is In The Peer's Conversation Queue (One At A Time), Then A Burst (msgs/s)
+// - retained  > USERS/ Directory Of 100 / 10k / 100k Entries: subscriberRetained() (As getUsers() Calls It) And The Whole Snapshot
+// - handshake > USER_REQUEST Until The Agent Records It, And Until The Chat Is Ready (USER_ACCEPTED + WAITING_USER, Confirmed By The Requester's Agent)
+// Broker: Embedded (broker.h, Ephemeral Port) Unless -b / CHATMQTT_BROKER Says Otherwise ("loop://" = In-Memory Bus, transport.h)
+// Output: A Table, Or One JSON Object Per Line With -j (Latencies In Microseconds) For Regression Tracking
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include "MQTTAsync.h"
+#include "transport.h"
+#include "constants.h"
+#include "publisher.h"
+#include "subscriber.h"
+#include "messages.h"
+#include "events.h"
+#include "agent.h"
+#include "conversations.h"
+#include "broker.h"
+#include "actions.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
+
+#if defined(_WRS_KERNEL)
+#include <OsWrapper.h>
+#endif
+
+// Parameters
+
+#define DEFAULT_SCENARIOS   "publish,chat,retained,handshake"
+#define DEFAULT_PUBLISHES   50 // publisher() Connects Every Time: Slow By Design
+#define DEFAULT_CHAT        2000
+#define DEFAULT_SIZES       "100,10000,100000"
+#define DEFAULT_HANDSHAKES  10
+#define MAX_HANDSHAKES      (MAX_CONVERSATIONS - 8) // Every Handshake Adds A Conversation To The Accepting User
+#define BENCH_WINDOW        1000 // QoS 1 Publishes In Flight While Filling / Clearing The Directory
+#define BENCH_TIMEOUT_MS    10000 // Longest Wait For One Sample (Counted As A Failure)
+#define BENCH_SETTLE_US     300000L // Agents / Subscriptions Starting Up (Not Timed)
+
+// Data Structures
+
+typedef struct
+{
+    char name[64];
+    int samples;
+    int failures;
+    double p50_us;
+    double p99_us;
+    double p999_us;
+    double max_us;
+    double msgs_per_s; // 0 = Not Measured
+    long entries; // -1 = Not Applicable
+} BenchResult;
+
+typedef struct // Raw Client (Fills / Reads The Directory Without Going Through The Per-Call Connections)
+{
+    MQTTAsync client;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int connected;
+    int failed;
+    int subscribed;
+    long sent;
+    long acked;
+    long arrived; // Non-Empty Messages On Topics Starting With prefix
+    long confirmed; // Empty Messages On CHATS/ (Chat Confirmations)
+    char prefix[128];
+} BenchClient;
+
+typedef struct // Agent Thread Arguments
+{
+    char username[72];
+    ConversationManager* conversations;
+    volatile int online;
+    pthread_t thread;
+} BenchAgent;
+
+// Globals
+
+static int json_output = 0;
+static char run_id[32]; // Prefix Of Every User / Topic Of This Run
+static const char* broker_uri;
+
+// Helpers
+
+static uint64_t nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void sleepUs(long us)
+{
+    #if defined(_WIN32)
+        Sleep(us / 1000);
+    #else
+        usleep(us);
+    #endif
+}
+
+static int compareSamples(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentileUs(const uint64_t* sorted, int count, double p) // Nearest Rank
+{
+    if (count == 0)
+        return 0;
+    int rank = (int)(p * count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1] / 1000.0;
+}
+
+// Results
+
+static void report(const char* name, uint64_t* samples, int count, int failures, double msgs_per_s, long entries)
+{
+    BenchResult result;
+    memset(&result, 0, sizeof(result));
+    snprintf(result.name, sizeof(result.name), "%s", name);
+
+    qsort(samples, count, sizeof(uint64_t), compareSamples);
+    result.samples = count;
+    result.failures = failures;
+    result.p50_us = percentileUs(samples, count, 0.50);
+    result.p99_us = percentileUs(samples, count, 0.99);
+    result.p999_us = percentileUs(samples, count, 0.999);
+    result.max_us = count ? samples[count - 1] / 1000.0 : 0;
+    result.msgs_per_s = msgs_per_s;
+    result.entries = entries;
+
+    if (json_output)
+    {
+        printf("{\"benchmark\":\"%s\",\"broker\":\"%s\",\"samples\":%d,\"failures\":%d,\"p50_us\":%.1f,\"p99_us\":%.1f,\"p999_us\":%.1f,\"max_us\":%.1f,\"msgs_per_s\":%.1f,\"entries\":%ld}\n",
+               result.name, broker_uri, result.samples, result.failures, result.p50_us, result.p99_us, result.p999_us, result.max_us, result.msgs_per_s, result.entries);
+    }
+    else
+    {
+        printf("%-28s %8d %6d %12.1f %12.1f %12.1f %12.1f %12.1f", result.name, result.samples, result.failures,
+               result.p50_us, result.p99_us, result.p999_us, result.max_us, result.msgs_per_s);
+        if (result.entries >= 0)
+            printf(" %9ld", result.entries);
+        printf("\n");
+    }
+    fflush(stdout);
+}
+
+// Raw Client Callbacks
+
+static void onConnect_bm(void* context_, MQTTAsync_successData* response)
+{
+    BenchClient* bench = (BenchClient*)context_;
+    pthread_mutex_lock(&bench->lock);
+    bench->connected = 1;
+    pthread_cond_broadcast(&bench->cond);
+    pthread_mutex_unlock(&bench->lock);
+}
+
+static void onFailure_bm(void* context_, MQTTAsync_failureData* response)
+{
+    BenchClient* bench = (BenchClient*)context_;
+    pthread_mutex_lock(&bench->lock);
+    bench->failed = 1;
+    pthread_cond_broadcast(&bench->cond);
+    pthread_mutex_unlock(&bench->lock);
+}
+
+static void onSubscribe_bm(void* context_, MQTTAsync_successData* response)
+{
+    BenchClient* bench = (BenchClient*)context_;
+    pthread_mutex_lock(&bench->lock);
+    bench->subscribed = 1;
+    pthread_cond_broadcast(&bench->cond);
+    pthread_mutex_unlock(&bench->lock);
+}
+
+static void onSend_bm(void* context_, MQTTAsync_successData* response)
+{
+    BenchClient* bench = (BenchClient*)context_;
+    pthread_mutex_lock(&bench->lock);
+    bench->acked++;
+    pthread_cond_broadcast(&bench->cond);
+    pthread_mutex_unlock(&bench->lock);
+}
+
+static int messageArrived_bm(void* context_, char* topicName, int topicLen, MQTTAsync_message* message)
+{
+    BenchClient* bench = (BenchClient*)context_;
+    int arrived = message->payloadlen > 0 && strncmp(topicName, bench->prefix, strlen(bench->prefix)) == 0;
+    int confirmed = message->payloadlen == 0 && strncmp(topicName, "CHATS/", 6) == 0;
+
+    if (arrived || confirmed)
+    {
+        pthread_mutex_lock(&bench->lock);
+        bench->arrived += arrived;
+        bench->confirmed += confirmed;
+        pthread_cond_broadcast(&bench->cond);
+        pthread_mutex_unlock(&bench->lock);
+    }
+    transportFreeMessage(&message);
+    return 1;
+}
+
+// Raw Client
+
+// Waits Until *value Reaches target (Or A Failure / BENCH_TIMEOUT_MS) | 1 = Reached
+static int waitClient(BenchClient* bench, long* value, long target)
+{
+    uint64_t deadline = nowNs() + (uint64_t)BENCH_TIMEOUT_MS * 1000000ull;
+    int reached;
+
+    pthread_mutex_lock(&bench->lock);
+    while (!(reached = *value >= target) && !bench->failed && nowNs() < deadline)
+    {
+        struct timespec wake;
+        clock_gettime(CLOCK_REALTIME, &wake);
+        wake.tv_nsec += 10 * 1000000L;
+        if (wake.tv_nsec >= 1000000000L)
+        {
+            wake.tv_sec++;
+            wake.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&bench->cond, &bench->lock, &wake);
+    }
+    pthread_mutex_unlock(&bench->lock);
+    return reached;
+}
+
+static int clientStart(BenchClient* bench, const char* client_id, const char* prefix)
+{
+    MQTTAsync_connectOptions conn_opts = MQTTAsync_connectOptions_initializer;
+
+    memset(bench, 0, sizeof(*bench));
+    pthread_mutex_init(&bench->lock, NULL);
+    pthread_cond_init(&bench->cond, NULL);
+    snprintf(bench->prefix, sizeof(bench->prefix), "%s", prefix ? prefix : "");
+
+    if (transportCreate(&bench->client, ADDRESS, client_id, MQTTCLIENT_PERSISTENCE_NONE, NULL) != MQTTASYNC_SUCCESS)
+        return 0;
+    transportSetCallbacks(bench->client, bench, NULL, messageArrived_bm, NULL);
+
+    conn_opts.keepAliveInterval = 30;
+    conn_opts.cleansession = 1;
+    conn_opts.onSuccess = onConnect_bm;
+    conn_opts.onFailure = onFailure_bm;
+    conn_opts.context = bench;
+    if (transportConnect(bench->client, &conn_opts) != MQTTASYNC_SUCCESS)
+        return 0;
+
+    uint64_t deadline = nowNs() + (uint64_t)BENCH_TIMEOUT_MS * 1000000ull;
+    while (!bench->connected && !bench->failed && nowNs() < deadline)
+        sleepUs(1000);
+    return bench->connected;
+}
+
+static int clientSubscribe(BenchClient* bench, const char* filter)
+{
+    MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer;
+    opts.onSuccess = onSubscribe_bm;
+    opts.onFailure = onFailure_bm;
+    opts.context = bench;
+
+    bench->subscribed = 0;
+    if (transportSubscribe(bench->client, filter, QOS, &opts) != MQTTASYNC_SUCCESS)
+        return 0;
+
+    uint64_t deadline = nowNs() + (uint64_t)BENCH_TIMEOUT_MS * 1000000ull;
+    while (!bench->subscribed && !bench->failed && nowNs() < deadline)
+        sleepUs(1000);
+    return bench->subscribed;
+}
+
+// QoS 1 Publish, At Most BENCH_WINDOW Unacknowledged
+static int clientPublish(BenchClient* bench, const char* topic, const char* payload, int retained)
+{
+    MQTTAsync_message message = MQTTAsync_message_initializer;
+    MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer;
+
+    if (!waitClient(bench, &bench->acked, bench->sent - BENCH_WINDOW))
+        return 0;
+
+    message.payload = (void*)payload;
+    message.payloadlen = (int)strlen(payload);
+    message.qos = 1;
+    message.retained = retained;
+    opts.onSuccess = onSend_bm;
+    opts.onFailure = onFailure_bm;
+    opts.context = bench;
+
+    if (transportSendMessage(bench->client, topic, &message, &opts) != MQTTASYNC_SUCCESS)
+        return 0;
+    bench->sent++;
+    return 1;
+}
+
+static void clientStop(BenchClient* bench)
+{
+    MQTTAsync_disconnectOptions disc_opts = MQTTAsync_disconnectOptions_initializer;
+
+    if (bench->connected)
+    {
+        waitClient(bench, &bench->acked, bench->sent);
+        transportDisconnect(bench->client, &disc_opts);
+        sleepUs(10000);
+    }
+    transportDestroy(&bench->client);
+    pthread_mutex_destroy(&bench->lock);
+    pthread_cond_destroy(&bench->cond);
+}
+
+// Agents (agentControl() On Its Own Thread, As "./main" Runs It)
+
+static void* agentThread(void* agent_)
+{
+    BenchAgent* agent = (BenchAgent*)agent_;
+    agentControl(agent->username, agent->conversations, &agent->online);
+    return NULL;
+}
+
+static int agentStart(BenchAgent* agent, const char* username, ConversationManager* conversations)
+{
+    snprintf(agent->username, sizeof(agent->username), "%s_Control", username);
+    agent->conversations = conversations;
+    agent->online = 1;
+    if (pthread_create(&agent->thread, NULL, agentThread, agent) != 0)
+        return 0;
+    sleepUs(BENCH_SETTLE_US);
+    return 1;
+}
+
+static void agentStop(BenchAgent* agent)
+{
+    agent->online = 0;
+    pthread_join(agent->thread, NULL);
+}
+
+// Scenarios
+
+static void benchPublish(int count)
+{
+    uint64_t* samples = calloc(count, sizeof(uint64_t));
+    char user[64], topic[128], payload[128];
+
+    if (!samples)
+        return;
+    snprintf(user, sizeof(user), "%s_pub", run_id);
+    snprintf(topic, sizeof(topic), "BENCH/%s/publish", run_id);
+    memset(payload, 'x', 64);
+    payload[64] = '\0';
+
+    uint64_t start = nowNs();
+    for (int i = 0; i < count; i++)
+    {
+        uint64_t t0 = nowNs();
+        publisher(user, topic, payload, 0);
+        samples[i] = nowNs() - t0;
+    }
+    double elapsed = (nowNs() - start) / 1e9;
+
+    report("publish", samples, count, 0, count / elapsed, -1);
+    free(samples);
+}
+
+static void benchChat(int count)
+{
+    ConversationManager alice, bob;
+    uint64_t* samples = calloc(count, sizeof(uint64_t));
+    char alice_name[64], bob_name[64], link[256];
+    MessageView view;
+    int failures = 0;
+
+    if (!samples)
+        return;
+    snprintf(alice_name, sizeof(alice_name), "%s_alice", run_id);
+    snprintf(bob_name, sizeof(bob_name), "%s_bob", run_id);
+    snprintf(link, sizeof(link), "%s|%s|chat", alice_name, bob_name);
+
+    if (conversationsStart(&alice, alice_name) != EXIT_SUCCESS || conversationsStart(&bob, bob_name) != EXIT_SUCCESS)
+    {
+        printf("BENCH: Falha Ao Conectar As Conversas\n");
+        free(samples);
+        return;
+    }
+    alice.queue_policy = LIST_DROP_OLDEST; // Our Own Lines Come Back To Us: Not Kept
+    bob.queue_max = count + 64; // The Whole Burst Fits In Memory (No Spill To Disk In The Measure)
+
+    Conversation* to_bob = conversationsAdd(&alice, bob_name, link, 0);
+    Conversation* from_alice = conversationsAdd(&bob, alice_name, link, 0);
+
+    // Subscriptions Active Once A Line Makes It Across
+
+    int warm = 0;
+    for (int i = 0; i < 50 && !warm && to_bob && from_alice; i++)
+    {
+        conversationsSend(&alice, to_bob, "warmup");
+        warm = listWaitView(&from_alice->messages, &view, 200);
+        if (warm)
+            viewRelease(&view);
+    }
+    if (!warm)
+    {
+        printf("BENCH: A Conversa Não Ficou Pronta\n");
+        conversationsStop(&alice);
+        conversationsStop(&bob);
+        free(samples);
+        return;
+    }
+    sleepUs(200000);
+    while (listPopView(&from_alice->messages, &view))
+        viewRelease(&view);
+
+    // Latency: One Line At A Time
+
+    int taken = 0;
+    for (int i = 0; i < count; i++)
+    {
+        uint64_t t0 = nowNs();
+        conversationsSend(&alice, to_bob, "Olá, Tudo Bem?");
+        if (!listWaitView(&from_alice->messages, &view, BENCH_TIMEOUT_MS))
+        {
+            failures++;
+            continue;
+        }
+        samples[taken++] = nowNs() - t0;
+        viewRelease(&view);
+    }
+
+    // Throughput: The Whole Burst Sent, Then Received
+
+    uint64_t start = nowNs();
+    for (int i = 0; i < count; i++)
+        conversationsSend(&alice, to_bob, "Olá, Tudo Bem?");
+    int received = 0;
+    while (received < count && listWaitView(&from_alice->messages, &view, BENCH_TIMEOUT_MS))
+    {
+        viewRelease(&view);
+        received++;
+    }
+    double elapsed = (nowNs() - start) / 1e9;
+
+    report("chat", samples, taken, failures + (count - received), received / elapsed, -1);
+
+    conversationsStop(&alice);
+    conversationsStop(&bob);
+    free(samples);
+}
+
+static void benchRetained(long size)
+{
+    BenchClient writer;
+    char topic[256], payload[256], prefix[128], name[64], user[64];
+    int repeats = size >= 100000 ? 3 : 10;
+    uint64_t samples[10];
+    int failures = 0;
+
+    snprintf(prefix, sizeof(prefix), "USERS/%s_u", run_id);
+    snprintf(user, sizeof(user), "%s_reader", run_id);
+
+    // Directory Of size Entries ("[USER]:Online", As setStatus() Leaves Them)
+
+    snprintf(name, sizeof(name), "%s_writer", run_id);
+    if (!clientStart(&writer, name, NULL))
+    {
+        printf("BENCH: Falha Ao Conectar O Cliente De Carga\n");
+        clientStop(&writer);
+        return;
+    }
+    for (long i = 0; i < size; i++)
+    {
+        snprintf(topic, sizeof(topic), "%s%ld", prefix, i);
+        snprintf(payload, sizeof(payload), "%s_u%ld:Online", run_id, i);
+        if (!clientPublish(&writer, topic, payload, 1))
+            break;
+    }
+    if (!waitClient(&writer, &writer.acked, writer.sent) || writer.sent < size)
+        printf("BENCH: Diretório Incompleto (%ld De %ld Entradas)\n", writer.acked, size);
+
+    // subscriberRetained() As getUsers() Calls It (Returns Once Entries Start Arriving)
+
+    long entries = 0;
+    for (int r = 0; r < repeats; r++)
+    {
+        LinkedList list;
+        listInit(&list);
+        uint64_t t0 = nowNs();
+        subscriberRetained(user, "USERS/+", &list);
+        samples[r] = nowNs() - t0;
+        entries = listGetStats(&list).count;
+        listDestroy(&list);
+    }
+    snprintf(name, sizeof(name), "retained_getusers_%ld", size);
+    report(name, samples, repeats, 0, 0, entries);
+
+    // Whole Snapshot: Subscribe Until Every Entry Arrived (Fresh Client Each Time)
+
+    int taken = 0;
+    for (int r = 0; r < repeats; r++)
+    {
+        BenchClient reader;
+        char reader_id[64];
+        snprintf(reader_id, sizeof(reader_id), "%s_snapshot", run_id);
+        if (!clientStart(&reader, reader_id, prefix))
+        {
+            failures++;
+            clientStop(&reader);
+            continue;
+        }
+        uint64_t t0 = nowNs();
+        if (clientSubscribe(&reader, "USERS/+") && waitClient(&reader, &reader.arrived, size))
+            samples[taken++] = nowNs() - t0;
+        else
+            failures++;
+        clientStop(&reader);
+    }
+    uint64_t total = 0;
+    for (int i = 0; i < taken; i++)
+        total += samples[i];
+    snprintf(name, sizeof(name), "retained_snapshot_%ld", size);
+    report(name, samples, taken, failures, total ? (double)size * taken / (total / 1e9) : 0, size);
+
+    // Directory Cleared (Empty Retained Payloads)
+
+    for (long i = 0; i < size; i++)
+    {
+        snprintf(topic, sizeof(topic), "%s%ld", prefix, i);
+        if (!clientPublish(&writer, topic, "", 1))
+            break;
+    }
+    clientStop(&writer);
+}
+
+static void benchHandshake(int count)
+{
+    ConversationManager accepting;
+    BenchAgent accepting_agent;
+    BenchClient observer;
+    uint64_t* requested = calloc(count, sizeof(uint64_t));
+    uint64_t* ready = calloc(count, sizeof(uint64_t));
+    char bob[64], filter[128], topic[1024], link[256], observer_id[64];
+    int taken_requested = 0, taken_ready = 0, failures = 0;
+
+    if (!requested || !ready)
+    {
+        free(requested);
+        free(ready);
+        return;
+    }
+    if (count > MAX_HANDSHAKES)
+        count = MAX_HANDSHAKES;
+
+    // Accepting User: Conversations + Agent, And A Client Watching Its Pending Requests (What Its Menu Would Read) And The Chat Confirmations
+
+    snprintf(bob, sizeof(bob), "%s_bob", run_id);
+    snprintf(filter, sizeof(filter), "%s_Control/REQUESTS/+", bob);
+    snprintf(observer_id, sizeof(observer_id), "%s_observer", run_id);
+
+    if (conversationsStart(&accepting, bob) != EXIT_SUCCESS || !clientStart(&observer, observer_id, bob) || !clientSubscribe(&observer, filter) || !clientSubscribe(&observer, "CHATS/+"))
+    {
+        printf("BENCH: Falha Ao Preparar O Usuário Que Aceita\n");
+        free(requested);
+        free(ready);
+        return;
+    }
+    agentStart(&accepting_agent, bob, &accepting);
+
+    for (int i = 0; i < count; i++)
+    {
+        ConversationManager requester;
+        BenchAgent requester_agent;
+        char alice[64];
+
+        snprintf(alice, sizeof(alice), "%s_req%d", run_id, i);
+        if (conversationsStart(&requester, alice) != EXIT_SUCCESS)
+        {
+            failures++;
+            continue;
+        }
+        agentStart(&requester_agent, alice, &requester);
+
+        // requestUser()
+
+        long before = observer.arrived;
+        uint64_t t0 = nowNs();
+        requestUser(alice, bob);
+
+        if (!waitClient(&observer, &observer.arrived, before + 1))
+        {
+            failures++;
+            agentStop(&requester_agent);
+            conversationsStop(&requester);
+            continue;
+        }
+        requested[taken_requested++] = nowNs() - t0;
+
+        // createConversation() (On This Manager) + respondUser("ACEITAR"), Then The Requester's Agent Confirms The Chat ("" On CHATS/[LINK])
+
+        long confirmed = observer.confirmed;
+        snprintf(link, sizeof(link), "%s|%s|%d", alice, bob, i);
+        snprintf(topic, sizeof(topic), "CHATS/%s", link);
+        conversationsAdd(&accepting, alice, link, 0);
+        publisherDirty(bob, topic, "WAITING_USER", 1);
+        respondUser(bob, alice, link, "ACEITAR");
+
+        if (waitClient(&observer, &observer.confirmed, confirmed + 1))
+            ready[taken_ready++] = nowNs() - t0;
+        else
+            failures++;
+
+        agentStop(&requester_agent);
+        conversationsStop(&requester);
+    }
+
+    report("handshake_request_seen", requested, taken_requested, count - taken_requested, 0, -1);
+    report("handshake_chat_ready", ready, taken_ready, failures, 0, -1);
+
+    agentStop(&accepting_agent);
+    clientStop(&observer);
+    conversationsStop(&accepting);
+    free(requested);
+    free(ready);
+}
+
+// Main Function
+
+static int hasScenario(const char* scenarios, const char* name)
+{
+    size_t len = strlen(name);
+    for (const char* p = scenarios; (p = strstr(p, name)) != NULL; p += len)
+        if ((p == scenarios || p[-1] == ',') && (p[len] == '\0' || p[len] == ','))
+            return 1;
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* scenarios = DEFAULT_SCENARIOS;
+    const char* sizes = DEFAULT_SIZES;
+    const char* broker = getenv("CHATMQTT_BROKER");
+    int publishes = DEFAULT_PUBLISHES;
+    int chat = DEFAULT_CHAT;
+    int handshakes = DEFAULT_HANDSHAKES;
+    Broker* embedded = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "-j") == 0)
+            json_output = 1;
+        else if (strcmp(argv[i], "-b") == 0 && value) { broker = value; i++; }
+        else if (strcmp(argv[i], "-s") == 0 && value) { scenarios = value; i++; }
+        else if (strcmp(argv[i], "-n") == 0 && value) { publishes = atoi(value); i++; }
+        else if (strcmp(argv[i], "-m") == 0 && value) { chat = atoi(value); i++; }
+        else if (strcmp(argv[i], "-r") == 0 && value) { sizes = value; i++; }
+        else if (strcmp(argv[i], "-k") == 0 && value) { handshakes = atoi(value); i++; }
+        else
+        {
+            printf("Uso: %s [-b BROKER] [-s CENARIOS] [-n PUBLICACOES] [-m MENSAGENS] [-r TAMANHOS] [-k HANDSHAKES] [-j]\n"
+                   "  -b  URI Do Broker (Padrão: Broker Embutido Em Porta Livre | \"loop://\" = Barramento Em Memória)\n"
+                   "  -s  Cenários (Padrão: %s)\n"
+                   "  -n  Chamadas De publisher() (Padrão: %d)\n"
+                   "  -m  Mensagens De Conversa (Padrão: %d)\n"
+                   "  -r  Tamanhos Do Diretório USERS/ (Padrão: %s)\n"
+                   "  -k  Handshakes Pedido > Aceite > Conversa Pronta (Padrão: %d, Máximo: %d)\n"
+                   "  -j  Uma Linha JSON Por Resultado (Latências Em Microssegundos)\n",
+                   argv[0], DEFAULT_SCENARIOS, DEFAULT_PUBLISHES, DEFAULT_CHAT, DEFAULT_SIZES, DEFAULT_HANDSHAKES, MAX_HANDSHAKES);
+            return strcmp(argv[i], "-h") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (publishes <= 0) publishes = DEFAULT_PUBLISHES;
+    if (chat <= 0) chat = DEFAULT_CHAT;
+    if (handshakes <= 0) handshakes = DEFAULT_HANDSHAKES;
+
+    // Broker: Given, Or Embedded On A Free Port (Every Client Reads CHATMQTT_BROKER Through ADDRESS)
+
+    if (!broker || !broker[0])
+    {
+        embedded = brokerStart(0);
+        if (!embedded)
+        {
+            printf("BENCH: Falha Ao Iniciar O Broker Embutido (Use -b [URI])\n");
+            return EXIT_FAILURE;
+        }
+        broker = brokerUri(embedded);
+    }
+    #if defined(_WIN32)
+        _putenv_s("CHATMQTT_BROKER", broker);
+    #else
+        setenv("CHATMQTT_BROKER", broker, 1);
+    #endif
+    broker_uri = broker;
+    snprintf(run_id, sizeof(run_id), "bench%ld", (long)(time(NULL) % 1000000));
+
+    if (!json_output)
+    {
+        printf("BENCH: Broker %s%s | Execução %s\n\n", broker, embedded ? " (Embutido)" : "", run_id);
+        printf("%-28s %8s %6s %12s %12s %12s %12s %12s %9s\n", "Cenário", "Amostras", "Falhas", "p50 (us)", "p99 (us)", "p999 (us)", "Máx (us)", "msgs/s", "Entradas");
+    }
+
+    if (hasScenario(scenarios, "publish"))
+        benchPublish(publishes);
+    if (hasScenario(scenarios, "chat"))
+        benchChat(chat);
+    if (hasScenario(scenarios, "retained"))
+    {
+        for (const char* p = sizes; *p; )
+        {
+            long size = atol(p);
+            if (size > 0)
+                benchRetained(size);
+            p += strcspn(p, ",");
+            if (*p == ',')
+                p++;
+        }
+    }
+    if (hasScenario(scenarios, "handshake"))
+        benchHandshake(handshakes);
+
+    brokerStop(embedded);
+    return EXIT_SUCCESS;
+}
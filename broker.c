@@ -0,0 +1,1571 @@
+// Embedded MQTT 3.1.1 Broker (Tests / Benchmarks Without An External Mosquitto)
+// Standalone Compilation Command: "gcc -DBROKER_MAIN broker.c -o broker -pthread"
+// Standalone Excecution Command: "./broker [-p PORT]" (Then "CHATMQTT_BROKER=tcp://127.0.0.1:[PORT] ./main")
+//
+// - One Thread Runs Every Connection (poll()), All Broker State Is Owned By It (No Locks, Only The Counts Snapshot Has One)
+// - Messages Are Stored Once (Refcounted) And Shared By Every Subscriber Queue And The Retained Store
+// - Exact Filters Are Found Through A Hash Table, Wildcard Filters ("+" / "#") Are Walked
+// - QoS 1/2 Messages Go Through The Session Queue: Up To BROKER_INFLIGHT_MAX Sent And Unacknowledged,
+//   Resent (DUP) When A Persistent Session Reconnects | QoS 2 Is Delivered On PUBLISH, Duplicates Filtered Until PUBREL
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include "broker.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#else
+#include <windows.h>
+#endif
+
+#if defined(_WRS_KERNEL)
+#include <OsWrapper.h>
+#endif
+
+// Broker Address (Every Client Module Uses It Through ADDRESS, constants.h)
+
+const char* brokerAddress(void)
+{
+    const char* address = getenv("CHATMQTT_BROKER");
+    return (address && address[0]) ? address : BROKER_DEFAULT_ADDRESS;
+}
+
+// Topics
+
+int brokerTopicMatches(const char* filter, const char* topic)
+{
+    if (topic[0] == '$' && (filter[0] == '+' || filter[0] == '#')) // "$SYS/..." Only Matched Explicitly
+        return 0;
+
+    while (1)
+    {
+        size_t filter_len = strcspn(filter, "/");
+        size_t topic_len = strcspn(topic, "/");
+
+        if (filter_len == 1 && filter[0] == '#')
+            return 1;
+        if (!(filter_len == 1 && filter[0] == '+') && (filter_len != topic_len || memcmp(filter, topic, filter_len) != 0))
+            return 0;
+
+        filter += filter_len;
+        topic += topic_len;
+        if (!*filter && !*topic)
+            return 1;
+        if (!*filter)
+            return 0;
+        if (!*topic)
+            return strcmp(filter, "/#") == 0; // "A/#" Also Matches "A"
+        filter++;
+        topic++;
+    }
+}
+
+int brokerFilterValid(const char* filter)
+{
+    if (!filter[0])
+        return 0;
+    for (const char* c = filter; *c; c++)
+    {
+        if (*c == '#' && (c[1] != '\0' || (c != filter && c[-1] != '/')))
+            return 0;
+        if (*c == '+' && ((c[1] != '\0' && c[1] != '/') || (c != filter && c[-1] != '/')))
+            return 0;
+    }
+    return 1;
+}
+
+#if !defined(_WIN32)
+
+// Packet Types
+
+enum
+{
+    PACKET_CONNECT = 1,
+    PACKET_CONNACK,
+    PACKET_PUBLISH,
+    PACKET_PUBACK,
+    PACKET_PUBREC,
+    PACKET_PUBREL,
+    PACKET_PUBCOMP,
+    PACKET_SUBSCRIBE,
+    PACKET_SUBACK,
+    PACKET_UNSUBSCRIBE,
+    PACKET_UNSUBACK,
+    PACKET_PINGREQ,
+    PACKET_PINGRESP,
+    PACKET_DISCONNECT
+};
+
+// Pending Message States
+
+enum
+{
+    PENDING_QUEUED, // Not Sent Yet
+    PENDING_SENT, // PUBLISH Sent, Waiting For PUBACK / PUBREC
+    PENDING_RELEASED // PUBREL Sent, Waiting For PUBCOMP
+};
+
+// Data Structures
+
+typedef struct Message_b
+{
+    int refs;
+    int topic_len;
+    int len;
+    char* topic; // Nul-Terminated, Same Block
+    char* payload; // Same Block
+} Message_b;
+
+typedef struct Pending_b
+{
+    Message_b* msg;
+    uint16_t id;
+    unsigned char qos;
+    unsigned char retain;
+    unsigned char state;
+    struct Pending_b* next;
+} Pending_b;
+
+typedef struct Session_b Session_b;
+typedef struct Connection_b Connection_b;
+
+typedef struct Subscription_b
+{
+    char* filter;
+    int qos;
+    Session_b* session;
+    struct Subscription_b* next_session; // Subscriptions Of The Same Session
+    struct Subscription_b* next_match; // Same Exact Filter / Wildcard List
+} Subscription_b;
+
+struct Session_b
+{
+    char* client_id;
+    int clean;
+    Connection_b* connection; // NULL = Offline
+    Subscription_b* subscriptions;
+    Pending_b* head; // Sent Messages First, Then Queued Ones (Publish Order)
+    Pending_b* tail;
+    int inflight;
+    int queued;
+    uint16_t next_id;
+    uint16_t* incoming; // QoS 2 Ids Received, Waiting For PUBREL
+    int incoming_count;
+    int incoming_cap;
+    unsigned long mark; // Publish Being Routed (One Delivery Per Session)
+    int mark_slot;
+};
+
+struct Connection_b
+{
+    int fd;
+    Session_b* session; // NULL Until CONNECT
+    unsigned char* in;
+    size_t in_len;
+    size_t in_cap;
+    unsigned char* out;
+    size_t out_len;
+    size_t out_cap;
+    int keepalive;
+    time_t last_seen;
+    Message_b* will;
+    int will_qos;
+    int will_retain;
+    int closing; // 1 = Close After This Loop, 2 = Normal DISCONNECT (No Will)
+};
+
+typedef struct Entry_b
+{
+    char* key;
+    void* value;
+    struct Entry_b* next;
+} Entry_b;
+
+typedef struct
+{
+    Entry_b** buckets;
+    int size; // Power Of Two
+    int count;
+} Table_b;
+
+typedef struct
+{
+    Message_b* msg;
+    int qos;
+} Retained_b;
+
+typedef struct
+{
+    Session_b* session;
+    int qos;
+} Target_b;
+
+struct Broker
+{
+    int listen_fd;
+    int wake[2]; // Self-Pipe: brokerStop() Wakes The Loop
+    int port;
+    char uri[64];
+    pthread_t thread;
+    volatile int stopping;
+
+    Connection_b* connections[BROKER_MAX_CLIENTS];
+    int connection_count;
+    Table_b sessions; // Client Id > Session_b*
+    Table_b retained; // Topic > Retained_b*
+    Table_b exact; // Filter Without Wildcards > Subscription_b* (List)
+    Subscription_b* wildcards;
+
+    unsigned long publish_seq;
+    Target_b* targets;
+    int targets_cap;
+    unsigned long auto_ids;
+
+    BrokerCounts counts; // Read By Other Threads (brokerCounts())
+    pthread_mutex_t counts_lock;
+    time_t counted_at;
+};
+
+// Helpers
+
+static uint32_t hashKey(const char* key) // FNV-1a
+{
+    uint32_t hash = 2166136261u;
+    for (; *key; key++)
+    {
+        hash ^= (unsigned char)*key;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static char* copyString(const unsigned char* data, int len)
+{
+    char* copy = malloc(len + 1);
+    if (copy)
+    {
+        memcpy(copy, data, len);
+        copy[len] = '\0';
+    }
+    return copy;
+}
+
+// Table (String Keys, Chained, Doubles When Full)
+
+static Entry_b** tableSlot(Table_b* table, const char* key)
+{
+    if (!table->buckets)
+        return NULL;
+    Entry_b** slot = &table->buckets[hashKey(key) & (table->size - 1)];
+    while (*slot && strcmp((*slot)->key, key) != 0)
+        slot = &(*slot)->next;
+    return slot;
+}
+
+static void* tableGet(Table_b* table, const char* key)
+{
+    Entry_b** slot = tableSlot(table, key);
+    return (slot && *slot) ? (*slot)->value : NULL;
+}
+
+static int tablePut(Table_b* table, const char* key, void* value)
+{
+    if (table->count >= table->size) // Grow
+    {
+        int size = table->size ? table->size * 2 : 64;
+        Entry_b** buckets = calloc(size, sizeof(Entry_b*));
+        if (!buckets)
+            return 0;
+        for (int i = 0; i < table->size; i++)
+        {
+            Entry_b* entry = table->buckets[i];
+            while (entry)
+            {
+                Entry_b* next = entry->next;
+                Entry_b** slot = &buckets[hashKey(entry->key) & (size - 1)];
+                entry->next = *slot;
+                *slot = entry;
+                entry = next;
+            }
+        }
+        free(table->buckets);
+        table->buckets = buckets;
+        table->size = size;
+    }
+
+    Entry_b** slot = tableSlot(table, key);
+    if (*slot)
+    {
+        (*slot)->value = value;
+        return 1;
+    }
+    Entry_b* entry = malloc(sizeof(Entry_b));
+    if (!entry || !(entry->key = strdup(key)))
+    {
+        free(entry);
+        return 0;
+    }
+    entry->value = value;
+    entry->next = NULL;
+    *slot = entry;
+    table->count++;
+    return 1;
+}
+
+static void tableRemove(Table_b* table, const char* key)
+{
+    Entry_b** slot = tableSlot(table, key);
+    if (!slot || !*slot)
+        return;
+    Entry_b* entry = *slot;
+    *slot = entry->next;
+    free(entry->key);
+    free(entry);
+    table->count--;
+}
+
+static void tableFree(Table_b* table)
+{
+    for (int i = 0; i < table->size; i++)
+    {
+        Entry_b* entry = table->buckets[i];
+        while (entry)
+        {
+            Entry_b* next = entry->next;
+            free(entry->key);
+            free(entry);
+            entry = next;
+        }
+    }
+    free(table->buckets);
+    memset(table, 0, sizeof(*table));
+}
+
+// Messages
+
+static Message_b* messageNew(const unsigned char* topic, int topic_len, const unsigned char* payload, int len)
+{
+    Message_b* msg = malloc(sizeof(Message_b) + topic_len + 1 + len);
+    if (!msg)
+        return NULL;
+    msg->refs = 1;
+    msg->topic_len = topic_len;
+    msg->len = len;
+    msg->topic = (char*)(msg + 1);
+    msg->payload = msg->topic + topic_len + 1;
+    memcpy(msg->topic, topic, topic_len);
+    msg->topic[topic_len] = '\0';
+    if (len > 0)
+        memcpy(msg->payload, payload, len);
+    return msg;
+}
+
+static void messageRelease(Message_b* msg)
+{
+    if (msg && --msg->refs == 0)
+        free(msg);
+}
+
+// Topics
+
+static int isWildcard(const char* filter)
+{
+    return strpbrk(filter, "+#") != NULL;
+}
+
+// Output (Appended To The Connection Buffer, Flushed By The Loop)
+
+static int outReserve(Connection_b* connection, size_t more)
+{
+    if (connection->out_len + more <= connection->out_cap)
+        return 1;
+    size_t cap = connection->out_cap ? connection->out_cap : 4096;
+    while (cap < connection->out_len + more)
+        cap *= 2;
+    unsigned char* out = realloc(connection->out, cap);
+    if (!out)
+    {
+        connection->closing = 1;
+        return 0;
+    }
+    connection->out = out;
+    connection->out_cap = cap;
+    return 1;
+}
+
+static unsigned char* putHeader(unsigned char* p, int type_flags, size_t remaining)
+{
+    *p++ = (unsigned char)type_flags;
+    do
+    {
+        unsigned char byte = remaining % 128;
+        remaining /= 128;
+        *p++ = byte | (remaining > 0 ? 0x80 : 0);
+    } while (remaining > 0);
+    return p;
+}
+
+static void sendAck(Connection_b* connection, int type_flags, uint16_t id) // PUBACK / PUBREC / PUBREL / PUBCOMP / UNSUBACK
+{
+    if (!outReserve(connection, 4))
+        return;
+    unsigned char* p = connection->out + connection->out_len;
+    p[0] = (unsigned char)type_flags;
+    p[1] = 2;
+    p[2] = id >> 8;
+    p[3] = id & 0xFF;
+    connection->out_len += 4;
+}
+
+static void sendPublish(Connection_b* connection, Message_b* msg, int qos, uint16_t id, int retain, int dup)
+{
+    size_t remaining = 2 + msg->topic_len + (qos > 0 ? 2 : 0) + msg->len;
+
+    if (qos == 0 && connection->out_len > BROKER_OUTBUF_MAX) // Slow Reader: QoS 0 Is Best Effort
+        return;
+    if (!outReserve(connection, remaining + 5))
+        return;
+
+    unsigned char* p = putHeader(connection->out + connection->out_len, (PACKET_PUBLISH << 4) | (dup ? 0x08 : 0) | (qos << 1) | (retain ? 1 : 0), remaining);
+    *p++ = msg->topic_len >> 8;
+    *p++ = msg->topic_len & 0xFF;
+    memcpy(p, msg->topic, msg->topic_len);
+    p += msg->topic_len;
+    if (qos > 0)
+    {
+        *p++ = id >> 8;
+        *p++ = id & 0xFF;
+    }
+    if (msg->len > 0)
+        memcpy(p, msg->payload, msg->len);
+    p += msg->len;
+    connection->out_len = p - connection->out;
+}
+
+static void flushConnection(Connection_b* connection)
+{
+    size_t sent = 0;
+    while (sent < connection->out_len)
+    {
+        ssize_t n = send(connection->fd, connection->out + sent, connection->out_len - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n > 0)
+        {
+            sent += n;
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if (n < 0 && errno == EINTR)
+            continue;
+        connection->closing = connection->closing ? connection->closing : 1;
+        break;
+    }
+    if (sent > 0)
+    {
+        memmove(connection->out, connection->out + sent, connection->out_len - sent);
+        connection->out_len -= sent;
+    }
+}
+
+// Sessions
+
+static uint16_t nextId(Session_b* session)
+{
+    while (1)
+    {
+        if (++session->next_id == 0)
+            session->next_id = 1;
+        int used = 0;
+        for (Pending_b* pending = session->head; pending && pending->state != PENDING_QUEUED; pending = pending->next)
+            if (pending->id == session->next_id)
+                used = 1;
+        if (!used)
+            return session->next_id;
+    }
+}
+
+// Sends Queued Messages While The Inflight Window Has Room
+static void pumpSession(Session_b* session)
+{
+    if (!session->connection)
+        return;
+    for (Pending_b* pending = session->head; pending && session->inflight < BROKER_INFLIGHT_MAX; pending = pending->next)
+    {
+        if (pending->state != PENDING_QUEUED)
+            continue;
+        pending->id = nextId(session);
+        pending->state = PENDING_SENT;
+        session->inflight++;
+        session->queued--;
+        sendPublish(session->connection, pending->msg, pending->qos, pending->id, pending->retain, 0);
+    }
+}
+
+static void removePending(Session_b* session, Pending_b* target)
+{
+    Pending_b** link = &session->head;
+    Pending_b* previous = NULL;
+    while (*link && *link != target)
+    {
+        previous = *link;
+        link = &(*link)->next;
+    }
+    if (!*link)
+        return;
+    *link = target->next;
+    if (session->tail == target)
+        session->tail = previous;
+    if (target->state == PENDING_QUEUED)
+        session->queued--;
+    else
+        session->inflight--;
+    messageRelease(target->msg);
+    free(target);
+}
+
+static Pending_b* findPending(Session_b* session, uint16_t id, int state)
+{
+    for (Pending_b* pending = session->head; pending && pending->state != PENDING_QUEUED; pending = pending->next)
+        if (pending->id == id && pending->state == state)
+            return pending;
+    return NULL;
+}
+
+static void deliver(Session_b* session, Message_b* msg, int qos, int retain)
+{
+    if (qos == 0)
+    {
+        if (session->connection)
+            sendPublish(session->connection, msg, 0, 0, retain, 0);
+        return;
+    }
+
+    // Queue Full: The Oldest Message Not Yet Sent Is Dropped
+
+    if (session->queued >= BROKER_QUEUE_MAX)
+    {
+        for (Pending_b* pending = session->head; pending; pending = pending->next)
+        {
+            if (pending->state == PENDING_QUEUED)
+            {
+                removePending(session, pending);
+                break;
+            }
+        }
+    }
+
+    Pending_b* pending = calloc(1, sizeof(Pending_b));
+    if (!pending)
+        return;
+    msg->refs++;
+    pending->msg = msg;
+    pending->qos = (unsigned char)qos;
+    pending->retain = (unsigned char)retain;
+    pending->state = PENDING_QUEUED;
+    if (session->tail)
+        session->tail->next = pending;
+    else
+        session->head = pending;
+    session->tail = pending;
+    session->queued++;
+
+    pumpSession(session);
+}
+
+static void unlinkSubscription(Broker* broker, Subscription_b* subscription)
+{
+    Subscription_b** link;
+    Subscription_b* head = NULL;
+
+    if (isWildcard(subscription->filter))
+        link = &broker->wildcards;
+    else
+    {
+        head = tableGet(&broker->exact, subscription->filter);
+        link = &head;
+    }
+
+    while (*link && *link != subscription)
+        link = &(*link)->next_match;
+    if (*link)
+        *link = subscription->next_match;
+
+    if (!isWildcard(subscription->filter))
+    {
+        if (head)
+            tablePut(&broker->exact, subscription->filter, head);
+        else
+            tableRemove(&broker->exact, subscription->filter);
+    }
+}
+
+static void freeSession(Broker* broker, Session_b* session)
+{
+    while (session->subscriptions)
+    {
+        Subscription_b* subscription = session->subscriptions;
+        session->subscriptions = subscription->next_session;
+        unlinkSubscription(broker, subscription);
+        free(subscription->filter);
+        free(subscription);
+    }
+    while (session->head)
+    {
+        Pending_b* pending = session->head;
+        session->head = pending->next;
+        messageRelease(pending->msg);
+        free(pending);
+    }
+    tableRemove(&broker->sessions, session->client_id);
+    free(session->incoming);
+    free(session->client_id);
+    free(session);
+}
+
+// Routing
+
+static void route(Broker* broker, Message_b* msg, int qos)
+{
+    int count = 0;
+    unsigned long seq = ++broker->publish_seq;
+
+    // Matching Sessions (A Session Matched By Several Filters Gets One Copy At The Highest QoS)
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        Subscription_b* subscription = pass == 0 ? tableGet(&broker->exact, msg->topic) : broker->wildcards;
+        for (; subscription; subscription = subscription->next_match)
+        {
+            if (pass == 1 && !brokerTopicMatches(subscription->filter, msg->topic))
+                continue;
+
+            Session_b* session = subscription->session;
+            int granted = subscription->qos < qos ? subscription->qos : qos;
+            if (session->mark == seq)
+            {
+                if (broker->targets[session->mark_slot].qos < granted)
+                    broker->targets[session->mark_slot].qos = granted;
+                continue;
+            }
+
+            if (count == broker->targets_cap)
+            {
+                int cap = broker->targets_cap ? broker->targets_cap * 2 : 64;
+                Target_b* targets = realloc(broker->targets, cap * sizeof(Target_b));
+                if (!targets)
+                    break;
+                broker->targets = targets;
+                broker->targets_cap = cap;
+            }
+            session->mark = seq;
+            session->mark_slot = count;
+            broker->targets[count].session = session;
+            broker->targets[count].qos = granted;
+            count++;
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+        deliver(broker->targets[i].session, msg, broker->targets[i].qos, 0);
+}
+
+static void retain(Broker* broker, Message_b* msg, int qos)
+{
+    Retained_b* old = tableGet(&broker->retained, msg->topic);
+
+    if (msg->len == 0) // Empty Retained Message Clears The Topic
+    {
+        if (old)
+        {
+            tableRemove(&broker->retained, msg->topic);
+            messageRelease(old->msg);
+            free(old);
+        }
+        return;
+    }
+
+    if (!old)
+    {
+        if (!(old = calloc(1, sizeof(Retained_b))) || !tablePut(&broker->retained, msg->topic, old))
+        {
+            free(old);
+            return;
+        }
+    }
+    else
+        messageRelease(old->msg);
+
+    msg->refs++;
+    old->msg = msg;
+    old->qos = qos;
+}
+
+static void publish(Broker* broker, Message_b* msg, int qos, int retained)
+{
+    if (retained)
+        retain(broker, msg, qos);
+    route(broker, msg, qos);
+}
+
+static void sendRetained(Broker* broker, Session_b* session, const char* filter, int granted)
+{
+    if (!isWildcard(filter))
+    {
+        Retained_b* retained = tableGet(&broker->retained, filter);
+        if (retained)
+            deliver(session, retained->msg, retained->qos < granted ? retained->qos : granted, 1);
+        return;
+    }
+
+    for (int i = 0; i < broker->retained.size; i++)
+    {
+        for (Entry_b* entry = broker->retained.buckets[i]; entry; entry = entry->next)
+        {
+            Retained_b* retained = entry->value;
+            if (brokerTopicMatches(filter, retained->msg->topic))
+                deliver(session, retained->msg, retained->qos < granted ? retained->qos : granted, 1);
+        }
+    }
+}
+
+// Packet Reading
+
+typedef struct
+{
+    const unsigned char* p;
+    const unsigned char* end;
+    int ok;
+} Reader_b;
+
+static int readByte(Reader_b* reader)
+{
+    if (reader->p >= reader->end)
+    {
+        reader->ok = 0;
+        return 0;
+    }
+    return *reader->p++;
+}
+
+static uint16_t readShort(Reader_b* reader)
+{
+    int high = readByte(reader);
+    int low = readByte(reader);
+    return (uint16_t)((high << 8) | low);
+}
+
+static const unsigned char* readBytes(Reader_b* reader, int* len) // 2-Byte Length Prefix
+{
+    *len = readShort(reader);
+    if (!reader->ok || reader->end - reader->p < *len)
+    {
+        reader->ok = 0;
+        return NULL;
+    }
+    const unsigned char* data = reader->p;
+    reader->p += *len;
+    return data;
+}
+
+// Packet Handlers (Return 0 To Close The Connection)
+
+static int handleConnect(Broker* broker, Connection_b* connection, Reader_b* reader)
+{
+    int len;
+    const unsigned char* protocol = readBytes(reader, &len);
+    int level = readByte(reader);
+    int flags = readByte(reader);
+    connection->keepalive = readShort(reader);
+
+    int id_len;
+    const unsigned char* id = readBytes(reader, &id_len);
+    if (!reader->ok || connection->session)
+        return 0;
+
+    if (!protocol || !((len == 4 && memcmp(protocol, "MQTT", 4) == 0 && level == 4) || (len == 6 && memcmp(protocol, "MQIsdp", 6) == 0 && level == 3)))
+    {
+        unsigned char refused[4] = { PACKET_CONNACK << 4, 2, 0, 1 }; // Unacceptable Protocol Version
+        if (outReserve(connection, 4))
+        {
+            memcpy(connection->out + connection->out_len, refused, 4);
+            connection->out_len += 4;
+        }
+        connection->closing = 2;
+        return 1;
+    }
+
+    int clean = (flags & 0x02) != 0;
+
+    if (flags & 0x04) // Will
+    {
+        int will_topic_len, will_len;
+        const unsigned char* will_topic = readBytes(reader, &will_topic_len);
+        const unsigned char* will = readBytes(reader, &will_len);
+        if (!reader->ok)
+            return 0;
+        connection->will = messageNew(will_topic, will_topic_len, will, will_len);
+        connection->will_qos = (flags >> 3) & 0x03;
+        connection->will_retain = (flags & 0x20) != 0;
+    }
+
+    // Username / Password Are Accepted As They Come
+
+    char* client_id;
+    if (id_len == 0)
+    {
+        if (!clean)
+            return 0; // Identifier Rejected
+        char generated[32];
+        snprintf(generated, sizeof(generated), "broker-auto-%lu", ++broker->auto_ids);
+        client_id = strdup(generated);
+    }
+    else
+        client_id = copyString(id, id_len);
+    if (!client_id)
+        return 0;
+
+    // Session: Taken Over From An Older Connection, Resumed (Persistent) Or New
+
+    Session_b* session = tableGet(&broker->sessions, client_id);
+    if (session && session->connection)
+    {
+        session->connection->session = NULL;
+        messageRelease(session->connection->will); // Taken Over: No Will
+        session->connection->will = NULL;
+        session->connection->closing = 2;
+        session->connection = NULL;
+    }
+    if (session && clean)
+    {
+        freeSession(broker, session);
+        session = NULL;
+    }
+
+    int present = session != NULL;
+    if (!session)
+    {
+        session = calloc(1, sizeof(Session_b));
+        if (!session || !tablePut(&broker->sessions, client_id, session))
+        {
+            free(session);
+            free(client_id);
+            return 0;
+        }
+        session->client_id = client_id;
+    }
+    else
+        free(client_id);
+
+    session->clean = clean;
+    session->connection = connection;
+    connection->session = session;
+
+    unsigned char connack[4] = { PACKET_CONNACK << 4, 2, (unsigned char)present, 0 };
+    if (outReserve(connection, 4))
+    {
+        memcpy(connection->out + connection->out_len, connack, 4);
+        connection->out_len += 4;
+    }
+
+    // Resume: Unacknowledged Messages Again (DUP), Then The Queue
+
+    for (Pending_b* pending = session->head; pending && pending->state != PENDING_QUEUED; pending = pending->next)
+    {
+        if (pending->state == PENDING_SENT)
+            sendPublish(connection, pending->msg, pending->qos, pending->id, pending->retain, 1);
+        else
+            sendAck(connection, (PACKET_PUBREL << 4) | 0x02, pending->id);
+    }
+    pumpSession(session);
+    return 1;
+}
+
+static int handlePublish(Broker* broker, Connection_b* connection, int flags, Reader_b* reader)
+{
+    Session_b* session = connection->session;
+    int qos = (flags >> 1) & 0x03;
+    int retained = flags & 0x01;
+    int topic_len;
+    const unsigned char* topic = readBytes(reader, &topic_len);
+    uint16_t id = qos > 0 ? readShort(reader) : 0;
+
+    if (!reader->ok || qos == 3 || topic_len == 0 || memchr(topic, '+', topic_len) || memchr(topic, '#', topic_len))
+        return 0;
+
+    if (qos == 2)
+    {
+        for (int i = 0; i < session->incoming_count; i++)
+        {
+            if (session->incoming[i] == id) // Resent Before PUBREL: Already Delivered
+            {
+                sendAck(connection, PACKET_PUBREC << 4, id);
+                return 1;
+            }
+        }
+        if (session->incoming_count == session->incoming_cap)
+        {
+            int cap = session->incoming_cap ? session->incoming_cap * 2 : 16;
+            uint16_t* incoming = realloc(session->incoming, cap * sizeof(uint16_t));
+            if (!incoming)
+                return 0;
+            session->incoming = incoming;
+            session->incoming_cap = cap;
+        }
+        session->incoming[session->incoming_count++] = id;
+    }
+
+    Message_b* msg = messageNew(topic, topic_len, reader->p, (int)(reader->end - reader->p));
+    if (!msg)
+        return 0;
+    publish(broker, msg, qos, retained);
+    messageRelease(msg);
+
+    if (qos == 1)
+        sendAck(connection, PACKET_PUBACK << 4, id);
+    else if (qos == 2)
+        sendAck(connection, PACKET_PUBREC << 4, id);
+    return 1;
+}
+
+static int handleSubscribe(Broker* broker, Connection_b* connection, Reader_b* reader)
+{
+    Session_b* session = connection->session;
+    uint16_t id = readShort(reader);
+    unsigned char codes[256];
+    char* filters[256];
+    int count = 0;
+
+    while (reader->ok && reader->p < reader->end && count < 256)
+    {
+        int len;
+        const unsigned char* data = readBytes(reader, &len);
+        int qos = readByte(reader);
+        if (!reader->ok)
+            break;
+
+        char* filter = copyString(data, len);
+        filters[count] = filter;
+        if (!filter || !brokerFilterValid(filter) || qos > 2)
+        {
+            codes[count++] = 0x80; // Failure
+            continue;
+        }
+        codes[count++] = (unsigned char)qos;
+
+        // Same Filter Again Replaces The QoS
+
+        Subscription_b* subscription = session->subscriptions;
+        while (subscription && strcmp(subscription->filter, filter) != 0)
+            subscription = subscription->next_session;
+        if (subscription)
+        {
+            subscription->qos = qos;
+            continue;
+        }
+
+        if (!(subscription = calloc(1, sizeof(Subscription_b))) || !(subscription->filter = strdup(filter)))
+        {
+            free(subscription);
+            codes[count - 1] = 0x80;
+            continue;
+        }
+        subscription->qos = qos;
+        subscription->session = session;
+        subscription->next_session = session->subscriptions;
+        session->subscriptions = subscription;
+
+        if (isWildcard(filter))
+        {
+            subscription->next_match = broker->wildcards;
+            broker->wildcards = subscription;
+        }
+        else
+        {
+            subscription->next_match = tableGet(&broker->exact, filter);
+            tablePut(&broker->exact, filter, subscription);
+        }
+    }
+
+    if (!reader->ok || count == 0)
+    {
+        for (int i = 0; i < count; i++)
+            free(filters[i]);
+        return 0;
+    }
+
+    // SUBACK, Then The Retained Messages Of Each Filter
+
+    if (outReserve(connection, 2 + count + 5))
+    {
+        unsigned char* p = putHeader(connection->out + connection->out_len, PACKET_SUBACK << 4, 2 + count);
+        *p++ = id >> 8;
+        *p++ = id & 0xFF;
+        memcpy(p, codes, count);
+        connection->out_len = (p + count) - connection->out;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (codes[i] != 0x80)
+            sendRetained(broker, session, filters[i], codes[i]);
+        free(filters[i]);
+    }
+    return 1;
+}
+
+static int handleUnsubscribe(Broker* broker, Connection_b* connection, Reader_b* reader)
+{
+    Session_b* session = connection->session;
+    uint16_t id = readShort(reader);
+
+    while (reader->ok && reader->p < reader->end)
+    {
+        int len;
+        const unsigned char* data = readBytes(reader, &len);
+        if (!reader->ok)
+            break;
+
+        Subscription_b** link = &session->subscriptions;
+        while (*link && ((int)strlen((*link)->filter) != len || memcmp((*link)->filter, data, len) != 0))
+            link = &(*link)->next_session;
+        if (*link)
+        {
+            Subscription_b* subscription = *link;
+            *link = subscription->next_session;
+            unlinkSubscription(broker, subscription);
+            free(subscription->filter);
+            free(subscription);
+        }
+    }
+    if (!reader->ok)
+        return 0;
+
+    sendAck(connection, PACKET_UNSUBACK << 4, id);
+    return 1;
+}
+
+static int handlePacket(Broker* broker, Connection_b* connection, int header, const unsigned char* body, size_t len)
+{
+    Reader_b reader = { body, body + len, 1 };
+    int type = header >> 4;
+    Session_b* session = connection->session;
+
+    if (type != PACKET_CONNECT && !session)
+        return 0; // CONNECT Must Come First
+
+    switch (type)
+    {
+        case PACKET_CONNECT:
+            return handleConnect(broker, connection, &reader);
+
+        case PACKET_PUBLISH:
+            return handlePublish(broker, connection, header & 0x0F, &reader);
+
+        case PACKET_PUBACK: // QoS 1 Delivered
+        {
+            Pending_b* pending = findPending(session, readShort(&reader), PENDING_SENT);
+            if (pending && pending->qos == 1)
+                removePending(session, pending);
+            pumpSession(session);
+            return reader.ok;
+        }
+
+        case PACKET_PUBREC: // QoS 2 Received By The Client
+        {
+            uint16_t id = readShort(&reader);
+            Pending_b* pending = findPending(session, id, PENDING_SENT);
+            if (pending)
+                pending->state = PENDING_RELEASED;
+            sendAck(connection, (PACKET_PUBREL << 4) | 0x02, id);
+            return reader.ok;
+        }
+
+        case PACKET_PUBREL: // QoS 2 From The Client Completed
+        {
+            uint16_t id = readShort(&reader);
+            for (int i = 0; i < session->incoming_count; i++)
+            {
+                if (session->incoming[i] == id)
+                {
+                    session->incoming[i] = session->incoming[--session->incoming_count];
+                    break;
+                }
+            }
+            sendAck(connection, PACKET_PUBCOMP << 4, id);
+            return reader.ok;
+        }
+
+        case PACKET_PUBCOMP: // QoS 2 Delivered
+        {
+            Pending_b* pending = findPending(session, readShort(&reader), PENDING_RELEASED);
+            if (pending)
+                removePending(session, pending);
+            pumpSession(session);
+            return reader.ok;
+        }
+
+        case PACKET_SUBSCRIBE:
+            return handleSubscribe(broker, connection, &reader);
+
+        case PACKET_UNSUBSCRIBE:
+            return handleUnsubscribe(broker, connection, &reader);
+
+        case PACKET_PINGREQ:
+            if (outReserve(connection, 2))
+            {
+                connection->out[connection->out_len++] = PACKET_PINGRESP << 4;
+                connection->out[connection->out_len++] = 0;
+            }
+            return 1;
+
+        case PACKET_DISCONNECT:
+            messageRelease(connection->will); // Normal Disconnection: No Will
+            connection->will = NULL;
+            connection->closing = 2;
+            return 1;
+    }
+    return 0;
+}
+
+// Parses Every Complete Packet In The Input Buffer
+static void readPackets(Broker* broker, Connection_b* connection)
+{
+    size_t offset = 0;
+
+    while (!connection->closing && connection->in_len - offset >= 2)
+    {
+        const unsigned char* p = connection->in + offset;
+        size_t available = connection->in_len - offset;
+        size_t remaining = 0;
+        size_t used = 1;
+        int multiplier = 1;
+        int complete = 0;
+
+        while (used < available && used <= 4)
+        {
+            unsigned char byte = p[used++];
+            remaining += (byte & 0x7F) * multiplier;
+            multiplier *= 128;
+            if (!(byte & 0x80))
+            {
+                complete = 1;
+                break;
+            }
+        }
+        if (!complete)
+        {
+            if (used > 4)
+                connection->closing = 1; // Malformed Length
+            break;
+        }
+        if (remaining > BROKER_PACKET_MAX)
+        {
+            connection->closing = 1;
+            break;
+        }
+        if (available - used < remaining)
+            break; // Rest Of The Packet Not Here Yet
+
+        if (!handlePacket(broker, connection, p[0], p + used, remaining))
+            connection->closing = 1;
+        offset += used + remaining;
+    }
+
+    if (offset > 0)
+    {
+        memmove(connection->in, connection->in + offset, connection->in_len - offset);
+        connection->in_len -= offset;
+    }
+}
+
+// Connections
+
+static void closeConnection(Broker* broker, int index)
+{
+    Connection_b* connection = broker->connections[index];
+    Session_b* session = connection->session;
+
+    if (connection->will && connection->closing != 2) // Unexpected Loss: Publish The Will
+        publish(broker, connection->will, connection->will_qos, connection->will_retain);
+    messageRelease(connection->will);
+
+    if (session) // Persistent Sessions Keep Their Messages (Unacknowledged Ones Are Resent On Reconnection)
+    {
+        session->connection = NULL;
+        if (session->clean)
+            freeSession(broker, session);
+    }
+
+    close(connection->fd);
+    free(connection->in);
+    free(connection->out);
+    free(connection);
+    broker->connections[index] = broker->connections[--broker->connection_count];
+}
+
+static void acceptConnections(Broker* broker)
+{
+    int fd;
+    while ((fd = accept(broker->listen_fd, NULL, NULL)) >= 0)
+    {
+        if (broker->connection_count == BROKER_MAX_CLIENTS)
+        {
+            close(fd);
+            continue;
+        }
+        Connection_b* connection = calloc(1, sizeof(Connection_b));
+        if (!connection)
+        {
+            close(fd);
+            continue;
+        }
+        int one = 1;
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        connection->fd = fd;
+        connection->last_seen = time(NULL);
+        broker->connections[broker->connection_count++] = connection;
+    }
+}
+
+static void readConnection(Broker* broker, Connection_b* connection)
+{
+    while (!connection->closing)
+    {
+        if (connection->in_cap - connection->in_len < 4096)
+        {
+            size_t cap = connection->in_cap ? connection->in_cap * 2 : 8192;
+            unsigned char* in = realloc(connection->in, cap);
+            if (!in)
+            {
+                connection->closing = 1;
+                return;
+            }
+            connection->in = in;
+            connection->in_cap = cap;
+        }
+
+        ssize_t n = recv(connection->fd, connection->in + connection->in_len, connection->in_cap - connection->in_len, 0);
+        if (n > 0)
+        {
+            connection->in_len += n;
+            connection->last_seen = time(NULL);
+            readPackets(broker, connection);
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return;
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (!connection->closing)
+            connection->closing = 1; // EOF / Error
+        return;
+    }
+}
+
+// Counts (The Only State Shared With Other Threads, Refreshed At Most Once A Second: Sessions Are Walked)
+
+static void countState(Broker* broker)
+{
+    BrokerCounts counts;
+    memset(&counts, 0, sizeof(counts));
+    counts.connections = broker->connection_count;
+    counts.sessions = broker->sessions.count;
+    counts.retained = broker->retained.count;
+
+    for (int i = 0; i < broker->sessions.size; i++)
+    {
+        for (Entry_b* entry = broker->sessions.buckets[i]; entry; entry = entry->next)
+        {
+            Session_b* session = entry->value;
+            if (!session->connection)
+                counts.sessions_offline++;
+            counts.pending += session->queued + session->inflight;
+        }
+    }
+
+    pthread_mutex_lock(&broker->counts_lock);
+    broker->counts = counts;
+    pthread_mutex_unlock(&broker->counts_lock);
+}
+
+static void* brokerLoop(void* broker_)
+{
+    Broker* broker = (Broker*)broker_;
+    struct pollfd* fds = calloc(BROKER_MAX_CLIENTS + 2, sizeof(struct pollfd));
+
+    if (!fds)
+        return NULL;
+
+    while (!broker->stopping)
+    {
+        int count = broker->connection_count;
+
+        fds[0].fd = broker->listen_fd;
+        fds[0].events = POLLIN;
+        fds[1].fd = broker->wake[0];
+        fds[1].events = POLLIN;
+        for (int i = 0; i < count; i++)
+        {
+            fds[i + 2].fd = broker->connections[i]->fd;
+            fds[i + 2].events = POLLIN | (broker->connections[i]->out_len > 0 ? POLLOUT : 0);
+            fds[i + 2].revents = 0;
+        }
+
+        if (poll(fds, count + 2, 1000) < 0 && errno != EINTR)
+            break;
+
+        if (fds[1].revents & POLLIN)
+        {
+            char drain[64];
+            while (read(broker->wake[0], drain, sizeof(drain)) > 0) {}
+        }
+
+        // Input (Handled Packets May Queue Output On Any Connection)
+
+        for (int i = 0; i < count; i++)
+            if (fds[i + 2].revents & (POLLIN | POLLHUP | POLLERR))
+                readConnection(broker, broker->connections[i]);
+
+        // Output, Keep Alive (1.5x), Closing
+
+        time_t now = time(NULL);
+        for (int i = broker->connection_count - 1; i >= 0; i--)
+        {
+            Connection_b* connection = broker->connections[i];
+            if (connection->out_len > 0)
+                flushConnection(connection);
+            if (!connection->closing && connection->keepalive > 0 && now - connection->last_seen > connection->keepalive * 3 / 2)
+                connection->closing = 1;
+            if (connection->closing)
+            {
+                if (connection->out_len > 0)
+                    flushConnection(connection); // Last Words (CONNACK Refusal...)
+                closeConnection(broker, i);
+            }
+        }
+
+        if (fds[0].revents & POLLIN)
+            acceptConnections(broker);
+
+        if (now != broker->counted_at)
+        {
+            countState(broker);
+            broker->counted_at = now;
+        }
+    }
+
+    free(fds);
+    return NULL;
+}
+
+// Main Functions
+
+Broker* brokerStart(int port)
+{
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    int one = 1;
+
+    Broker* broker = calloc(1, sizeof(Broker));
+    if (!broker)
+        return NULL;
+
+    broker->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (broker->listen_fd < 0)
+    {
+        free(broker);
+        return NULL;
+    }
+    setsockopt(broker->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons((uint16_t)port);
+
+    if (bind(broker->listen_fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(broker->listen_fd, 128) != 0 ||
+        getsockname(broker->listen_fd, (struct sockaddr*)&addr, &addr_len) != 0 || pipe(broker->wake) != 0)
+    {
+        close(broker->listen_fd);
+        free(broker);
+        return NULL;
+    }
+    fcntl(broker->listen_fd, F_SETFL, O_NONBLOCK);
+    fcntl(broker->wake[0], F_SETFL, O_NONBLOCK);
+
+    broker->port = ntohs(addr.sin_port);
+    snprintf(broker->uri, sizeof(broker->uri), "tcp://127.0.0.1:%d", broker->port);
+    pthread_mutex_init(&broker->counts_lock, NULL);
+
+    if (pthread_create(&broker->thread, NULL, brokerLoop, broker) != 0)
+    {
+        pthread_mutex_destroy(&broker->counts_lock);
+        close(broker->listen_fd);
+        close(broker->wake[0]);
+        close(broker->wake[1]);
+        free(broker);
+        return NULL;
+    }
+    return broker;
+}
+
+int brokerPort(const Broker* broker)
+{
+    return broker->port;
+}
+
+const char* brokerUri(const Broker* broker)
+{
+    return broker->uri;
+}
+
+void brokerCounts(Broker* broker, BrokerCounts* counts)
+{
+    pthread_mutex_lock(&broker->counts_lock);
+    *counts = broker->counts;
+    pthread_mutex_unlock(&broker->counts_lock);
+}
+
+void brokerStop(Broker* broker)
+{
+    if (!broker)
+        return;
+
+    broker->stopping = 1;
+    if (write(broker->wake[1], "x", 1) < 0) { /* Loop Wakes Up Within A Second Anyway */ }
+    pthread_join(broker->thread, NULL);
+
+    // Memory Management (Loop Finished, Nothing Else Touches The State)
+
+    while (broker->connection_count > 0)
+    {
+        broker->connections[0]->closing = 2;
+        closeConnection(broker, 0);
+    }
+    while (broker->sessions.count > 0)
+    {
+        for (int i = 0; i < broker->sessions.size; i++)
+            if (broker->sessions.buckets[i])
+            {
+                freeSession(broker, broker->sessions.buckets[i]->value);
+                break;
+            }
+    }
+    for (int i = 0; i < broker->retained.size; i++)
+    {
+        for (Entry_b* entry = broker->retained.buckets[i]; entry; entry = entry->next)
+        {
+            Retained_b* retained = entry->value;
+            messageRelease(retained->msg);
+            free(retained);
+        }
+    }
+    tableFree(&broker->retained);
+    tableFree(&broker->sessions);
+    tableFree(&broker->exact);
+    free(broker->targets);
+
+    close(broker->listen_fd);
+    close(broker->wake[0]);
+    close(broker->wake[1]);
+    pthread_mutex_destroy(&broker->counts_lock);
+    free(broker);
+}
+
+#else
+
+Broker* brokerStart(int port)
+{
+    (void)port;
+    return NULL;
+}
+
+int brokerPort(const Broker* broker)
+{
+    (void)broker;
+    return 0;
+}
+
+const char* brokerUri(const Broker* broker)
+{
+    (void)broker;
+    return BROKER_DEFAULT_ADDRESS;
+}
+
+void brokerStop(Broker* broker)
+{
+    (void)broker;
+}
+
+void brokerCounts(Broker* broker, BrokerCounts* counts)
+{
+    (void)broker;
+    memset(counts, 0, sizeof(*counts));
+}
+
+#endif
+
+// Standalone Broker
+
+#if defined(BROKER_MAIN)
+
+#if !defined(_WIN32)
+static volatile sig_atomic_t stop_b = 0;
+
+static void onSignal(int sig)
+{
+    (void)sig;
+    stop_b = 1;
+}
+#endif
+
+int main(int argc, char* argv[])
+{
+    int port = BROKER_DEFAULT_PORT;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+            port = atoi(argv[++i]);
+        else
+        {
+            printf("Uso: %s [-p PORTA] (0 = Porta Livre Qualquer, Padrão: %d)\n", argv[0], BROKER_DEFAULT_PORT);
+            return strcmp(argv[i], "-h") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    Broker* broker = brokerStart(port);
+    if (!broker)
+    {
+        printf("BROKER: Falha Ao Iniciar Na Porta %d\n", port);
+        return EXIT_FAILURE;
+    }
+
+    #if !defined(_WIN32)
+        signal(SIGINT, onSignal);
+        signal(SIGTERM, onSignal);
+        printf("BROKER: Pronto Em %s (Ctrl+C Encerra)\n", brokerUri(broker));
+        fflush(stdout);
+        while (!stop_b)
+            pause();
+    #endif
+
+    brokerStop(broker);
+    printf("BROKER: Encerrado\n");
+    return EXIT_SUCCESS;
+}
+
+#endif
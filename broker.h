@@ -0,0 +1,47 @@
+#ifndef BROKER_H
+#define BROKER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Constants */
+#define BROKER_DEFAULT_ADDRESS "tcp://localhost:1883" // Default: "tcp://test.mosquitto.org:1883" | CHATMQTT_BROKER Overrides
+#define BROKER_DEFAULT_PORT    1883 // Standalone Broker (-DBROKER_MAIN)
+#define BROKER_MAX_CLIENTS     1024 // Connections Served At Once
+#define BROKER_PACKET_MAX      (4 * 1024 * 1024) // Largest Packet Accepted (Bigger Ones Close The Connection)
+#define BROKER_INFLIGHT_MAX    100 // QoS 1/2 Messages Sent To A Client And Not Yet Acknowledged (The Rest Wait)
+#define BROKER_QUEUE_MAX       1000 // QoS 1/2 Messages Waiting For A Client (Offline Persistent Sessions Too, Oldest Dropped)
+#define BROKER_OUTBUF_MAX      (8 * 1024 * 1024) // Unsent Bytes Per Connection Before QoS 0 Messages Are Dropped
+
+/* Embedded Broker */
+// Minimal MQTT 3.1.1 Broker For Hermetic Tests / Benchmarks (Not A Mosquitto Replacement In Production)
+// - QoS 0/1/2 (Both Directions), Retained Messages, "+" / "#" Wildcards, Persistent Sessions (cleansession = 0), Will Messages
+// - One Thread, poll() Over Every Connection | Listens On 127.0.0.1 Only
+// - POSIX Only (brokerStart() Returns NULL On Windows)
+typedef struct Broker Broker;
+
+typedef struct BrokerCounts { // Snapshot Taken By The Broker Thread About Once A Second
+    int connections;
+    int sessions; // Connected + Offline Persistent Ones
+    int sessions_offline;
+    int retained; // Topics With A Retained Message
+    long pending; // QoS 1/2 Messages Queued Or Unacknowledged (Every Session)
+} BrokerCounts;
+
+/* Core Functions */
+const char* brokerAddress(void); // Broker URI The Clients Connect To: CHATMQTT_BROKER Or BROKER_DEFAULT_ADDRESS
+int brokerTopicMatches(const char* filter, const char* topic); // "+" / "#" Wildcards ("A/#" Matches "A", "$" Topics Only Explicitly)
+int brokerFilterValid(const char* filter);
+
+Broker* brokerStart(int port); // 0 = Ephemeral Port | NULL = Failed
+int brokerPort(const Broker* broker);
+const char* brokerUri(const Broker* broker); // "tcp://127.0.0.1:[PORT]" (Set CHATMQTT_BROKER To It Before Creating Clients)
+void brokerStop(Broker* broker);
+void brokerCounts(Broker* broker, BrokerCounts* counts); // Latest Snapshot (Soak Tests: Sessions / Retained Topics Must Not Grow)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BROKER_H
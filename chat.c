@@ -0,0 +1,524 @@
+// Realtime Chat Loop
+// Keyboard Input And Incoming Messages Are Multiplexed With poll(), Incoming Lines Are Printed
+// Above The Line Being Typed As Soon As messageArrived_m() Queues Them (listSetNotify)
+// Commands: ":" Exit | "/conversas" List Conversations | "/trocar [NOME]" Switch Conversation | "/anexo [CAMINHO]" Send A File | "/filas" Queue Counters
+// Consecutive Lines Entered Within CHAT_COALESCE_MS (A Paste) Are Sent As One Publish, Split Again By The Receiver
+// chatWaitReady() Holds A Chat Not Yet Confirmed By The Other User Until The Confirmation Arrives (Enter Gives Up)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "constants.h"
+#include "messages.h"
+#include "conversations.h"
+#include "chat.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <termios.h>
+#include <time.h>
+#else
+#include <windows.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#endif
+
+#if defined(_WRS_KERNEL)
+#include <OsWrapper.h>
+#endif
+
+// Key Codes
+
+#define KEY_CTRL_C    3
+#define KEY_CTRL_D    4
+#define KEY_BACKSPACE 8
+#define KEY_CTRL_U    21
+#define KEY_ESCAPE    27
+#define KEY_DELETE    127
+
+// Helpers
+
+// Publish One Chat Line (Displayed As "[USERNAME]: [MESSAGE]")
+static void chatSend(ConversationManager* manager, Conversation* conversation, const char* message)
+{
+    conversationsSend(manager, conversation, message);
+}
+
+// Handles "/..." Commands, Returns The Conversation Displayed Afterwards
+static Conversation* chatCommand(ConversationManager* manager, Conversation* conversation, const char* line, int notify_fd)
+{
+    if (strcmp(line, "/conversas") == 0)
+    {
+        conversationsPrint(manager);
+    }
+    else if (strncmp(line, "/trocar ", 8) == 0)
+    {
+        Conversation* target = conversationsFind(manager, line + 8);
+        if (!target)
+        {
+            printf("Conversa Não Encontrada!\n");
+        }
+        else if (target != conversation)
+        {
+            listSetNotify(&conversation->messages, -1);
+            listSetNotify(&target->messages, notify_fd);
+            conversationsSetActive(manager, target);
+            printf("\n--- Conversa Com %s: %s ---\n", target->is_group ? "Grupo" : "Usuário", target->name);
+            conversation = target;
+        }
+    }
+    else if (strcmp(line, "/filas") == 0)
+    {
+        conversationsPrintQueues(manager);
+    }
+    else if (strncmp(line, "/anexo ", 7) == 0)
+    {
+        conversationsSendFile(manager, conversation, line + 7);
+    }
+    else
+    {
+        printf("Comandos: \":\" Sair | \"/conversas\" Listar | \"/trocar [NOME]\" Trocar De Conversa | \"/anexo [CAMINHO]\" Enviar Arquivo | \"/filas\" Filas\n");
+    }
+    return conversation;
+}
+
+// Returns 1 If The Line Has Only Whitespaces
+static int chatBlank(const char* line)
+{
+    return strspn(line, " \t\n\r") == strlen(line);
+}
+
+#if !defined(_WIN32)
+
+static struct termios saved_termios; // Terminal State Before The Chat
+static int raw_enabled = 0;
+
+// Character Mode Without Echo, So Incoming Lines Can Be Printed Without Mixing With The Typed Line
+static void terminalRaw(void)
+{
+    struct termios raw;
+    if (tcgetattr(STDIN_FILENO, &saved_termios) != 0)
+        return;
+    raw = saved_termios;
+    raw.c_lflag &= ~(ICANON | ECHO | ISIG);
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0)
+        raw_enabled = 1;
+}
+
+static void terminalRestore(void)
+{
+    if (raw_enabled)
+        tcsetattr(STDIN_FILENO, TCSANOW, &saved_termios);
+    raw_enabled = 0;
+}
+
+// Notification Channel (eventfd On Linux, Pipe Elsewhere) | fds[0] = Read, fds[1] = Write
+static int notifyCreate(int fds[2])
+{
+    #if defined(__linux__)
+        int efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (efd >= 0)
+        {
+            fds[0] = fds[1] = efd;
+            return 0;
+        }
+    #endif
+    if (pipe(fds) != 0)
+        return -1;
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+    return 0;
+}
+
+static void notifyDrain(int fd)
+{
+    char buf[256];
+    while (read(fd, buf, sizeof(buf)) > 0) {}
+}
+
+static void notifyClose(int fds[2])
+{
+    close(fds[0]);
+    if (fds[1] != fds[0])
+        close(fds[1]);
+}
+
+// Redraws The Prompt And The Partially Typed Line
+static void redrawLine(const char* line, size_t len, int interactive)
+{
+    if (!interactive)
+        return;
+    printf("\r\033[K%s%.*s", CHAT_PROMPT, (int)len, line);
+    fflush(stdout);
+}
+
+// Prints Every Queued Message (Oldest First) Above The Line Being Typed
+static void renderIncoming(ConversationManager* manager, Conversation* conversation, const char* line, size_t len, int interactive)
+{
+    MessageView msg;
+    int printed = 0;
+
+    while (conversationsPop(manager, conversation, &msg))
+    {
+        if (!printed && interactive)
+            printf("\r\033[K"); // Clear The Typed Line
+        printf("%.*s\n", msg.length, msg.data);
+        viewRelease(&msg);
+        printed = 1;
+    }
+
+    if (printed)
+    {
+        fflush(stdout);
+        redrawLine(line, len, interactive);
+    }
+}
+
+// Outgoing Lines Waiting For The Coalescing Window To Close
+
+typedef struct
+{
+    char* data; // Lines Joined With '\n'
+    size_t len;
+    int lines;
+    struct timespec deadline;
+} Pending;
+
+// Milliseconds Left Until deadline (Rounded Up, 0 If Expired)
+static int msUntil(const struct timespec* deadline)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long ms = (deadline->tv_sec - now.tv_sec) * 1000 + (deadline->tv_nsec - now.tv_nsec + 999999) / 1000000;
+    return ms > 0 ? (int)ms : 0;
+}
+
+static void pendingFlush(ConversationManager* manager, Conversation* conversation, Pending* pending)
+{
+    if (pending->lines == 0)
+        return;
+    pending->data[pending->len] = '\0';
+    chatSend(manager, conversation, pending->data);
+    pending->len = 0;
+    pending->lines = 0;
+}
+
+static void pendingAdd(ConversationManager* manager, Conversation* conversation, Pending* pending, const char* line)
+{
+    size_t line_len = strlen(line);
+
+    if (CHAT_COALESCE_MS <= 0 || !pending->data || line_len >= CHAT_COALESCE_MAX_BYTES) // Disabled / Too Long: Send Alone
+    {
+        pendingFlush(manager, conversation, pending);
+        chatSend(manager, conversation, line);
+        return;
+    }
+
+    if (pending->lines >= CHAT_COALESCE_MAX_LINES || pending->len + 1 + line_len > CHAT_COALESCE_MAX_BYTES)
+        pendingFlush(manager, conversation, pending);
+
+    if (pending->lines == 0) // Window Opens With The First Line
+    {
+        clock_gettime(CLOCK_MONOTONIC, &pending->deadline);
+        pending->deadline.tv_nsec += (long)CHAT_COALESCE_MS * 1000000L;
+        pending->deadline.tv_sec += pending->deadline.tv_nsec / 1000000000L;
+        pending->deadline.tv_nsec %= 1000000000L;
+    }
+    else
+    {
+        pending->data[pending->len++] = '\n';
+    }
+
+    memcpy(pending->data + pending->len, line, line_len);
+    pending->len += line_len;
+    pending->lines++;
+}
+
+// Main Functions
+
+int chatLoop(ConversationManager* manager, Conversation* conversation, volatile int* chatting)
+{
+    int interactive = isatty(STDIN_FILENO);
+    int notify_fds[2];
+
+    if (notifyCreate(notify_fds) != 0)
+    {
+        if (LOG_ENABLED)
+            printf("               [LOG] CHAT: Failed to create notification channel\n");
+        return EXIT_FAILURE;
+    }
+    conversationsSetActive(manager, conversation);
+    listSetNotify(&conversation->messages, notify_fds[1]);
+
+    if (interactive)
+        terminalRaw();
+
+    char* line = malloc(CHAT_LINE_MAX);
+    size_t len = 0;
+    int escape = 0; // Skipping An Escape Sequence (Arrow Keys...)
+
+    Pending pending = { 0 };
+    pending.data = malloc(CHAT_COALESCE_MAX_BYTES + 1); // NULL Only Disables Coalescing
+
+    if (!line)
+    {
+        listSetNotify(&conversation->messages, -1);
+        conversationsSetActive(manager, NULL);
+        notifyClose(notify_fds);
+        terminalRestore();
+        return EXIT_FAILURE;
+    }
+
+    redrawLine(line, len, interactive);
+    renderIncoming(manager, conversation, line, len, interactive); // Messages Queued Before The Loop Started
+
+    while (*chatting)
+    {
+        struct pollfd fds[2];
+        fds[0].fd = STDIN_FILENO;
+        fds[0].events = POLLIN;
+        fds[1].fd = notify_fds[0];
+        fds[1].events = POLLIN;
+
+        int timeout = pending.lines > 0 ? msUntil(&pending.deadline) : -1;
+
+        if (poll(fds, 2, timeout) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        // Coalescing Window Closed
+
+        if (pending.lines > 0 && msUntil(&pending.deadline) == 0)
+            pendingFlush(manager, conversation, &pending);
+
+        // Incoming Messages
+
+        if (fds[1].revents & POLLIN)
+        {
+            notifyDrain(notify_fds[0]);
+            renderIncoming(manager, conversation, line, len, interactive);
+        }
+
+        // Keyboard
+
+        if (!(fds[0].revents & (POLLIN | POLLHUP | POLLERR)))
+            continue;
+
+        unsigned char input[512];
+        ssize_t n = read(STDIN_FILENO, input, sizeof(input));
+        if (n <= 0)
+        {
+            *chatting = 0; // EOF
+            break;
+        }
+
+        for (ssize_t i = 0; i < n && *chatting; i++)
+        {
+            unsigned char c = input[i];
+
+            if (escape) // ESC [ ... Final Byte (0x40 - 0x7E)
+            {
+                if (escape == 1 && c != '[' && c != 'O')
+                    escape = 0;
+                else if (escape > 1 && c >= 0x40 && c <= 0x7E)
+                    escape = 0;
+                else
+                    escape++;
+                continue;
+            }
+
+            if (c == '\n' || c == '\r')
+            {
+                if (interactive)
+                    printf("\n");
+                line[len] = '\0';
+                len = 0;
+
+                if (strcmp(line, ":") == 0) // EXIT
+                {
+                    *chatting = 0;
+                    break;
+                }
+
+                if (line[0] == '/')
+                {
+                    pendingFlush(manager, conversation, &pending); // Lines Belong To The Current Conversation
+                    conversation = chatCommand(manager, conversation, line, notify_fds[1]);
+                }
+                else if (strcmp(line, ";") != 0 && !chatBlank(line)) // ";" Kept For Compatibility (Messages Already Appear Automatically)
+                {
+                    pendingAdd(manager, conversation, &pending, line);
+                }
+
+                renderIncoming(manager, conversation, "", 0, interactive);
+                redrawLine(line, len, interactive);
+            }
+            else if (c == KEY_DELETE || c == KEY_BACKSPACE)
+            {
+                while (len > 0 && (line[len - 1] & 0xC0) == 0x80) // UTF-8 Continuation Bytes
+                    len--;
+                if (len > 0)
+                    len--;
+                redrawLine(line, len, interactive);
+            }
+            else if (c == KEY_CTRL_U)
+            {
+                len = 0;
+                redrawLine(line, len, interactive);
+            }
+            else if (c == KEY_CTRL_C || (c == KEY_CTRL_D && len == 0))
+            {
+                if (interactive)
+                    printf("\n");
+                *chatting = 0;
+                break;
+            }
+            else if (c == KEY_ESCAPE)
+            {
+                escape = 1;
+            }
+            else if (c >= 32 || c == '\t')
+            {
+                if (len < CHAT_LINE_MAX - 1)
+                {
+                    line[len++] = (char)c;
+                    if (interactive)
+                    {
+                        putchar(c);
+                        fflush(stdout);
+                    }
+                }
+            }
+        }
+    }
+
+    pendingFlush(manager, conversation, &pending);
+    free(pending.data);
+
+    // Restore Terminal & Detach Notifications
+
+    terminalRestore();
+    listSetNotify(&conversation->messages, -1);
+    conversationsSetActive(manager, NULL);
+    notifyClose(notify_fds);
+    free(line);
+
+    return EXIT_SUCCESS;
+}
+
+// Waits For The Other User To Confirm The Chat | 1 = Ready (Open It), 0 = Cancelled
+int chatWaitReady(ConversationManager* manager, Conversation* conversation)
+{
+    int notify_fds[2];
+
+    if (conversationsReady(manager, conversation))
+        return 1;
+
+    if (notifyCreate(notify_fds) != 0)
+    {
+        if (LOG_ENABLED)
+            printf("               [LOG] CHAT: Failed to create notification channel\n");
+        return 0;
+    }
+    conversationsSetReadyNotify(manager, notify_fds[1]);
+
+    int c;
+    while ((c = getchar()) != '\n' && c != EOF) {} // Rest Of The Menu Line (Already Buffered By scanf)
+
+    printf("Aguardando Outro Usuário... A Conversa Abre Assim Que For Confirmada (Enter Para Voltar)\n");
+    fflush(stdout);
+
+    int ready = 0;
+    while (!(ready = conversationsReady(manager, conversation)))
+    {
+        struct pollfd fds[2];
+        fds[0].fd = STDIN_FILENO;
+        fds[0].events = POLLIN;
+        fds[1].fd = notify_fds[0];
+        fds[1].events = POLLIN;
+
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        if (fds[1].revents & POLLIN)
+            notifyDrain(notify_fds[0]);
+
+        if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) // Enter (Or EOF) Gives Up
+        {
+            while ((c = getchar()) != '\n' && c != EOF) {}
+            break;
+        }
+    }
+
+    conversationsSetReadyNotify(manager, -1);
+    notifyClose(notify_fds);
+
+    return ready || conversationsReady(manager, conversation);
+}
+
+#else
+
+// Windows: Line Based Fallback (Messages Appear After Each Sent Line)
+
+int chatLoop(ConversationManager* manager, Conversation* conversation, volatile int* chatting)
+{
+    char* message = malloc(CHAT_LINE_MAX);
+    if (!message)
+        return EXIT_FAILURE;
+
+    conversationsSetActive(manager, conversation);
+
+    while (*chatting)
+    {
+        fflush(stdout);
+        if (fgets(message, CHAT_LINE_MAX, stdin) == NULL)
+            break;
+        message[strcspn(message, "\r\n")] = '\0';
+
+        if (strcmp(message, ":") == 0) // EXIT
+            break;
+
+        if (message[0] == '/')
+            conversation = chatCommand(manager, conversation, message, -1);
+        else if (strcmp(message, ";") != 0 && !chatBlank(message))
+            chatSend(manager, conversation, message);
+
+        MessageView msg;
+        while (conversationsPop(manager, conversation, &msg))
+        {
+            printf("%.*s\n", msg.length, msg.data);
+            viewRelease(&msg);
+        }
+    }
+
+    conversationsSetActive(manager, NULL);
+    *chatting = 0;
+    free(message);
+    return EXIT_SUCCESS;
+}
+
+// Windows: No Keyboard Multiplexing, Waits Up To CHAT_READY_WAIT_MS
+int chatWaitReady(ConversationManager* manager, Conversation* conversation)
+{
+    if (conversationsReady(manager, conversation))
+        return 1;
+
+    printf("Aguardando Outro Usuário... (Até %d Segundos)\n", CHAT_READY_WAIT_MS / 1000);
+    return conversationsWaitReady(manager, conversation, CHAT_READY_WAIT_MS);
+}
+
+#endif
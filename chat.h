@@ -0,0 +1,29 @@
+#ifndef CHAT_H
+#define CHAT_H
+
+#include "messages.h"
+#include "conversations.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Constants */
+#define CHAT_LINE_MAX 16256 // Longest Line Accepted From The Keyboard
+#define CHAT_PROMPT   "> "
+
+#define CHAT_COALESCE_MS        5 // Lines Entered Within This Window Share One Publish (0 = Disabled)
+#define CHAT_COALESCE_MAX_LINES 64 // Lines Per Coalesced Publish
+#define CHAT_COALESCE_MAX_BYTES 8192 // Bytes Per Coalesced Publish (Longer Lines Are Sent Alone)
+
+#define CHAT_READY_WAIT_MS 60000 // Windows Only: Longest Wait For A Chat Confirmation (Elsewhere Enter Cancels)
+
+/* Core Functions */
+int chatLoop(ConversationManager* manager, Conversation* conversation, volatile int* chatting);
+int chatWaitReady(ConversationManager* manager, Conversation* conversation);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CHAT_H
@@ -0,0 +1,196 @@
+// Chunked Transfers
+// Payloads Larger Than CHUNK_SIZE Travel As Several Frames And Are Reassembled In Place On Arrival
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "chunk.h"
+#include "envelope.h"
+
+// Helpers
+
+static void transferDrop(ChunkTransfer* transfer)
+{
+    bufferRelease(transfer->buffer);
+    free(transfer->have);
+    memset(transfer, 0, sizeof(*transfer));
+}
+
+// Parses An Unsigned Number (base 10 / 16) Ending With ';' | Returns The Position After ';' Or NULL
+static const char* parseField(const char* p, const char* end, int base, uint64_t* value)
+{
+    const char* start = p;
+    uint64_t result = 0;
+
+    for (; p < end && *p != ';'; p++)
+    {
+        int digit;
+        if (*p >= '0' && *p <= '9') digit = *p - '0';
+        else if (base == 16 && *p >= 'a' && *p <= 'f') digit = *p - 'a' + 10;
+        else if (base == 16 && *p >= 'A' && *p <= 'F') digit = *p - 'A' + 10;
+        else return NULL;
+        result = result * base + digit;
+    }
+    if (p == start || p == end || p - start > 16)
+        return NULL;
+
+    *value = result;
+    return p + 1;
+}
+
+// Main Functions
+
+uint64_t chunkTransferId(void)
+{
+    static uint32_t counter = 0;
+    uint32_t next = __atomic_add_fetch(&counter, 1, __ATOMIC_RELAXED);
+    return ((uint64_t)envelopeSession() << 32) | next;
+}
+
+int chunkFrames(int len)
+{
+    return len <= CHUNK_SIZE ? 1 : (len + CHUNK_SIZE - 1) / CHUNK_SIZE;
+}
+
+// Frame Header + Data Into out (Raw Bytes, Not Nul-Terminated) | Returns The Frame Length Or -1 If out Is Too Small
+int chunkEncode(char* out, size_t size, uint64_t transfer, uint32_t offset, uint32_t total, const char* data, int len)
+{
+    int header = snprintf(out, size, CHUNK_PREFIX "%llx;%u;%u;", (unsigned long long)transfer, offset, total);
+    if (header < 0 || (size_t)header + len > size)
+        return -1;
+    memcpy(out + header, data, len);
+    return header + len;
+}
+
+int chunkIsFrame(const char* payload, int len)
+{
+    return len >= (int)sizeof(CHUNK_PREFIX) - 1 && memcmp(payload, CHUNK_PREFIX, sizeof(CHUNK_PREFIX) - 1) == 0;
+}
+
+void chunkInit(ChunkAssembler* assembler)
+{
+    memset(assembler, 0, sizeof(*assembler));
+}
+
+void chunkFree(ChunkAssembler* assembler)
+{
+    for (int i = 0; i < CHUNK_IN_FLIGHT; i++)
+        if (assembler->transfers[i].id)
+            transferDrop(&assembler->transfers[i]);
+}
+
+// Splits A Frame Into Its Header Fields And Data | 0 = Not A Well-Formed Frame
+int chunkParse(const char* payload, int len, ChunkFrame* frame)
+{
+    const char* end = payload + len;
+    const char* p = payload + sizeof(CHUNK_PREFIX) - 1;
+
+    if (!chunkIsFrame(payload, len) ||
+        !(p = parseField(p, end, 16, &frame->id)) || !(p = parseField(p, end, 10, &frame->offset)) || !(p = parseField(p, end, 10, &frame->total)))
+        return 0;
+    if (frame->id == 0 || frame->total == 0 || frame->offset >= frame->total || (uint64_t)(end - p) > frame->total - frame->offset)
+        return 0;
+
+    frame->data = p;
+    frame->len = (int)(end - p);
+    return 1;
+}
+
+// Writes One Frame Into Its Transfer | On CHUNK_COMPLETE *complete Holds The Whole Payload (Caller Releases)
+int chunkFeed(ChunkAssembler* assembler, const char* payload, int len, MessageBuffer** complete)
+{
+    ChunkFrame frame;
+    time_t now = time(NULL);
+
+    *complete = NULL;
+
+    if (!chunkParse(payload, len, &frame))
+    {
+        assembler->rejected++;
+        return CHUNK_REJECTED;
+    }
+
+    uint64_t id = frame.id, offset = frame.offset, total = frame.total;
+    uint64_t data_len = (uint64_t)frame.len;
+    uint64_t expected = (total - offset < CHUNK_SIZE) ? total - offset : CHUNK_SIZE;
+    if (total > CHUNK_TRANSFER_MAX || offset % CHUNK_SIZE != 0 || data_len != expected)
+    {
+        assembler->rejected++;
+        return CHUNK_REJECTED;
+    }
+
+    for (int i = 0; i < CHUNK_IN_FLIGHT; i++) // Late Duplicate Of A Completed Transfer
+        if (assembler->done[i] == id)
+            return CHUNK_PENDING;
+
+    // Find The Transfer (Expiring Stale Ones), Or Start It In A Free / The Oldest Slot
+
+    ChunkTransfer* transfer = NULL;
+    ChunkTransfer* slot = NULL;
+    for (int i = 0; i < CHUNK_IN_FLIGHT; i++)
+    {
+        ChunkTransfer* t = &assembler->transfers[i];
+        if (t->id && difftime(now, t->updated) > CHUNK_TIMEOUT_S)
+        {
+            transferDrop(t);
+            assembler->expired++;
+        }
+        if (t->id == id)
+            transfer = t;
+        else if (!slot || (slot->id && (!t->id || t->updated < slot->updated)))
+            slot = t;
+    }
+
+    if (!transfer)
+    {
+        if (slot->id)
+        {
+            transferDrop(slot);
+            assembler->expired++;
+        }
+
+        MessageBuffer* buffer = bufferAlloc((int)total);
+        unsigned char* have = calloc((chunkFrames((int)total) + 7) / 8, 1);
+        if (!buffer || !have)
+        {
+            bufferRelease(buffer);
+            free(have);
+            assembler->rejected++;
+            return CHUNK_REJECTED;
+        }
+
+        slot->id = id;
+        slot->buffer = buffer;
+        slot->total = (uint32_t)total;
+        slot->received = 0;
+        slot->have = have;
+        transfer = slot;
+    }
+    else if (transfer->total != total)
+    {
+        assembler->rejected++;
+        return CHUNK_REJECTED;
+    }
+
+    // Write The Frame In Place (Repeated Frames Are Ignored)
+
+    uint32_t index = (uint32_t)(offset / CHUNK_SIZE);
+    transfer->updated = now;
+    if (!(transfer->have[index / 8] & (1u << (index % 8))))
+    {
+        transfer->have[index / 8] |= (unsigned char)(1u << (index % 8));
+        memcpy(transfer->buffer->data + offset, frame.data, (size_t)data_len);
+        transfer->received += (uint32_t)data_len;
+    }
+
+    if (transfer->received < transfer->total)
+        return CHUNK_PENDING;
+
+    *complete = transfer->buffer;
+    transfer->buffer = NULL; // Handed Over
+    transferDrop(transfer);
+    assembler->done[assembler->done_next] = id;
+    assembler->done_next = (assembler->done_next + 1) % CHUNK_IN_FLIGHT;
+    assembler->completed++;
+    return CHUNK_COMPLETE;
+}
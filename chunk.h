@@ -0,0 +1,73 @@
+#ifndef CHUNK_H
+#define CHUNK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include "messages.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Constants */
+#define CHUNK_PREFIX       "#C1;" // Chunk Frame Version 1
+#define CHUNK_SIZE         1024 // Data Bytes Per Frame (Payloads Up To This Size Are Sent Whole)
+#define CHUNK_TRANSFER_MAX (256 * 1024) // Largest Payload Reassembled (Memory Cap Per In-Flight Transfer)
+#define CHUNK_IN_FLIGHT    8 // Transfers Reassembled At Once Per Conversation (Oldest Dropped When Full)
+#define CHUNK_TIMEOUT_S    60 // Transfers Without Progress For This Long Are Dropped
+#define CHUNK_HEADER_MAX   64 // Room For The Frame Header
+
+/* Chunk Frame */
+// "#C1;[TRANSFER];[OFFSET];[TOTAL];[DATA]"
+// [TRANSFER] > Hex Id (Sender Session << 32 | Counter), Unique Per Sender
+// [OFFSET]   > Position Of [DATA] In The Whole Payload (Multiple Of CHUNK_SIZE)
+// [TOTAL]    > Size Of The Whole Payload | Frames May Arrive In Any Order Or Twice (QoS 1)
+
+typedef struct ChunkFrame {
+    uint64_t id;
+    uint64_t offset;
+    uint64_t total;
+    const char* data; // Points Into The Frame
+    int len;
+} ChunkFrame;
+
+typedef struct ChunkTransfer {
+    uint64_t id; // 0 = Free Slot
+    MessageBuffer* buffer; // Streaming Buffer (total Bytes, Handed Over Whole When Complete)
+    uint32_t total;
+    uint32_t received; // Bytes Written (Each Frame Counted Once)
+    unsigned char* have; // One Bit Per Frame
+    time_t updated;
+} ChunkTransfer;
+
+typedef struct ChunkAssembler {
+    ChunkTransfer transfers[CHUNK_IN_FLIGHT];
+    uint64_t done[CHUNK_IN_FLIGHT]; // Recently Completed Transfers (Late Duplicate Frames Are Ignored)
+    int done_next;
+    unsigned long completed;
+    unsigned long rejected; // Malformed / Over The Memory Cap
+    unsigned long expired; // Timed Out Or Evicted Before Completion
+} ChunkAssembler;
+
+/* Feed Results */
+#define CHUNK_REJECTED  -1
+#define CHUNK_PENDING    0
+#define CHUNK_COMPLETE   1
+
+/* Core Functions */
+uint64_t chunkTransferId(void);
+int chunkFrames(int len);
+int chunkEncode(char* out, size_t size, uint64_t transfer, uint32_t offset, uint32_t total, const char* data, int len);
+int chunkIsFrame(const char* payload, int len);
+int chunkParse(const char* payload, int len, ChunkFrame* frame);
+
+void chunkInit(ChunkAssembler* assembler);
+void chunkFree(ChunkAssembler* assembler);
+int chunkFeed(ChunkAssembler* assembler, const char* payload, int len, MessageBuffer** complete);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CHUNK_H
@@ -0,0 +1,749 @@
+// Compilation Command: "gcc cleaner.c events.c broker.c transport.c stats.c trace.c memory.c -o cleaner -lpaho-mqtt3as -pthread"
+// Excecution Command: "./cleaner [-x] [-b BATCH] [-r RATE] [-w WAIT_MS] [-a DAYS]"
+//
+// Retained Topic Garbage Collector / Broker State Audit
+// - Walks The ChatMQTT Namespace (USERS/, GROUPS/, CHATS/, [USER]_Control/...) Over One Connection
+// - Reports Retained Entries & Bytes Per Topic Family
+// - Clears Unreachable Retained Entries In Batches (Only With "-x", Default Is Report Only)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <stdint.h>
+#include "MQTTAsync.h"
+#include "transport.h"
+#include "constants.h"
+#include "events.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
+
+#if defined(_WRS_KERNEL)
+#include <OsWrapper.h>
+#endif
+
+// Parameters
+
+#define CLEANER_CLIENT_ID "ChatMQTT_Cleaner"
+#define DEFAULT_BATCH 100 // Entries Cleared Per Batch
+#define DEFAULT_RATE 500 // Entries Cleared Per Second
+#define DEFAULT_WAIT_MS 2000 // Quiet Period That Ends The Retained Snapshot
+#define DEFAULT_MAX_AGE_DAYS 30 // WAITING_USER Older Than This Is Considered Abandoned
+
+// Topic Families
+
+enum
+{
+    FAMILY_USERS,
+    FAMILY_GROUPS,
+    FAMILY_CHATS,
+    FAMILY_REQUESTS,
+    FAMILY_HISTORY,
+    FAMILY_OTHER,
+    FAMILY_COUNT
+};
+
+static const char* family_names[FAMILY_COUNT] = { "USERS/", "GROUPS/", "CHATS/", "[USER]_Control/REQUESTS/", "[USER]_Control/HISTORY/", "(outros)" };
+
+static const char* walk_topics[] = { "USERS/+", "GROUPS/+", "CHATS/+", "+/REQUESTS/+", "+/HISTORY/+" };
+static const int walk_qos[] = { QOS, QOS, QOS, QOS, QOS };
+#define WALK_TOPICS_COUNT ((int)(sizeof(walk_topics) / sizeof(walk_topics[0])))
+
+// Retained Entry
+
+typedef struct
+{
+    char* topic;
+    char* payload; // Nul-Terminated Copy
+    int payloadlen;
+    int family;
+    const char* reason; // Why It Is Unreachable (NULL = Reachable)
+    const char* note; // Worth A Look But Still Reachable: Reported, Never Cleared
+} Entry;
+
+// Context
+
+typedef struct
+{
+    MQTTAsync client;
+    Entry* entries;
+    int count;
+    int capacity;
+    time_t last_arrival;
+    pthread_mutex_t lock;
+} Context_c;
+
+// Flags
+
+volatile int connected_c = 0; // Connection Successful
+volatile int subscribed_c = 0; // Subscription Successful
+volatile int finished_c = 0; // Program Finished (Failure)
+volatile int disc_finished_c = 0; // Disconnection Finished
+volatile int acked_c = 0; // Clear Messages Acknowledged
+volatile int failed_c = 0; // Clear Messages Failed
+volatile int snapshot_c = 0; // Retained Snapshot Closed (Later Messages Are Ignored)
+
+// Function Prototypes
+
+void onConnect_c(void* context_, MQTTAsync_successData* response);
+void onConnectFailure_c(void* context_, MQTTAsync_failureData* response);
+void connectionLost_c(void *context_, char *cause);
+int messageArrived_c(void *context_, char *topicName, int topicLen, MQTTAsync_message *message);
+void onSubscribe_c(void* context_, MQTTAsync_successData* response);
+void onSubscribeFailure_c(void* context_, MQTTAsync_failureData* response);
+void onSend_c(void* context_, MQTTAsync_successData* response);
+void onSendFailure_c(void* context_, MQTTAsync_failureData* response);
+void onDisconnect_c(void* context_, MQTTAsync_successData* response);
+void onDisconnectFailure_c(void* context_, MQTTAsync_failureData* response);
+
+// Helpers
+
+static void sleepMs(int ms)
+{
+    #if defined(_WIN32)
+        Sleep(ms);
+    #else
+        usleep((useconds_t)ms * 1000);
+    #endif
+}
+
+static int topicFamily(const char* topic)
+{
+    if (strncmp(topic, "USERS/", 6) == 0) return FAMILY_USERS;
+    if (strncmp(topic, "GROUPS/", 7) == 0) return FAMILY_GROUPS;
+    if (strncmp(topic, "CHATS/", 6) == 0) return FAMILY_CHATS;
+
+    const char* slash = strchr(topic, '/');
+    if (slash && slash - topic > 8 && strncmp(slash - 8, "_Control", 8) == 0)
+    {
+        if (strncmp(slash, "/REQUESTS/", 10) == 0) return FAMILY_REQUESTS;
+        if (strncmp(slash, "/HISTORY/", 9) == 0) return FAMILY_HISTORY;
+    }
+    return FAMILY_OTHER;
+}
+
+// Returns The Owner Of A Control Topic ("[USER]_Control/...") Into owner
+static void topicOwner(const char* topic, char* owner, size_t size)
+{
+    const char* slash = strchr(topic, '/');
+    size_t len = slash ? (size_t)(slash - topic) : strlen(topic);
+    if (len >= 8) len -= 8; // "_Control"
+    if (len >= size) len = size - 1;
+    memcpy(owner, topic, len);
+    owner[len] = '\0';
+}
+
+// Parses The "|%Y-%m-%dT%H-%M-%S" Suffix Of A Conversation Link
+static time_t linkTimestamp(const char* link)
+{
+    const char* bar = strrchr(link, '|');
+    struct tm t;
+    memset(&t, 0, sizeof(t));
+    if (!bar || sscanf(bar + 1, "%d-%d-%dT%d-%d-%d", &t.tm_year, &t.tm_mon, &t.tm_mday, &t.tm_hour, &t.tm_min, &t.tm_sec) != 6)
+        return 0;
+    t.tm_year -= 1900;
+    t.tm_mon -= 1;
+    t.tm_isdst = -1;
+    return mktime(&t);
+}
+
+// Callbacks
+
+void connectionLost_c(void *context_, char *cause) // Connection Lost
+{
+    printf("CLEANER: Conexão Perdida%s%s\n", cause ? ": " : "", cause ? cause : "");
+    finished_c = 1;
+}
+
+int messageArrived_c(void *context_, char *topicName, int topicLen, MQTTAsync_message *message) // Message Arrived
+{
+    Context_c* context = (Context_c*)context_;
+
+    // Only Retained Entries Are Part Of The Broker State
+
+    if (message->retained && message->payloadlen > 0 && !snapshot_c)
+    {
+        pthread_mutex_lock(&context->lock);
+
+        if (!snapshot_c && context->count == context->capacity) // Snapshot May Close While Waiting For The Lock
+        {
+            int capacity = context->capacity ? context->capacity * 2 : 1024;
+            Entry* entries = realloc(context->entries, capacity * sizeof(Entry));
+            if (entries)
+            {
+                context->entries = entries;
+                context->capacity = capacity;
+            }
+        }
+
+        if (!snapshot_c && context->count < context->capacity)
+        {
+            Entry* entry = &context->entries[context->count];
+            entry->topic = strdup(topicName);
+            entry->payload = malloc(message->payloadlen + 1);
+            if (entry->topic && entry->payload)
+            {
+                memcpy(entry->payload, message->payload, message->payloadlen);
+                entry->payload[message->payloadlen] = '\0';
+                entry->payloadlen = message->payloadlen;
+                entry->family = topicFamily(topicName);
+                entry->reason = NULL;
+                entry->note = NULL;
+                context->count++;
+            }
+            else
+            {
+                free(entry->topic);
+                free(entry->payload);
+            }
+        }
+
+        context->last_arrival = time(NULL);
+
+        pthread_mutex_unlock(&context->lock);
+    }
+
+    if (LOG_ENABLED)
+        printf("               [LOG] CLEANER: Message arrived on %s (%d bytes, retained %d)\n", topicName, message->payloadlen, message->retained);
+
+    // Memory Management
+    transportFreeMessage(&message);
+
+    return 1;
+}
+
+void onSubscribe_c(void* context_, MQTTAsync_successData* response) // Subscribed Successfuly
+{
+    Context_c* context = (Context_c*)context_;
+    if (LOG_ENABLED)
+        printf("               [LOG] CLEANER: Subscribe succeeded\n");
+    pthread_mutex_lock(&context->lock);
+    context->last_arrival = time(NULL);
+    pthread_mutex_unlock(&context->lock);
+    subscribed_c = 1;
+}
+
+void onSubscribeFailure_c(void* context_, MQTTAsync_failureData* response) // Fails To Subscribe
+{
+    printf("CLEANER: Falha Ao Assinar Os Tópicos, rc %d\n", response ? response->code : 0);
+    finished_c = 1;
+}
+
+void onSend_c(void* context_, MQTTAsync_successData* response) // Clear Message Acknowledged
+{
+    __sync_fetch_and_add(&acked_c, 1);
+}
+
+void onSendFailure_c(void* context_, MQTTAsync_failureData* response) // Clear Message Failed
+{
+    if (LOG_ENABLED)
+        printf("               [LOG] CLEANER: Clear failed token %d error code %d\n", response->token, response->code);
+    __sync_fetch_and_add(&failed_c, 1);
+}
+
+void onConnectFailure_c(void* context_, MQTTAsync_failureData* response) // Fails To Connect
+{
+    printf("CLEANER: Falha Ao Conectar, rc %d\n", response ? response->code : 0);
+    finished_c = 1;
+}
+
+void onConnect_c(void* context_, MQTTAsync_successData* response) // Connected Successfuly
+{
+    Context_c* context = (Context_c*)context_;
+    MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer; // Response Options (... = [Default Initializer Macro])
+    int rc;
+
+    if (LOG_ENABLED)
+        printf("               [LOG] CLEANER: Successful connection\n");
+
+    connected_c = 1;
+
+    // Subscription Parameters
+    opts.onSuccess = onSubscribe_c;
+    opts.onFailure = onSubscribeFailure_c;
+    opts.context = context;
+
+    // Subscribe To Every Topic Family At Once
+    if ((rc = transportSubscribeMany(context->client, WALK_TOPICS_COUNT, (char* const*)walk_topics, walk_qos, &opts)) != MQTTASYNC_SUCCESS)
+    {
+        printf("CLEANER: Falha Ao Iniciar Assinatura, rc %d\n", rc);
+        finished_c = 1;
+    }
+}
+
+void onDisconnectFailure_c(void* context_, MQTTAsync_failureData* response) // Fails To Disconnect
+{
+    disc_finished_c = 1;
+}
+
+void onDisconnect_c(void* context_, MQTTAsync_successData* response) // Disconnected Successfuly
+{
+    disc_finished_c = 1;
+}
+
+// Name Sets (Open Addressing, FNV-1a, Sized Once For The Snapshot)
+// Filled In One Pass Over The Entries, So Classifying Each Entry Is A Lookup Instead Of Another Scan
+
+typedef struct
+{
+    char** slots; // Own Copies, Nul-Terminated
+    size_t mask;
+} NameSet;
+
+static int setInit(NameSet* set, int expected)
+{
+    size_t capacity = 16;
+    while (capacity < (size_t)expected * 2)
+        capacity <<= 1;
+    set->slots = calloc(capacity, sizeof(char*));
+    set->mask = capacity - 1;
+    return set->slots != NULL;
+}
+
+static void setFree(NameSet* set)
+{
+    if (!set->slots)
+        return;
+    for (size_t i = 0; i <= set->mask; i++)
+        free(set->slots[i]);
+    free(set->slots);
+    set->slots = NULL;
+}
+
+static size_t setSlot(const NameSet* set, const char* key, size_t len)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; i++)
+        hash = (hash ^ (unsigned char)key[i]) * 1099511628211ULL;
+
+    size_t slot = (size_t)hash & set->mask;
+    while (set->slots[slot] && (strncmp(set->slots[slot], key, len) != 0 || set->slots[slot][len] != '\0'))
+        slot = (slot + 1) & set->mask;
+    return slot;
+}
+
+static int setAdd(NameSet* set, const char* key, size_t len) // 0 = Out Of Memory
+{
+    size_t slot = setSlot(set, key, len);
+    if (set->slots[slot])
+        return 1;
+    if (!(set->slots[slot] = malloc(len + 1)))
+        return 0;
+    memcpy(set->slots[slot], key, len);
+    set->slots[slot][len] = '\0';
+    return 1;
+}
+
+static int setHas(const NameSet* set, const char* key)
+{
+    return set->slots[setSlot(set, key, strlen(key))] != NULL;
+}
+
+// Analysis
+
+typedef struct
+{
+    NameSet topics; // Every Retained Topic
+    NameSet owners; // Users Owning A REQUESTS / HISTORY Entry
+    NameSet created; // "[LEADER]\n[GROUP]" Of Every GROUP_CREATED In The Leader's Own History
+    NameSet links; // Chat Links Named By Any HISTORY Event
+} Index_c;
+
+static void indexFree(Index_c* index)
+{
+    setFree(&index->topics);
+    setFree(&index->owners);
+    setFree(&index->created);
+    setFree(&index->links);
+}
+
+static int indexBuild(Index_c* index, const Context_c* context)
+{
+    char owner[1024];
+    char key[2048];
+
+    memset(index, 0, sizeof(*index));
+    if (!setInit(&index->topics, context->count) || !setInit(&index->owners, context->count) ||
+        !setInit(&index->created, context->count) || !setInit(&index->links, context->count))
+        return 0;
+
+    for (int i = 0; i < context->count; i++)
+    {
+        const Entry* entry = &context->entries[i];
+        if (!setAdd(&index->topics, entry->topic, strlen(entry->topic)))
+            return 0;
+        if (entry->family != FAMILY_HISTORY && entry->family != FAMILY_REQUESTS)
+            continue;
+
+        topicOwner(entry->topic, owner, sizeof(owner));
+        if (!setAdd(&index->owners, owner, strlen(owner)))
+            return 0;
+
+        Event event;
+        if (entry->family != FAMILY_HISTORY || !eventDecode(entry->payload, entry->payloadlen, &event))
+            continue;
+
+        // GROUP_CREATED / USER_ACCEPTED / USER_REQUEST_ACCEPTED / GROUP_REQUEST_ACCEPTED (Link Field From events.h)
+        int link = event_schema[event.type].chat_link;
+        if (link >= 0 && link < event.field_count && !setAdd(&index->links, event.fields[link].ptr, (size_t)event.fields[link].len))
+            return 0;
+
+        if (event.type == EVENT_GROUP_CREATED)
+        {
+            int len = snprintf(key, sizeof(key), "%s\n%.*s", owner, event.fields[0].len, event.fields[0].ptr);
+            if (len > 0 && len < (int)sizeof(key) && !setAdd(&index->created, key, (size_t)len))
+                return 0;
+        }
+    }
+    return 1;
+}
+
+// Marks Every Retained Entry That No Longer Can Be Reached By A Client | 0 = Out Of Memory (Nothing Marked)
+static int analyze(Context_c* context, int max_age_days)
+{
+    time_t now = time(NULL);
+    char field[1024];
+    char topic[2048];
+
+    Index_c index;
+    if (!indexBuild(&index, context))
+    {
+        indexFree(&index);
+        return 0;
+    }
+
+    for (int i = 0; i < context->count; i++)
+    {
+        Entry* entry = &context->entries[i];
+
+        switch (entry->family)
+        {
+            case FAMILY_USERS: // USERS/[USER] > [USER]:[STATUS]
+            {
+                const char* user = entry->topic + 6;
+                size_t len = strlen(user);
+                if (strncmp(entry->payload, user, len) != 0 || entry->payload[len] != ':')
+                {
+                    entry->reason = "presença malformada";
+                    break;
+                }
+
+                // Offline User That Never Left Any Control State Behind: Still Listed By getUsers() And Reachable
+                // (Retained Presence Carries No Timestamp, So Idle Accounts Cannot Be Told From Abandoned Ones)
+                if (strcmp(entry->payload + len + 1, "Offline") == 0 && !setHas(&index.owners, user))
+                    entry->note = "usuário offline sem histórico (não é limpo)";
+                break;
+            }
+
+            case FAMILY_GROUPS: // GROUPS/[GROUP] > [GROUP]:[LEADER]:[MEMBERS]
+            {
+                const char* group = entry->topic + 7;
+                const char* colon = strchr(entry->payload, ':');
+                size_t leader_len = colon ? strcspn(colon + 1, ":") : 0;
+                if (!colon || leader_len == 0 || leader_len >= sizeof(field))
+                {
+                    entry->reason = "grupo malformado";
+                    break;
+                }
+                memcpy(field, colon + 1, leader_len);
+                field[leader_len] = '\0';
+
+                // The Leader Must Still Own The Group Creation Event (Or At Least Still Exist)
+                snprintf(topic, sizeof(topic), "%s\n%s", field, group);
+                int found = setHas(&index.created, topic);
+                snprintf(topic, sizeof(topic), "USERS/%s", field);
+                if (!found && !setHas(&index.topics, topic))
+                    entry->reason = "grupo órfão (líder inexistente)";
+                break;
+            }
+
+            case FAMILY_CHATS: // CHATS/[LINK] > WAITING_USER
+            {
+                const char* link = entry->topic + 6;
+                if (!setHas(&index.links, link))
+                {
+                    entry->reason = "conversa sem referência no histórico";
+                }
+                else if (strcmp(entry->payload, "WAITING_USER") == 0 && max_age_days > 0)
+                {
+                    time_t created = linkTimestamp(link);
+                    if (created > 0 && difftime(now, created) > (double)max_age_days * 86400.0)
+                        entry->reason = "WAITING_USER abandonado";
+                }
+                break;
+            }
+
+            case FAMILY_REQUESTS: // [USER]_Control/REQUESTS/[BODY]
+            {
+                // Group Requests For Groups That No Longer Exist
+                Event event;
+                if (eventDecode(entry->payload, entry->payloadlen, &event) && event.type == EVENT_GROUP_REQUEST && eventField(&event, 0, field, sizeof(field)))
+                {
+                    snprintf(topic, sizeof(topic), "GROUPS/%s", field);
+                    if (!setHas(&index.topics, topic))
+                        entry->reason = "solicitação para grupo inexistente";
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+
+    indexFree(&index);
+    return 1;
+}
+
+// Clears Marked Entries By Publishing Empty Retained Payloads, "batch" At A Time, At Most "rate" Per Second
+static int clearUnreachable(Context_c* context, int batch, int rate)
+{
+    MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer; // Response Options (... = [Default Initializer Macro])
+    opts.onSuccess = onSend_c;
+    opts.onFailure = onSendFailure_c;
+    opts.context = context;
+
+    int sent = 0;
+    int i = 0;
+
+    while (i < context->count && !finished_c)
+    {
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        int in_batch = 0;
+        for (; i < context->count && in_batch < batch; i++)
+        {
+            Entry* entry = &context->entries[i];
+            if (!entry->reason)
+                continue;
+
+            MQTTAsync_message pubmsg = MQTTAsync_message_initializer; // Message Object (... = [Default Initializer Macro])
+            pubmsg.payload = "";
+            pubmsg.payloadlen = 0;
+            pubmsg.qos = QOS;
+            pubmsg.retained = 1; // Empty Retained Payload Removes The Entry
+
+            int rc;
+            if ((rc = transportSendMessage(context->client, entry->topic, &pubmsg, &opts)) != MQTTASYNC_SUCCESS)
+            {
+                printf("CLEANER: Falha Ao Limpar %s, rc %d\n", entry->topic, rc);
+                continue;
+            }
+            in_batch++;
+        }
+        sent += in_batch;
+
+        // Wait For The Batch Acknowledgements Before Sending The Next One
+        while (acked_c + failed_c < sent && !finished_c)
+            sleepMs(10);
+
+        // Rate Limit
+        if (rate > 0 && in_batch > 0)
+        {
+            struct timespec end;
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            long elapsed_ms = (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+            long budget_ms = (long)in_batch * 1000 / rate;
+            if (budget_ms > elapsed_ms)
+                sleepMs((int)(budget_ms - elapsed_ms));
+        }
+
+        if (in_batch > 0)
+            printf("Lote Enviado: %d Entradas (%d Confirmadas, %d Falhas)\n", in_batch, acked_c, failed_c);
+    }
+
+    return sent;
+}
+
+static void printReport(const Context_c* context, int executed)
+{
+    long counts[FAMILY_COUNT] = { 0 };
+    long bytes[FAMILY_COUNT] = { 0 };
+    long stale_counts[FAMILY_COUNT] = { 0 };
+    long stale_bytes[FAMILY_COUNT] = { 0 };
+
+    for (int i = 0; i < context->count; i++)
+    {
+        const Entry* entry = &context->entries[i];
+        long size = (long)strlen(entry->topic) + entry->payloadlen;
+        counts[entry->family]++;
+        bytes[entry->family] += size;
+        if (entry->reason)
+        {
+            stale_counts[entry->family]++;
+            stale_bytes[entry->family] += size;
+            if (LOG_ENABLED || !executed)
+                printf("  %-40s | %s\n", entry->topic, entry->reason);
+        }
+        else if (entry->note && (LOG_ENABLED || !executed))
+        {
+            printf("  %-40s | %s\n", entry->topic, entry->note);
+        }
+    }
+
+    printf("\n%-26s %10s %12s %12s %12s\n", "Família", "Entradas", "Bytes", "Inalcanç.", "Bytes Inalc.");
+    for (int f = 0; f < FAMILY_COUNT; f++)
+        printf("%-25s %10ld %12ld %12ld %12ld\n", family_names[f], counts[f], bytes[f], stale_counts[f], stale_bytes[f]);
+    printf("\n");
+}
+
+// Main Function
+
+int main(int argc, char* argv[])
+{
+    int execute = 0; // 0 = Report Only, 1 = Clear Unreachable Entries
+    int batch = DEFAULT_BATCH;
+    int rate = DEFAULT_RATE;
+    int wait_ms = DEFAULT_WAIT_MS;
+    int max_age_days = DEFAULT_MAX_AGE_DAYS;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "xb:r:w:a:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'x': execute = 1; break;
+            case 'b': batch = atoi(optarg); break;
+            case 'r': rate = atoi(optarg); break;
+            case 'w': wait_ms = atoi(optarg); break;
+            case 'a': max_age_days = atoi(optarg); break;
+            default:
+                printf("Uso: %s [-x] [-b LOTE] [-r TAXA/s] [-w ESPERA_MS] [-a DIAS]\n"
+                       "  -x  Limpa As Entradas Inalcançáveis (Padrão: Apenas Relatório)\n"
+                       "  -b  Entradas Por Lote (Padrão: %d)\n"
+                       "  -r  Máximo De Entradas Limpas Por Segundo, 0 = Sem Limite (Padrão: %d)\n"
+                       "  -w  Tempo Sem Mensagens Que Encerra A Leitura, Em ms (Padrão: %d)\n"
+                       "  -a  Idade Máxima De Um WAITING_USER Em Dias, 0 = Nunca Expira (Padrão: %d)\n",
+                       argv[0], DEFAULT_BATCH, DEFAULT_RATE, DEFAULT_WAIT_MS, DEFAULT_MAX_AGE_DAYS);
+                return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (batch <= 0) batch = DEFAULT_BATCH;
+    if (wait_ms <= 0) wait_ms = DEFAULT_WAIT_MS;
+
+    MQTTAsync client; // Client (Handler) | Connection To Broker
+    MQTTAsync_connectOptions conn_opts = MQTTAsync_connectOptions_initializer; // Connection Options (... = [Default Initializer Macro])
+    MQTTAsync_disconnectOptions disc_opts = MQTTAsync_disconnectOptions_initializer; // Disconnection Options (... = [Default Initializer Macro])
+    int rc;
+
+    // Create Client
+
+    if ((rc = transportCreate(&client, ADDRESS, CLEANER_CLIENT_ID, MQTTCLIENT_PERSISTENCE_NONE, NULL)) != MQTTASYNC_SUCCESS)
+    {
+        printf("CLEANER: Falha Ao Criar Cliente, rc %d\n", rc);
+        return EXIT_FAILURE;
+    }
+
+    // Create Context
+
+    Context_c* context = calloc(1, sizeof(Context_c));
+    if (!context)
+    {
+        transportDestroy(&client);
+        return EXIT_FAILURE;
+    }
+    context->client = client;
+    pthread_mutex_init(&context->lock, NULL);
+
+    // Set Callbacks
+
+    if ((rc = transportSetCallbacks(client, context, connectionLost_c, messageArrived_c, NULL)) != MQTTASYNC_SUCCESS)
+    {
+        printf("CLEANER: Falha Ao Definir Callbacks, rc %d\n", rc);
+        transportDestroy(&client);
+        free(context);
+        return EXIT_FAILURE;
+    }
+
+    // Connection Parameters
+
+    conn_opts.keepAliveInterval = 30;
+    conn_opts.cleansession = 1; // No Session Left Behind
+    conn_opts.onSuccess = onConnect_c;
+    conn_opts.onFailure = onConnectFailure_c;
+    conn_opts.context = context;
+
+    // Connect To Broker
+
+    if ((rc = transportConnect(client, &conn_opts)) != MQTTASYNC_SUCCESS)
+    {
+        printf("CLEANER: Falha Ao Iniciar Conexão, rc %d\n", rc);
+        transportDestroy(&client);
+        free(context);
+        return EXIT_FAILURE;
+    }
+
+    // Wait For Subscription
+
+    while (!subscribed_c && !finished_c)
+        sleepMs(DELAY_100_MS_MS);
+
+    // Wait Until The Retained Snapshot Goes Quiet
+
+    printf("\nLendo Estado Do Broker...\n");
+    while (!finished_c)
+    {
+        pthread_mutex_lock(&context->lock);
+        double quiet_ms = difftime(time(NULL), context->last_arrival) * 1000.0;
+        pthread_mutex_unlock(&context->lock);
+        if (quiet_ms >= wait_ms)
+            break;
+        sleepMs(DELAY_100_MS_MS);
+    }
+
+    // Close The Snapshot (Our Own Clear Messages Are Delivered Back And Must Be Ignored)
+
+    pthread_mutex_lock(&context->lock);
+    snapshot_c = 1;
+    pthread_mutex_unlock(&context->lock);
+
+    if (!analyze(context, max_age_days))
+    {
+        printf("CLEANER: Memória Insuficiente Para Analisar %d Entradas (Nada Será Limpo)\n", context->count);
+        execute = 0;
+    }
+    printReport(context, 0);
+
+    if (execute && !finished_c)
+    {
+        int cleared = clearUnreachable(context, batch, rate);
+        printf("\nEntradas Limpas: %d (Falhas: %d)\n", acked_c, failed_c);
+        if (cleared == 0)
+            printf("Nada Para Limpar.\n");
+    }
+    else if (!execute)
+    {
+        printf("Apenas Relatório. Use \"-x\" Para Limpar As Entradas Inalcançáveis.\n");
+    }
+
+    // Disconnect
+
+    if (connected_c && !finished_c)
+    {
+        disc_opts.onSuccess = onDisconnect_c;
+        disc_opts.onFailure = onDisconnectFailure_c;
+        if (transportDisconnect(client, &disc_opts) == MQTTASYNC_SUCCESS)
+            while (!disc_finished_c)
+                sleepMs(DELAY_100_MS_MS);
+    }
+
+    // Memory Management
+
+    for (int i = 0; i < context->count; i++)
+    {
+        free(context->entries[i].topic);
+        free(context->entries[i].payload);
+    }
+    free(context->entries);
+    pthread_mutex_destroy(&context->lock);
+    free(context);
+    transportDestroy(&client);
+
+    return finished_c ? EXIT_FAILURE : EXIT_SUCCESS;
+}
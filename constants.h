@@ -1,6 +1,9 @@
+#include "broker.h"
+
 // MQTT Parameters
-#define ADDRESS     "tcp://localhost:1883" // Default: "tcp://test.mosquitto.org:1883"
+#define ADDRESS     brokerAddress() // CHATMQTT_BROKER=[URI] Or BROKER_DEFAULT_ADDRESS (broker.h)
 #define QOS 2
+#define QOS_CHAT 1 // Chat Lines (Duplicates Filtered By The Envelope Sequence Numbers)
 
 // Parameters
 #define MAX_GROUP_MEMBERS 50
@@ -24,7 +27,7 @@
 //               /REQUESTS/ > Conversation Requests ([REQUEST_TYPE]/[REQUEST_BODY])
 //               /HISTORY/  > Events History        ([EVENT_TYPE]/[EVENT_BODY])
 
-// Possible Request Type Received By Topic
+// Possible Request Type Received By Topic (Encoded / Decoded Through The EVENT_TYPES Schema In events.h)
 // --- X_Control/ ---
 // USER_REQUEST:[USERNAME]                               | [USERNAME]  > Your User
 // GROUP_REQUEST:[GROUPNAME];[USERNAME]                  | [GROUPNAME] > My Group       / [USERNAME] > Your User
@@ -0,0 +1,860 @@
+// Conversation Manager
+// Every Conversation Topic (CHATS/[LINK]) Is Subscribed On One Shared Connection, Incoming Messages Are
+// Routed To A Bounded Queue Per Conversation And Counted As Unread Until The Conversation Is Displayed
+// The Same Subscription Tracks Readiness: A Retained "WAITING_USER" Marks The Chat As Waiting, The Empty Publish
+// (Or Any Message) The Other User Sends When Confirming Clears It And Wakes Whoever Waits (conversationsWaitReady)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "MQTTAsync.h"
+#include "transport.h"
+#include "constants.h"
+#include "messages.h"
+#include "envelope.h"
+#include "events.h"
+#include "chunk.h"
+#include "attachment.h"
+#include "stats.h"
+#include "trace.h"
+#include "conversations.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
+
+#if defined(_WRS_KERNEL)
+#include <OsWrapper.h>
+#endif
+
+// Function Prototypes
+
+void onConnect_m(void* context_, MQTTAsync_successData* response);
+void onConnectFailure_m(void* context_, MQTTAsync_failureData* response);
+void connectionLost_m(void *context_, char *cause);
+int messageArrived_m(void *context_, char *topicName, int topicLen, MQTTAsync_message *message);
+void onSubscribeFailure_m(void* context_, MQTTAsync_failureData* response);
+void onDisconnect_m(void* context_, MQTTAsync_successData* response);
+
+// Helpers
+
+static int isWaitingUser(const char* payload, int len)
+{
+    return len == (int)sizeof("WAITING_USER") - 1 && memcmp(payload, "WAITING_USER", len) == 0;
+}
+
+// Records The Topic State Carried By A Chat Topic Message (Caller Holds manager->lock)
+static void markReadiness(ConversationManager* manager, Conversation* conversation, int waiting)
+{
+    if (conversation->waiting == waiting)
+        return;
+    conversation->waiting = waiting;
+
+    if (LOG_ENABLED)
+        printf("               [LOG] CONVERSATIONS: %s %s\n", conversation->topic, waiting ? "waiting for the other user" : "confirmed");
+
+    if (waiting)
+        return;
+
+    pthread_cond_broadcast(&manager->ready);
+    #if !defined(_WIN32)
+    if (manager->ready_fd >= 0) {
+        uint64_t one = 1; // eventfd Counter Increment (A Pipe Just Receives 8 Bytes)
+        if (write(manager->ready_fd, &one, sizeof(one)) < 0) { /* Reader Already Signaled */ }
+    }
+    #endif
+}
+
+static void connectManager(ConversationManager* manager)
+{
+    MQTTAsync_connectOptions conn_opts = MQTTAsync_connectOptions_initializer; // Connection Options (... = [Default Initializer Macro])
+    int rc;
+
+    conn_opts.keepAliveInterval = 30;
+    conn_opts.cleansession = 0; // Persistance (Messages Sent While Offline Are Delivered On Reconnect)
+    conn_opts.onSuccess = onConnect_m;
+    conn_opts.onFailure = onConnectFailure_m;
+    conn_opts.context = manager;
+
+    if ((rc = transportConnect(manager->client, &conn_opts)) != MQTTASYNC_SUCCESS)
+    {
+        if (LOG_ENABLED)
+            printf("               [LOG] CONVERSATIONS: Failed to start connect, return code %d\n", rc);
+        manager->failed = 1;
+    }
+}
+
+static void subscribeConversation(ConversationManager* manager, const char* topic)
+{
+    MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer; // Response Options (... = [Default Initializer Macro])
+    int rc;
+
+    opts.onFailure = onSubscribeFailure_m;
+    opts.context = manager;
+
+    if ((rc = transportSubscribe(manager->client, topic, QOS_CHAT, &opts)) != MQTTASYNC_SUCCESS)
+    {
+        if (LOG_ENABLED)
+            printf("               [LOG] CONVERSATIONS: Failed to start subscribe to %s, return code %d\n", topic, rc);
+    }
+
+    // Attachments Of The Conversation (CHATS/[LINK]/files/[ID])
+
+    char files[1100];
+    snprintf(files, sizeof(files), "%s" ATTACHMENT_TOPIC "+", topic);
+    if ((rc = transportSubscribe(manager->client, files, QOS_CHAT, &opts)) != MQTTASYNC_SUCCESS)
+    {
+        if (LOG_ENABLED)
+            printf("               [LOG] CONVERSATIONS: Failed to start subscribe to %s, return code %d\n", files, rc);
+    }
+}
+
+// Conversation Named "name" (Manager Lock Held)
+static Conversation* findLocked(ConversationManager* manager, const char* name)
+{
+    for (int i = 0; i < manager->count; i++)
+        if (strcmp(manager->conversations[i]->name, name) == 0)
+            return manager->conversations[i];
+    return NULL;
+}
+
+// Conversation Of A CHATS/[LINK] Or CHATS/[LINK]/files/[ID] Topic (Manager Lock Held)
+static Conversation* topicConversation(ConversationManager* manager, const char* topic, int* is_file)
+{
+    for (int i = 0; i < manager->count; i++)
+    {
+        Conversation* conversation = manager->conversations[i];
+        size_t len = strlen(conversation->topic);
+        if (strncmp(topic, conversation->topic, len) != 0)
+            continue;
+        if (topic[len] == '\0' || strncmp(topic + len, ATTACHMENT_TOPIC, sizeof(ATTACHMENT_TOPIC) - 1) == 0)
+        {
+            *is_file = topic[len] != '\0';
+            return conversation;
+        }
+    }
+    return NULL;
+}
+
+// Lines Of One Received Payload, Collected Under The Manager Lock And Queued After It Is Dropped:
+// Under LIST_BLOCK A Full Queue Waits For The UI To Pop, And The UI Needs That Lock
+typedef struct
+{
+    MessageBuffer* buffer; // Own Reference
+    const char* line;
+    int len;
+} ReceivedLine;
+
+typedef struct
+{
+    ReceivedLine* lines;
+    int count;
+    int capacity;
+} ReceivedLines;
+
+static void queueMessage(ReceivedLines* received, MessageBuffer* buffer, const char* line, int line_len)
+{
+    if (received->count == received->capacity)
+    {
+        int capacity = received->capacity ? received->capacity * 2 : 4;
+        ReceivedLine* grown = realloc(received->lines, capacity * sizeof(ReceivedLine));
+        if (!grown)
+            return;
+        received->lines = grown;
+        received->capacity = capacity;
+    }
+    bufferRetain(buffer);
+    received->lines[received->count].buffer = buffer;
+    received->lines[received->count].line = line;
+    received->lines[received->count].len = line_len;
+    received->count++;
+}
+
+// Queues A Line Built Here (Gap Notices, Continuation Lines)
+static void queueCopy(ReceivedLines* received, const char* line)
+{
+    MessageBuffer* buffer = bufferCopy(line, (int)strlen(line));
+    if (!buffer)
+        return;
+    queueMessage(received, buffer, buffer->data, buffer->length);
+    bufferRelease(buffer);
+}
+
+// Queues The Collected Lines For Display (Manager Lock NOT Held) | The Queue Takes Its Own References, Its Limit Applies The Policy
+// The Conversation Outlives The Callback: Conversations Are Only Freed By conversationsStop(), After The Client Is Destroyed
+static void queueFlush(ConversationManager* manager, Conversation* conversation, ReceivedLines* received)
+{
+    for (int i = 0; i < received->count; i++)
+    {
+        listInsertView(&conversation->messages, received->lines[i].buffer, received->lines[i].line, received->lines[i].len);
+        bufferRelease(received->lines[i].buffer);
+    }
+
+    if (received->count > 0)
+    {
+        pthread_mutex_lock(&manager->lock);
+        if (conversation != manager->active)
+            conversation->unread += received->count;
+        pthread_mutex_unlock(&manager->lock);
+    }
+
+    free(received->lines);
+    memset(received, 0, sizeof(*received));
+}
+
+// Splits A Coalesced Payload Back Into "[USERNAME]: [LINE]" Lines (Manager Lock Held)
+// Single Lines (The Common Case) Are Queued As Views Into The Received Payload
+static void queueLines(ReceivedLines* received, MessageBuffer* buffer, const ChatEnvelope* envelope)
+{
+    const char* start = envelope->text;
+    const char* end = envelope->text + envelope->text_len;
+    const char* nl = memchr(start, '\n', end - start);
+
+    if (!nl)
+    {
+        queueMessage(received, buffer, start, envelope->text_len);
+        return;
+    }
+
+    // Prefix Of The First Line ("[USERNAME]: ") Repeated On The Following Ones
+    const char* colon = envelope->has_header ? envelope->sender + envelope->sender_len : memchr(start, ':', nl - start);
+    int prefix_len = (colon && colon < nl) ? (int)(colon - start) : 0;
+
+    queueMessage(received, buffer, start, (int)(nl - start));
+
+    while (nl < end)
+    {
+        start = nl + 1;
+        nl = memchr(start, '\n', end - start);
+        if (!nl)
+            nl = end;
+
+        if (prefix_len == 0) // Nothing To Prepend: View Into The Payload
+        {
+            queueMessage(received, buffer, start, (int)(nl - start));
+            continue;
+        }
+
+        int line_len = prefix_len + 2 + (int)(nl - start); // Built At Its Exact Size (Long Lines Are Never Cut)
+        MessageBuffer* line = bufferAlloc(line_len);
+        if (!line)
+            continue;
+        snprintf(line->data, line_len + 1, "%.*s: %.*s", prefix_len, envelope->text, (int)(nl - start), start);
+        queueMessage(received, line, line->data, line_len);
+        bufferRelease(line);
+    }
+}
+
+// PING:[USERNAME];[T1] To [PEER]_Control, Answered By Its Agent With A PONG (Clock Offset, envelope.h)
+static void pingPeer(ConversationManager* manager, const char* peer, uint64_t now_us)
+{
+    char topic[128];
+    char t1[24];
+    snprintf(topic, sizeof(topic), "%s_Control", peer);
+    snprintf(t1, sizeof(t1), "%llx", (unsigned long long)now_us);
+    char* payload = eventPack(EVENT_WIRE_CURRENT, EVENT_PING, manager->username, t1, NULL);
+    if (!payload)
+        return;
+
+    MQTTAsync_message pubmsg = MQTTAsync_message_initializer; // Message Object (... = [Default Initializer Macro])
+    pubmsg.payload = payload;
+    pubmsg.payloadlen = (int)strlen(payload);
+    pubmsg.qos = 0; // A Lost PING Is Sent Again Later
+    pubmsg.retained = 0;
+    int rc = transportSendMessage((MQTTAsync)manager->client, topic, &pubmsg, NULL);
+    if (rc != MQTTASYNC_SUCCESS && LOG_ENABLED)
+        printf("               [LOG] CONVERSATIONS: Failed to ping %s, return code %d\n", peer, rc);
+    free(payload);
+}
+
+// One-Way Latency Of A Line From Another User Into Its Conversation Histogram (stats.h), Pinging The Sender When Due
+static void recordLatency(ConversationManager* manager, Conversation* conversation, const ChatEnvelope* envelope)
+{
+    if (!envelope->has_time || envelope->session == envelopeSession()) // Own Lines: STATS_DELIVERY
+        return;
+
+    EnvelopeTime received;
+    envelopeNow(&received);
+    int64_t latency_us = envelopeLatency(envelope, &received);
+
+    char sender[64];
+    char name[128];
+    snprintf(sender, sizeof(sender), "%.*s", envelope->sender_len, envelope->sender);
+    if (conversation->is_group)
+        snprintf(name, sizeof(name), "%s/%s", conversation->name, sender);
+    else
+        snprintf(name, sizeof(name), "%s", conversation->name);
+    statsConversationRecord(name, (uint64_t)latency_us * 1000);
+
+    if (peerClockPingDue(sender, received.mono_us))
+        pingPeer(manager, sender, received.mono_us);
+}
+
+// Collects The Lines Of A Received Chat Payload (Manager Lock Held) | *buffer Is Replaced When A Chunked Payload Completes
+static void receiveLine(ConversationManager* manager, Conversation* conversation, MessageBuffer** buffer, const char* topic, ReceivedLines* received)
+{
+    const char* payload = (*buffer)->data;
+    int len = (*buffer)->length;
+
+    // Chunk Frames Are Written Into Their Transfer, The Payload Is Handled Once Reassembled
+
+    if (chunkIsFrame(payload, len))
+    {
+        MessageBuffer* complete;
+        int rc = chunkFeed(&conversation->chunks, payload, len, &complete);
+        if (rc == CHUNK_REJECTED && LOG_ENABLED)
+            printf("               [LOG] CONVERSATIONS: Chunk frame rejected on %s\n", topic);
+        if (rc != CHUNK_COMPLETE)
+            return;
+
+        bufferRelease(*buffer);
+        *buffer = complete;
+        payload = complete->data;
+        len = complete->length;
+    }
+
+    // Duplicates (QoS Redelivery, Reconnect Replay) Are Dropped, Gaps Are Reported In The Conversation
+
+    ChatEnvelope envelope;
+    uint32_t missing;
+    envelopeDecode(payload, len, &envelope);
+    if (dedupeCheck(&conversation->dedupe, &envelope, &missing) == DEDUPE_DUPLICATE)
+    {
+        if (LOG_ENABLED)
+            printf("               [LOG] CONVERSATIONS: Duplicate %.*s #%u dropped\n", envelope.sender_len, envelope.sender, envelope.seq);
+        return;
+    }
+
+    if (missing > 0)
+    {
+        char notice[128];
+        snprintf(notice, sizeof(notice), "--- %u Mensagem(ns) De %.*s Perdida(s) ---", missing, envelope.sender_len < 64 ? envelope.sender_len : 64, envelope.sender);
+        queueCopy(received, notice);
+    }
+    if (envelope.has_header)
+        TRACE_EVENT(TRACE_CHAT_RECEIVE, chat_receive, ((uint64_t)envelope.session << 32) | envelope.seq, len);
+    recordLatency(manager, conversation, &envelope);
+    queueLines(received, *buffer, &envelope);
+
+    // Our Own Line Back From The Broker: End-To-End Delivery Latency (Same Clock, No Offset)
+
+    if (envelope.has_header && envelope.session == envelopeSession() &&
+        envelope.sender_len == (int)strlen(manager->username) && memcmp(envelope.sender, manager->username, envelope.sender_len) == 0)
+    {
+        int slot = envelope.seq % STATS_PENDING;
+        if (conversation->sent_seq[slot] == envelope.seq && conversation->sent_ns[slot])
+        {
+            statsSince(STATS_DELIVERY, conversation->sent_ns[slot]);
+            conversation->sent_ns[slot] = 0;
+        }
+    }
+}
+
+static void releaseMessage_m(void* message_) // Last View Released
+{
+    MQTTAsync_message* message = (MQTTAsync_message*)message_;
+    transportFreeMessage(&message);
+}
+
+// Callbacks
+
+void connectionLost_m(void *context_, char *cause) // Connection Lost
+{
+    ConversationManager* manager = (ConversationManager*)context_;
+
+    if (LOG_ENABLED)
+    {
+        printf("\n               [LOG] CONVERSATIONS: Connection lost\n");
+        if (cause)
+            printf("     cause: %s\n", cause);
+        printf("               [LOG] CONVERSATIONS: Reconnecting\n");
+    }
+
+    manager->connected = 0;
+    connectManager(manager);
+}
+
+int messageArrived_m(void *context_, char *topicName, int topicLen, MQTTAsync_message *message) // Message Arrived
+{
+    ConversationManager* manager = (ConversationManager*)context_;
+    const char* payload = (const char*)message->payload;
+    int len = message->payloadlen;
+
+    if (LOG_ENABLED)
+    {
+        printf("\n               [LOG] CONVERSATIONS: Message arrived\n");
+        printf("               [LOG]      Topic: %s\n", topicName);
+        printf("               [LOG]    Message: %.*s\n", len, payload);
+    }
+
+    // The Payload Is Kept As Received: Queued Lines Are Views Into It, Freed With The Last One
+
+    MessageBuffer* buffer = bufferAdopt((char*)message->payload, len, releaseMessage_m, message);
+    if (!buffer)
+        return 1;
+
+    // Route To The Conversation (Empty / WAITING_USER Payloads Only Mark The Topic State)
+
+    int is_file = 0;
+
+    pthread_mutex_lock(&manager->lock);
+    Conversation* conversation = topicConversation(manager, topicName, &is_file);
+    if (conversation && !is_file)
+        markReadiness(manager, conversation, isWaitingUser(payload, len));
+    pthread_mutex_unlock(&manager->lock);
+
+    if (len > 0 && !isWaitingUser(payload, len))
+    {
+        ReceivedLines received = { NULL, 0, 0 };
+
+        pthread_mutex_lock(&manager->lock);
+        if (conversation && !is_file)
+            receiveLine(manager, conversation, &buffer, topicName, &received);
+        pthread_mutex_unlock(&manager->lock);
+
+        if (conversation)
+            queueFlush(manager, conversation, &received); // May Wait For Room (LIST_BLOCK) Without Holding The Manager
+
+        // Attachments Go Straight To Disk, Outside The Lock (Only This Callback Thread Uses The Receiver)
+
+        if (conversation && is_file)
+        {
+            char notice[1200];
+            int rc = attachmentFeed(&manager->attachments, payload, len, notice, sizeof(notice));
+            if (rc == ATTACHMENT_REJECTED && LOG_ENABLED)
+                printf("               [LOG] CONVERSATIONS: Attachment message rejected on %s\n", topicName);
+            if (rc == ATTACHMENT_COMPLETE || rc == ATTACHMENT_CORRUPTED)
+            {
+                queueCopy(&received, notice);
+                queueFlush(manager, conversation, &received);
+            }
+        }
+    }
+
+	// Memory Management (Our Reference, The Queue Holds Its Own)
+    bufferRelease(buffer);
+
+    return 1;
+}
+
+void onSubscribeFailure_m(void* context_, MQTTAsync_failureData* response) // Fails To Subscribe
+{
+    if (LOG_ENABLED)
+        printf("               [LOG] CONVERSATIONS: Subscribe failed, rc %d\n", response ? response->code : 0);
+}
+
+void onConnectFailure_m(void* context_, MQTTAsync_failureData* response) // Fails To Connect
+{
+    ConversationManager* manager = (ConversationManager*)context_;
+    if (LOG_ENABLED)
+        printf("               [LOG] CONVERSATIONS: Connect failed, rc %d\n", response ? response->code : 0);
+    manager->failed = 1;
+}
+
+void onConnect_m(void* context_, MQTTAsync_successData* response) // Connected Successfuly
+{
+    ConversationManager* manager = (ConversationManager*)context_;
+
+    if (LOG_ENABLED)
+        printf("               [LOG] CONVERSATIONS: Successful connection\n");
+
+    // (Re)Subscribe Every Known Conversation
+
+    pthread_mutex_lock(&manager->lock);
+    for (int i = 0; i < manager->count; i++)
+        subscribeConversation(manager, manager->conversations[i]->topic);
+    manager->connected = 1;
+    pthread_mutex_unlock(&manager->lock);
+}
+
+void onDisconnect_m(void* context_, MQTTAsync_successData* response) // Disconnected Successfuly
+{
+    ConversationManager* manager = (ConversationManager*)context_;
+    if (LOG_ENABLED)
+        printf("               [LOG] CONVERSATIONS: Successful disconnection\n");
+    manager->connected = -1;
+}
+
+// Main Functions
+
+int conversationsStart(ConversationManager* manager, const char* username)
+{
+    MQTTAsync client; // Client (Handler) | Connection To Broker
+    int rc;
+
+    memset(manager, 0, sizeof(*manager));
+    pthread_mutex_init(&manager->lock, NULL);
+    pthread_cond_init(&manager->ready, NULL);
+    manager->ready_fd = -1;
+    attachmentInit(&manager->attachments);
+
+    // Queue Limits (CHATMQTT_QUEUE_MAX=[MESSAGES] / CHATMQTT_QUEUE_POLICY=block|drop|spill Override The Defaults)
+
+    const char* queue_max = getenv("CHATMQTT_QUEUE_MAX");
+    manager->queue_max = (queue_max && atoi(queue_max) > 0) ? atoi(queue_max) : CONVERSATION_QUEUE_MAX;
+    manager->queue_policy = listPolicyParse(getenv("CHATMQTT_QUEUE_POLICY"), CONVERSATION_QUEUE_POLICY);
+    snprintf(manager->username, sizeof(manager->username), "%s", username);
+    snprintf(manager->client_id, sizeof(manager->client_id), "%s;", username); // Same Session As The Former Per-Conversation Client
+
+    // Create Client
+
+    if ((rc = transportCreate(&client, ADDRESS, manager->client_id, MQTTCLIENT_PERSISTENCE_NONE, NULL)) != MQTTASYNC_SUCCESS)
+    {
+        if (LOG_ENABLED)
+            printf("               [LOG] CONVERSATIONS: Failed to create client, return code %d\n", rc);
+        return EXIT_FAILURE;
+    }
+    manager->client = client;
+
+    // Set Callbacks
+
+    if ((rc = transportSetCallbacks(client, manager, connectionLost_m, messageArrived_m, NULL)) != MQTTASYNC_SUCCESS)
+    {
+        if (LOG_ENABLED)
+            printf("               [LOG] CONVERSATIONS: Failed to set callbacks, return code %d\n", rc);
+        transportDestroy(&client);
+        manager->client = NULL;
+        return EXIT_FAILURE;
+    }
+
+    // Connect To Broker & Wait
+
+    connectManager(manager);
+
+    while (manager->connected != 1 && !manager->failed)
+    {
+        #if defined(_WIN32)
+            Sleep(DELAY_100_MS_MS);
+        #else
+            usleep(DELAY_100_MS_US);
+        #endif
+    }
+
+    return manager->failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+void conversationsStop(ConversationManager* manager)
+{
+    MQTTAsync client = (MQTTAsync)manager->client;
+    MQTTAsync_disconnectOptions disc_opts = MQTTAsync_disconnectOptions_initializer; // Disconnection Options (... = [Default Initializer Macro])
+
+    if (!client)
+        return;
+
+    // Disconnect (Subscriptions Stay In The Persistent Session)
+
+    if (manager->connected == 1)
+    {
+        disc_opts.onSuccess = onDisconnect_m;
+        disc_opts.context = manager;
+        if (transportDisconnect(client, &disc_opts) == MQTTASYNC_SUCCESS)
+        {
+            for (int waited = 0; manager->connected != -1 && waited < DELAY_5_SEC_MS; waited += DELAY_100_MS_MS)
+            {
+                #if defined(_WIN32)
+                    Sleep(DELAY_100_MS_MS);
+                #else
+                    usleep(DELAY_100_MS_US);
+                #endif
+            }
+        }
+    }
+
+    transportDestroy(&client);
+    manager->client = NULL;
+
+    // Memory Management
+
+    pthread_mutex_lock(&manager->lock);
+    for (int i = 0; i < manager->count; i++)
+    {
+        listDestroy(&manager->conversations[i]->messages);
+        chunkFree(&manager->conversations[i]->chunks);
+        free(manager->conversations[i]);
+    }
+    manager->count = 0;
+    manager->active = NULL;
+    attachmentFree(&manager->attachments);
+    pthread_mutex_unlock(&manager->lock);
+    pthread_cond_destroy(&manager->ready);
+    pthread_mutex_destroy(&manager->lock);
+}
+
+Conversation* conversationsFind(ConversationManager* manager, const char* name)
+{
+    pthread_mutex_lock(&manager->lock);
+    Conversation* found = findLocked(manager, name);
+    pthread_mutex_unlock(&manager->lock);
+
+    return found;
+}
+
+// Registers A Conversation And Subscribes Its Topic (Returns The Existing One If Already Known)
+// Built Before Taking The Lock; The Lookup And The Append Share One Critical Section, So The UI And The Agent Worker
+// Adding The Same Name At Once Still Register A Single Conversation (The Loser Frees Its Copy)
+Conversation* conversationsAdd(ConversationManager* manager, const char* name, const char* link, int is_group)
+{
+    Conversation* conversation = calloc(1, sizeof(Conversation));
+    if (!conversation)
+        return NULL;
+
+    snprintf(conversation->name, sizeof(conversation->name), "%s", name);
+    snprintf(conversation->topic, sizeof(conversation->topic), "CHATS/%s", link);
+    conversation->is_group = is_group;
+    conversation->next_seq = 1;
+    dedupeInit(&conversation->dedupe);
+    chunkInit(&conversation->chunks);
+    listInit(&conversation->messages);
+    listSetName(&conversation->messages, "messages");
+    listSetLimit(&conversation->messages, manager->queue_max, manager->queue_policy);
+
+    pthread_mutex_lock(&manager->lock);
+    Conversation* found = findLocked(manager, name);
+    if (found || manager->count >= MAX_CONVERSATIONS)
+    {
+        pthread_mutex_unlock(&manager->lock);
+        listDestroy(&conversation->messages);
+        free(conversation);
+        return found;
+    }
+    manager->conversations[manager->count++] = conversation;
+    if (manager->connected == 1)
+        subscribeConversation(manager, conversation->topic);
+    pthread_mutex_unlock(&manager->lock);
+
+    return conversation;
+}
+
+// Publishes One Payload (Whole Or As Chunk Frames) On The Shared Connection
+static int publishPayload(ConversationManager* manager, Conversation* conversation, const char* payload, int len)
+{
+    MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer; // Response Options (... = [Default Initializer Macro])
+    MQTTAsync_message pubmsg = MQTTAsync_message_initializer; // Message Object (... = [Default Initializer Macro])
+    int rc;
+
+    pubmsg.payload = (void*)payload;
+    pubmsg.payloadlen = len;
+    pubmsg.qos = QOS_CHAT; // Duplicates Are Filtered By The Receiver (ChatDedupe / Chunk Bitmap)
+    pubmsg.retained = 0;
+
+    if ((rc = transportSendMessage((MQTTAsync)manager->client, conversation->topic, &pubmsg, &opts)) != MQTTASYNC_SUCCESS)
+    {
+        if (LOG_ENABLED)
+            printf("               [LOG] CONVERSATIONS: Failed to start sendMessage, return code %d\n", rc);
+    }
+    return rc; // Paho Copies The Payload
+}
+
+// Gives Back The Sequence Numbers Of A Line That Never Went Out (Unless A Later Line Took Its Own Since: Then The Gap Stays)
+static void releaseSeq(ConversationManager* manager, Conversation* conversation, uint32_t seq, uint32_t lines)
+{
+    pthread_mutex_lock(&manager->lock);
+    if (conversation->next_seq == seq + lines)
+    {
+        conversation->next_seq = seq;
+        conversation->sent_ns[seq % STATS_PENDING] = 0;
+    }
+    pthread_mutex_unlock(&manager->lock);
+}
+
+// Publishes One Line On The Shared Connection (No Connection Per Message), Wrapped In The Chat Envelope
+// Payloads Longer Than CHUNK_SIZE Are Split Into Chunk Frames (Bounded MQTT Messages), Reassembled By The Receiver
+int conversationsSend(ConversationManager* manager, Conversation* conversation, const char* message)
+{
+    int rc;
+
+    uint32_t lines = 1; // Coalesced Payloads Use One Sequence Number Per Line
+    for (const char* nl = strchr(message, '\n'); nl; nl = strchr(nl + 1, '\n'))
+        lines++;
+
+    size_t size = strlen(message) + sizeof(manager->username) + 96; // Header With Send Time Under 64 Bytes
+    char* payload = malloc(size);
+    if (!payload)
+        return MQTTASYNC_FAILURE;
+
+    // Sequence Numbers Taken Now, Given Back Below If The Line Never Leaves (Receivers Would Report A Gap)
+
+    pthread_mutex_lock(&manager->lock);
+    uint32_t seq = conversation->next_seq;
+    conversation->next_seq += lines;
+    conversation->sent_seq[seq % STATS_PENDING] = seq;
+    conversation->sent_ns[seq % STATS_PENDING] = statsNow();
+    pthread_mutex_unlock(&manager->lock);
+
+    EnvelopeTime sent;
+    envelopeNow(&sent);
+    envelopeEncode(payload, size, envelopeSession(), seq, envelopeSendsTime() ? &sent : NULL, manager->username, message);
+    int len = (int)strlen(payload);
+    TRACE_EVENT(TRACE_CHAT_SEND, chat_send, ((uint64_t)envelopeSession() << 32) | seq, len);
+
+    if (len <= CHUNK_SIZE)
+    {
+        rc = publishPayload(manager, conversation, payload, len);
+        if (rc != MQTTASYNC_SUCCESS)
+            releaseSeq(manager, conversation, seq, lines);
+        free(payload);
+        return rc;
+    }
+
+    if (len > CHUNK_TRANSFER_MAX) // Receivers Would Drop It
+    {
+        if (LOG_ENABLED)
+            printf("               [LOG] CONVERSATIONS: Payload of %d bytes over the transfer cap\n", len);
+        releaseSeq(manager, conversation, seq, lines);
+        free(payload);
+        return MQTTASYNC_FAILURE;
+    }
+
+    char frame[CHUNK_HEADER_MAX + CHUNK_SIZE];
+    uint64_t transfer = chunkTransferId();
+    rc = MQTTASYNC_SUCCESS;
+    for (int offset = 0; offset < len && rc == MQTTASYNC_SUCCESS; offset += CHUNK_SIZE)
+    {
+        int part = (len - offset < CHUNK_SIZE) ? len - offset : CHUNK_SIZE;
+        int frame_len = chunkEncode(frame, sizeof(frame), transfer, (uint32_t)offset, (uint32_t)len, payload + offset, part);
+        rc = publishPayload(manager, conversation, frame, frame_len);
+    }
+    if (rc != MQTTASYNC_SUCCESS) // Frames Already Out Never Complete The Transfer: The Line Is Not Delivered Either Way
+        releaseSeq(manager, conversation, seq, lines);
+    free(payload);
+    return rc;
+}
+
+// Streams A File Into The Conversation (CHATS/[LINK]/files/[ID]) On The Shared Connection
+int conversationsSendFile(ConversationManager* manager, Conversation* conversation, const char* path)
+{
+    return attachmentSend(manager->client, conversation->topic, path);
+}
+
+// Pops The Oldest Queued Message Into view (Caller Calls viewRelease) | 0 = Queue Empty
+int conversationsPop(ConversationManager* manager, Conversation* conversation, MessageView* view)
+{
+    return listPopView(&conversation->messages, view); // Own Lock Only (A Blocked Producer Holds The Manager Lock)
+}
+
+// Selects The Displayed Conversation (Its Unread Counter Is Reset)
+void conversationsSetActive(ConversationManager* manager, Conversation* conversation)
+{
+    pthread_mutex_lock(&manager->lock);
+    manager->active = conversation;
+    if (conversation)
+        conversation->unread = 0;
+    pthread_mutex_unlock(&manager->lock);
+}
+
+// 1 Once The Other User Confirmed The Chat (Groups And Chats Without A Retained "WAITING_USER" Are Always Ready)
+int conversationsReady(ConversationManager* manager, Conversation* conversation)
+{
+    pthread_mutex_lock(&manager->lock);
+    int ready = !conversation->waiting;
+    pthread_mutex_unlock(&manager->lock);
+    return ready;
+}
+
+// Blocks Until The Chat Is Confirmed Or timeout_ms Passes (< 0 = No Limit) | Returns conversationsReady()
+int conversationsWaitReady(ConversationManager* manager, Conversation* conversation, int timeout_ms)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&manager->lock);
+    while (conversation->waiting)
+    {
+        int rc = timeout_ms < 0 ? pthread_cond_wait(&manager->ready, &manager->lock)
+                                : pthread_cond_timedwait(&manager->ready, &manager->lock, &deadline);
+        if (rc != 0)
+            break;
+    }
+    int ready = !conversation->waiting;
+    pthread_mutex_unlock(&manager->lock);
+
+    return ready;
+}
+
+// Confirmations Also Write To fd (-1 Detaches)
+void conversationsSetReadyNotify(ConversationManager* manager, int fd)
+{
+    pthread_mutex_lock(&manager->lock);
+    manager->ready_fd = fd;
+    pthread_mutex_unlock(&manager->lock);
+}
+
+// Higher Level Functions
+
+// Registers Every Conversation Found In The History (GROUP_CREATED / GROUP_REQUEST_ACCEPTED / USER_ACCEPTED / USER_REQUEST_ACCEPTED)
+void conversationsLoad(ConversationManager* manager, const LinkedList* history_list)
+{
+    char names[MAX_CONVERSATIONS][64];
+    char links[MAX_CONVERSATIONS][256];
+    int groups[MAX_CONVERSATIONS];
+    int found = 0;
+
+    pthread_mutex_lock((pthread_mutex_t*)&history_list->lock);
+
+    Node* curr = history_list->head;
+    while (curr && found < MAX_CONVERSATIONS) {
+        Event event;
+
+        if (eventDecode(curr->message, curr->length, &event) && event_schema[event.type].chat_link >= 0 &&
+            eventField(&event, 0, names[found], sizeof(names[found])) &&
+            eventField(&event, event_schema[event.type].chat_link, links[found], sizeof(links[found])))
+        {
+            groups[found] = event_schema[event.type].is_group;
+            found++;
+        }
+
+        curr = curr->next;
+    }
+
+    pthread_mutex_unlock((pthread_mutex_t*)&history_list->lock);
+
+    for (int i = 0; i < found; i++)
+        conversationsAdd(manager, names[i], links[i], groups[i]);
+}
+
+void conversationsPrint(ConversationManager* manager)
+{
+    pthread_mutex_lock(&manager->lock);
+
+    for (int i = 0; i < manager->count; i++)
+    {
+        Conversation* conversation = manager->conversations[i];
+        printf("- %s: %s", conversation->is_group ? "Grupo" : "Usuário", conversation->name);
+        if (conversation->unread > 0)
+            printf(" (%d Não Lidas)", conversation->unread);
+        if (conversation->waiting)
+            printf(" (Aguardando Confirmação)");
+        if (conversation == manager->active)
+            printf(" [Atual]");
+        printf("\n");
+    }
+
+    pthread_mutex_unlock(&manager->lock);
+}
+
+// Queue Counters Of Every Conversation (Slow Consumers: High-Water Mark, Drops, Spilled Messages)
+void conversationsPrintQueues(ConversationManager* manager)
+{
+    pthread_mutex_lock(&manager->lock);
+
+    printf("Limite: %d Mensagens Por Conversa | Política: %s\n", manager->queue_max, listPolicyName(manager->queue_policy));
+    for (int i = 0; i < manager->count; i++)
+    {
+        Conversation* conversation = manager->conversations[i];
+        ListStats stats = listGetStats(&conversation->messages);
+        printf("- %s: %d Na Fila (%ld Bytes) | Pico: %d (%ld Bytes) | Descartadas: %lu | Em Disco: %ld | Esperas: %lu\n", conversation->name,
+               stats.count, stats.bytes, stats.high_water, stats.bytes_high_water, stats.dropped, stats.spilled, stats.blocked);
+    }
+
+    pthread_mutex_unlock(&manager->lock);
+}
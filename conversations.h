@@ -0,0 +1,74 @@
+#ifndef CONVERSATIONS_H
+#define CONVERSATIONS_H
+
+#include <pthread.h>
+#include "messages.h"
+#include "envelope.h"
+#include "chunk.h"
+#include "attachment.h"
+#include "stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Constants */
+#define MAX_CONVERSATIONS        256 // Conversations Subscribed On The Shared Connection
+#define CONVERSATION_QUEUE_MAX   500 // Messages Kept In Memory Per Conversation While It Is Not Displayed
+#define CONVERSATION_QUEUE_POLICY LIST_SPILL // Beyond The Limit: Spill To Disk (Nothing Lost, Memory Stays Bounded)
+
+/* Data Structures */
+typedef struct Conversation {
+    char name[64]; // Target User Or Group
+    char topic[1024]; // CHATS/[LINK]
+    int is_group;
+    LinkedList messages; // Bounded Queue (listSetLimit: queue_max / queue_policy, Counters In listGetStats)
+    int unread; // Messages Received While Not Displayed
+    uint32_t next_seq; // Sequence Number Of Our Next Line
+    ChatDedupe dedupe; // Duplicate / Gap Detection Of Incoming Lines
+    ChunkAssembler chunks; // Payloads Arriving As Chunk Frames (Reassembled In Place)
+    int waiting; // Retained "WAITING_USER" Seen, The Other User Has Not Confirmed The Chat Yet
+    uint32_t sent_seq[STATS_PENDING]; // Our Recent Lines (By seq % STATS_PENDING), Timed Until They Come Back (STATS_DELIVERY)
+    uint64_t sent_ns[STATS_PENDING]; // 0 = Echo Already Seen
+} Conversation;
+
+typedef struct ConversationManager {
+    void* client; // MQTTAsync (One Connection For Every Conversation)
+    char username[64];
+    char client_id[72]; // "[USERNAME];"
+    Conversation* conversations[MAX_CONVERSATIONS];
+    int count;
+    Conversation* active; // Conversation Being Displayed (NULL = None)
+    AttachmentReceiver attachments; // Files Being Received (Any Conversation)
+    int queue_max;
+    ListPolicy queue_policy;
+    pthread_mutex_t lock;
+    pthread_cond_t ready; // Broadcast When A Waiting Conversation Is Confirmed
+    int ready_fd; // Also Written Then (-1 = Disabled) | Lets The Menu poll() Keyboard And Confirmation Together
+    volatile int connected;
+    volatile int failed;
+} ConversationManager;
+
+/* Core Functions */
+int conversationsStart(ConversationManager* manager, const char* username);
+void conversationsStop(ConversationManager* manager);
+Conversation* conversationsAdd(ConversationManager* manager, const char* name, const char* link, int is_group);
+Conversation* conversationsFind(ConversationManager* manager, const char* name);
+int conversationsSend(ConversationManager* manager, Conversation* conversation, const char* message);
+int conversationsSendFile(ConversationManager* manager, Conversation* conversation, const char* path);
+int conversationsPop(ConversationManager* manager, Conversation* conversation, MessageView* view);
+void conversationsSetActive(ConversationManager* manager, Conversation* conversation);
+int conversationsReady(ConversationManager* manager, Conversation* conversation);
+int conversationsWaitReady(ConversationManager* manager, Conversation* conversation, int timeout_ms);
+void conversationsSetReadyNotify(ConversationManager* manager, int fd);
+
+/* Higher Level Functions */
+void conversationsLoad(ConversationManager* manager, const LinkedList* history_list);
+void conversationsPrint(ConversationManager* manager);
+void conversationsPrintQueues(ConversationManager* manager);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONVERSATIONS_H
@@ -0,0 +1,396 @@
+// Chat Envelope
+// Sequence Numbers, Message IDs & Send Times For Chat Lines, Plus The Receiver Side Duplicate / Gap Detection
+// And The Peer Clock Offsets Turning Send Times Into One-Way Latencies
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ctype.h>
+#include <pthread.h>
+#include "envelope.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#else
+#include <windows.h>
+#include <process.h>
+#define getpid _getpid
+#endif
+
+// Peer Clocks (Shared By Every Conversation: Filled By The Agent, Read On The Conversations Callback Thread)
+
+static PeerClock peer_clocks[PEER_CLOCKS];
+static unsigned long peer_clock_use = 0;
+static pthread_mutex_t peer_clock_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Helpers
+
+static uint64_t hashId(const char* sender, int sender_len, uint32_t session, uint32_t seq) // FNV-1a
+{
+    uint64_t hash = 1469598103934665603ULL;
+    for (int i = 0; i < sender_len; i++)
+    {
+        hash ^= (unsigned char)sender[i];
+        hash *= 1099511628211ULL;
+    }
+    uint32_t numbers[2] = { session, seq };
+    const unsigned char* bytes = (const unsigned char*)numbers;
+    for (size_t i = 0; i < sizeof(numbers); i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash ? hash : 1; // 0 Marks An Empty Slot
+}
+
+#define SLOTS_COUNT (DEDUPE_WINDOW * 2)
+
+static int slotFind(const ChatDedupe* dedupe, uint64_t id)
+{
+    int i = (int)(id % SLOTS_COUNT);
+    while (dedupe->slots[i] != 0)
+    {
+        if (dedupe->slots[i] == id)
+            return i;
+        i = (i + 1) % SLOTS_COUNT;
+    }
+    return -1;
+}
+
+static void slotInsert(ChatDedupe* dedupe, uint64_t id)
+{
+    int i = (int)(id % SLOTS_COUNT);
+    while (dedupe->slots[i] != 0)
+        i = (i + 1) % SLOTS_COUNT;
+    dedupe->slots[i] = id;
+}
+
+static void slotRemove(ChatDedupe* dedupe, uint64_t id) // Backward Shift Deletion (No Tombstones)
+{
+    int i = slotFind(dedupe, id);
+    if (i < 0)
+        return;
+
+    int j = i;
+    while (1)
+    {
+        dedupe->slots[i] = 0;
+        int home;
+        do
+        {
+            j = (j + 1) % SLOTS_COUNT;
+            if (dedupe->slots[j] == 0)
+                return;
+            home = (int)(dedupe->slots[j] % SLOTS_COUNT);
+        } while ((i <= j) ? (i < home && home <= j) : (i < home || home <= j));
+        dedupe->slots[i] = dedupe->slots[j];
+        i = j;
+    }
+}
+
+// Returns The Sender Entry, Replacing The Least Recently Seen One If Needed
+static SenderState* senderState(ChatDedupe* dedupe, const ChatEnvelope* envelope, int* is_new)
+{
+    SenderState* oldest = &dedupe->senders[0];
+
+    dedupe->clock++;
+    for (int i = 0; i < DEDUPE_SENDERS; i++)
+    {
+        SenderState* sender = &dedupe->senders[i];
+        if (sender->seen != 0 && sender->session == envelope->session &&
+            (int)strlen(sender->name) == envelope->sender_len && strncmp(sender->name, envelope->sender, envelope->sender_len) == 0)
+        {
+            sender->seen = dedupe->clock;
+            *is_new = 0;
+            return sender;
+        }
+        if (sender->seen < oldest->seen)
+            oldest = sender;
+    }
+
+    int len = envelope->sender_len < (int)sizeof(oldest->name) ? envelope->sender_len : (int)sizeof(oldest->name) - 1;
+    memcpy(oldest->name, envelope->sender, len);
+    oldest->name[len] = '\0';
+    oldest->session = envelope->session;
+    oldest->last_seq = 0;
+    oldest->seen = dedupe->clock;
+    *is_new = 1;
+    return oldest;
+}
+
+static PeerClock* peerClock(const char* peer, int create) // Locked By The Caller
+{
+    PeerClock* oldest = &peer_clocks[0];
+
+    peer_clock_use++;
+    for (int i = 0; i < PEER_CLOCKS; i++)
+    {
+        PeerClock* clock = &peer_clocks[i];
+        if (clock->seen != 0 && strcmp(clock->name, peer) == 0)
+        {
+            clock->seen = peer_clock_use;
+            return clock;
+        }
+        if (clock->seen < oldest->seen)
+            oldest = clock;
+    }
+    if (!create)
+        return NULL;
+
+    memset(oldest, 0, sizeof(*oldest));
+    snprintf(oldest->name, sizeof(oldest->name), "%s", peer);
+    oldest->seen = peer_clock_use;
+    return oldest;
+}
+
+static uint64_t hexValue(const char** p, const char* end, int* digits)
+{
+    uint64_t value = 0;
+    *digits = 0;
+    for (; *p < end && isxdigit((unsigned char)**p); (*p)++, (*digits)++)
+        value = (value << 4) | (uint64_t)(isdigit((unsigned char)**p) ? **p - '0' : (tolower((unsigned char)**p) - 'a' + 10));
+    return value;
+}
+
+// Main Functions
+
+// Random Session Id, Chosen Once Per Process (First Caller May Be The UI Or The Client Callback Thread)
+static uint32_t session = 0;
+static pthread_once_t session_once = PTHREAD_ONCE_INIT;
+
+static void sessionPick(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    session = (uint32_t)(now.tv_nsec ^ (now.tv_sec << 12) ^ ((uint32_t)getpid() << 20));
+    if (session == 0)
+        session = 1;
+}
+
+uint32_t envelopeSession(void)
+{
+    pthread_once(&session_once, sessionPick);
+    return session;
+}
+
+void envelopeNow(EnvelopeTime* time)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    time->mono_us = (uint64_t)now.tv_sec * 1000000u + now.tv_nsec / 1000;
+    clock_gettime(CLOCK_REALTIME, &now);
+    time->wall_us = (uint64_t)now.tv_sec * 1000000u + now.tv_nsec / 1000;
+}
+
+int envelopeSendsTime(void)
+{
+    static int sends = -1;
+    if (sends < 0)
+    {
+        const char* value = getenv(ENVELOPE_TIME_ENV);
+        sends = !(value && strcmp(value, "0") == 0);
+    }
+    return sends;
+}
+
+int envelopeEncode(char* out, size_t size, uint32_t session, uint32_t seq, const EnvelopeTime* time, const char* username, const char* message)
+{
+    if (!time)
+        return snprintf(out, size, ENVELOPE_PREFIX "%x;%u;%s: %s", session, seq, username, message);
+    return snprintf(out, size, ENVELOPE_PREFIX "%x;%u@%llx,%llx;%s: %s", session, seq,
+                    (unsigned long long)time->mono_us, (unsigned long long)time->wall_us, username, message);
+}
+
+// Payload Need Not Be Nul-Terminated | Every Pointer Set In envelope Points Into It
+int envelopeDecode(const char* payload, int len, ChatEnvelope* envelope)
+{
+    memset(envelope, 0, sizeof(*envelope));
+    envelope->text = payload;
+    envelope->text_len = len;
+    envelope->lines = 1;
+    for (const char* nl = memchr(payload, '\n', len); nl; nl = memchr(nl + 1, '\n', len - (nl + 1 - payload)))
+        envelope->lines++;
+
+    int prefix_len = (int)sizeof(ENVELOPE_PREFIX) - 1;
+    if (len < prefix_len || memcmp(payload, ENVELOPE_PREFIX, prefix_len) != 0)
+        return 0; // Legacy
+
+    const char* p = payload + prefix_len;
+    const char* end = payload + len;
+
+    uint32_t session = 0;
+    const char* digits = p;
+    for (; p < end && isxdigit((unsigned char)*p); p++)
+        session = (session << 4) | (uint32_t)(isdigit((unsigned char)*p) ? *p - '0' : (tolower((unsigned char)*p) - 'a' + 10));
+    if (p == digits || p == end || *p != ';')
+        return 0;
+    p++;
+
+    uint32_t seq = 0;
+    digits = p;
+    for (; p < end && isdigit((unsigned char)*p); p++)
+        seq = seq * 10 + (uint32_t)(*p - '0');
+    if (p == digits || p == end)
+        return 0;
+
+    // Optional Send Time
+
+    int has_time = 0;
+    uint64_t mono_us = 0;
+    uint64_t wall_us = 0;
+    if (*p == '@')
+    {
+        int mono_digits, wall_digits;
+        p++;
+        mono_us = hexValue(&p, end, &mono_digits);
+        if (mono_digits == 0 || p == end || *p != ',')
+            return 0;
+        p++;
+        wall_us = hexValue(&p, end, &wall_digits);
+        if (wall_digits == 0 || p == end)
+            return 0;
+        has_time = 1;
+    }
+    if (*p != ';')
+        return 0;
+    p++;
+
+    const char* colon = memchr(p, ':', end - p);
+    if (!colon || colon == p)
+        return 0;
+
+    envelope->has_header = 1;
+    envelope->session = session;
+    envelope->seq = seq;
+    envelope->sender = p;
+    envelope->sender_len = (int)(colon - p);
+    envelope->text = p;
+    envelope->text_len = (int)(end - p);
+    envelope->has_time = has_time;
+    envelope->sent_mono_us = mono_us;
+    envelope->sent_wall_us = wall_us;
+    return 1;
+}
+
+// Rate Limit Of The PING Exchanges (One Per Peer Every PEER_PING_INTERVAL, Retried At That Pace While Unanswered)
+int peerClockPingDue(const char* peer, uint64_t now_us)
+{
+    pthread_mutex_lock(&peer_clock_lock);
+    PeerClock* clock = peerClock(peer, 1);
+    int due = clock->pinged_us == 0 || now_us - clock->pinged_us >= (uint64_t)PEER_PING_INTERVAL * 1000000u;
+    if (due)
+        clock->pinged_us = now_us;
+    pthread_mutex_unlock(&peer_clock_lock);
+    return due;
+}
+
+void peerClockSample(const char* peer, uint64_t t1_us, uint64_t t2_us, uint64_t t4_us)
+{
+    if (t4_us < t1_us || t4_us - t1_us > PEER_RTT_MAX_US)
+        return;
+
+    pthread_mutex_lock(&peer_clock_lock);
+    PeerClock* clock = peerClock(peer, 1);
+    int slot = clock->samples % PEER_CLOCK_SAMPLES;
+    clock->offsets_us[slot] = (int64_t)t2_us - (int64_t)((t1_us + t4_us) / 2);
+    clock->rtts_us[slot] = t4_us - t1_us;
+    clock->samples++;
+    pthread_mutex_unlock(&peer_clock_lock);
+}
+
+int peerClockOffset(const char* peer, int64_t* offset_us)
+{
+    int found = 0;
+    pthread_mutex_lock(&peer_clock_lock);
+    PeerClock* clock = peerClock(peer, 0);
+    if (clock && clock->samples > 0)
+    {
+        int count = clock->samples < PEER_CLOCK_SAMPLES ? clock->samples : PEER_CLOCK_SAMPLES;
+        int best = 0;
+        for (int i = 1; i < count; i++)
+            if (clock->rtts_us[i] < clock->rtts_us[best])
+                best = i;
+        *offset_us = clock->offsets_us[best];
+        found = 1;
+    }
+    pthread_mutex_unlock(&peer_clock_lock);
+    return found;
+}
+
+// Negative Results (Clock Estimate Off By More Than The Latency) Are Clamped To 0
+int64_t envelopeLatency(const ChatEnvelope* envelope, const EnvelopeTime* received)
+{
+    if (!envelope->has_time)
+        return -1;
+
+    char peer[64];
+    int len = envelope->sender_len < (int)sizeof(peer) ? envelope->sender_len : (int)sizeof(peer) - 1;
+    memcpy(peer, envelope->sender, len);
+    peer[len] = '\0';
+
+    int64_t latency;
+    int64_t offset_us;
+    if (envelope->session == envelopeSession())
+        latency = (int64_t)(received->mono_us - envelope->sent_mono_us); // Our Own Line: Same Clock
+    else if (peerClockOffset(peer, &offset_us))
+        latency = (int64_t)received->mono_us - ((int64_t)envelope->sent_mono_us - offset_us);
+    else
+        latency = (int64_t)(received->wall_us - envelope->sent_wall_us);
+    return latency > 0 ? latency : 0;
+}
+
+void dedupeInit(ChatDedupe* dedupe)
+{
+    memset(dedupe, 0, sizeof(*dedupe));
+}
+
+// DEDUPE_NEW (missing = Messages Skipped Before This One) Or DEDUPE_DUPLICATE
+int dedupeCheck(ChatDedupe* dedupe, const ChatEnvelope* envelope, uint32_t* missing)
+{
+    *missing = 0;
+
+    if (!envelope->has_header)
+        return DEDUPE_NEW; // Nothing To Compare
+
+    uint64_t id = hashId(envelope->sender, envelope->sender_len, envelope->session, envelope->seq);
+    if (slotFind(dedupe, id) >= 0)
+    {
+        dedupe->duplicates++;
+        return DEDUPE_DUPLICATE;
+    }
+
+    // Older Than The Window Can Tell Apart: Treated As A Replay
+
+    int is_new;
+    SenderState* sender = senderState(dedupe, envelope, &is_new);
+    if (!is_new && envelope->seq + DEDUPE_WINDOW <= sender->last_seq)
+    {
+        dedupe->duplicates++;
+        return DEDUPE_DUPLICATE;
+    }
+
+    // Remember The ID (Evicting The Oldest When The Window Is Full)
+
+    if (dedupe->window_count == DEDUPE_WINDOW)
+        slotRemove(dedupe, dedupe->window[dedupe->window_next]);
+    else
+        dedupe->window_count++;
+    dedupe->window[dedupe->window_next] = id;
+    dedupe->window_next = (dedupe->window_next + 1) % DEDUPE_WINDOW;
+    slotInsert(dedupe, id);
+
+    // Gap Detection (Late Arrivals Below last_seq Fill A Gap Already Reported)
+
+    if (!is_new && envelope->seq > sender->last_seq + 1)
+    {
+        *missing = envelope->seq - sender->last_seq - 1;
+        dedupe->gaps++;
+        dedupe->lost += *missing;
+    }
+    uint32_t last = envelope->seq + (uint32_t)envelope->lines - 1;
+    if (last > sender->last_seq)
+        sender->last_seq = last;
+
+    return DEDUPE_NEW;
+}
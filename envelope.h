@@ -0,0 +1,104 @@
+#ifndef ENVELOPE_H
+#define ENVELOPE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Constants */
+#define ENVELOPE_PREFIX    "#1;" // Envelope Version 1
+#define DEDUPE_WINDOW      256 // Message IDs Remembered Per Conversation
+#define DEDUPE_SENDERS     64 // Senders Tracked Per Conversation (Least Recently Seen Is Replaced)
+#define ENVELOPE_TIME_ENV  "CHATMQTT_SEND_TIME" // 0 = Lines Go Out Without The Send Time (Set While Older Clients Are Still Around)
+#define PEER_CLOCKS        64 // Peers With A Clock Offset Estimate (Least Recently Used Is Replaced)
+#define PEER_CLOCK_SAMPLES 8 // Estimate = Offset Of The Fastest Of The Last Exchanges (Least Queueing)
+#define PEER_PING_INTERVAL 60 // Seconds Between PING Exchanges With The Same Peer
+#define PEER_RTT_MAX_US    2000000 // Slower Exchanges Are Ignored (A PING Queued While The Peer Was Offline)
+
+/* Chat Envelope */
+// "#1;[SESSION];[SEQ][@[MONO],[WALL]];[USERNAME]: [MESSAGE]"
+// [SESSION] > Random Hex Id Chosen By The Sender At Startup
+// [SEQ]     > Per-Conversation Sequence Number Of That Sender Session (Starts At 1)
+// [MONO]    > Optional Send Time, Sender's Monotonic Clock (Hex Microseconds) | Older Decoders Show These Payloads As-Is
+// [WALL]    > Same Instant On The Sender's Wall Clock (Hex Microseconds Since 1970), Used Until A Clock Offset Is Known
+// Message ID = [USERNAME] + [SESSION] + [SEQ] | Payloads Without The Prefix Are Shown As-Is
+// [MESSAGE] May Hold Several Lines Joined With '\n' (Coalesced Publish), Line N Uses [SEQ] + N
+
+typedef struct ChatEnvelope {
+    int has_header; // 0 = Legacy Payload (No Ordering Metadata)
+    uint32_t session;
+    uint32_t seq;
+    const char* sender; // Points Into The Payload (Not Nul-Terminated)
+    int sender_len;
+    const char* text; // "[USERNAME]: [MESSAGE]" (Display Part, Points Into The Payload)
+    int text_len;
+    int lines; // Lines Carried (Sequence Numbers Used)
+    int has_time; // Send Time Present
+    uint64_t sent_mono_us;
+    uint64_t sent_wall_us;
+} ChatEnvelope;
+
+typedef struct EnvelopeTime {
+    uint64_t mono_us;
+    uint64_t wall_us;
+} EnvelopeTime;
+
+typedef struct SenderState {
+    char name[64];
+    uint32_t session;
+    uint32_t last_seq; // Highest Sequence Number Seen
+    unsigned long seen; // Last Use (LRU)
+} SenderState;
+
+typedef struct ChatDedupe {
+    uint64_t window[DEDUPE_WINDOW]; // Recent IDs In Arrival Order (Eviction Order)
+    int window_count;
+    int window_next;
+    uint64_t slots[DEDUPE_WINDOW * 2]; // Open Addressing Set Over The Window (0 = Empty)
+    SenderState senders[DEDUPE_SENDERS];
+    unsigned long clock;
+    unsigned long duplicates; // Messages Dropped As Duplicates
+    unsigned long gaps; // Gaps Detected
+    unsigned long lost; // Messages Missing Inside Gaps
+} ChatDedupe;
+
+/* Peer Clocks */
+// Offset = Peer's Monotonic Clock - Ours, Measured With PING / PONG Events On The Control Topics (events.h):
+// PING:[USER];[T1] > PONG:[PEER];[T1];[T2] Received At T4 > Offset = T2 - (T1 + T4) / 2 (Off By Half The Path Asymmetry)
+// One-Way Latency = Receive Time - (Send Time - Offset) | Wall Clocks Until The First Exchange Completes
+typedef struct PeerClock {
+    char name[64];
+    int64_t offsets_us[PEER_CLOCK_SAMPLES];
+    uint64_t rtts_us[PEER_CLOCK_SAMPLES];
+    int samples; // Exchanges Recorded (Ring Over PEER_CLOCK_SAMPLES)
+    uint64_t pinged_us; // Last PING Sent (Monotonic)
+    unsigned long seen; // Last Use (LRU)
+} PeerClock;
+
+/* Dedupe Results */
+#define DEDUPE_NEW        0
+#define DEDUPE_DUPLICATE  1
+
+/* Core Functions */
+uint32_t envelopeSession(void);
+void envelopeNow(EnvelopeTime* time);
+int envelopeSendsTime(void); // ENVELOPE_TIME_ENV (On By Default)
+int envelopeEncode(char* out, size_t size, uint32_t session, uint32_t seq, const EnvelopeTime* time, const char* username, const char* message); // time NULL = Omitted
+int envelopeDecode(const char* payload, int len, ChatEnvelope* envelope);
+
+int peerClockPingDue(const char* peer, uint64_t now_us); // 1 = Send A PING Now (Counted As Sent)
+void peerClockSample(const char* peer, uint64_t t1_us, uint64_t t2_us, uint64_t t4_us);
+int peerClockOffset(const char* peer, int64_t* offset_us); // 0 = No Exchange Completed Yet
+int64_t envelopeLatency(const ChatEnvelope* envelope, const EnvelopeTime* received); // One-Way, Microseconds (-1 = No Send Time)
+
+void dedupeInit(ChatDedupe* dedupe);
+int dedupeCheck(ChatDedupe* dedupe, const ChatEnvelope* envelope, uint32_t* missing);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ENVELOPE_H
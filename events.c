@@ -0,0 +1,488 @@
+// Event Codec
+// Encoder, Decoder, Printer & Dispatcher Of The Control / Requests / History Events, All Driven By EVENT_TYPES (events.h)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include "events.h"
+
+// Schema Table
+
+const EventSchema event_schema[EVENT_COUNT] = {
+#define EVENT_ROW(type, min, max, link, group, recorded, history, request) \
+    { #type, (int)sizeof(#type) - 1, min, max, link, group, recorded, history, request },
+    EVENT_TYPES(EVENT_ROW)
+#undef EVENT_ROW
+};
+
+// Type Lookup
+// FNV-1a Of The Type Name Into 128 Slots, Collision-Free For The Current Schema (One Probe Per Lookup)
+// Linear Probing Keeps It Correct If A New Type Ever Collides
+
+#define LOOKUP_SLOTS 128
+
+static signed char lookup_table[LOOKUP_SLOTS];
+static pthread_once_t lookup_once = PTHREAD_ONCE_INIT;
+
+#define HASH_INIT 2166136261u
+#define HASH_STEP(hash, c) (((hash) ^ (unsigned char)(c)) * 16777619u)
+
+static void lookupBuild(void)
+{
+    memset(lookup_table, -1, sizeof(lookup_table));
+    for (int i = 0; i < EVENT_COUNT; i++)
+    {
+        uint32_t hash = HASH_INIT;
+        for (int j = 0; j < event_schema[i].name_len; j++)
+            hash = HASH_STEP(hash, event_schema[i].name[j]);
+
+        unsigned slot = hash % LOOKUP_SLOTS;
+        while (lookup_table[slot] >= 0)
+            slot = (slot + 1) % LOOKUP_SLOTS;
+        lookup_table[slot] = (signed char)i;
+    }
+}
+
+static EventType lookupHashed(uint32_t hash, const char* name, int len)
+{
+    pthread_once(&lookup_once, lookupBuild);
+
+    unsigned slot = hash % LOOKUP_SLOTS;
+    while (lookup_table[slot] >= 0)
+    {
+        const EventSchema* schema = &event_schema[(int)lookup_table[slot]];
+        if (schema->name_len == len && memcmp(schema->name, name, len) == 0)
+            return (EventType)lookup_table[slot];
+        slot = (slot + 1) % LOOKUP_SLOTS;
+    }
+    return EVENT_NONE;
+}
+
+// Main Functions
+
+EventType eventLookup(const char* name, int len)
+{
+    uint32_t hash = HASH_INIT;
+    for (int i = 0; i < len; i++)
+        hash = HASH_STEP(hash, name[i]);
+    return lookupHashed(hash, name, len);
+}
+
+// Wire Format Chosen Once From CHATMQTT_WIRE (text | binary)
+
+static int wire_format = EVENT_WIRE_DEFAULT;
+static pthread_once_t wire_once = PTHREAD_ONCE_INIT;
+
+static void wireLoad(void)
+{
+    const char* env = getenv("CHATMQTT_WIRE");
+    if (env && strcmp(env, "text") == 0)
+        wire_format = EVENT_WIRE_TEXT;
+    else if (env && strcmp(env, "binary") == 0)
+        wire_format = EVENT_WIRE_BINARY;
+}
+
+int eventWire(void)
+{
+    pthread_once(&wire_once, wireLoad);
+    return wire_format;
+}
+
+// Varints (LEB128) | A Non-Zero Value Never Produces A 0x00 Byte
+
+static size_t varintSize(uint32_t value)
+{
+    size_t size = 1;
+    while (value >= 0x80)
+    {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+static char* varintPut(char* out, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        *out++ = (char)(0x80 | (value & 0x7F));
+        value >>= 7;
+    }
+    *out++ = (char)value;
+    return out;
+}
+
+static int varintGet(const unsigned char** p, const unsigned char* end, uint32_t* value)
+{
+    uint32_t result = 0;
+    for (int shift = 0; shift < 35 && *p < end; shift += 7)
+    {
+        unsigned char byte = *(*p)++;
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            *value = result;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Builds A Payload From Field Views | Returns A Nul-Terminated Heap String (Caller Frees) Or NULL
+// Only What eventDecode() Accepts Is Built: A Field Count Outside The Schema Or An Empty Field Is Refused
+// (In Binary Both Would Also Put A 0x00 Count / Length Byte In The Payload)
+static char* packFields(int wire, EventType type, const EventField* fields, int count)
+{
+    if (type <= EVENT_NONE || type >= EVENT_COUNT)
+        return NULL;
+    if (wire == EVENT_WIRE_CURRENT)
+        wire = eventWire();
+
+    const EventSchema* schema = &event_schema[type];
+    if (count < schema->min_fields || count > schema->max_fields)
+        return NULL;
+    for (int i = 0; i < count; i++)
+        if (fields[i].len <= 0)
+            return NULL;
+
+    size_t size = 1; // '\0'
+    if (wire == EVENT_WIRE_BINARY)
+    {
+        size += 2 + varintSize((uint32_t)type + 1) + varintSize((uint32_t)count);
+        for (int i = 0; i < count; i++)
+            size += varintSize((uint32_t)fields[i].len) + fields[i].len;
+    }
+    else
+    {
+        size += schema->name_len + 1;
+        for (int i = 0; i < count; i++)
+            size += fields[i].len + 1;
+    }
+
+    char* out = malloc(size);
+    if (!out)
+        return NULL;
+
+    char* p = out;
+    if (wire == EVENT_WIRE_BINARY)
+    {
+        *p++ = (char)EVENT_BINARY_MAGIC;
+        *p++ = (char)EVENT_BINARY_VERSION;
+        p = varintPut(p, (uint32_t)type + 1);
+        p = varintPut(p, (uint32_t)count);
+        for (int i = 0; i < count; i++)
+        {
+            p = varintPut(p, (uint32_t)fields[i].len);
+            memcpy(p, fields[i].ptr, fields[i].len);
+            p += fields[i].len;
+        }
+    }
+    else
+    {
+        memcpy(p, schema->name, schema->name_len);
+        p += schema->name_len;
+        *p++ = ':';
+        for (int i = 0; i < count; i++)
+        {
+            if (i)
+                *p++ = ';';
+            memcpy(p, fields[i].ptr, fields[i].len);
+            p += fields[i].len;
+        }
+    }
+    *p = '\0';
+    return out;
+}
+
+// Text Form Into A Caller Buffer (Topic Keys) | Fields Past The Schema Maximum (Or NULL) Are Left Out | snprintf Return Convention
+int eventEncode(char* out, size_t size, EventType type, const char* field0, const char* field1, const char* field2)
+{
+    if (type <= EVENT_NONE || type >= EVENT_COUNT)
+        return -1;
+
+    const char* fields[EVENT_MAX_FIELDS] = { field0, field1, field2 };
+    const EventSchema* schema = &event_schema[type];
+
+    size_t used = 0;
+    int total = snprintf(out, size, "%s:", schema->name);
+    for (int i = 0; i < schema->max_fields && fields[i]; i++)
+    {
+        used = (size_t)total < size ? (size_t)total : size;
+        total += snprintf(out + used, size - used, i ? ";%s" : "%s", fields[i]);
+    }
+    return total;
+}
+
+// "type" With Up To Three Fields (Stops At The First NULL, NULL If The Count Does Not Fit The Schema) | wire = EVENT_WIRE_TEXT / EVENT_WIRE_BINARY / EVENT_WIRE_CURRENT
+char* eventPack(int wire, EventType type, const char* field0, const char* field1, const char* field2)
+{
+    const char* values[EVENT_MAX_FIELDS] = { field0, field1, field2 };
+    EventField fields[EVENT_MAX_FIELDS];
+    int count = 0;
+
+    while (count < EVENT_MAX_FIELDS && values[count])
+    {
+        fields[count].ptr = values[count];
+        fields[count].len = (int)strlen(values[count]);
+        count++;
+    }
+    return packFields(wire, type, fields, count);
+}
+
+// "type" With The Fields Of An Already Decoded Event (Agent Transformations, Text Keys Of Binary Payloads)
+char* eventRepack(int wire, EventType type, const Event* event)
+{
+    return packFields(wire, type, event->fields, event->field_count);
+}
+
+// Text: Hashes The Type While Looking For ':', Then Splits The Body On ';'
+static EventType decodeText(const char* payload, int len, Event* event)
+{
+    uint32_t hash = HASH_INIT;
+    int i = 0;
+    while (i < len && payload[i] != ':')
+    {
+        hash = HASH_STEP(hash, payload[i]);
+        i++;
+    }
+    if (i == len || i == 0)
+        return EVENT_NONE;
+
+    EventType type = lookupHashed(hash, payload, i);
+    if (type == EVENT_NONE)
+        return EVENT_NONE;
+
+    int start = ++i;
+    for (; i <= len; i++)
+    {
+        if (i < len && payload[i] != ';')
+            continue;
+
+        if (event->field_count == EVENT_MAX_FIELDS || i == start) // Too Many / Empty Field
+            return EVENT_NONE;
+
+        event->fields[event->field_count].ptr = payload + start;
+        event->fields[event->field_count].len = i - start;
+        event->field_count++;
+        start = i + 1;
+    }
+    return type;
+}
+
+// Binary: Views Point Straight Into The Payload
+static EventType decodeBinary(const char* payload, int len, Event* event)
+{
+    const unsigned char* p = (const unsigned char*)payload + 2;
+    const unsigned char* end = (const unsigned char*)payload + len;
+    uint32_t type_id, count;
+
+    if (len < 2 || (unsigned char)payload[1] != EVENT_BINARY_VERSION) // Newer Versions Are Not Guessed At
+        return EVENT_NONE;
+    if (!varintGet(&p, end, &type_id) || type_id == 0 || type_id > EVENT_COUNT)
+        return EVENT_NONE;
+    if (!varintGet(&p, end, &count) || count > EVENT_MAX_FIELDS)
+        return EVENT_NONE;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t field_len;
+        if (!varintGet(&p, end, &field_len) || field_len == 0 || field_len > (uint32_t)(end - p))
+            return EVENT_NONE;
+        event->fields[i].ptr = (const char*)p;
+        event->fields[i].len = (int)field_len;
+        event->field_count++;
+        p += field_len;
+    }
+    if (p != end)
+        return EVENT_NONE;
+
+    return (EventType)(type_id - 1);
+}
+
+// Accepts Both Wire Formats In One Pass | Payload Need Not Be Nul-Terminated (len < 0 = Use strlen)
+// Returns 1 If The Event Matches The Schema (Fields Are Views Into The Payload)
+int eventDecode(const char* payload, int len, Event* event)
+{
+    event->type = EVENT_NONE;
+    event->field_count = 0;
+    for (int i = 0; i < EVENT_MAX_FIELDS; i++)
+    {
+        event->fields[i].ptr = "";
+        event->fields[i].len = 0;
+    }
+
+    if (!payload)
+        return 0;
+    if (len < 0)
+        len = (int)strlen(payload);
+    if (len == 0)
+        return 0;
+
+    EventType type = ((unsigned char)payload[0] == EVENT_BINARY_MAGIC) ? decodeBinary(payload, len, event) : decodeText(payload, len, event);
+    if (type == EVENT_NONE)
+    {
+        event->field_count = 0;
+        return 0;
+    }
+
+    const EventSchema* schema = &event_schema[type];
+    if (event->field_count < schema->min_fields || event->field_count > schema->max_fields)
+    {
+        event->field_count = 0;
+        return 0;
+    }
+
+    event->type = type;
+    return 1;
+}
+
+// Same Type & Fields (Regardless Of The Wire Format Each Side Arrived In)
+int eventEquals(const Event* a, const Event* b)
+{
+    if (a->type != b->type || a->field_count != b->field_count)
+        return 0;
+    for (int i = 0; i < a->field_count; i++)
+        if (a->fields[i].len != b->fields[i].len || memcmp(a->fields[i].ptr, b->fields[i].ptr, a->fields[i].len) != 0)
+            return 0;
+    return 1;
+}
+
+// Copies Field "index" Into out | 0 If Missing Or Too Long
+int eventField(const Event* event, int index, char* out, size_t size)
+{
+    if (index < 0 || index >= event->field_count || (size_t)event->fields[index].len >= size)
+        return 0;
+    memcpy(out, event->fields[index].ptr, event->fields[index].len);
+    out[event->fields[index].len] = '\0';
+    return 1;
+}
+
+int eventFieldIs(const Event* event, int index, const char* value)
+{
+    if (index < 0 || index >= event->field_count)
+        return 0;
+    size_t len = strlen(value);
+    return (size_t)event->fields[index].len == len && memcmp(event->fields[index].ptr, value, len) == 0;
+}
+
+// Higher Level Functions
+
+#define EVENT_ARGS(event) \
+    (event)->fields[0].len, (event)->fields[0].ptr, \
+    (event)->fields[1].len, (event)->fields[1].ptr, \
+    (event)->fields[2].len, (event)->fields[2].ptr
+
+void eventPrint(const Event* event, EventView view)
+{
+    if (event->type <= EVENT_NONE || event->type >= EVENT_COUNT)
+        return;
+
+    const EventSchema* schema = &event_schema[event->type];
+    switch (view)
+    {
+        case EVENT_VIEW_HISTORY:
+            if (schema->history_text)
+                printf(schema->history_text, EVENT_ARGS(event));
+            break;
+        case EVENT_VIEW_REQUESTS:
+            if (schema->request_text)
+                printf(schema->request_text, EVENT_ARGS(event));
+            break;
+        case EVENT_VIEW_CHATS:
+            if (schema->chat_link >= 0)
+                printf(schema->is_group ? "- Grupo: %.*s\n" : "- Usuário: %.*s\n", event->fields[0].len, event->fields[0].ptr);
+            break;
+    }
+}
+
+// Calls handlers[event->type] | Returns 0 When The Type Has No Handler
+int eventDispatch(const Event* event, const EventHandler handlers[EVENT_COUNT], void* context)
+{
+    if (event->type <= EVENT_NONE || event->type >= EVENT_COUNT || !handlers[event->type])
+        return 0;
+    handlers[event->type](event, context);
+    return 1;
+}
+
+// Standalone Self-Test (gcc -DEVENTS_MAIN events.c -o events)
+// Packs Every Type With Every Field Count And Field Lengths Around The Varint Boundaries: Counts Outside The Schema
+// And Empty Fields Must Be Refused, Everything Else Must Decode Back Unchanged Without A 0x00 Byte In The Binary Form
+
+#if defined(EVENTS_MAIN)
+
+static const int test_lengths[] = { 1, 2, 127, 128, 255, 16383, 16384 };
+#define TEST_LENGTHS ((int)(sizeof(test_lengths) / sizeof(test_lengths[0])))
+#define TEST_DATA    (16384 + EVENT_MAX_FIELDS) // Field i Starts At data + i
+
+static int checkPack(int wire, EventType type, const EventField* fields, int count)
+{
+    const EventSchema* schema = &event_schema[type];
+    int valid = count >= schema->min_fields && count <= schema->max_fields;
+    for (int i = 0; i < count; i++)
+        if (fields[i].len <= 0)
+            valid = 0;
+
+    char* payload = packFields(wire, type, fields, count);
+    if (!payload)
+        return !valid;
+    if (!valid)
+    {
+        free(payload);
+        return 0;
+    }
+
+    // Nul-Terminated Length Must Cover The Whole Payload (No Embedded 0x00)
+    size_t expected = (wire == EVENT_WIRE_BINARY) ? 2 + varintSize((uint32_t)type + 1) + varintSize((uint32_t)count) : (size_t)schema->name_len + 1;
+    for (int i = 0; i < count; i++)
+        expected += (wire == EVENT_WIRE_BINARY) ? varintSize((uint32_t)fields[i].len) + fields[i].len : (size_t)fields[i].len + (i ? 1 : 0);
+
+    Event event = { 0 };
+    int ok = strlen(payload) == expected && eventDecode(payload, (int)expected, &event) && event.type == type && event.field_count == count;
+    for (int i = 0; ok && i < count; i++)
+        ok = event.fields[i].len == fields[i].len && memcmp(event.fields[i].ptr, fields[i].ptr, fields[i].len) == 0;
+    free(payload);
+    return ok;
+}
+
+int main(void)
+{
+    // Field Bytes Cycle Through 0x01..0xFF Except The Text Separators
+    char* data = malloc(TEST_DATA);
+    if (!data)
+        return EXIT_FAILURE;
+    for (int i = 0, c = 1; i < TEST_DATA; i++, c = c % 255 + 1)
+    {
+        while (c == ';' || c == ':')
+            c++;
+        data[i] = (char)c;
+    }
+
+    int checks = 0, failures = 0;
+    for (int wire = EVENT_WIRE_TEXT; wire <= EVENT_WIRE_BINARY; wire++)
+        for (int type = 0; type < EVENT_COUNT; type++)
+            for (int count = 0; count <= EVENT_MAX_FIELDS; count++)
+                for (int length = -1; length < TEST_LENGTHS; length++)
+                {
+                    EventField fields[EVENT_MAX_FIELDS];
+                    for (int i = 0; i < count; i++)
+                    {
+                        fields[i].ptr = data + i;
+                        fields[i].len = (length < 0 && i == count - 1) ? 0 : test_lengths[length < 0 ? 0 : length]; // -1: Last Field Empty
+                    }
+                    checks++;
+                    if (!checkPack(wire, (EventType)type, fields, count))
+                    {
+                        failures++;
+                        printf("FAIL: %s %s, %d Fields, Length %d\n", wire == EVENT_WIRE_BINARY ? "binary" : "text",
+                               event_schema[type].name, count, length < 0 ? 0 : test_lengths[length]);
+                    }
+                }
+
+    free(data);
+    printf("%d Checks, %d Failures\n", checks, failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#endif // EVENTS_MAIN
@@ -0,0 +1,124 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Event Schema */
+// Control / Requests / History Payloads: "[TYPE]:[FIELD0];[FIELD1];[FIELD2]" (constants.h)
+// X(TYPE, MIN_FIELDS, MAX_FIELDS, CHAT_LINK, IS_GROUP, RECORDED_AS, HISTORY_TEXT, REQUEST_TEXT)
+// CHAT_LINK   > Index Of The Conversation Link When The Event Opens A Conversation (Name = Field 0) | -1 = None
+// RECORDED_AS > Type The Agent Stores In HISTORY/ When The Event Arrives On [USER]_Control (EVENT_NONE = Not Recorded)
+// *_TEXT      > printf Templates, Fields Passed In Order As "%.*s" (NULL = Not Shown)
+// Append New Types At The End: The Position Is The Type ID Of The Binary Wire Format
+// PING:[USERNAME];[T1] / PONG:[USERNAME];[T1];[T2] > Clock Offset Exchange (envelope.h), Never Recorded Or Shown
+#define EVENT_TYPES(X) \
+    X(USER_REQUEST,           1, 1, -1, 0, EVENT_NONE,                   NULL, \
+      "- Solicitação De Conversa Com: %.*s.") \
+    X(GROUP_REQUEST,          2, 2, -1, 1, EVENT_NONE,                   NULL, \
+      "- Solicitação De Entrada No Grupo: %.*s. Pelo Usuário: %.*s.") \
+    X(USER_ACCEPTED,          2, 2,  1, 0, EVENT_USER_REQUEST_ACCEPTED,  \
+      "- Você Aceitou A Solicitação De Conversa Com O Usuário: %.*s. ", NULL) \
+    X(GROUP_ACCEPTED,         2, 3, -1, 1, EVENT_GROUP_REQUEST_ACCEPTED, \
+      "- Você Aceitou A Solicitação De Entrada No Grupo: %.*s. Pelo Usuário: %.*s.", NULL) \
+    X(USER_REJECTED,          1, 1, -1, 0, EVENT_USER_REQUEST_REJECTED,  \
+      "- Você Rejeitou A Solicitação De Conversa Com O Usuário: %.*s.", NULL) \
+    X(GROUP_REJECTED,         2, 2, -1, 1, EVENT_GROUP_REQUEST_REJECTED, \
+      "- Você Rejeitou A Solicitação De Entrada No Grupo: %.*s. Pelo Usuário: %.*s.", NULL) \
+    X(GROUP_CREATED,          2, 2,  1, 1, EVENT_NONE,                   \
+      "- Você Criou O Grupo: %.*s.", NULL) \
+    X(USER_REQUEST_SENT,      1, 1, -1, 0, EVENT_NONE,                   \
+      "- Você Enviou Uma Solicitação De Conversa Para: %.*s.", NULL) \
+    X(GROUP_REQUEST_SENT,     2, 2, -1, 1, EVENT_NONE,                   \
+      "- Você Enviou Uma Solicitação De Entrada No Grupo: %.*s. Possuindo O Líder: %.*s.", NULL) \
+    X(USER_REQUEST_ACCEPTED,  2, 2,  1, 0, EVENT_NONE,                   \
+      "- Solicitação De Conversa Para: %.*s. Aceita!", NULL) \
+    X(GROUP_REQUEST_ACCEPTED, 3, 3,  2, 1, EVENT_NONE,                   \
+      "- Solicitação De Entrada No Grupo: %.*s. Possuindo O Líder: %.*s. Aceita!", NULL) \
+    X(USER_REQUEST_REJECTED,  1, 1, -1, 0, EVENT_NONE,                   \
+      "- Solicitação De Conversa Para: %.*s. Rejeitada.", NULL) \
+    X(GROUP_REQUEST_REJECTED, 2, 2, -1, 1, EVENT_NONE,                   \
+      "- Solicitação De Entrada No Grupo: %.*s. Possuindo O Líder: %.*s. Rejeitada.", NULL) \
+    X(PING,                   2, 2, -1, 0, EVENT_NONE,                   NULL, NULL) \
+    X(PONG,                   3, 3, -1, 0, EVENT_NONE,                   NULL, NULL)
+
+/* Constants */
+#define EVENT_MAX_FIELDS  3
+
+/* Wire Formats */
+// Text   > "[TYPE]:[FIELD0];[FIELD1];[FIELD2]" (Readable, Understood By Every Version, Always Used In Topic Names)
+// Binary > [MAGIC] [VERSION] [TYPE ID + 1] [FIELD COUNT] ([LENGTH] [BYTES])... | Numbers Are Varints (LEB128)
+// Binary Payloads Never Hold A 0x00 Byte, So They Still Travel Through The Nul-Terminated Lists
+// Decoders Accept Both | The Format Sent Is Chosen With CHATMQTT_WIRE=text|binary (Default: EVENT_WIRE_DEFAULT)
+#define EVENT_WIRE_TEXT      0
+#define EVENT_WIRE_BINARY    1
+#define EVENT_WIRE_DEFAULT   EVENT_WIRE_BINARY // Set CHATMQTT_WIRE=text While Older Clients Are Still Around
+#define EVENT_WIRE_CURRENT   -1 // eventPack(): Use The Configured Format
+#define EVENT_BINARY_MAGIC   0x1E // Never The First Byte Of A Text Event
+#define EVENT_BINARY_VERSION 1
+
+typedef enum EventType {
+    EVENT_NONE = -1,
+#define EVENT_ENUM(type, ...) EVENT_##type,
+    EVENT_TYPES(EVENT_ENUM)
+#undef EVENT_ENUM
+    EVENT_COUNT
+} EventType;
+
+typedef enum EventView {
+    EVENT_VIEW_HISTORY, // "Ver Histórico"
+    EVENT_VIEW_REQUESTS, // "Ver Solicitações"
+    EVENT_VIEW_CHATS // "Ver Conversas" (Only Events That Open A Conversation)
+} EventView;
+
+/* Data Structures */
+typedef struct EventSchema {
+    const char* name;
+    int name_len;
+    int min_fields;
+    int max_fields;
+    int chat_link; // Field Holding The Conversation Link (-1 = Not A Conversation)
+    int is_group;
+    EventType recorded_as;
+    const char* history_text;
+    const char* request_text;
+} EventSchema;
+
+typedef struct EventField {
+    const char* ptr; // Points Into The Payload (Not Nul-Terminated)
+    int len;
+} EventField;
+
+typedef struct Event {
+    EventType type;
+    int field_count;
+    EventField fields[EVENT_MAX_FIELDS]; // Missing Fields = "" (len 0)
+} Event;
+
+typedef void (*EventHandler)(const Event* event, void* context);
+
+extern const EventSchema event_schema[EVENT_COUNT];
+
+/* Core Functions */
+EventType eventLookup(const char* name, int len);
+int eventWire(void);
+int eventEncode(char* out, size_t size, EventType type, const char* field0, const char* field1, const char* field2);
+char* eventPack(int wire, EventType type, const char* field0, const char* field1, const char* field2);
+char* eventRepack(int wire, EventType type, const Event* event);
+int eventDecode(const char* payload, int len, Event* event);
+int eventEquals(const Event* a, const Event* b);
+int eventField(const Event* event, int index, char* out, size_t size);
+int eventFieldIs(const Event* event, int index, const char* value);
+
+/* Higher Level Functions */
+void eventPrint(const Event* event, EventView view);
+int eventDispatch(const Event* event, const EventHandler handlers[EVENT_COUNT], void* context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EVENTS_H
@@ -0,0 +1,1059 @@
+// Compilation Command: "gcc gateway.c agent.c messages.c events.c conversations.c envelope.c chunk.c attachment.c broker.c transport.c stats.c trace.c memory.c -o gateway -lpaho-mqtt3as -pthread"
+// Excecution Command: "./gateway [-s SOCKET] [-c CONNECTIONS] [-w WORKERS] [-u MAX_USERS]"
+//
+// Multi-User Gateway (Kiosks / Bots)
+// - Hosts The Control Agent (agent.h) Of Many Users In One Process, Instead Of One "./main" Per User
+// - Users Are Spread Over A Few Shared Broker Connections (Hash Of The Username), Each [USER]_Control Is One Subscription
+// - Every User Is A Small State Machine (IDLE > QUEUED > RUNNING) With A Bounded Mailbox, Run By A Fixed Worker Pool:
+//   A User Is Queued On Its Home Worker, Idle Workers Steal From The Others, One Worker At A Time Runs A Given User
+// - Memory And Threads Are Bounded: MAX_USERS Users, GATEWAY_MAILBOX_MAX Events Each, WORKERS + 1 Threads (+ Paho's)
+//
+// Local Socket API (UNIX Stream Socket, One Command Per Line, Replies "OK ..." / "ERR ...")
+// - "LOGIN [USER]"  > Hosts The User's Agent, This Frontend Receives Its Notifications
+// - "LOGOUT [USER]" > Stops Hosting The User
+// - "STATS"         > Counters
+// - "QUIT"          > Closes The Frontend Connection
+// Notifications (Nothing Is Queued Beyond The Socket Buffer: Lost Notifications Are Counted, Lost Replies Close The Frontend):
+// - "EVENT [USER] [TEXT EVENT]"          > Every Event Handled For The User (events.h Text Form)
+// - "CHAT [USER] [NAME] [LINK] [U|G]"    > Conversation Opened By An Accepted Request
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include "MQTTAsync.h"
+#include "transport.h"
+#include "constants.h"
+#include "messages.h"
+#include "events.h"
+#include "agent.h"
+#include "trace.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#else
+#include <windows.h>
+#endif
+
+#if defined(_WRS_KERNEL)
+#include <OsWrapper.h>
+#endif
+
+#if !defined(_WIN32)
+
+// Parameters
+
+#define GATEWAY_CLIENT_ID "ChatMQTT_Gateway_%d" // One Per Shared Connection
+#define DEFAULT_SOCKET "/tmp/chatmqtt-gateway.sock" // CHATMQTT_GATEWAY_SOCKET Overrides
+#define DEFAULT_CONNECTIONS 4
+#define DEFAULT_WORKERS 4
+#define DEFAULT_MAX_USERS 10240
+#define GATEWAY_MAILBOX_MAX 32 // Events Queued Per User (The Connection's Callback Waits When Full, LIST_BLOCK)
+#define GATEWAY_SUBSCRIBE_BATCH 128 // Topics Per SUBSCRIBE When A Connection Is (Re)Established
+#define GATEWAY_MAX_FRONTENDS 256
+#define GATEWAY_LINE_MAX 256 // Longest Command Line
+#define GATEWAY_NOTICE_MAX 1024 // Longest Notification Line
+#define GATEWAY_SNDBUF (1024 * 1024) // Socket Buffer Per Frontend (Notifications Beyond It Are Dropped)
+
+// User State Machine
+
+enum
+{
+    USER_IDLE, // Mailbox Empty, Not Queued
+    USER_QUEUED, // Waiting In A Worker's Queue
+    USER_RUNNING // A Worker Is Handling Its Mailbox
+};
+
+typedef struct GatewayUser
+{
+    char name[64];
+    char topic[72]; // [USER]_Control
+    int connection; // Index Of The Shared Connection Holding The Subscription
+    int active; // Hosted (0 = Logged Out, The Slot Is Reused Once Idle)
+    int next; // Hash Chain (Index, -1 = End)
+    LinkedList mailbox; // Adopted Event Payloads (Bounded, LIST_BLOCK)
+    pthread_mutex_t lock; // state / rerun / frontend
+    int state;
+    int rerun; // Events Arrived While RUNNING
+    int frontend; // Socket Notified (-1 = None)
+} GatewayUser;
+
+// Worker Queue (Ring Of Users: The Owner Pops The Oldest, Thieves Take The Newest)
+
+typedef struct
+{
+    GatewayUser** ring; // Capacity = Max Users (A User Is Queued At Most Once)
+    int head;
+    int size;
+    pthread_mutex_t lock;
+} Deque_g;
+
+typedef struct Gateway Gateway;
+
+typedef struct
+{
+    Gateway* gateway;
+    int index;
+    pthread_t thread;
+    Deque_g queue;
+    AgentBatch* batch; // Allocated By startGateway() (A Worker That Cannot Run Fails The Startup)
+    unsigned long long handled; // Written By This Worker Only (Read Loosely By STATS)
+    unsigned long long publishes;
+    unsigned long long steals;
+    unsigned long long notices_dropped;
+} Worker_g;
+
+typedef struct
+{
+    Gateway* gateway;
+    int index;
+    MQTTAsync client;
+    volatile int connected;
+} Connection_g;
+
+struct Gateway
+{
+    Connection_g* connections;
+    int connection_count;
+    Worker_g* workers;
+    int worker_count;
+
+    GatewayUser** users; // Slots (Allocated On First Use, Never Freed Before Shutdown)
+    int user_slots; // Slots Used
+    int user_count; // Active Users
+    int max_users;
+    int* buckets; // Hash Of [USER]_Control > First Slot (-1 = Empty)
+    int bucket_mask;
+    pthread_mutex_t lock; // users / buckets / counts
+
+    pthread_mutex_t wake_lock; // Idle Workers Sleep Here
+    pthread_cond_t wake;
+    int queued; // Users Waiting In Any Queue
+    volatile int stopping;
+};
+
+// Flags
+
+static volatile sig_atomic_t stop_g = 0; // SIGINT / SIGTERM
+
+// Function Prototypes
+
+void onConnect_g(void* context_, MQTTAsync_successData* response);
+void onConnectFailure_g(void* context_, MQTTAsync_failureData* response);
+void connectionLost_g(void *context_, char *cause);
+int messageArrived_g(void *context_, char *topicName, int topicLen, MQTTAsync_message *message);
+void onSubscribeFailure_g(void* context_, MQTTAsync_failureData* response);
+
+// Helpers
+
+static void sleepMs(int ms)
+{
+    usleep((useconds_t)ms * 1000);
+}
+
+static uint32_t hashName(const char* name) // FNV-1a
+{
+    uint32_t hash = 2166136261u;
+    for (; *name; name++)
+    {
+        hash ^= (unsigned char)*name;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void onSignal(int sig)
+{
+    (void)sig;
+    stop_g = 1;
+}
+
+// Frontend Notifications (Non-Blocking, Caller Holds user->lock So The Socket Stays Open)
+
+static int notifyFrontend(GatewayUser* user, const char* line, int len)
+{
+    if (user->frontend < 0)
+        return 1;
+    return send(user->frontend, line, len, MSG_DONTWAIT | MSG_NOSIGNAL) == len;
+}
+
+static void notifyEvent(Worker_g* worker, GatewayUser* user, const char* payload, int len)
+{
+    Event event;
+    char line[GATEWAY_NOTICE_MAX];
+
+    if (!eventDecode(payload, len, &event) || event.type == EVENT_PING || event.type == EVENT_PONG) // Clock Exchange: Not For The Frontend
+        return;
+
+    char* text = eventRepack(EVENT_WIRE_TEXT, event.type, &event);
+    if (!text)
+        return;
+    int n = snprintf(line, sizeof(line), "EVENT %s %s\n", user->name, text);
+    free(text);
+
+    pthread_mutex_lock(&user->lock);
+    if (n > 0 && n < (int)sizeof(line) && !notifyFrontend(user, line, n))
+        worker->notices_dropped++;
+    pthread_mutex_unlock(&user->lock);
+}
+
+static void notifyChat_g(void* owner, const char* name, const char* link, int is_group) // AgentChatHook
+{
+    GatewayUser* user = (GatewayUser*)owner;
+    char line[GATEWAY_NOTICE_MAX];
+
+    int n = snprintf(line, sizeof(line), "CHAT %s %s %s %s\n", user->name, name, link, is_group ? "G" : "U");
+
+    pthread_mutex_lock(&user->lock);
+    if (n > 0 && n < (int)sizeof(line))
+        notifyFrontend(user, line, n);
+    pthread_mutex_unlock(&user->lock);
+}
+
+// Worker Queues
+
+static void dequePush(Gateway* gateway, Deque_g* deque, GatewayUser* user)
+{
+    pthread_mutex_lock(&deque->lock);
+    deque->ring[(deque->head + deque->size) % gateway->max_users] = user;
+    deque->size++;
+    pthread_mutex_unlock(&deque->lock);
+
+    pthread_mutex_lock(&gateway->wake_lock);
+    gateway->queued++;
+    pthread_cond_signal(&gateway->wake);
+    pthread_mutex_unlock(&gateway->wake_lock);
+}
+
+static GatewayUser* dequeTake(Gateway* gateway, Deque_g* deque, int oldest)
+{
+    GatewayUser* user = NULL;
+
+    pthread_mutex_lock(&deque->lock);
+    if (deque->size > 0)
+    {
+        if (oldest)
+        {
+            user = deque->ring[deque->head];
+            deque->head = (deque->head + 1) % gateway->max_users;
+        }
+        else
+            user = deque->ring[(deque->head + deque->size - 1) % gateway->max_users];
+        deque->size--;
+    }
+    pthread_mutex_unlock(&deque->lock);
+
+    if (user)
+    {
+        pthread_mutex_lock(&gateway->wake_lock);
+        gateway->queued--;
+        pthread_mutex_unlock(&gateway->wake_lock);
+    }
+    return user;
+}
+
+// Queues The User On Its Home Worker Unless It Is Already Queued / Running
+static void scheduleUser(Gateway* gateway, GatewayUser* user, int slot)
+{
+    pthread_mutex_lock(&user->lock);
+    if (user->state == USER_RUNNING)
+    {
+        user->rerun = 1; // The Running Worker Queues It Again
+        pthread_mutex_unlock(&user->lock);
+        return;
+    }
+    if (user->state == USER_QUEUED)
+    {
+        pthread_mutex_unlock(&user->lock);
+        return;
+    }
+    user->state = USER_QUEUED;
+    pthread_mutex_unlock(&user->lock);
+
+    dequePush(gateway, &gateway->workers[slot % gateway->worker_count].queue, user);
+}
+
+// Next User For This Worker: Its Own Queue First, Then The Newest User Of Another Worker
+static GatewayUser* nextUser(Worker_g* worker)
+{
+    Gateway* gateway = worker->gateway;
+    GatewayUser* user = dequeTake(gateway, &worker->queue, 1);
+
+    for (int i = 1; !user && i < gateway->worker_count; i++)
+    {
+        user = dequeTake(gateway, &gateway->workers[(worker->index + i) % gateway->worker_count].queue, 0);
+        if (user)
+            worker->steals++;
+    }
+    return user;
+}
+
+// Runs One User: Up To AGENT_BATCH_MAX Events, Their Publishes Flushed Together
+static void runUser(Worker_g* worker, AgentBatch* batch, GatewayUser* user)
+{
+    Gateway* gateway = worker->gateway;
+    MessageView view;
+    int handled = 0;
+
+    pthread_mutex_lock(&user->lock);
+    user->state = USER_RUNNING;
+    user->rerun = 0;
+    pthread_mutex_unlock(&user->lock);
+
+    batch->client = gateway->connections[user->connection].client;
+    batch->control_topic = user->topic;
+    batch->owner = user;
+
+    while (handled < AGENT_BATCH_MAX && listPopView(&user->mailbox, &view))
+    {
+        if (user->active && agentHandle(batch, view.data, view.length))
+            notifyEvent(worker, user, view.data, view.length);
+        viewRelease(&view);
+        handled++;
+    }
+
+    worker->handled += handled;
+    worker->publishes += batch->count;
+    agentFlush(batch);
+
+    // More Work Arrived (Or Left Over): Back Of This Worker's Queue, Others May Steal It
+
+    pthread_mutex_lock(&user->lock);
+    int again = user->rerun || listGetStats(&user->mailbox).count > 0;
+    user->state = again ? USER_QUEUED : USER_IDLE;
+    pthread_mutex_unlock(&user->lock);
+
+    if (again)
+        dequePush(gateway, &worker->queue, user);
+}
+
+static void* workerThread_g(void* worker_)
+{
+    Worker_g* worker = (Worker_g*)worker_;
+    Gateway* gateway = worker->gateway;
+    AgentBatch* batch = worker->batch;
+
+    while (1)
+    {
+        GatewayUser* user = nextUser(worker);
+        if (user)
+        {
+            runUser(worker, batch, user);
+            continue;
+        }
+
+        // Nothing Queued Anywhere: Sleep Until A User Is Queued
+
+        pthread_mutex_lock(&gateway->wake_lock);
+        if (gateway->stopping && gateway->queued == 0)
+        {
+            pthread_mutex_unlock(&gateway->wake_lock);
+            break;
+        }
+        if (gateway->queued == 0)
+        {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += DELAY_100_MS_MS * 1000000L;
+            if (deadline.tv_nsec >= 1000000000L)
+            {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&gateway->wake, &gateway->wake_lock, &deadline);
+        }
+        pthread_mutex_unlock(&gateway->wake_lock);
+    }
+
+    return NULL;
+}
+
+// Users (Caller Holds gateway->lock)
+
+static int findUser(Gateway* gateway, const char* topic)
+{
+    int slot = gateway->buckets[hashName(topic) & gateway->bucket_mask];
+    while (slot >= 0 && strcmp(gateway->users[slot]->topic, topic) != 0)
+        slot = gateway->users[slot]->next;
+    return slot;
+}
+
+static void unlinkUser(Gateway* gateway, int slot)
+{
+    int* link = &gateway->buckets[hashName(gateway->users[slot]->topic) & gateway->bucket_mask];
+    while (*link >= 0 && *link != slot)
+        link = &gateway->users[*link]->next;
+    if (*link == slot)
+        *link = gateway->users[slot]->next;
+}
+
+// Free Slot: A New One While There Is Room, Else A Logged Out User Whose Mailbox Drained
+static int reserveSlot(Gateway* gateway)
+{
+    if (gateway->user_slots < gateway->max_users)
+    {
+        GatewayUser* user = calloc(1, sizeof(GatewayUser));
+        if (!user)
+            return -1;
+        listInit(&user->mailbox);
+        listSetName(&user->mailbox, "mailbox");
+        listSetLimit(&user->mailbox, GATEWAY_MAILBOX_MAX, LIST_BLOCK);
+        pthread_mutex_init(&user->lock, NULL);
+        user->frontend = -1;
+        gateway->users[gateway->user_slots] = user;
+        return gateway->user_slots++;
+    }
+
+    for (int i = 0; i < gateway->user_slots; i++)
+    {
+        GatewayUser* user = gateway->users[i];
+        if (user->active || user->name[0] == '\0')
+            continue;
+        pthread_mutex_lock(&user->lock);
+        int idle = user->state == USER_IDLE && listGetStats(&user->mailbox).count == 0;
+        pthread_mutex_unlock(&user->lock);
+        if (idle)
+            return i;
+    }
+    return -1;
+}
+
+static void subscribeTopics(Connection_g* connection, char* const* topics, int count)
+{
+    MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer; // Response Options (... = [Default Initializer Macro])
+    int qos[GATEWAY_SUBSCRIBE_BATCH];
+    int rc;
+
+    for (int i = 0; i < count; i++)
+        qos[i] = QOS;
+
+    opts.onFailure = onSubscribeFailure_g;
+    opts.context = connection;
+
+    if ((rc = transportSubscribeMany(connection->client, count, topics, qos, &opts)) != MQTTASYNC_SUCCESS)
+    {
+        if (LOG_ENABLED)
+            printf("               [LOG] GATEWAY: Failed to start subscribe (%d topics), return code %d\n", count, rc);
+    }
+}
+
+// "LOGIN [USER]": Hosts The User (Or Re-Attaches The Frontend)
+static const char* loginUser(Gateway* gateway, const char* name, int frontend)
+{
+    char topic[72];
+    snprintf(topic, sizeof(topic), "%s_Control", name);
+
+    pthread_mutex_lock(&gateway->lock);
+    int slot = findUser(gateway, topic);
+    int created = slot < 0;
+    if (created && (slot = reserveSlot(gateway)) < 0)
+    {
+        pthread_mutex_unlock(&gateway->lock);
+        return "ERR LOTADO";
+    }
+
+    GatewayUser* user = gateway->users[slot];
+    if (created)
+    {
+        snprintf(user->name, sizeof(user->name), "%s", name);
+        snprintf(user->topic, sizeof(user->topic), "%s", topic);
+        user->connection = (int)(hashName(name) % (uint32_t)gateway->connection_count);
+        user->next = gateway->buckets[hashName(topic) & gateway->bucket_mask];
+        gateway->buckets[hashName(topic) & gateway->bucket_mask] = slot;
+        user->active = 1;
+        gateway->user_count++;
+    }
+    pthread_mutex_unlock(&gateway->lock);
+
+    pthread_mutex_lock(&user->lock);
+    user->frontend = frontend;
+    pthread_mutex_unlock(&user->lock);
+
+    // One Subscription On The User's Shared Connection (Also Restored By onConnect_g After A Reconnect)
+
+    Connection_g* connection = &gateway->connections[user->connection];
+    if (created && connection->connected)
+    {
+        char* topics[1] = { user->topic };
+        subscribeTopics(connection, topics, 1);
+    }
+
+    if (LOG_ENABLED)
+        printf("               [LOG] GATEWAY: %s hosted on connection %d\n", name, user->connection);
+    return "OK LOGIN";
+}
+
+// "LOGOUT [USER]": Unsubscribes, Events Still Queued Are Discarded By The Worker
+static const char* logoutUser(Gateway* gateway, const char* name)
+{
+    char topic[72];
+    snprintf(topic, sizeof(topic), "%s_Control", name);
+
+    pthread_mutex_lock(&gateway->lock);
+    int slot = findUser(gateway, topic);
+    if (slot < 0)
+    {
+        pthread_mutex_unlock(&gateway->lock);
+        return "ERR DESCONHECIDO";
+    }
+    GatewayUser* user = gateway->users[slot];
+    unlinkUser(gateway, slot);
+    user->active = 0;
+    gateway->user_count--;
+    pthread_mutex_unlock(&gateway->lock);
+
+    pthread_mutex_lock(&user->lock);
+    user->frontend = -1;
+    pthread_mutex_unlock(&user->lock);
+
+    Connection_g* connection = &gateway->connections[user->connection];
+    if (connection->connected)
+        transportUnsubscribe(connection->client, topic, NULL);
+
+    return "OK LOGOUT";
+}
+
+// Frontend Closed: Its Users Keep Running, Without Notifications
+static void detachFrontend(Gateway* gateway, int frontend)
+{
+    pthread_mutex_lock(&gateway->lock);
+    for (int i = 0; i < gateway->user_slots; i++)
+    {
+        GatewayUser* user = gateway->users[i];
+        pthread_mutex_lock(&user->lock);
+        if (user->frontend == frontend)
+            user->frontend = -1;
+        pthread_mutex_unlock(&user->lock);
+    }
+    pthread_mutex_unlock(&gateway->lock);
+}
+
+static void printStats(Gateway* gateway, char* out, size_t size)
+{
+    unsigned long long handled = 0, publishes = 0, steals = 0, dropped = 0;
+    int connected = 0;
+
+    for (int i = 0; i < gateway->worker_count; i++)
+    {
+        handled += gateway->workers[i].handled;
+        publishes += gateway->workers[i].publishes;
+        steals += gateway->workers[i].steals;
+        dropped += gateway->workers[i].notices_dropped;
+    }
+    for (int i = 0; i < gateway->connection_count; i++)
+        connected += gateway->connections[i].connected == 1;
+
+    pthread_mutex_lock(&gateway->wake_lock);
+    int queued = gateway->queued;
+    pthread_mutex_unlock(&gateway->wake_lock);
+
+    pthread_mutex_lock(&gateway->lock);
+    snprintf(out, size, "OK STATS users=%d slots=%d/%d connections=%d/%d workers=%d queued=%d handled=%llu publishes=%llu steals=%llu notices_dropped=%llu",
+             gateway->user_count, gateway->user_slots, gateway->max_users, connected, gateway->connection_count,
+             gateway->worker_count, queued, handled, publishes, steals, dropped);
+    pthread_mutex_unlock(&gateway->lock);
+}
+
+// Callbacks
+
+void connectionLost_g(void *context_, char *cause) // Connection Lost
+{
+    Connection_g* connection = (Connection_g*)context_;
+    MQTTAsync_connectOptions conn_opts = MQTTAsync_connectOptions_initializer; // Connection Options (... = [Default Initializer Macro])
+    int rc;
+
+    if (LOG_ENABLED)
+    {
+        printf("\n               [LOG] GATEWAY: Connection %d lost\n", connection->index);
+        if (cause)
+            printf("     cause: %s\n", cause);
+        printf("               [LOG] GATEWAY: Reconnecting\n");
+    }
+    connection->connected = 0;
+
+    conn_opts.keepAliveInterval = 30;
+    conn_opts.cleansession = 1;
+    conn_opts.onSuccess = onConnect_g;
+    conn_opts.onFailure = onConnectFailure_g;
+    conn_opts.context = connection;
+
+    if ((rc = transportConnect(connection->client, &conn_opts)) != MQTTASYNC_SUCCESS)
+        printf("GATEWAY: Falha Ao Reconectar (Conexão %d), rc %d\n", connection->index, rc);
+}
+
+static void releaseMessage_g(void* message_) // Worker Done With The Event
+{
+    MQTTAsync_message* message = (MQTTAsync_message*)message_;
+    transportFreeMessage(&message);
+}
+
+int messageArrived_g(void *context_, char *topicName, int topicLen, MQTTAsync_message *message) // Message Arrived
+{
+    Connection_g* connection = (Connection_g*)context_;
+    Gateway* gateway = connection->gateway;
+
+    if (LOG_ENABLED)
+    {
+        printf("\n               [LOG] GATEWAY: Message arrived on connection %d\n", connection->index);
+        printf("               [LOG]      Topic: %s\n", topicName);
+    }
+
+    // Route To The User's Mailbox (Decode Check Only, The Worker Handles It)
+
+    pthread_mutex_lock(&gateway->lock);
+    int slot = findUser(gateway, topicName);
+    GatewayUser* user = slot >= 0 ? gateway->users[slot] : NULL;
+    pthread_mutex_unlock(&gateway->lock);
+
+    if (user && agentAccepts((const char*)message->payload, message->payloadlen))
+    {
+        MessageBuffer* buffer = bufferAdopt((char*)message->payload, message->payloadlen, releaseMessage_g, message);
+        listInsertView(&user->mailbox, buffer, buffer ? buffer->data : NULL, message->payloadlen); // Blocks While The Mailbox Is Full
+        bufferRelease(buffer);
+        scheduleUser(gateway, user, slot);
+    }
+    else
+    {
+        if (LOG_ENABLED)
+            printf("               [LOG] GATEWAY: Message for unknown user or malformed event ignored\n");
+        transportFreeMessage(&message);
+    }
+
+    return 1;
+}
+
+void onSubscribeFailure_g(void* context_, MQTTAsync_failureData* response) // Fails To Subscribe
+{
+    Connection_g* connection = (Connection_g*)context_;
+    printf("GATEWAY: Falha Na Inscrição (Conexão %d), rc %d\n", connection->index, response ? response->code : 0);
+}
+
+void onConnectFailure_g(void* context_, MQTTAsync_failureData* response) // Fails To Connect
+{
+    Connection_g* connection = (Connection_g*)context_;
+    if (LOG_ENABLED)
+        printf("               [LOG] GATEWAY: Connect failed on connection %d, rc %d\n", connection->index, response ? response->code : 0);
+    connection->connected = -1;
+}
+
+void onConnect_g(void* context_, MQTTAsync_successData* response) // Connected Successfuly
+{
+    Connection_g* connection = (Connection_g*)context_;
+    Gateway* gateway = connection->gateway;
+    char* topics[GATEWAY_SUBSCRIBE_BATCH];
+    int count = 0;
+
+    if (LOG_ENABLED)
+        printf("               [LOG] GATEWAY: Connection %d established\n", connection->index);
+
+    // (Re)Subscribe Every User Hosted On This Connection, GATEWAY_SUBSCRIBE_BATCH Topics Per SUBSCRIBE
+    // (Paho Copies The Topic Strings, gateway->lock Keeps Them Stable Until Then)
+
+    pthread_mutex_lock(&gateway->lock);
+    connection->connected = 1;
+    for (int i = 0; i < gateway->user_slots; i++)
+    {
+        GatewayUser* user = gateway->users[i];
+        if (!user->active || user->connection != connection->index)
+            continue;
+        topics[count++] = user->topic;
+        if (count == GATEWAY_SUBSCRIBE_BATCH)
+        {
+            subscribeTopics(connection, topics, count);
+            count = 0;
+        }
+    }
+    if (count > 0)
+        subscribeTopics(connection, topics, count);
+    pthread_mutex_unlock(&gateway->lock);
+}
+
+// Gateway Lifecycle
+
+static int startGateway(Gateway* gateway, int connections, int workers, int max_users)
+{
+    memset(gateway, 0, sizeof(*gateway));
+    pthread_mutex_init(&gateway->lock, NULL);
+    pthread_mutex_init(&gateway->wake_lock, NULL);
+    pthread_cond_init(&gateway->wake, NULL);
+
+    int buckets = 1;
+    while (buckets < max_users * 2)
+        buckets <<= 1;
+
+    gateway->max_users = max_users;
+    gateway->bucket_mask = buckets - 1;
+    gateway->users = calloc(max_users, sizeof(GatewayUser*));
+    gateway->buckets = malloc(buckets * sizeof(int));
+    gateway->connections = calloc(connections, sizeof(Connection_g));
+    gateway->workers = calloc(workers, sizeof(Worker_g));
+    if (!gateway->users || !gateway->buckets || !gateway->connections || !gateway->workers)
+        return EXIT_FAILURE;
+    for (int i = 0; i < buckets; i++)
+        gateway->buckets[i] = -1;
+
+    // Workers
+
+    for (int i = 0; i < workers; i++)
+    {
+        Worker_g* worker = &gateway->workers[i];
+        worker->gateway = gateway;
+        worker->index = i;
+        worker->queue.ring = calloc(max_users, sizeof(GatewayUser*));
+        worker->batch = calloc(1, sizeof(AgentBatch));
+        pthread_mutex_init(&worker->queue.lock, NULL);
+        if (worker->batch)
+            worker->batch->on_chat = notifyChat_g;
+        if (!worker->queue.ring || !worker->batch || pthread_create(&worker->thread, NULL, workerThread_g, worker) != 0)
+        {
+            free(worker->queue.ring);
+            free(worker->batch);
+            pthread_mutex_destroy(&worker->queue.lock);
+            return EXIT_FAILURE;
+        }
+        gateway->worker_count++;
+    }
+
+    // Shared Connections
+
+    for (int i = 0; i < connections; i++)
+    {
+        Connection_g* connection = &gateway->connections[i];
+        MQTTAsync_connectOptions conn_opts = MQTTAsync_connectOptions_initializer; // Connection Options (... = [Default Initializer Macro])
+        char client_id[64];
+        int rc;
+
+        connection->gateway = gateway;
+        connection->index = i;
+        snprintf(client_id, sizeof(client_id), GATEWAY_CLIENT_ID, i);
+
+        if ((rc = transportCreate(&connection->client, ADDRESS, client_id, MQTTCLIENT_PERSISTENCE_NONE, NULL)) != MQTTASYNC_SUCCESS)
+        {
+            printf("GATEWAY: Falha Ao Criar Cliente %d, rc %d\n", i, rc);
+            return EXIT_FAILURE;
+        }
+        gateway->connection_count++;
+
+        if ((rc = transportSetCallbacks(connection->client, connection, connectionLost_g, messageArrived_g, NULL)) != MQTTASYNC_SUCCESS)
+        {
+            printf("GATEWAY: Falha Ao Definir Callbacks, rc %d\n", rc);
+            return EXIT_FAILURE;
+        }
+
+        conn_opts.keepAliveInterval = 30;
+        conn_opts.cleansession = 1; // Subscriptions Follow The Hosted Users (A User's Own Agent Session Is Left Untouched)
+        conn_opts.onSuccess = onConnect_g;
+        conn_opts.onFailure = onConnectFailure_g;
+        conn_opts.context = connection;
+
+        if ((rc = transportConnect(connection->client, &conn_opts)) != MQTTASYNC_SUCCESS)
+        {
+            printf("GATEWAY: Falha Ao Iniciar Conexão %d, rc %d\n", i, rc);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Wait For Every Connection
+
+    for (int i = 0; i < gateway->connection_count; i++)
+    {
+        while (gateway->connections[i].connected == 0)
+            sleepMs(DELAY_100_MS_MS);
+        if (gateway->connections[i].connected < 0)
+        {
+            printf("GATEWAY: Falha Ao Conectar Ao Broker (Conexão %d)\n", i);
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static void stopGateway(Gateway* gateway)
+{
+    // Workers Finish Every Queued User, Then The Connections Close
+
+    pthread_mutex_lock(&gateway->wake_lock);
+    gateway->stopping = 1;
+    pthread_cond_broadcast(&gateway->wake);
+    pthread_mutex_unlock(&gateway->wake_lock);
+
+    for (int i = 0; i < gateway->worker_count; i++)
+        pthread_join(gateway->workers[i].thread, NULL);
+
+    for (int i = 0; i < gateway->connection_count; i++)
+    {
+        MQTTAsync_disconnectOptions disc_opts = MQTTAsync_disconnectOptions_initializer; // Disconnection Options (... = [Default Initializer Macro])
+        disc_opts.timeout = DELAY_5_SEC_MS; // Lets The Last Batches Complete
+        if (gateway->connections[i].connected == 1)
+            transportDisconnect(gateway->connections[i].client, &disc_opts);
+    }
+    sleepMs(DELAY_100_MS_MS);
+    for (int i = 0; i < gateway->connection_count; i++)
+        transportDestroy(&gateway->connections[i].client);
+
+    // Memory Management (No More Callbacks)
+
+    for (int i = 0; i < gateway->user_slots; i++)
+    {
+        listDestroy(&gateway->users[i]->mailbox);
+        pthread_mutex_destroy(&gateway->users[i]->lock);
+        free(gateway->users[i]);
+    }
+    for (int i = 0; i < gateway->worker_count; i++)
+    {
+        free(gateway->workers[i].queue.ring);
+        free(gateway->workers[i].batch);
+        pthread_mutex_destroy(&gateway->workers[i].queue.lock);
+    }
+    free(gateway->users);
+    free(gateway->buckets);
+    free(gateway->connections);
+    free(gateway->workers);
+    pthread_cond_destroy(&gateway->wake);
+    pthread_mutex_destroy(&gateway->wake_lock);
+    pthread_mutex_destroy(&gateway->lock);
+}
+
+// Local Socket API
+
+typedef struct
+{
+    int fd;
+    char line[GATEWAY_LINE_MAX];
+    size_t len;
+} Frontend_g;
+
+static int listenSocket(const char* path)
+{
+    struct sockaddr_un addr;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+    unlink(path); // Left Behind By A Previous Run
+
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 64) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+    return fd;
+}
+
+// Never Blocks (One Frontend Not Reading Would Stall The Others) | 0 = Not Delivered
+static int reply(int fd, const char* text)
+{
+    char line[GATEWAY_NOTICE_MAX];
+    int n = snprintf(line, sizeof(line), "%s\n", text);
+    return send(fd, line, n, MSG_DONTWAIT | MSG_NOSIGNAL) == n;
+}
+
+// Returns 0 When The Frontend Must Be Closed (QUIT Or Reply Not Delivered)
+static int handleCommand(Gateway* gateway, int fd, char* line)
+{
+    char* command = strtok(line, " \t\r");
+    char* name = strtok(NULL, " \t\r");
+
+    if (!command)
+        return 1;
+
+    if (strcmp(command, "LOGIN") == 0 || strcmp(command, "LOGOUT") == 0)
+    {
+        if (!name || strlen(name) >= 64 || strpbrk(name, ":/+#;|"))
+            return reply(fd, "ERR USUARIO INVALIDO");
+        return reply(fd, command[3] == 'I' ? loginUser(gateway, name, fd) : logoutUser(gateway, name));
+    }
+    if (strcmp(command, "STATS") == 0)
+    {
+        char stats[GATEWAY_NOTICE_MAX];
+        printStats(gateway, stats, sizeof(stats));
+        return reply(fd, stats);
+    }
+    if (strcmp(command, "QUIT") == 0)
+        return 0;
+
+    return reply(fd, "ERR COMANDO");
+}
+
+static void serveFrontends(Gateway* gateway, int listen_fd)
+{
+    Frontend_g* frontends = calloc(GATEWAY_MAX_FRONTENDS, sizeof(Frontend_g));
+    struct pollfd fds[GATEWAY_MAX_FRONTENDS + 1];
+    int count = 0;
+
+    if (!frontends)
+        return;
+
+    while (!stop_g)
+    {
+        fds[0].fd = listen_fd;
+        fds[0].events = POLLIN;
+        for (int i = 0; i < count; i++)
+        {
+            fds[i + 1].fd = frontends[i].fd;
+            fds[i + 1].events = POLLIN;
+        }
+
+        if (poll(fds, count + 1, 500) < 0) // Wakes Up To Check stop_g
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        // New Frontends
+
+        if (fds[0].revents & POLLIN)
+        {
+            int fd;
+            while ((fd = accept(listen_fd, NULL, NULL)) >= 0)
+            {
+                if (count == GATEWAY_MAX_FRONTENDS)
+                {
+                    reply(fd, "ERR LOTADO");
+                    close(fd);
+                    continue;
+                }
+                int sndbuf = GATEWAY_SNDBUF;
+                setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+                frontends[count].fd = fd;
+                frontends[count].len = 0;
+                count++;
+            }
+        }
+
+        // Commands (Walked Backwards: Closed Frontends Are Replaced By The Last One)
+
+        for (int i = count - 1; i >= 0; i--)
+        {
+            if (!(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+
+            Frontend_g* frontend = &frontends[i];
+            char input[512];
+            ssize_t n = recv(frontend->fd, input, sizeof(input), 0);
+            int open = n > 0;
+
+            for (ssize_t j = 0; j < n && open; j++)
+            {
+                if (input[j] != '\n')
+                {
+                    if (frontend->len < sizeof(frontend->line) - 1) // Longer Lines Are Cut
+                        frontend->line[frontend->len++] = input[j];
+                    continue;
+                }
+                frontend->line[frontend->len] = '\0';
+                frontend->len = 0;
+                open = handleCommand(gateway, frontend->fd, frontend->line);
+            }
+
+            if (!open)
+            {
+                detachFrontend(gateway, frontend->fd);
+                close(frontend->fd);
+                frontends[i] = frontends[--count];
+            }
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        detachFrontend(gateway, frontends[i].fd);
+        close(frontends[i].fd);
+    }
+    free(frontends);
+}
+
+// Main Function
+
+int main(int argc, char* argv[])
+{
+    const char* socket_path = getenv("CHATMQTT_GATEWAY_SOCKET") ? getenv("CHATMQTT_GATEWAY_SOCKET") : DEFAULT_SOCKET;
+    int connections = DEFAULT_CONNECTIONS;
+    int workers = DEFAULT_WORKERS;
+    int max_users = DEFAULT_MAX_USERS;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:c:w:u:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 's': socket_path = optarg; break;
+            case 'c': connections = atoi(optarg); break;
+            case 'w': workers = atoi(optarg); break;
+            case 'u': max_users = atoi(optarg); break;
+            default:
+                printf("Uso: %s [-s SOCKET] [-c CONEXOES] [-w WORKERS] [-u USUARIOS]\n"
+                       "  -s  Socket Local Dos Frontends (Padrão: %s)\n"
+                       "  -c  Conexões Compartilhadas Com O Broker (Padrão: %d)\n"
+                       "  -w  Threads De Trabalho (Padrão: %d)\n"
+                       "  -u  Máximo De Usuários Hospedados (Padrão: %d)\n",
+                       argv[0], DEFAULT_SOCKET, DEFAULT_CONNECTIONS, DEFAULT_WORKERS, DEFAULT_MAX_USERS);
+                return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (connections <= 0) connections = DEFAULT_CONNECTIONS;
+    if (workers <= 0) workers = DEFAULT_WORKERS;
+    if (max_users <= 0) max_users = DEFAULT_MAX_USERS;
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+    traceInit(); // CHATMQTT_TRACE / SIGUSR1 / SIGUSR2 (trace.h)
+
+    Gateway* gateway = calloc(1, sizeof(Gateway));
+    if (!gateway)
+        return EXIT_FAILURE;
+
+    if (startGateway(gateway, connections, workers, max_users) != EXIT_SUCCESS)
+    {
+        printf("GATEWAY: Falha Ao Iniciar\n");
+        stopGateway(gateway);
+        free(gateway);
+        return EXIT_FAILURE;
+    }
+
+    int listen_fd = listenSocket(socket_path);
+    if (listen_fd < 0)
+    {
+        printf("GATEWAY: Falha Ao Abrir O Socket \"%s\"\n", socket_path);
+        stopGateway(gateway);
+        free(gateway);
+        return EXIT_FAILURE;
+    }
+
+    printf("GATEWAY: Pronto Em \"%s\" (%d Conexões, %d Workers, Até %d Usuários)\n", socket_path, connections, workers, max_users);
+
+    serveFrontends(gateway, listen_fd);
+
+    close(listen_fd);
+    unlink(socket_path);
+    stopGateway(gateway);
+    free(gateway);
+
+    printf("GATEWAY: Encerrado\n");
+    return EXIT_SUCCESS;
+}
+
+#else
+
+int main(void)
+{
+    printf("GATEWAY: Disponível Apenas Em Sistemas POSIX (Socket UNIX)\n");
+    return EXIT_FAILURE;
+}
+
+#endif
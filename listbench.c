@@ -0,0 +1,840 @@
+// Compilation Command: "gcc -O2 listbench.c messages.c events.c memory.c -o listbench -pthread"
+// Excecution Command: "./listbench [-n SIZES] [-c CORPORA] [-k OPERATIONS] [-t BUDGET_MS] [-j]"
+//
+// Microbenchmarks For The List / Parsing Layer (messages.c) | No Broker, No Network
+// - status  > "[USER]:Online|Offline" (USERS/ As getUsers() Keeps It)
+// - groups  > "[GROUP]:[LEADER]:[MEMBER];[MEMBER];..." (GROUPS/)
+// - history > Events Packed In The Configured Wire Format (HISTORY/ And REQUESTS/, events.h)
+// Every List Operation Is Timed Over Corpora Of 1k..1M Entries (Print Functions Write To /dev/null),
+// Reported As ns/op And Allocations/op (malloc Family Counted Under glibc, "n/d" Elsewhere)
+// Candidates Replacing The Linear Scans Run Side By Side Over The Same Corpus:
+// - index > Open-Addressing Hash Over The First Field (Lookups By User / Group / Conversation Target)
+// - queue > Oldest-First Links With A Tail Pointer (listPopLast / listPopView Without Walking The List)
+// Output: A Table, Or One JSON Object Per Line With -j For Regression Tracking
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include "messages.h"
+#include "events.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <fcntl.h>
+#else
+#include <io.h>
+#include <fcntl.h>
+#define dup _dup
+#define dup2 _dup2
+#define close _close
+#define open _open
+#endif
+
+// Parameters
+
+#define DEFAULT_SIZES      "1000,10000,100000,1000000"
+#define DEFAULT_CORPORA    "status,groups,history"
+#define DEFAULT_OPERATIONS 10000 // Most Calls Per Measurement
+#define DEFAULT_BUDGET_MS  300 // Longest Time Per Measurement (The O(n) Scans Stop Early On Large Corpora)
+#define MIN_OPERATIONS     3
+#define GROUP_MEMBERS      4
+#define NULL_DEVICE        "/dev/null"
+
+// Allocation Counting (glibc Only: Interposes The malloc Family, Forwards To The Real Allocator)
+
+static int json_output = 0;
+static unsigned long alloc_calls = 0;
+static unsigned long alloc_bytes = 0;
+
+#if defined(__GLIBC__) && !defined(LISTBENCH_NO_ALLOC_COUNT)
+#define ALLOC_COUNTED 1
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+
+void* malloc(size_t size)
+{
+    alloc_calls++;
+    alloc_bytes += size;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    alloc_calls++;
+    alloc_bytes += count * size;
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    alloc_calls++;
+    alloc_bytes += size;
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr)
+{
+    __libc_free(ptr);
+}
+#else
+#define ALLOC_COUNTED 0
+#endif
+
+// Data Structures
+
+typedef struct
+{
+    const char* corpus;
+    const char* operation;
+    const char* impl; // "list" (messages.c) | "index" | "queue" (Candidates)
+    long size;
+    long operations;
+    double ns_per_op;
+    double allocs_per_op;
+    double bytes_per_op;
+} ListBenchResult;
+
+typedef struct // Timed Section: Operations Done, Elapsed Time And Allocations Inside
+{
+    uint64_t start_ns;
+    uint64_t budget_ns;
+    unsigned long calls;
+    unsigned long bytes;
+    long operations;
+    long limit;
+} Meter;
+
+typedef struct // Candidate: Open-Addressing Hash, Key = First Field Of The Entry (Newest Entry Wins, As The Head-First Scans Do)
+{
+    Node** slots;
+    unsigned long mask;
+    long count;
+} FieldIndex;
+
+typedef struct // Candidate: Oldest-First Singly Linked Queue With A Tail Pointer
+{
+    Node* head; // Oldest
+    Node* tail; // Newest
+    long count;
+} TailQueue;
+
+// Helpers
+
+static uint64_t nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static uint64_t nextRandom(void) // xorshift64* (Same Targets On Every Run)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1Dull;
+}
+
+static long randomBelow(long bound)
+{
+    return (long)(nextRandom() % (uint64_t)bound);
+}
+
+static int hasItem(const char* items, const char* name)
+{
+    size_t len = strlen(name);
+    for (const char* p = items; (p = strstr(p, name)) != NULL; p += len)
+        if ((p == items || p[-1] == ',') && (p[len] == '\0' || p[len] == ','))
+            return 1;
+    return 0;
+}
+
+static int stdout_saved = -1;
+
+static void outputMute(void) // Print Functions Run Against /dev/null (Their Formatting Is Timed, Not The Terminal)
+{
+    fflush(stdout);
+    int null_fd = open(NULL_DEVICE, O_WRONLY);
+    if (null_fd < 0)
+        return;
+    stdout_saved = dup(1);
+    dup2(null_fd, 1);
+    close(null_fd);
+}
+
+static void outputRestore(void)
+{
+    fflush(stdout);
+    if (stdout_saved < 0)
+        return;
+    dup2(stdout_saved, 1);
+    close(stdout_saved);
+    stdout_saved = -1;
+}
+
+// Measurement
+
+static void meterStart(Meter* meter, long limit, int budget_ms)
+{
+    meter->operations = 0;
+    meter->limit = limit > 0 ? limit : 1;
+    meter->budget_ns = (uint64_t)budget_ms * 1000000ull;
+    meter->calls = alloc_calls;
+    meter->bytes = alloc_bytes;
+    meter->start_ns = nowNs();
+}
+
+static int meterNext(Meter* meter) // Keep Going Until The Limit, Or The Budget Once MIN_OPERATIONS Were Done (0 = No Budget)
+{
+    if (meter->operations >= meter->limit)
+        return 0;
+    if (meter->budget_ns && meter->operations >= MIN_OPERATIONS && nowNs() - meter->start_ns >= meter->budget_ns)
+        return 0;
+    meter->operations++;
+    return 1;
+}
+
+static void report(const char* corpus, const char* operation, const char* impl, long size, Meter* meter)
+{
+    uint64_t elapsed = nowNs() - meter->start_ns;
+    ListBenchResult result;
+    result.corpus = corpus;
+    result.operation = operation;
+    result.impl = impl;
+    result.size = size;
+    result.operations = meter->operations;
+    result.ns_per_op = meter->operations ? (double)elapsed / meter->operations : 0;
+    result.allocs_per_op = meter->operations ? (double)(alloc_calls - meter->calls) / meter->operations : 0;
+    result.bytes_per_op = meter->operations ? (double)(alloc_bytes - meter->bytes) / meter->operations : 0;
+
+    if (json_output)
+    {
+        printf("{\"corpus\":\"%s\",\"operation\":\"%s\",\"impl\":\"%s\",\"size\":%ld,\"operations\":%ld,\"ns_per_op\":%.1f",
+               result.corpus, result.operation, result.impl, result.size, result.operations, result.ns_per_op);
+        if (ALLOC_COUNTED)
+            printf(",\"allocs_per_op\":%.2f,\"bytes_per_op\":%.1f}\n", result.allocs_per_op, result.bytes_per_op);
+        else
+            printf(",\"allocs_per_op\":null,\"bytes_per_op\":null}\n");
+    }
+    else
+    {
+        printf("%-8s %-26s %-6s %9ld %9ld %14.1f", result.corpus, result.operation, result.impl, result.size, result.operations, result.ns_per_op);
+        if (ALLOC_COUNTED)
+            printf(" %10.2f %10.1f\n", result.allocs_per_op, result.bytes_per_op);
+        else
+            printf(" %10s %10s\n", "n/d", "n/d");
+    }
+    fflush(stdout);
+}
+
+// Candidate: Field Index
+
+static int firstField(const Node* node, char delimiter, const char** field) // Length Of Field 0 (Up To delimiter)
+{
+    const char* end = memchr(node->message, delimiter, node->length);
+    *field = node->message;
+    return end ? (int)(end - node->message) : node->length;
+}
+
+static uint32_t hashBytes(const char* data, int length) // FNV-1a
+{
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static int eventKey(const Node* node, const char** key) // History: Field 0 Of Events That Open A Conversation (-1 = Not Indexed)
+{
+    Event event;
+    *key = NULL;
+    if (!eventDecode(node->message, node->length, &event) || event_schema[event.type].chat_link < 0)
+        return -1;
+    *key = event.fields[0].ptr;
+    return event.fields[0].len;
+}
+
+static int nodeKey(const Node* node, int history, const char** key)
+{
+    return history ? eventKey(node, key) : firstField(node, ':', key);
+}
+
+static void indexBuild(FieldIndex* index, const LinkedList* list, long count, int history)
+{
+    unsigned long slots = 16;
+    while (slots < (unsigned long)count * 2)
+        slots <<= 1;
+    index->slots = calloc(slots, sizeof(Node*));
+    index->mask = slots - 1;
+    index->count = 0;
+
+    for (Node* curr = list->head; curr; curr = curr->next) // Head = Newest: An Occupied Key Keeps The Newer Entry
+    {
+        const char* key;
+        int key_len = nodeKey(curr, history, &key);
+        if (key_len <= 0)
+            continue;
+        unsigned long slot = hashBytes(key, key_len) & index->mask;
+        for (;; slot = (slot + 1) & index->mask)
+        {
+            Node* held = index->slots[slot];
+            if (!held)
+            {
+                index->slots[slot] = curr;
+                index->count++;
+                break;
+            }
+            const char* held_key;
+            int held_len = nodeKey(held, history, &held_key);
+            if (held_len == key_len && memcmp(held_key, key, key_len) == 0)
+                break;
+        }
+    }
+}
+
+static Node* indexFind(const FieldIndex* index, const char* key, int history)
+{
+    int key_len = (int)strlen(key);
+    for (unsigned long slot = hashBytes(key, key_len) & index->mask; index->slots[slot]; slot = (slot + 1) & index->mask)
+    {
+        const char* held_key;
+        int held_len = nodeKey(index->slots[slot], history, &held_key);
+        if (held_len == key_len && memcmp(held_key, key, key_len) == 0)
+            return index->slots[slot];
+    }
+    return NULL;
+}
+
+static void indexDestroy(FieldIndex* index)
+{
+    free(index->slots);
+    index->slots = NULL;
+}
+
+static char* groupLeaderIndexed(const FieldIndex* index, const char* group) // Same Result As listGetGroupLeader()
+{
+    Node* node = indexFind(index, group, 0);
+    if (!node)
+        return NULL;
+    const char* leader = memchr(node->message, ':', node->length);
+    if (!leader)
+        return NULL;
+    leader++;
+    const char* end = memchr(leader, ':', node->length - (leader - node->message));
+    int leader_len = end ? (int)(end - leader) : node->length - (int)(leader - node->message);
+    char* result = malloc(leader_len + 1);
+    if (result)
+    {
+        memcpy(result, leader, leader_len);
+        result[leader_len] = '\0';
+    }
+    return result;
+}
+
+static char* topicIndexed(const FieldIndex* index, const char* target) // Same Result As listGetTopic()
+{
+    Node* node = indexFind(index, target, 1);
+    Event event;
+    if (!node || !eventDecode(node->message, node->length, &event))
+        return NULL;
+    const EventField* topic = &event.fields[event_schema[event.type].chat_link];
+    char* result = malloc(topic->len + 1);
+    if (result)
+    {
+        memcpy(result, topic->ptr, topic->len);
+        result[topic->len] = '\0';
+    }
+    return result;
+}
+
+// Candidate: Tail Queue
+
+static void queuePush(TailQueue* queue, const char* message) // Same Allocations As listInsert(): Buffer Copy + Node
+{
+    int length = (int)strlen(message);
+    Node* node = malloc(sizeof(Node));
+    node->buffer = bufferCopy(message, length);
+    node->message = node->buffer->data;
+    node->length = length;
+    node->next = NULL;
+    if (queue->tail)
+        queue->tail->next = node;
+    else
+        queue->head = node;
+    queue->tail = node;
+    queue->count++;
+}
+
+static char* queuePop(TailQueue* queue) // Same Result As listPopLast()
+{
+    Node* node = queue->head;
+    if (!node)
+        return NULL;
+    queue->head = node->next;
+    if (!queue->head)
+        queue->tail = NULL;
+    queue->count--;
+    char* result = malloc(node->length + 1);
+    if (result)
+    {
+        memcpy(result, node->message, node->length);
+        result[node->length] = '\0';
+    }
+    bufferRelease(node->buffer);
+    free(node);
+    return result;
+}
+
+static void queueClear(TailQueue* queue)
+{
+    while (queue->head)
+    {
+        Node* node = queue->head;
+        queue->head = node->next;
+        bufferRelease(node->buffer);
+        free(node);
+    }
+    queue->tail = NULL;
+    queue->count = 0;
+}
+
+// Corpora
+
+static void userName(char* out, size_t size, long i)
+{
+    snprintf(out, size, "user%07ld", i);
+}
+
+static void groupName(char* out, size_t size, long i)
+{
+    snprintf(out, size, "group%07ld", i);
+}
+
+static void statusEntry(char* out, size_t size, long i)
+{
+    snprintf(out, size, "user%07ld:%s", i, (i % 3) ? "Online" : "Offline");
+}
+
+static void groupEntry(char* out, size_t size, long i, long total)
+{
+    int written = snprintf(out, size, "group%07ld:user%07ld:", i, i % total);
+    for (int m = 1; m <= GROUP_MEMBERS && written > 0 && (size_t)written < size; m++)
+        written += snprintf(out + written, size - written, "user%07ld;", (i + m) % total);
+}
+
+static EventType historyEntry(long i, char* field0, char* field1, char* field2, size_t size) // Mix Of What The Agent Records
+{
+    char name[32];
+    field1[0] = field2[0] = '\0';
+    switch (i % 4)
+    {
+        case 0:
+            groupName(field0, size, i);
+            snprintf(field1, size, "%s|2024-01-01T00-00-00", field0);
+            return EVENT_GROUP_CREATED;
+        case 1:
+            userName(field0, size, i);
+            snprintf(field1, size, "me_%s|2024-01-01T00-00-00", field0);
+            return EVENT_USER_REQUEST_ACCEPTED;
+        case 2:
+            userName(field0, size, i);
+            return EVENT_USER_REQUEST_SENT;
+        default:
+            groupName(field0, size, i);
+            userName(name, sizeof(name), i);
+            snprintf(field1, size, "%s", name);
+            snprintf(field2, size, "%s|2024-01-01T00-00-00", field0);
+            return EVENT_GROUP_REQUEST_ACCEPTED;
+    }
+}
+
+static EventType requestEntry(long i, char* field0, char* field1, size_t size)
+{
+    userName(field0, size, i);
+    field1[0] = '\0';
+    if (i % 2)
+    {
+        groupName(field1, size, i);
+        return EVENT_GROUP_REQUEST;
+    }
+    return EVENT_USER_REQUEST;
+}
+
+static long linkedTarget(long size) // Random History Entry That Opens A Conversation (i % 4 != 2)
+{
+    long i;
+    do
+        i = randomBelow(size);
+    while (i % 4 == 2);
+    return i;
+}
+
+// Shared Measurements
+
+static void benchInsert(const char* corpus, LinkedList* list, char** entries, long size)
+{
+    Meter meter;
+    meterStart(&meter, size, 0); // The Whole Corpus Is Always Built
+    for (long i = 0; meterNext(&meter); i++)
+        listInsert(list, entries[i]);
+    report(corpus, "listInsert", "list", size, &meter);
+}
+
+static void benchPop(const char* corpus, LinkedList* list, char** entries, long size, long operations, int budget_ms)
+{
+    // Pops Put The Entry Back (Keeps The Size) | listInsert Is Timed Separately Above
+    Meter meter;
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+    {
+        char* oldest = listPopLast(list);
+        if (oldest)
+        {
+            listInsert(list, oldest);
+            listFreeResult(oldest);
+        }
+    }
+    report(corpus, "listPopLast+listInsert", "list", size, &meter);
+
+    TailQueue queue = { NULL, NULL, 0 };
+    for (long i = 0; i < size; i++)
+        queuePush(&queue, entries[i]);
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+    {
+        char* oldest = queuePop(&queue);
+        if (oldest)
+        {
+            queuePush(&queue, oldest);
+            free(oldest);
+        }
+    }
+    report(corpus, "listPopLast+listInsert", "queue", size, &meter);
+    queueClear(&queue);
+}
+
+static void benchSearchDelete(const char* corpus, LinkedList* list, char** entries, long size, long operations, int budget_ms)
+{
+    Meter meter;
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+        listSearch(list, entries[randomBelow(size)]);
+    report(corpus, "listSearch", "list", size, &meter);
+
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+    {
+        long i = randomBelow(size);
+        listDelete(list, entries[i]);
+        listInsert(list, entries[i]);
+    }
+    report(corpus, "listDelete+listInsert", "list", size, &meter);
+}
+
+static void benchClear(const char* corpus, LinkedList* list, long size)
+{
+    Meter meter;
+    meterStart(&meter, 1, 0);
+    meterNext(&meter);
+    listClear(list);
+    report(corpus, "listClear (Whole List)", "list", size, &meter);
+}
+
+// Corpus: Status
+
+static void benchStatus(long size, long operations, int budget_ms)
+{
+    char** entries = malloc(size * sizeof(char*));
+    char entry[64], name[32];
+    for (long i = 0; i < size; i++)
+    {
+        statusEntry(entry, sizeof(entry), i);
+        entries[i] = strdup(entry);
+    }
+
+    LinkedList list;
+    listInit(&list);
+    benchInsert("status", &list, entries, size);
+
+    Meter meter;
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+    {
+        userName(name, sizeof(name), randomBelow(size));
+        listSearchFirstParameter(&list, name);
+    }
+    report("status", "listSearchFirstParameter", "list", size, &meter);
+
+    FieldIndex index;
+    meterStart(&meter, 1, 0);
+    meterNext(&meter);
+    indexBuild(&index, &list, size, 0);
+    report("status", "build (Whole List)", "index", size, &meter);
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+    {
+        userName(name, sizeof(name), randomBelow(size));
+        indexFind(&index, name, 0);
+    }
+    report("status", "listSearchFirstParameter", "index", size, &meter);
+    indexDestroy(&index);
+
+    outputMute();
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+        listPrintStatus(&list);
+    outputRestore();
+    report("status", "listPrintStatus", "list", size, &meter);
+
+    benchSearchDelete("status", &list, entries, size, operations, budget_ms);
+    benchPop("status", &list, entries, size, operations, budget_ms);
+    benchClear("status", &list, size);
+
+    listDestroy(&list);
+    for (long i = 0; i < size; i++)
+        free(entries[i]);
+    free(entries);
+}
+
+// Corpus: Groups
+
+static void benchGroups(long size, long operations, int budget_ms)
+{
+    char** entries = malloc(size * sizeof(char*));
+    char entry[256], group[32], leader[32];
+    for (long i = 0; i < size; i++)
+    {
+        groupEntry(entry, sizeof(entry), i, size);
+        entries[i] = strdup(entry);
+    }
+
+    LinkedList list;
+    listInit(&list);
+    benchInsert("groups", &list, entries, size);
+
+    Meter meter;
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+    {
+        long i = randomBelow(size);
+        groupName(group, sizeof(group), i);
+        userName(leader, sizeof(leader), i % size);
+        listFreeResult(listGetGroup(&list, group, leader));
+    }
+    report("groups", "listGetGroup", "list", size, &meter);
+
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+    {
+        groupName(group, sizeof(group), randomBelow(size));
+        listFreeResult(listGetGroupLeader(&list, group));
+    }
+    report("groups", "listGetGroupLeader", "list", size, &meter);
+
+    FieldIndex index;
+    meterStart(&meter, 1, 0);
+    meterNext(&meter);
+    indexBuild(&index, &list, size, 0);
+    report("groups", "build (Whole List)", "index", size, &meter);
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+    {
+        groupName(group, sizeof(group), randomBelow(size));
+        free(groupLeaderIndexed(&index, group));
+    }
+    report("groups", "listGetGroupLeader", "index", size, &meter);
+    indexDestroy(&index);
+
+    outputMute();
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+        listPrintGroups(&list);
+    outputRestore();
+    report("groups", "listPrintGroups", "list", size, &meter);
+
+    benchSearchDelete("groups", &list, entries, size, operations, budget_ms);
+    benchPop("groups", &list, entries, size, operations, budget_ms);
+    benchClear("groups", &list, size);
+
+    listDestroy(&list);
+    for (long i = 0; i < size; i++)
+        free(entries[i]);
+    free(entries);
+}
+
+// Corpus: History / Requests
+
+static void benchHistory(long size, long operations, int budget_ms)
+{
+    char** entries = malloc(size * sizeof(char*));
+    char field0[64], field1[64], field2[64], payload[256];
+    for (long i = 0; i < size; i++)
+    {
+        EventType type = historyEntry(i, field0, field1, field2, sizeof(field0));
+        entries[i] = eventPack(EVENT_WIRE_CURRENT, type, field0, field1[0] ? field1 : NULL, field2[0] ? field2 : NULL);
+    }
+
+    LinkedList list;
+    listInit(&list);
+    benchInsert("history", &list, entries, size);
+
+    Meter meter;
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+    {
+        historyEntry(linkedTarget(size), field0, field1, field2, sizeof(field0));
+        listFreeResult(listGetTopic(&list, field0));
+    }
+    report("history", "listGetTopic", "list", size, &meter);
+
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+    {
+        historyEntry(linkedTarget(size), field0, field1, field2, sizeof(field0));
+        listSearchConversation(&list, field0);
+    }
+    report("history", "listSearchConversation", "list", size, &meter);
+
+    FieldIndex index;
+    meterStart(&meter, 1, 0);
+    meterNext(&meter);
+    indexBuild(&index, &list, size, 1);
+    report("history", "build (Whole List)", "index", size, &meter);
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+    {
+        historyEntry(linkedTarget(size), field0, field1, field2, sizeof(field0));
+        free(topicIndexed(&index, field0));
+    }
+    report("history", "listGetTopic", "index", size, &meter);
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+    {
+        historyEntry(linkedTarget(size), field0, field1, field2, sizeof(field0));
+        indexFind(&index, field0, 1);
+    }
+    report("history", "listSearchConversation", "index", size, &meter);
+    indexDestroy(&index);
+
+    meterStart(&meter, 1, 0);
+    meterNext(&meter);
+    listSearchChat(&list);
+    report("history", "listSearchChat", "list", size, &meter);
+
+    outputMute();
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+        listPrintHistory(&list, "user0000000");
+    outputRestore();
+    report("history", "listPrintHistory", "list", size, &meter);
+
+    outputMute();
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+        listPrintChats(&list, "user0000000");
+    outputRestore();
+    report("history", "listPrintChats", "list", size, &meter);
+
+    benchSearchDelete("history", &list, entries, size, operations, budget_ms);
+    benchPop("history", &list, entries, size, operations, budget_ms);
+    benchClear("history", &list, size);
+
+    // REQUESTS/: Stored As Packed, Searched With The Text Form (As The Agent Compares Incoming Requests)
+
+    for (long i = 0; i < size; i++)
+    {
+        free(entries[i]);
+        EventType type = requestEntry(i, field0, field1, sizeof(field0));
+        entries[i] = eventPack(EVENT_WIRE_CURRENT, type, field0, field1[0] ? field1 : NULL, NULL);
+    }
+    benchInsert("requests", &list, entries, size);
+
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+    {
+        EventType type = requestEntry(randomBelow(size), field0, field1, sizeof(field0));
+        eventEncode(payload, sizeof(payload), type, field0, field1[0] ? field1 : NULL, NULL);
+        listSearchEvent(&list, payload);
+    }
+    report("requests", "listSearchEvent", "list", size, &meter);
+
+    outputMute();
+    meterStart(&meter, operations, budget_ms);
+    while (meterNext(&meter))
+        listPrintRequests(&list);
+    outputRestore();
+    report("requests", "listPrintRequests", "list", size, &meter);
+
+    listDestroy(&list);
+    for (long i = 0; i < size; i++)
+        free(entries[i]);
+    free(entries);
+}
+
+int main(int argc, char* argv[])
+{
+    const char* sizes = DEFAULT_SIZES;
+    const char* corpora = DEFAULT_CORPORA;
+    long operations = DEFAULT_OPERATIONS;
+    int budget_ms = DEFAULT_BUDGET_MS;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "-j") == 0)
+            json_output = 1;
+        else if (strcmp(argv[i], "-n") == 0 && value) { sizes = value; i++; }
+        else if (strcmp(argv[i], "-c") == 0 && value) { corpora = value; i++; }
+        else if (strcmp(argv[i], "-k") == 0 && value) { operations = atol(value); i++; }
+        else if (strcmp(argv[i], "-t") == 0 && value) { budget_ms = atoi(value); i++; }
+        else
+        {
+            printf("Uso: %s [-n TAMANHOS] [-c CORPORA] [-k OPERACOES] [-t ORCAMENTO_MS] [-j]\n"
+                   "  -n  Entradas Por Lista (Padrão: %s)\n"
+                   "  -c  Corpora (Padrão: %s)\n"
+                   "  -k  Máximo De Chamadas Por Medição (Padrão: %d)\n"
+                   "  -t  Tempo Máximo Por Medição Em ms (Padrão: %d, Mínimo De %d Chamadas)\n"
+                   "  -j  Uma Linha JSON Por Resultado\n",
+                   argv[0], DEFAULT_SIZES, DEFAULT_CORPORA, DEFAULT_OPERATIONS, DEFAULT_BUDGET_MS, MIN_OPERATIONS);
+            return strcmp(argv[i], "-h") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (operations <= 0) operations = DEFAULT_OPERATIONS;
+    if (budget_ms <= 0) budget_ms = DEFAULT_BUDGET_MS;
+
+    if (!json_output)
+    {
+        printf("LISTBENCH: Formato %s | Alocações %s\n\n", eventWire() == EVENT_WIRE_BINARY ? "Binário" : "Texto", ALLOC_COUNTED ? "Contadas" : "n/d (Sem glibc)");
+        printf("%-8s %-26s %-6s %9s %9s %14s %10s %10s\n", "Corpus", "Operação", "Impl", "Entradas", "Chamadas", "ns/op", "allocs/op", "bytes/op");
+    }
+
+    for (const char* p = sizes; *p; )
+    {
+        long size = atol(p);
+        if (size > 0)
+        {
+            if (hasItem(corpora, "status"))
+                benchStatus(size, operations, budget_ms);
+            if (hasItem(corpora, "groups"))
+                benchGroups(size, operations, budget_ms);
+            if (hasItem(corpora, "history"))
+                benchHistory(size, operations, budget_ms);
+        }
+        p += strcspn(p, ",");
+        if (*p == ',')
+            p++;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,646 @@
+// Compilation Command: "gcc loadgen.c simuser.c actions.c publisher.c subscriber.c agent.c messages.c events.c conversations.c envelope.c chunk.c attachment.c broker.c transport.c stats.c trace.c memory.c -o loadgen -lpaho-mqtt3as -pthread"
+// Excecution Command: "./loadgen [-b BROKER] [-u USERS] [-r RATES] [-g GROUP_SIZE] [-p PAIRS] [-d SECONDS] [-w SECONDS] [-o SECONDS] [-l BYTES] [-j]"
+//
+// Multi-User Load Generator (Realistic Traffic Through The Actions "./main" Runs, To Find The Knee Of The Throughput Curve)
+// - One Process Per Simulated User (actions.c Keeps One Logged-In User Per Process, As In Production), Each With Its Agent And Conversations
+// - Setup: setStatus("Online"), Leaders setGroup(), Then requestUser() To The Next -p Users And requestGroup() To The Group Leader
+//   Requests Are Answered As The Menu Does: getRequests(), createConversation() + respondUser() / getGroups() + respondGroup(), processRequest()
+// - Traffic: -r Lines Per Second Per User For -d Seconds (Open Loop: A Fixed Schedule, Late Lines Still Count From Their Slot),
+//   Round Robin Over The User's Open Chats And Group | Offline / Online Toggles (setStatus()) Every -o Seconds
+// - Sweep: Every -u x -r Combination Is A Fresh Step (New Users) | Offered = Users x Rate, Delivered = Lines Received (Group Fan-Out Included)
+// Latencies Are Client Side (Microseconds): Each Action Call, Request Until The Chat / Group Opens At The Requester,
+// Scheduled Send Until The Line Is Queued At A Receiver (CLOCK_MONOTONIC Is Shared By The User Processes)
+// Broker: Embedded (broker.h, In Its Own Process, Ephemeral Port) Unless -b / CHATMQTT_BROKER Says Otherwise ("loop://" Is Per Process: Refused)
+// POSIX Only (fork())
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include "constants.h"
+#include "transport.h"
+#include "messages.h"
+#include "events.h"
+#include "conversations.h"
+#include "actions.h"
+#include "broker.h"
+#include "simuser.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#else
+#include <windows.h>
+#endif
+
+#if defined(_WRS_KERNEL)
+#include <OsWrapper.h>
+#endif
+
+// Parameters
+
+#define DEFAULT_USERS        "10"
+#define DEFAULT_RATES        "1"
+#define DEFAULT_GROUP_SIZE   5 // Users Per Group, Leader Included (0 / 1 = No Groups) | May Go Past MAX_GROUP_MEMBERS
+#define DEFAULT_PAIRS        1 // Direct Chats Each User Requests
+#define DEFAULT_SECONDS      20 // Measured Traffic Per Step
+#define DEFAULT_WARMUP       10 // Handshakes Before The Traffic (Still Timed)
+#define DEFAULT_CHURN        0 // Seconds Between Offline / Online Toggles (0 = Always Online)
+#define DEFAULT_BYTES        64
+#define LOAD_MAX_USERS       2000
+#define LOAD_MAX_STEPS       64
+#define LOAD_MAX_PAIRS       SIM_MAX_PAIRS
+#define LOAD_MAX_BYTES       16000
+#define LOAD_READY_TIMEOUT_S 60 // Longest Wait For Every User To Come Up (The Step Starts Anyway)
+#define LOAD_DRAIN_MS        2000 // Lines Still In Flight When The Traffic Stops
+#define LOAD_LINE_TAG        "LG " // "LG [SCHEDULED NS] xxx..." (Lines Of Other Clients Are Ignored)
+
+// Data Structures
+
+typedef enum LoadOp // The Timed Actions Of simuser.h, Then What Only The Load Generator Measures
+{
+    OP_STATUS = SIM_STATUS,
+    OP_GROUP_CREATE = SIM_GROUP_CREATE,
+    OP_REQUEST = SIM_REQUEST,
+    OP_ACCEPT = SIM_ACCEPT,
+    OP_CHAT_OPEN = SIM_CHAT_OPEN,
+    OP_GROUP_JOIN = SIM_GROUP_JOIN,
+    OP_SEND = SIM_SEND,
+    OP_DELIVERY = SIM_OP_COUNT, // Scheduled Send Until Queued At A Receiver
+    OP_COUNT
+} LoadOp;
+
+static const char* const op_names[OP_COUNT] = {
+    "status", "group_create", "request", "accept", "chat_open", "group_join", "send", "delivery"
+};
+
+typedef struct // Client-Side Latencies Of One Operation
+{
+    uint32_t* us;
+    int count;
+    int capacity;
+} LoadSamples;
+
+typedef struct // Totals Of One User (Sent To The Parent Ahead Of The Samples)
+{
+    long sent; // Lines Sent Inside The Traffic Window
+    long sent_direct;
+    long delivered; // Lines From Others Received (Sent Inside The Window)
+    long delivered_direct;
+    long skipped; // Scheduled Lines With No Open Chat Yet
+    long send_failed;
+    long open_failed; // Requests Whose Chat / Group Never Opened
+    long accept_failed; // Requests Left Unanswered (Group Missing From The Snapshot, Conversation Limit)
+} LoadCounters;
+
+typedef struct // One Step Of The Sweep (Same For Every User Process)
+{
+    char run_id[32]; // Prefix Of Every User / Group Of The Step
+    int users;
+    double rate; // Lines Per Second Per User
+    int group_size;
+    int pairs;
+    int seconds;
+    int warmup;
+    int churn;
+    int bytes;
+} LoadStep;
+
+typedef struct // Shared With Every User Process (MAP_SHARED)
+{
+    volatile int ready; // Users With Agent + Conversations Up
+    volatile int failed; // Users That Could Not Start
+    volatile uint64_t start_ns; // Set By The Parent Once Everyone Is Ready (0 = Not Yet)
+} LoadShared;
+
+typedef struct // One Simulated User (Its Own Process)
+{
+    SimUser sim; // Workload (simuser.h)
+    uint64_t traffic_start; // Lines Scheduled In [traffic_start, traffic_end) Are Measured
+    uint64_t traffic_end;
+    int status_online; // Churn Toggles
+    long delivered; // Lines From Others Received (Sent Inside The Window)
+    long delivered_direct;
+    LoadSamples samples[OP_COUNT]; // Control Thread: OP_REQUEST / OP_ACCEPT / Toggles | Chat Loop: The Rest
+} LoadUser;
+
+typedef struct // Everything The Parent Collected For A Step
+{
+    LoadSamples samples[OP_COUNT];
+    LoadCounters counters;
+    int reported; // Users That Sent Their Results
+} LoadTotals;
+
+// Globals
+
+static int json_output = 0;
+static const char* broker_uri;
+
+// Helpers
+
+static void samplesAdd(LoadSamples* samples, uint64_t ns)
+{
+    if (samples->count == samples->capacity)
+    {
+        int capacity = samples->capacity ? samples->capacity * 2 : 256;
+        uint32_t* grown = realloc(samples->us, capacity * sizeof(uint32_t));
+        if (!grown)
+            return;
+        samples->us = grown;
+        samples->capacity = capacity;
+    }
+    uint64_t us = ns / 1000;
+    samples->us[samples->count++] = us > UINT32_MAX ? UINT32_MAX : (uint32_t)us;
+}
+
+static int compareSamples(const void* a, const void* b)
+{
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentileUs(const uint32_t* sorted, int count, double p) // Nearest Rank
+{
+    if (count == 0)
+        return 0;
+    int rank = (int)(p * count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+static int parseList(const char* list, double* values, int max) // "10,20,40" | Non-Positive Entries Skipped
+{
+    int count = 0;
+    for (const char* p = list; *p && count < max; )
+    {
+        double value = atof(p);
+        if (value > 0)
+            values[count++] = value;
+        p += strcspn(p, ",");
+        if (*p == ',')
+            p++;
+    }
+    return count;
+}
+
+#if !defined(_WIN32)
+
+static int writeAll(int fd, const void* data, size_t size)
+{
+    const char* p = (const char*)data;
+    while (size > 0)
+    {
+        ssize_t n = write(fd, p, size);
+        if (n <= 0)
+            return 0;
+        p += n;
+        size -= (size_t)n;
+    }
+    return 1;
+}
+
+// ----- Simulated User (Child Process) -----
+
+static void userTimed(SimUser* sim, SimOp op, uint64_t ns)
+{
+    LoadUser* user = (LoadUser*)sim->owner;
+    samplesAdd(&user->samples[op], ns);
+}
+
+// Churn: Offline / Online Toggle Every -o Seconds
+static void userRound(SimUser* sim)
+{
+    LoadUser* user = (LoadUser*)sim->owner;
+    user->status_online = !user->status_online;
+    uint64_t t0 = simNowNs();
+    setStatus(sim->username, user->status_online ? "Online" : "Offline");
+    samplesAdd(&user->samples[OP_STATUS], simNowNs() - t0);
+}
+
+// A Line From Another User ("[SENDER]: " LOAD_LINE_TAG "[SCHEDULED NS] xxx...")
+static void userReceived(SimUser* sim, SimPeer* peer, const MessageView* view)
+{
+    LoadUser* user = (LoadUser*)sim->owner;
+    const char* colon = memchr(view->data, ':', view->length);
+    if (!colon)
+        return;
+
+    const char* text = colon + 2;
+    int text_len = view->length - (int)(text - view->data);
+    int tag_len = (int)strlen(LOAD_LINE_TAG);
+    if (text_len <= tag_len || memcmp(text, LOAD_LINE_TAG, tag_len) != 0)
+        return;
+
+    char digits[24];
+    int digits_len = 0;
+    for (const char* p = text + tag_len; p < text + text_len && *p >= '0' && *p <= '9' && digits_len < (int)sizeof(digits) - 1; p++)
+        digits[digits_len++] = *p;
+    digits[digits_len] = '\0';
+
+    uint64_t scheduled = strtoull(digits, NULL, 10);
+    if (scheduled < user->traffic_start || scheduled >= user->traffic_end)
+        return;
+
+    user->delivered++;
+    if (!peer->is_group)
+        user->delivered_direct++;
+    uint64_t now = simNowNs();
+    samplesAdd(&user->samples[OP_DELIVERY], now > scheduled ? now - scheduled : 0);
+}
+
+static const SimHooks load_hooks = { userTimed, userRound, userReceived, NULL };
+
+// [COUNTERS] Then For Each Operation: [COUNT] [COUNT x uint32 Microseconds]
+static void writeResults(LoadUser* user, int fd)
+{
+    LoadCounters counters;
+    counters.sent = user->sim.counters.sent;
+    counters.sent_direct = user->sim.counters.sent_direct;
+    counters.delivered = user->delivered;
+    counters.delivered_direct = user->delivered_direct;
+    counters.skipped = user->sim.counters.skipped;
+    counters.send_failed = user->sim.counters.send_failed;
+    counters.open_failed = user->sim.counters.open_failed;
+    counters.accept_failed = user->sim.counters.accept_failed;
+
+    if (!writeAll(fd, &counters, sizeof(counters)))
+        return;
+    for (int op = 0; op < OP_COUNT; op++)
+    {
+        int32_t count = user->samples[op].count;
+        if (!writeAll(fd, &count, sizeof(count)) || !writeAll(fd, user->samples[op].us, (size_t)count * sizeof(uint32_t)))
+            return;
+    }
+}
+
+static void simulateUser(const LoadStep* step, LoadShared* shared, int index, int fd)
+{
+    static LoadUser user; // One Per Process
+
+    memset(&user, 0, sizeof(user));
+    simUserInit(&user.sim, step->run_id, step->users, index, step->pairs, step->group_size);
+    user.sim.hooks = &load_hooks;
+    user.sim.owner = &user;
+    user.status_online = 1;
+
+    if (!simUserStart(&user.sim))
+    {
+        __atomic_add_fetch(&shared->failed, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    // Every User Up (Requests Go To Subscribed Agents And Existing Groups)
+
+    __atomic_add_fetch(&shared->ready, 1, __ATOMIC_RELAXED);
+    while (!shared->start_ns)
+        simSleepUs(DELAY_100_MS_US / 10);
+
+    // Handshakes During The Warm-Up, Lines During -d Seconds, Then LOAD_DRAIN_MS For Those Still In Flight
+
+    user.traffic_start = shared->start_ns + (uint64_t)step->warmup * 1000000000ull;
+    user.traffic_end = user.traffic_start + (uint64_t)step->seconds * 1000000000ull;
+    user.sim.rate = step->rate;
+    user.sim.bytes = step->bytes;
+    user.sim.line_tag = LOAD_LINE_TAG;
+    user.sim.send_from = user.traffic_start;
+    user.sim.send_until = user.traffic_end;
+    user.sim.control_until = user.traffic_end;
+    user.sim.chat_until = user.traffic_end + (uint64_t)LOAD_DRAIN_MS * 1000000ull;
+    user.sim.round_ns = step->churn > 0 ? (uint64_t)step->churn * 1000000000ull : 0;
+
+    simUserTraffic(&user.sim);
+    simUserStop(&user.sim);
+
+    writeResults(&user, fd);
+}
+
+// ----- Parent -----
+
+static void mergeResults(LoadTotals* totals, const char* data, size_t size)
+{
+    LoadCounters counters;
+    size_t offset = sizeof(counters);
+
+    if (size < offset)
+        return;
+    memcpy(&counters, data, sizeof(counters));
+
+    for (int op = 0; op < OP_COUNT; op++)
+    {
+        int32_t count;
+        if (offset + sizeof(count) > size)
+            return;
+        memcpy(&count, data + offset, sizeof(count));
+        offset += sizeof(count);
+        if (count < 0 || offset + (size_t)count * sizeof(uint32_t) > size)
+            return;
+        for (int i = 0; i < count; i++)
+        {
+            uint32_t us;
+            memcpy(&us, data + offset + (size_t)i * sizeof(uint32_t), sizeof(us));
+            samplesAdd(&totals->samples[op], (uint64_t)us * 1000);
+        }
+        offset += (size_t)count * sizeof(uint32_t);
+    }
+
+    totals->counters.sent += counters.sent;
+    totals->counters.sent_direct += counters.sent_direct;
+    totals->counters.delivered += counters.delivered;
+    totals->counters.delivered_direct += counters.delivered_direct;
+    totals->counters.skipped += counters.skipped;
+    totals->counters.send_failed += counters.send_failed;
+    totals->counters.open_failed += counters.open_failed;
+    totals->counters.accept_failed += counters.accept_failed;
+    totals->reported++;
+}
+
+static void report(const LoadStep* step, int step_number, LoadTotals* totals, int started)
+{
+    double offered = step->users * step->rate;
+    double sent = (double)totals->counters.sent / step->seconds;
+    double delivered = (double)totals->counters.delivered / step->seconds;
+    double direct = totals->counters.sent_direct ? 100.0 * totals->counters.delivered_direct / totals->counters.sent_direct : 0;
+
+    if (!json_output)
+    {
+        printf("\nEtapa %d: %d Usuários (%d Iniciados, %d Relataram) | %.2f Msgs/s Por Usuário | Grupos De %d%s | %d Conversa(s) Direta(s) Por Usuário\n",
+               step_number, step->users, started, totals->reported, step->rate, step->group_size,
+               step->group_size > MAX_GROUP_MEMBERS ? " (Acima De MAX_GROUP_MEMBERS)" : "", step->pairs);
+        printf("%-14s %9s %12s %12s %12s %12s\n", "Operação", "Amostras", "p50 (us)", "p99 (us)", "p999 (us)", "Máx (us)");
+    }
+
+    for (int op = 0; op < OP_COUNT; op++)
+    {
+        LoadSamples* samples = &totals->samples[op];
+        qsort(samples->us, samples->count, sizeof(uint32_t), compareSamples);
+        double p50 = percentileUs(samples->us, samples->count, 0.50);
+        double p99 = percentileUs(samples->us, samples->count, 0.99);
+        double p999 = percentileUs(samples->us, samples->count, 0.999);
+        double max = samples->count ? samples->us[samples->count - 1] : 0;
+
+        if (json_output)
+            printf("{\"step\":%d,\"users\":%d,\"rate\":%.3f,\"group_size\":%d,\"pairs\":%d,\"broker\":\"%s\",\"op\":\"%s\",\"samples\":%d,\"p50_us\":%.1f,\"p99_us\":%.1f,\"p999_us\":%.1f,\"max_us\":%.1f}\n",
+                   step_number, step->users, step->rate, step->group_size, step->pairs, broker_uri, op_names[op], samples->count, p50, p99, p999, max);
+        else
+            printf("%-14s %9d %12.1f %12.1f %12.1f %12.1f\n", op_names[op], samples->count, p50, p99, p999, max);
+    }
+
+    if (json_output)
+        printf("{\"step\":%d,\"users\":%d,\"rate\":%.3f,\"group_size\":%d,\"pairs\":%d,\"broker\":\"%s\",\"started\":%d,\"reported\":%d,"
+               "\"offered_per_s\":%.1f,\"sent_per_s\":%.1f,\"delivered_per_s\":%.1f,\"direct_delivery_pct\":%.2f,"
+               "\"skipped\":%ld,\"send_failed\":%ld,\"open_failed\":%ld,\"accept_failed\":%ld}\n",
+               step_number, step->users, step->rate, step->group_size, step->pairs, broker_uri, started, totals->reported,
+               offered, sent, delivered, direct, totals->counters.skipped, totals->counters.send_failed, totals->counters.open_failed, totals->counters.accept_failed);
+    else
+        printf("Oferecido: %.1f Msgs/s | Enviado: %.1f Msgs/s | Entregue: %.1f Msgs/s (Grupos Multiplicam) | Entrega Direta: %.2f%%\n"
+               "Sem Conversa Aberta: %ld | Falhas De Envio: %ld | Conversas Não Abertas: %ld | Pedidos Sem Resposta: %ld\n",
+               offered, sent, delivered, direct, totals->counters.skipped, totals->counters.send_failed, totals->counters.open_failed, totals->counters.accept_failed);
+    fflush(stdout);
+}
+
+// Forks One Process Per User, Releases Them Together And Collects Their Results
+static void runStep(const LoadStep* step, int step_number)
+{
+    LoadShared* shared = mmap(NULL, sizeof(LoadShared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    struct pollfd* fds = calloc(step->users, sizeof(struct pollfd));
+    char** data = calloc(step->users, sizeof(char*));
+    size_t* sizes = calloc(step->users, sizeof(size_t));
+    pid_t* pids = calloc(step->users, sizeof(pid_t));
+    LoadTotals totals;
+    int started = 0;
+
+    memset(&totals, 0, sizeof(totals));
+    if (shared == MAP_FAILED || !fds || !data || !sizes || !pids)
+    {
+        printf("LOADGEN: Memória Insuficiente Para A Etapa %d\n", step_number);
+        return;
+    }
+    memset(shared, 0, sizeof(*shared));
+    for (int i = 0; i < step->users; i++)
+        fds[i].fd = -1;
+    fflush(stdout); // The Children Would Flush Our Buffer Again
+
+    for (int i = 0; i < step->users; i++)
+    {
+        int pipe_fd[2];
+        if (pipe(pipe_fd) != 0)
+            break;
+
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            close(pipe_fd[0]);
+            simulateUser(step, shared, i, pipe_fd[1]);
+            close(pipe_fd[1]);
+            _exit(EXIT_SUCCESS);
+        }
+        close(pipe_fd[1]);
+        if (pid < 0)
+        {
+            close(pipe_fd[0]);
+            break;
+        }
+        pids[i] = pid;
+        fds[i].fd = pipe_fd[0];
+        fds[i].events = POLLIN;
+        started++;
+    }
+
+    // Release Everyone Once Up (Or After LOAD_READY_TIMEOUT_S), Then Read Until Every Pipe Closes
+
+    uint64_t ready_deadline = simNowNs() + (uint64_t)LOAD_READY_TIMEOUT_S * 1000000000ull;
+    int open_pipes = started;
+    while (open_pipes > 0)
+    {
+        if (!shared->start_ns && (shared->ready + shared->failed >= started || simNowNs() >= ready_deadline))
+        {
+            if (!json_output && shared->ready < started)
+                printf("LOADGEN: %d De %d Usuários Prontos, Iniciando Assim Mesmo\n", shared->ready, started);
+            shared->start_ns = simNowNs();
+        }
+
+        if (poll(fds, step->users, 10) <= 0)
+            continue;
+        for (int i = 0; i < step->users; i++)
+        {
+            if (fds[i].fd < 0 || !(fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+
+            char buffer[65536];
+            ssize_t n = read(fds[i].fd, buffer, sizeof(buffer));
+            if (n > 0)
+            {
+                char* grown = realloc(data[i], sizes[i] + (size_t)n);
+                if (grown)
+                {
+                    memcpy(grown + sizes[i], buffer, (size_t)n);
+                    data[i] = grown;
+                    sizes[i] += (size_t)n;
+                }
+                continue;
+            }
+            close(fds[i].fd);
+            fds[i].fd = -1;
+            open_pipes--;
+        }
+    }
+
+    for (int i = 0; i < step->users; i++)
+    {
+        if (pids[i] > 0)
+            waitpid(pids[i], NULL, 0);
+        mergeResults(&totals, data[i], sizes[i]);
+        free(data[i]);
+    }
+
+    report(step, step_number, &totals, started);
+
+    for (int op = 0; op < OP_COUNT; op++)
+        free(totals.samples[op].us);
+    free(fds);
+    free(data);
+    free(sizes);
+    free(pids);
+    munmap(shared, sizeof(LoadShared));
+}
+
+#endif
+
+// Main Function
+
+int main(int argc, char* argv[])
+{
+    const char* users_list = DEFAULT_USERS;
+    const char* rates_list = DEFAULT_RATES;
+    const char* broker = getenv("CHATMQTT_BROKER");
+    LoadStep step;
+
+    memset(&step, 0, sizeof(step));
+    step.group_size = DEFAULT_GROUP_SIZE;
+    step.pairs = DEFAULT_PAIRS;
+    step.seconds = DEFAULT_SECONDS;
+    step.warmup = DEFAULT_WARMUP;
+    step.churn = DEFAULT_CHURN;
+    step.bytes = DEFAULT_BYTES;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "-j") == 0)
+            json_output = 1;
+        else if (strcmp(argv[i], "-b") == 0 && value) { broker = value; i++; }
+        else if (strcmp(argv[i], "-u") == 0 && value) { users_list = value; i++; }
+        else if (strcmp(argv[i], "-r") == 0 && value) { rates_list = value; i++; }
+        else if (strcmp(argv[i], "-g") == 0 && value) { step.group_size = atoi(value); i++; }
+        else if (strcmp(argv[i], "-p") == 0 && value) { step.pairs = atoi(value); i++; }
+        else if (strcmp(argv[i], "-d") == 0 && value) { step.seconds = atoi(value); i++; }
+        else if (strcmp(argv[i], "-w") == 0 && value) { step.warmup = atoi(value); i++; }
+        else if (strcmp(argv[i], "-o") == 0 && value) { step.churn = atoi(value); i++; }
+        else if (strcmp(argv[i], "-l") == 0 && value) { step.bytes = atoi(value); i++; }
+        else
+        {
+            printf("Uso: %s [-b BROKER] [-u USUARIOS] [-r TAXAS] [-g TAMANHO] [-p PARES] [-d SEGUNDOS] [-w SEGUNDOS] [-o SEGUNDOS] [-l BYTES] [-j]\n"
+                   "  -b  URI Do Broker (Padrão: Broker Embutido Em Porta Livre, Em Outro Processo)\n"
+                   "  -u  Usuários Simulados Por Etapa, Ex.: \"10,50,100\" (Padrão: %s, Máximo: %d)\n"
+                   "  -r  Mensagens Por Segundo Por Usuário, Ex.: \"0.5,1,2\" (Padrão: %s)\n"
+                   "  -g  Usuários Por Grupo, Líder Incluso (Padrão: %d, 0 = Sem Grupos, Pode Passar De MAX_GROUP_MEMBERS = %d)\n"
+                   "  -p  Conversas Diretas Pedidas Por Usuário (Padrão: %d)\n"
+                   "  -d  Segundos De Tráfego Medido Por Etapa (Padrão: %d)\n"
+                   "  -w  Segundos De Pedidos / Aceites Antes Do Tráfego (Padrão: %d)\n"
+                   "  -o  Segundos Entre Alternâncias Online / Offline (Padrão: %d = Sempre Online)\n"
+                   "  -l  Bytes Por Mensagem (Padrão: %d)\n"
+                   "  -j  Uma Linha JSON Por Resultado (Latências Em Microssegundos)\n",
+                   argv[0], DEFAULT_USERS, LOAD_MAX_USERS, DEFAULT_RATES, DEFAULT_GROUP_SIZE, MAX_GROUP_MEMBERS, DEFAULT_PAIRS,
+                   DEFAULT_SECONDS, DEFAULT_WARMUP, DEFAULT_CHURN, DEFAULT_BYTES);
+            return strcmp(argv[i], "-h") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    #if defined(_WIN32)
+        printf("LOADGEN: Requer fork() (Linux / macOS)\n");
+        return EXIT_FAILURE;
+    #else
+
+    double users[LOAD_MAX_STEPS], rates[LOAD_MAX_STEPS];
+    int users_count = parseList(users_list, users, LOAD_MAX_STEPS);
+    int rates_count = parseList(rates_list, rates, LOAD_MAX_STEPS);
+    pid_t broker_pid = 0;
+    char embedded_uri[64];
+
+    if (users_count == 0 || rates_count == 0)
+    {
+        printf("LOADGEN: Informe Ao Menos Um Número De Usuários (-u) E Uma Taxa (-r)\n");
+        return EXIT_FAILURE;
+    }
+    if (step.seconds <= 0) step.seconds = DEFAULT_SECONDS;
+    if (step.warmup < 0) step.warmup = DEFAULT_WARMUP;
+    if (step.churn < 0) step.churn = 0;
+    if (step.pairs < 0) step.pairs = 0;
+    if (step.pairs > LOAD_MAX_PAIRS) step.pairs = LOAD_MAX_PAIRS;
+    if (step.bytes < 32) step.bytes = 32;
+    if (step.bytes > LOAD_MAX_BYTES) step.bytes = LOAD_MAX_BYTES;
+
+    // Broker: Given, Or Embedded In Its Own Process (Every User Reads CHATMQTT_BROKER Through ADDRESS)
+
+    if (broker && transportIsLoopback(broker))
+    {
+        printf("LOADGEN: \"loop://\" Só Existe Dentro De Um Processo (Cada Usuário Roda No Seu), Use Um Broker TCP\n");
+        return EXIT_FAILURE;
+    }
+    if (!broker || !broker[0])
+    {
+        broker_pid = simBrokerStart(NULL, embedded_uri, sizeof(embedded_uri));
+        if (!broker_pid)
+        {
+            printf("LOADGEN: Falha Ao Iniciar O Broker Embutido (Use -b [URI])\n");
+            return EXIT_FAILURE;
+        }
+        broker = embedded_uri;
+    }
+    setenv("CHATMQTT_BROKER", broker, 1);
+    broker_uri = broker;
+    signal(SIGPIPE, SIG_IGN);
+
+    if (!json_output)
+    {
+        printf("LOADGEN: Broker %s%s | %d Etapa(s) De %d s (+ %d s De Preparação)\n", broker, broker_pid ? " (Embutido)" : "",
+               users_count * rates_count, step.seconds, step.warmup);
+        if (broker_pid && users[users_count - 1] * 3 > BROKER_MAX_CLIENTS)
+            printf("LOADGEN: O Broker Embutido Atende %d Conexões (Até 3 Por Usuário), Use -b Para Mais Usuários\n", BROKER_MAX_CLIENTS);
+    }
+
+    // Sweep: Users (Outer) x Rate (Inner), Each Step With Fresh Users
+
+    int step_number = 0;
+    for (int u = 0; u < users_count; u++)
+    {
+        for (int r = 0; r < rates_count; r++)
+        {
+            step.users = (int)users[u] > LOAD_MAX_USERS ? LOAD_MAX_USERS : (int)users[u];
+            step.rate = rates[r];
+            step_number++;
+            snprintf(step.run_id, sizeof(step.run_id), "lg%ld_%d", (long)(time(NULL) % 1000000), step_number);
+
+            LoadStep current = step;
+            int unique_pairs = (current.users - 1) / 2; // I > I+K And I+K > I Would Be The Same Chat
+            if (current.pairs > unique_pairs)
+                current.pairs = unique_pairs;
+            runStep(&current, step_number);
+        }
+    }
+
+    if (broker_pid)
+    {
+        kill(broker_pid, SIGTERM);
+        waitpid(broker_pid, NULL, 0);
+    }
+    return EXIT_SUCCESS;
+
+    #endif
+}
@@ -1,4 +1,4 @@
-// Compilation Command: "gcc main.c publisher.c subscriber.c agent.c messages.c -o main -lpaho-mqtt3as -pthread"
+// Compilation Command: "gcc main.c actions.c publisher.c subscriber.c agent.c messages.c chat.c conversations.c envelope.c events.c chunk.c attachment.c broker.c transport.c stats.c trace.c memory.c -o main -lpaho-mqtt3as -pthread"
 // Excecution Command: "./main"
 
 #include <stdio.h>
@@ -10,7 +10,13 @@
 #include "publisher.h"
 #include "subscriber.h"
 #include "messages.h"
+#include "events.h"
 #include "agent.h"
+#include "conversations.h"
+#include "chat.h"
+#include "actions.h"
+#include "stats.h"
+#include "trace.h"
 
 #if !defined(_WIN32)
 #include <unistd.h>
@@ -36,362 +42,19 @@ typedef struct // Publish Arguments
     volatile int* online;
 } PublishArgs;
 
-typedef struct // Subscriber Arguments
-{
-    char username[64];
-    char topic[1024];
-	LinkedList* message_list;
-    volatile int* online;
-} SubscribeArgs;
-
 typedef struct // Agent Arguments
 {
     char username[64];
-    char topic[1024];
-    LinkedList* message_list;
     volatile int* online;
 } AgentArgs;
 
-typedef struct // Conversation (Subscriber) Arguments
-{
-    char username[64];
-    char topic[1024];
-    LinkedList* message_list;
-    volatile int* chatting;
-} ConversationArgs;
-
-// Default Functions
-
-// Set User Status (Online / Offline)
-void setStatus(const char* username, const char* status)
-{
-    // [USERNAME]:[STATUS]
-    char topic[1024];
-    char payload[512];
-
-    snprintf(topic, sizeof(topic), "USERS/%s", username);
-    snprintf(payload, sizeof(payload), "%s:%s", username, status);
-
-    publisher(username, topic, payload, 1);
-}
-
-// Get Users Status (Online / Offline)
-void getUsers(const char* username, LinkedList* status_list, int print_status)
-{ 
-    // print_status: 1 = Print, 0 = Don't Print
-    listClear(status_list);
-    subscriberRetained(username, "USERS/+", status_list);
-    if (print_status)
-    {
-        listPrintStatus(status_list);
-    }
-}
-
-// Get Groups (Name / Leader / Members)
-void getGroups(const char* username, LinkedList* groups_list, int print_groups)
-{
-    // print_groups: 1 = Print, 0 = Don't Print
-    listClear(groups_list);
-    subscriberRetained(username, "GROUPS/+", groups_list);
-    if (print_groups)
-    {
-        listPrintGroups(groups_list);
-    }
-}
-
-// Get Requests
-void getRequests(const char* username, LinkedList* requests_list, int print_requests)
-{
-    // print_requests: 1 = Print, 0 = Don't Print
-    listClear(requests_list);
-    char temp[128];
-    snprintf(temp, sizeof(temp), "%s_Control/REQUESTS/+", username);
-    subscriberRetained(username, temp, requests_list);
-    if (print_requests)
-    {
-        listPrintRequests(requests_list);
-    }
-}
-
-// Get History
-void getHistory(const char* username, LinkedList* history_list, int print_history)
-{
-    // print_history: 1 = Print, 0 = Don't Print
-    listClear(history_list);
-    char temp[128];
-    snprintf(temp, sizeof(temp), "%s_Control/HISTORY/+", username);
-    subscriberRetained(username, temp, history_list);
-    if (print_history)
-    {
-        listPrintHistory(history_list, username);
-    }
-}
-
-// Get Chats (Name)
-int getChats(const char* username, LinkedList* history_list, int print_chats)
-{
-    // print_chats: 1 = Print, 0 = Don't Print
-    listClear(history_list);
-    char temp[128];
-    snprintf(temp, sizeof(temp), "%s_Control/HISTORY/+", username);
-    subscriberRetained(username, temp, history_list);
-    if (print_chats)
-    {
-        listPrintChats(history_list, username);
-    }
-}
-
-// Create Group (Name / Leader / Members)
-void setGroup(const char* groupname, const char* username)
-{
-    // [GROUP_NAME]:[LEADER]:[MEMBER1;MEMBER2;...]
-    char topic[1024];
-    char payload[512];
-    char link[256];
-
-    // Publish On Groups
-    snprintf(topic, sizeof(topic), "GROUPS/%s", groupname);
-    snprintf(payload, sizeof(payload), "%s:%s:%s;", groupname, username, username); // Leader Is The First Member
-
-    publisher(username, topic, payload, 1);
-
-    // Publish On History
-    char timestamp[100];
-    time_t now = time(NULL);
-    struct tm *t = localtime(&now);
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H-%M-%S", t);
-
-    snprintf(link, sizeof(link), "%s|%s", groupname, timestamp);
-    snprintf(payload, sizeof(payload), "GROUP_CREATED:%s;%s", groupname, link);
-    snprintf(topic, sizeof(topic), "%s_Control/HISTORY/%s", username, payload);
-
-    publisher(username, topic, payload, 1);
-
-    // Subscribe On Conversation Topic
-    snprintf(topic, sizeof(topic), "CHATS/%s", link);
-
-    subscriberDirty(username, topic, NULL);
-}
-
-// Request User Coversation
-void requestUser(const char* username, const char* user)
-{
-    char topic[512]; // Topic = [TARGET_USER]_Control
-    char my_topic[512]; // Topic = [USERNAME]_Control/HISTORY/[BODY]
-    char request[256]; // USER_REQUEST:[USERNAME]
-    char history[256]; // USER_REQUEST_SENT:[TARGET_USER]
-
-    // Request
-    snprintf(topic, sizeof(topic), "%s_Control", user);
-    snprintf(request, sizeof(request), "USER_REQUEST:%s", username);
-
-    publisher(username, topic, request, 0);
-
-    // History
-    snprintf(history, sizeof(history), "USER_REQUEST_SENT:%s", user);
-    snprintf(my_topic, sizeof(my_topic), "%s_Control/HISTORY/%s", username, history);
-
-    publisher(username, my_topic, history, 1);
-}
-
-// Request User Coversation
-void requestGroup(const char* username, const char* leader, const char* group)
-{
-    char topic[512]; // Topic = [TARGET_LEADER]_Control
-    char my_topic[512]; // Topic = [USERNAME]_Control/HISTORY/[BODY]
-    char request[256]; // GROUP_REQUEST:[GROUPNAME];[USERNAME]
-    char history[256]; // GROUP_REQUEST_SENT:[GROUPNAME];[LEADER]
-
-    // Request
-    snprintf(topic, sizeof(topic), "%s_Control", leader);
-    snprintf(request, sizeof(request), "GROUP_REQUEST:%s;%s", group, username);
-    
-    publisher(username, topic, request, 0);
-
-    // History
-    snprintf(history, sizeof(history), "GROUP_REQUEST_SENT:%s;%s", group, leader);
-    snprintf(my_topic, sizeof(my_topic), "%s_Control/HISTORY/%s", username, history);
-
-    publisher(username, my_topic, history, 1);
-}
-
-// Respond Group Coversation
-void respondUser(const char* username, const char* user, const char* link, const char* my_response)
-{
-    char topic[512]; // Topic = [USER]_Control
-    char my_topic[512]; // Topic = [USERNAME]_Control/HISTORY/[BODY]
-    char response[256]; // USER_ACCEPTED:[USERNAME];[TOPIC] | USER_REJECTED:[USERNAME]
-    char history[256]; // USER_ACCEPTED:[USERNAME];[TOPIC]  | USER_REJECTED:[USERNAME]
-
-    if (strcmp(my_response, "ACEITAR") == 0) // ACCEPTED
-    {
-        // Request
-        snprintf(topic, sizeof(topic), "%s_Control", user);
-        snprintf(response, sizeof(response), "USER_ACCEPTED:%s;%s", username, link);
-        
-        publisher(username, topic, response, 0);
-
-        // History
-        snprintf(history, sizeof(history), "USER_ACCEPTED:%s;%s", user, link);
-        snprintf(my_topic, sizeof(my_topic), "%s_Control/HISTORY/%s", username, history);
-
-        publisher(username, my_topic, history, 1);
-    }
-    else // REJECTED
-    {
-        // Request
-        snprintf(topic, sizeof(topic), "%s_Control", user);
-        snprintf(response, sizeof(response), "USER_REJECTED:%s", username);
-        
-        publisher(username, topic, response, 0);
-
-        // History
-        snprintf(history, sizeof(history), "USER_REJECTED:%s", user);
-        snprintf(my_topic, sizeof(my_topic), "%s_Control/HISTORY/%s", username, history);
-
-        publisher(username, my_topic, history, 1);
-    }
-}
-
-// Respond Group Coversation
-void respondGroup(const char* username, const char* group, const char* user, const char* link, const LinkedList* groups_list, const char* my_response)
-{
-    char topic[512]; // Topic = [USER]_Control
-    char my_topic[512]; // Topic = [USERNAME]_Control/HISTORY/[BODY]
-    char response[256]; // GROUP_ACCEPTED:[GROUPNAME];[USER];[TOPIC] | GROUP_REJECTED:[GROUPNAME];[USER]
-    char history[256]; // GROUP_ACCEPTED:[GROUPNAME];[USER]          | GROUP_REJECTED:[GROUPNAME];[USER]
-    char *group_info; // Message = [GROUPNAME]:[USERNAME]:[MEMBER];
-    char group_info_new[2048]; // Message = [GROUPNAME]:[USERNAME]:[MEMBER];[MEMBER];
-    char group_topic[512]; // Topic = GROUPS/[GROUPNAME]
-
-    if (strcmp(my_response, "ACEITAR") == 0) // ACCEPTED
-    {
-        // Update "GROUPS/"
-        group_info = listGetGroup(groups_list, group, username);
-        snprintf(group_topic, sizeof(group_topic), "GROUPS/%s", group);
-        snprintf(group_info_new, sizeof(group_info_new), "%s%s;", group_info, user);
-
-        publisher(username, group_topic, group_info_new, 1);
-
-        // Request
-        snprintf(topic, sizeof(topic), "%s_Control", user);
-        snprintf(response, sizeof(response), "GROUP_ACCEPTED:%s;%s;%s", group, username, link);
-        
-        publisher(username, topic, response, 0);
-
-        // History
-        snprintf(history, sizeof(history), "GROUP_ACCEPTED:%s;%s", group, user);
-        snprintf(my_topic, sizeof(my_topic), "%s_Control/HISTORY/%s", username, history);
-
-        publisher(username, my_topic, history, 1);
-    }
-    else // REJECTED
-    {
-        // Request
-        snprintf(topic, sizeof(topic), "%s_Control", user);
-        snprintf(response, sizeof(response), "GROUP_REJECTED:%s;%s", group, username);
-        
-        publisher(username, topic, response, 0);
-
-        // History
-        snprintf(history, sizeof(history), "GROUP_REJECTED:%s;%s", group, user);
-        snprintf(my_topic, sizeof(my_topic), "%s_Control/HISTORY/%s", username, history);
-
-        publisher(username, my_topic, history, 1);
-    }
-}
-
-// Create Conversation Topic By Sending "WATING_USER"
-void createConversation(const char* username, const char* link)
-{
-    char topic[1024];
-
-    snprintf(topic, sizeof(topic), "CHATS/%s", link);
-
-    subscriberDirty(username, topic, NULL);
-    publisherDirty(username, topic, "WAITING_USER", 1);
-}
-
-// Check If Conversation Topic Is Ready
-int checkConversation(const char* username, const char* link, LinkedList* message_list)
-{
-    char topic[1024];
-    char pseudouser[128]; // To Avoid Receiving Messages In The Wrong Time
-    snprintf(topic, sizeof(topic), "CHATS/%s", link);
-    snprintf(pseudouser, sizeof(pseudouser), "%s;", username);
-    listClear(message_list);
-    subscriberRetained(pseudouser, topic, message_list);
-    if (listSearch(message_list, "WAITING_USER") != 0)
-    {
-        return 0;
-    }
-    return 1;
-}
-
-// Monitor Control Topic ([USER]_Control) > Used With Threads
-void monitorControl(const char* username, LinkedList* control_list, volatile int* online)
-{
-    char control_username[72];
-    snprintf(control_username, sizeof(control_username), "%s_Control", username);
-
-    listClear(control_list);
-
-    agentControl(control_username, control_list, online);
-}
-
-// Realtime Conversation Confirmation > Used With Threads
-void confirmationControl(const char* username, LinkedList* control_list, volatile int* online)
-{
-    while (*online)
-    {
-        char* element = listPopLast(control_list);
-        if (element) // If There's A New Element
-        {
-            subscriberDirty(username, element, NULL);
-            free(element);
-        }
-
-        #if defined(_WIN32)
-            Sleep(DELAY_100_MS_MS);
-        #else
-            usleep(DELAY_100_MS_US);
-        #endif
-    }
-}
-
-// Process Request
-void processRequest(const char* username, const char* request)
-{
-    char topic[512]; // Topic = [USERNAME]_Control/REQUESTS/[REQUEST]
-    snprintf(topic, sizeof(topic), "%s_Control/REQUESTS/%s", username, request);
-    publisher(username, topic, "", 1); // Publish Empty Payload To Remove Retained Message
-}
-
 // Thread Function Wrappers
 
 // monitorControl Thread Wrapper
 void* monitorControlThread(void* arg)
 {
     AgentArgs* args = (AgentArgs*)arg;
-    monitorControl(args->username, args->message_list, args->online);
-    free(args);  // Free Arguments Structure
-    return NULL;
-}
-
-// confirmationControl Thread Wrapper
-void* confirmationControlThread(void* arg)
-{
-    SubscribeArgs* args = (SubscribeArgs*)arg;
-    confirmationControl(args->username, args->message_list, args->online);
-    free(args);  // Free Arguments Structure
-    return NULL;
-}
-
-// subscriberConversation (startConversation) Thread Wrapper
-void* subscriberConversationThread(void* arg)
-{
-    ConversationArgs* args = (ConversationArgs*)arg;
-    subscriberConversation(args->username, args->topic, args->message_list, args->chatting);
+    monitorControl(args->username, args->online);
     free(args);  // Free Arguments Structure
     return NULL;
 }
@@ -402,6 +65,8 @@ int main()
 {
     // ----- Program Startup -----
 
+    traceInit(); // CHATMQTT_TRACE=1 Records From Startup, SIGUSR1 / SIGUSR2 Switch / Dump At Any Time
+
     // Welcome & Username Definition
 
     printf("\nChatMQTT\n");
@@ -434,37 +99,48 @@ int main()
 
     // Threads Parameters
 
-    pthread_t threads[2]; // Threads Handler
+    pthread_t threads[1]; // Threads Handler
     // Total Threads Number Is Based On The Maximum Possible Concurrent Threads:
     // - Control Topic Agent (Publisher/Subscriber)
-    // - User Realtime Conversation Confirmation
     int threads_running = 0; // Threads Counter
 
     // Queues Initialization
 
     LinkedList status_list; // Status (Users) List
     listInit(&status_list);
+    listSetName(&status_list, "status");
 
     LinkedList groups_list; // Groups List
     listInit(&groups_list);
-
-    LinkedList control_list; // Control List
-    listInit(&control_list);
+    listSetName(&groups_list, "groups");
 
     LinkedList requests_list; // Requests List
     listInit(&requests_list);
+    listSetName(&requests_list, "requests");
 
     LinkedList history_list; // History List
     listInit(&history_list);
+    listSetName(&history_list, "history");
+
+    // Conversations Connection (Every Known Chat Is Subscribed In Background)
+
+    if (conversationsStart(&conversations, username) != EXIT_SUCCESS) {
+        printf("Erro Ao Iniciar O Programa! (Conversations Connection Failed)\n");
+        return EXIT_FAILURE;
+    }
+    getChats(username, &history_list, 0);
+    conversationsLoad(&conversations, &history_list);
+
+    // Periodic Stats Summary On The Conversations Connection (CHATMQTT_STATS=[SECONDS] > CHATMQTT/STATS/[USER], Off By Default)
 
-    LinkedList messages_list; // Messages List
-    listInit(&messages_list);
+    const char* stats_interval = getenv(STATS_INTERVAL_ENV);
+    if (stats_interval)
+        statsPublishStart(conversations.client, username, atoi(stats_interval));
 
-    // Control Topic Thread Inicialization
+    // Control Topic Thread Inicialization (Started After The Conversations, Accepted Chats Land There)
 
     AgentArgs* control_args = malloc(sizeof(AgentArgs));
     strncpy(control_args->username, username, sizeof(control_args->username) - 1);
-    control_args->message_list = &control_list;
     control_args->online = &online;
 
     if (pthread_create(&threads[threads_running], NULL, monitorControlThread, control_args) != 0) {
@@ -474,18 +150,6 @@ int main()
     }
     threads_running++;
 
-    SubscribeArgs* subscribe_args = malloc(sizeof(SubscribeArgs));
-    strncpy(subscribe_args->username, username, sizeof(subscribe_args->username) - 1);
-    subscribe_args->message_list = &control_list;
-    subscribe_args->online = &online;
-
-    if (pthread_create(&threads[threads_running], NULL, confirmationControlThread, subscribe_args) != 0) {
-        printf("Erro Ao Iniciar O Programa! (Confirmation Thread Inicialization Failed)\n");
-        free(subscribe_args);
-        return EXIT_FAILURE;
-    }
-    threads_running++;
-
     // Send Online Status (USERS)
 
     setStatus(username, "Online");
@@ -562,7 +226,10 @@ int main()
             if(LOG_ENABLED)
                 printf("\n");
 
-            getChats(username, &history_list, 1);
+            getChats(username, &history_list, 0);
+            conversationsLoad(&conversations, &history_list);
+            conversationsPrint(&conversations);
+            printf("\n");
 
             if (listSearchChat(&history_list) != 0)
             {
@@ -631,80 +298,32 @@ int main()
                     {
                         char* link = listGetTopic(&history_list, target);
 
-                        // If User, Check If Ready
-                        if (strcmp(type, "U") == 0)
-                        { 
-                            if (checkConversation(username, link, &messages_list) == 0)
-                            {
-                                printf("Aguardando Outro Usuário...\n");
-                                continue;
-                            }
-                        }
-
-                        volatile int chatting = 1;
-
-                        char topic[1024];
-                        snprintf(topic, sizeof(topic), "CHATS/%s", link);
-                        free(link);
+                        // Already Subscribed On The Shared Connection, Only Registered If New
+                        Conversation* conversation = conversationsAdd(&conversations, target, link, strcmp(type, "G") == 0);
+                        listFreeResult(link);
 
-                        pthread_t chat_thread[1];
-
-                        ConversationArgs* conversation_args = malloc(sizeof(ConversationArgs));
-                        strncpy(conversation_args->username, username, sizeof(conversation_args->username) - 1);
-                        strncpy(conversation_args->topic, topic, sizeof(conversation_args->topic) - 1);
-                        conversation_args->message_list = &messages_list;
-                        conversation_args->chatting = &chatting;
-
-                        if (pthread_create(&chat_thread[0], NULL, subscriberConversationThread, conversation_args) != 0)
+                        if (!conversation)
                         {
                             printf("Erro Ao Iniciar Conversa!\n");
-                            free(conversation_args);
-                            return EXIT_FAILURE;
+                            continue;
                         }
 
-                        char pseudousername[128];
-                        snprintf(pseudousername, sizeof(pseudousername), "%s;", username);
+                        // Not Confirmed Yet (Retained "WAITING_USER"): Opens As Soon As The Confirmation Arrives
+                        if (!chatWaitReady(&conversations, conversation))
+                        {
+                            continue;
+                        }
+
+                        volatile int chatting = 1;
 
                         printf("\nIniciando Conversa...\n\n"
                             "- Escreva Normalmente Para Enviar Mensagens\n"
-                            "- Digite \";\" Para Procurar Novas Mensagens (Não Atualiza Automaticamente)\n"
+                            "- Novas Mensagens Aparecem Automaticamente\n"
+                            "- Digite \"/conversas\" Para Listar As Conversas E \"/trocar [NOME]\" Para Trocar\n"
+                            "- Digite \"/anexo [CAMINHO]\" Para Enviar Um Arquivo\n"
                             "- Digite \":\" Para Sair\n\n");
-                        char message[16256];
-                        char formatted_message[16384];
-
-                        while (chatting)
-                        {
-                            fflush(stdout);
-                            if (fgets(message, sizeof(message), stdin) == NULL) {
-                                chatting = 0;
-                                break;
-                            }
-                            // Remove trailing newline(s)
-                            message[strcspn(message, "\r\n")] = '\0';
-
-                            if (strlen(message) == 0 || strspn(message, " \t\n\r") == strlen(message)) // No Groupname / Only Whitespaces
-                            { 
-                                continue;
-                            }
 
-                            if (strcmp(message, ":") == 0) // EXIT
-                            {
-                                break;
-                            }
-
-                            if (strcmp(message, ";") == 0) // Uptade Messages
-                            {
-                                listPopPrintAll(&messages_list);
-                                continue;
-                            }
-
-                            
-                            snprintf(formatted_message, sizeof(formatted_message), "%s: %s", username, message);
-                            publisherDirty(pseudousername, topic, formatted_message, 0);
-                        }
-
-                        chatting = 0;
-                        pthread_join(chat_thread[0], NULL);
+                        chatLoop(&conversations, conversation, &chatting);
                     }
                 }
                 else
@@ -819,9 +438,9 @@ int main()
                             }
 
                             char formatted_group[1024];
-                            snprintf(formatted_group, sizeof(formatted_group), "GROUP_REQUEST:%s;%s", group, user);
+                            eventEncode(formatted_group, sizeof(formatted_group), EVENT_GROUP_REQUEST, group, user, NULL);
 
-                            if (listSearch(&requests_list, formatted_group) == 0)
+                            if (listSearchEvent(&requests_list, formatted_group) == 0)
                             {
                                 printf("\nUsuário Ou Grupo Inválido!\n");
                                 continue;
@@ -830,7 +449,7 @@ int main()
                             char* topic = listGetTopic(&history_list, group);
 
                             respondGroup(username, group, user, topic, &groups_list, response);
-                            free(topic);
+                            listFreeResult(topic);
 
                             processRequest(username, formatted_group);
                         }
@@ -854,9 +473,9 @@ int main()
                             }
 
                             char formatted_user[300];
-                            snprintf(formatted_user, sizeof(formatted_user), "USER_REQUEST:%s", user);
+                            eventEncode(formatted_user, sizeof(formatted_user), EVENT_USER_REQUEST, user, NULL, NULL);
 
-                            if (listSearch(&requests_list, formatted_user) == 0)
+                            if (listSearchEvent(&requests_list, formatted_user) == 0)
                             {
                                 printf("\nUsuário Inválido!\n");
                                 continue;
@@ -872,7 +491,7 @@ int main()
 
                             if (strcmp(response, "ACEITAR") == 0)
                             {
-                                createConversation(username, topic);
+                                createConversation(username, user, topic);
                             }
 
                             respondUser(username, user, topic, response);
@@ -1037,11 +656,16 @@ int main()
                         printf("Grupo Escolhido: %s\n", target_group);
 
                         target_leader = listGetGroupLeader(&groups_list, target_group);
+                        if (!target_leader) // Left The Groups List Since It Was Printed
+                        {
+                            printf("Grupo Não Encontrado!\n");
+                            continue;
+                        }
                         printf("Líder: %s\n", target_leader);
 
                         requestGroup(username, target_leader, target_group);
 
-                        free(target_leader);
+                        listFreeResult(target_leader);
                     }
                 }
                 else
@@ -1062,6 +686,40 @@ int main()
             break;
         }
 
+        // 9 - Estatísticas (Not Listed: Latency Histograms / Counters For Diagnostics)
+        else if (menu_op1 == '9')
+        {
+            printf("\nEstatísticas De Rede:\n\n");
+            statsPrint();
+        }
+
+        // 8 - Rastreamento (Not Listed: Per-Thread Trace Rings, Read With The Standalone Reader In trace.c)
+        else if (menu_op1 == '8')
+        {
+            long records;
+            int threads_traced;
+            unsigned long dropped;
+            traceCounts(&records, &threads_traced, &dropped);
+            printf("\nRastreamento: %s | %ld Registros Em %d Thread(s) | %lu Descartados\n"
+                   "1. %s\n"
+                   "2. Gravar Em %s\n"
+                   "3. Voltar\n\n", traceEnabled() ? "Ligado" : "Desligado", records, threads_traced, dropped,
+                   traceEnabled() ? "Desligar" : "Ligar", tracePath());
+            printf("> ");
+            char trace_op;
+            scanf(" %c", &trace_op);
+            if (trace_op == '1')
+                traceEnable(!traceEnabled());
+            else if (trace_op == '2')
+            {
+                long written = traceDump(NULL);
+                if (written < 0)
+                    printf("Erro Ao Gravar %s!\n", tracePath());
+                else
+                    printf("%ld Registros Gravados Em %s\n", written, tracePath());
+            }
+        }
+
         // X - Opção Inválida
         else
         {
@@ -1090,6 +748,9 @@ int main()
         pthread_join(threads[i], NULL);
     }
 
+    statsPublishStop();
+    conversationsStop(&conversations);
+
     // Send Offline Status (USERS)
 
     setStatus(username, "Offline");
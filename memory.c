@@ -0,0 +1,247 @@
+// Allocation Accounting (memory.h)
+// Every Account Is A Few Counters Updated With Relaxed Atomics, So Lists / Buffers / Contexts Account On Every
+// Allocation Without A Lock; Only Registering A New Name And The Leak-Check Table Take One
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "memory.h"
+
+// Data Structures
+
+typedef struct
+{
+    char name[48];
+    long bytes;
+    long objects;
+    long bytes_high;
+    long objects_high;
+    unsigned long allocations;
+} MemoryAccount;
+
+typedef struct // Leak-Check Entry (pointer NULL = Empty, LEAK_DELETED = Removed)
+{
+    const void* pointer;
+    long bytes;
+    const char* origin;
+    int account;
+} MemoryLeak;
+
+#define LEAK_DELETED ((const void*)(uintptr_t)1)
+
+static MemoryAccount accounts[MEMORY_ACCOUNTS];
+static int account_count = 0;
+static pthread_mutex_t account_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static MemoryLeak leaks[MEMORY_LEAK_SLOTS];
+static unsigned long leaks_untracked = 0; // Table Full: Counted Only
+static pthread_mutex_t leak_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t leak_once = PTHREAD_ONCE_INIT;
+static int leak_check = 0;
+
+// Helpers
+
+static void raiseTo(long* high, long value)
+{
+    long seen = __atomic_load_n(high, __ATOMIC_RELAXED);
+    while (value > seen && !__atomic_compare_exchange_n(high, &seen, value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+static size_t leakSlot(const void* pointer)
+{
+    return (size_t)(((uintptr_t)pointer >> 4) * 0x9E3779B97F4A7C15ull >> 20) % MEMORY_LEAK_SLOTS;
+}
+
+static void leakExit(void)
+{
+    if (memoryLeakReport() == 0)
+        printf("MEMORY: Nenhum Resultado Pendente\n");
+}
+
+static void leakInit(void)
+{
+    const char* value = getenv(MEMORY_LEAK_ENV);
+    leak_check = value && atoi(value) > 0;
+    if (leak_check)
+        atexit(leakExit);
+}
+
+// Core Functions
+
+int memoryAccount(const char* name)
+{
+    pthread_mutex_lock(&account_lock);
+    int count = account_count;
+    int found = -1;
+    for (int i = 0; i < count && found < 0; i++)
+        if (strcmp(accounts[i].name, name) == 0)
+            found = i;
+
+    if (found < 0)
+    {
+        if (count >= MEMORY_ACCOUNTS - 1 && strcmp(name, "other") != 0) // Last Slot Kept For "other"
+        {
+            pthread_mutex_unlock(&account_lock);
+            return memoryAccount("other");
+        }
+        if (count < MEMORY_ACCOUNTS)
+        {
+            snprintf(accounts[count].name, sizeof(accounts[count].name), "%s", name);
+            __atomic_store_n(&account_count, count + 1, __ATOMIC_RELEASE);
+            found = count;
+        }
+    }
+    pthread_mutex_unlock(&account_lock);
+    return found;
+}
+
+int memoryAccountCached(int* slot, const char* name)
+{
+    int id = __atomic_load_n(slot, __ATOMIC_RELAXED);
+    if (id < 0) // Racers Resolve The Same Name To The Same Id
+    {
+        id = memoryAccount(name);
+        __atomic_store_n(slot, id, __ATOMIC_RELAXED);
+    }
+    return id;
+}
+
+void memoryAdd(int account, long bytes, long objects)
+{
+    if (account < 0 || account >= MEMORY_ACCOUNTS)
+        return;
+    MemoryAccount* entry = &accounts[account];
+
+    long now_bytes = __atomic_add_fetch(&entry->bytes, bytes, __ATOMIC_RELAXED);
+    long now_objects = __atomic_add_fetch(&entry->objects, objects, __ATOMIC_RELAXED);
+    if (objects > 0)
+        __atomic_fetch_add(&entry->allocations, (unsigned long)objects, __ATOMIC_RELAXED);
+    if (bytes > 0)
+        raiseTo(&entry->bytes_high, now_bytes);
+    if (objects > 0)
+        raiseTo(&entry->objects_high, now_objects);
+}
+
+int memoryUsage(int account, MemoryUsage* usage)
+{
+    if (account < 0 || account >= __atomic_load_n(&account_count, __ATOMIC_ACQUIRE))
+        return 0;
+    MemoryAccount* entry = &accounts[account];
+
+    usage->name = entry->name;
+    usage->bytes = __atomic_load_n(&entry->bytes, __ATOMIC_RELAXED);
+    usage->objects = __atomic_load_n(&entry->objects, __ATOMIC_RELAXED);
+    usage->bytes_high = __atomic_load_n(&entry->bytes_high, __ATOMIC_RELAXED);
+    usage->objects_high = __atomic_load_n(&entry->objects_high, __ATOMIC_RELAXED);
+    usage->allocations = __atomic_load_n(&entry->allocations, __ATOMIC_RELAXED);
+    return 1;
+}
+
+// Leak Check
+
+int memoryLeakCheck(void)
+{
+    pthread_once(&leak_once, leakInit);
+    return leak_check;
+}
+
+void memoryTrack(int account, const void* pointer, long bytes, const char* origin)
+{
+    if (!pointer)
+        return;
+    memoryAdd(account, bytes, 1);
+    if (!memoryLeakCheck())
+        return;
+
+    pthread_mutex_lock(&leak_lock);
+    size_t slot = leakSlot(pointer);
+    int probes = 0;
+    while (leaks[slot].pointer && leaks[slot].pointer != LEAK_DELETED && probes < MEMORY_LEAK_SLOTS)
+    {
+        slot = (slot + 1) % MEMORY_LEAK_SLOTS;
+        probes++;
+    }
+    if (probes < MEMORY_LEAK_SLOTS)
+    {
+        leaks[slot].pointer = pointer;
+        leaks[slot].bytes = bytes;
+        leaks[slot].origin = origin;
+        leaks[slot].account = account;
+    }
+    else
+        leaks_untracked++;
+    pthread_mutex_unlock(&leak_lock);
+}
+
+void memoryUntrack(int account, const void* pointer, long bytes)
+{
+    if (!pointer)
+        return;
+    memoryAdd(account, -bytes, -1);
+    if (!memoryLeakCheck())
+        return;
+
+    pthread_mutex_lock(&leak_lock);
+    size_t slot = leakSlot(pointer);
+    for (int probes = 0; leaks[slot].pointer && probes < MEMORY_LEAK_SLOTS; probes++)
+    {
+        if (leaks[slot].pointer == pointer)
+        {
+            leaks[slot].pointer = LEAK_DELETED;
+            break;
+        }
+        slot = (slot + 1) % MEMORY_LEAK_SLOTS;
+    }
+    pthread_mutex_unlock(&leak_lock);
+}
+
+int memoryLeakReport(void)
+{
+    if (!memoryLeakCheck())
+        return 0;
+
+    int held = 0;
+    long bytes = 0;
+    pthread_mutex_lock(&leak_lock);
+    for (int i = 0; i < MEMORY_LEAK_SLOTS; i++)
+    {
+        if (!leaks[i].pointer || leaks[i].pointer == LEAK_DELETED)
+            continue;
+        if (held == 0)
+            printf("MEMORY: Resultados Nunca Liberados:\n");
+        printf("- %p | %ld Bytes | %s\n", leaks[i].pointer, leaks[i].bytes, leaks[i].origin ? leaks[i].origin : "?");
+        bytes += leaks[i].bytes;
+        held++;
+    }
+    if (held > 0 || leaks_untracked > 0)
+        printf("MEMORY: %d Resultado(s) Pendente(s) (%ld Bytes), %lu Não Rastreado(s)\n", held, bytes, leaks_untracked);
+    pthread_mutex_unlock(&leak_lock);
+    return held;
+}
+
+// Higher Level Functions
+
+void memoryPrint(void)
+{
+    MemoryUsage usage;
+    printf("%-24s %12s %9s %12s %9s %12s\n", "Conta", "Bytes", "Objetos", "Máx Bytes", "Máx Obj.", "Alocações");
+    for (int i = 0; memoryUsage(i, &usage); i++)
+        printf("%-24s %12ld %9ld %12ld %9ld %12lu\n", usage.name, usage.bytes, usage.objects, usage.bytes_high, usage.objects_high, usage.allocations);
+    if (memoryLeakCheck())
+        memoryLeakReport();
+}
+
+int memoryFormat(char* out, size_t size)
+{
+    MemoryUsage usage;
+    int written = snprintf(out, size, "{");
+    for (int i = 0; written > 0 && (size_t)written < size && memoryUsage(i, &usage); i++)
+        written += snprintf(out + written, size - written, "%s\"%s\":[%ld,%ld,%ld,%ld]", i ? "," : "", usage.name,
+                            usage.bytes, usage.objects, usage.bytes_high, usage.objects_high);
+    if (written > 0 && (size_t)written < size)
+        written += snprintf(out + written, size - written, "}");
+    return (written > 0 && (size_t)written < size) ? written : 0;
+}
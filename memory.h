@@ -0,0 +1,53 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Constants */
+#define MEMORY_ACCOUNTS   64 // Named Accounts (Names Registered After That Are Counted Under "other")
+#define MEMORY_LEAK_ENV   "CHATMQTT_LEAK_CHECK" // 1 = Every Tracked Result Is Remembered Until Released, Leftovers Reported At Exit
+#define MEMORY_LEAK_SLOTS 4096 // Results Remembered At Once In Leak-Check Mode (Past That Only Counted)
+
+/* Allocation Accounting */
+// Bytes / Objects Held Right Now Per Named Account, With High-Water Marks (Relaxed Atomics, No Lock After Registration)
+// - "list:[NAME]"     > Nodes + Bytes Viewed Of The LinkedLists Named With listSetName() (Instances Of One Name Add Up)
+// - "buffers"         > MessageBuffers Alive (Header + Owned Bytes, Adopted Payloads Count In Their Owner's Account)
+// - "Context_[p|s|a]" > Client Contexts Alive (publisher() / subscriber*() / agentControl())
+// - "paho:messages"   > Received Messages Handed Over By The Client Library, Until transportFreeMessage()
+// - "results"         > Copies Returned By listGetGroup() / listGetGroupLeader() / listGetTopic() / ..., Until listFreeResult()
+typedef struct MemoryUsage {
+    const char* name;
+    long bytes;
+    long objects;
+    long bytes_high; // High-Water Marks
+    long objects_high;
+    unsigned long allocations; // Objects Ever Added
+} MemoryUsage;
+
+/* Core Functions */
+int memoryAccount(const char* name); // Same Name > Same Account (Cache The Result, Registration Takes A Lock)
+int memoryAccountCached(int* slot, const char* name); // memoryAccount() Once Per Slot (Static, Starts At -1) | Safe From Any Thread
+void memoryAdd(int account, long bytes, long objects); // Negative = Released
+int memoryUsage(int account, MemoryUsage* usage); // 0 = No Such Account (Accounts Are Numbered From 0)
+
+/* Leak Check */
+// Off: memoryTrack / memoryUntrack Only Move The Account | On: Also Remember Pointer, Size And Origin,
+// memoryLeakReport() Lists What Was Never Released (Also Printed At Exit)
+int memoryLeakCheck(void); // MEMORY_LEAK_ENV
+void memoryTrack(int account, const void* pointer, long bytes, const char* origin);
+void memoryUntrack(int account, const void* pointer, long bytes);
+int memoryLeakReport(void); // Results Still Held
+
+/* Higher Level Functions */
+void memoryPrint(void); // Hidden Menu Option (Table)
+int memoryFormat(char* out, size_t size); // JSON Object {"[NAME]":[BYTES,OBJECTS,BYTES_HIGH,OBJECTS_HIGH],...} | Length Written
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MEMORY_H
@@ -5,14 +5,312 @@
 #include <string.h>
 #include <pthread.h>
 #include <ctype.h>
+#include <stdint.h>
+#include <time.h>
 #include "constants.h"
 #include "messages.h"
+#include "events.h"
+#include "memory.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+// Memory Accounts (memory.h, Registered On First Use)
+
+static int account_buffers = -1;
+static int account_results = -1;
+static int account_lists = -1;
+static pthread_once_t accounts_once = PTHREAD_ONCE_INIT;
+
+static void accountsInit(void) {
+    account_buffers = memoryAccount("buffers");
+    account_results = memoryAccount("results");
+    account_lists = memoryAccount("list:other");
+}
+
+static int bufferAccount(void) {
+    pthread_once(&accounts_once, accountsInit);
+    return account_buffers;
+}
+
+static long bufferBytes(const MessageBuffer* buffer) { // Adopted Payloads Belong To Their Owner's Account
+    return (long)sizeof(MessageBuffer) + (buffer->release ? 0 : buffer->length + 1);
+}
+
+// Buffer Functions
+// A Received Payload Is Kept Once (Adopted From The Client Library When Possible) And Shared By Reference
+
+MessageBuffer* bufferAdopt(char* data, int length, void (*release)(void* owner), void* owner) { // Takes Ownership Of data
+    MessageBuffer* buffer = malloc(sizeof(MessageBuffer));
+    if (!buffer) {
+        if (release) release(owner);
+        return NULL;
+    }
+    memoryAdd(bufferAccount(), (long)sizeof(MessageBuffer), 1);
+    buffer->refs = 1;
+    buffer->data = data;
+    buffer->length = length;
+    buffer->release = release;
+    buffer->owner = owner;
+    return buffer;
+}
+
+MessageBuffer* bufferAlloc(int length) { // One Allocation: Header + length Bytes (Filled By The Caller) + Nul
+    MessageBuffer* buffer = malloc(sizeof(MessageBuffer) + length + 1);
+    if (!buffer) {
+        perror("Message Buffer Malloc Failed");
+        return NULL;
+    }
+    buffer->refs = 1;
+    buffer->data = (char*)(buffer + 1);
+    buffer->length = length;
+    buffer->release = NULL;
+    buffer->owner = NULL;
+    buffer->data[length] = '\0';
+    memoryAdd(bufferAccount(), bufferBytes(buffer), 1);
+    return buffer;
+}
+
+MessageBuffer* bufferCopy(const char* data, int length) { // Nul-Terminated Copy
+    MessageBuffer* buffer = bufferAlloc(length);
+    if (buffer) memcpy(buffer->data, data, length);
+    return buffer;
+}
+
+void bufferRetain(MessageBuffer* buffer) {
+    if (buffer) __atomic_add_fetch(&buffer->refs, 1, __ATOMIC_RELAXED);
+}
+
+void bufferRelease(MessageBuffer* buffer) {
+    if (!buffer || __atomic_sub_fetch(&buffer->refs, 1, __ATOMIC_ACQ_REL) != 0) return;
+    memoryAdd(bufferAccount(), -bufferBytes(buffer), -1);
+    if (buffer->release) buffer->release(buffer->owner);
+    free(buffer);
+}
+
+void viewRelease(MessageView* view) {
+    bufferRelease(view->buffer);
+    view->buffer = NULL;
+    view->data = NULL;
+    view->length = 0;
+}
+
+// Helpers
+
+// Nul-Terminated Heap Copy (For Callers Outside The Hot Path), Accounted As "results" Until listFreeResult()
+// The Accounted Size Sits In Front Of The Copy (The Data May Hold A '\0', strlen() Would Not Match It)
+static char* viewDup(const char* data, int length, const char* origin) {
+    long* header = malloc(sizeof(long) + length + 1);
+    if (!header)
+        return NULL;
+    *header = length + 1;
+    char* result = (char*)(header + 1);
+    memcpy(result, data, length);
+    result[length] = '\0';
+    pthread_once(&accounts_once, accountsInit);
+    memoryTrack(account_results, result, *header, origin);
+    return result;
+}
+
+static int viewEquals(const Node* node, const char* message) {
+    size_t len = strlen(message);
+    return (size_t)node->length == len && memcmp(node->message, message, len) == 0;
+}
+
+// Field "index" Of A View Split By delimiter (Empty Fields Skipped, Like strtok) | Returns Its Length (0 = Missing)
+static int viewField(const char* data, int length, char delimiter, int index, const char** field) {
+    int i = 0;
+    *field = data;
+    while (i < length) {
+        while (i < length && data[i] == delimiter) i++;
+        if (i == length) break;
+        int start = i;
+        while (i < length && data[i] != delimiter) i++;
+        if (index-- == 0) {
+            *field = data + start;
+            return i - start;
+        }
+    }
+    return 0;
+}
+
+static void nodeAccount(LinkedList* list, int length, int sign) { // List Lock Held
+    long bytes = (long)sizeof(Node) + length;
+    list->stats.bytes += sign * bytes;
+    if (list->stats.bytes > list->stats.bytes_high_water) list->stats.bytes_high_water = list->stats.bytes;
+    memoryAdd(list->account, sign * bytes, sign);
+}
+
+static void nodeFree(Node* node) {
+    bufferRelease(node->buffer);
+    free(node);
+}
+
+static void deadlineAfter(struct timespec* deadline, int timeout_ms) { // Absolute Time For pthread_cond_timedwait
+    clock_gettime(CLOCK_REALTIME, deadline);
+    deadline->tv_sec += timeout_ms / 1000;
+    deadline->tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+// Queue Limit Helpers (List Lock Held)
+
+static void listNotify(LinkedList* list) {
+    #if !defined(_WIN32)
+    if (list->notify_fd >= 0) {
+        uint64_t one = 1; // eventfd Counter Increment (A Pipe Just Receives 8 Bytes)
+        if (write(list->notify_fd, &one, sizeof(one)) < 0) { /* Reader Already Signaled */ }
+    }
+    #endif
+}
+
+static int nodePush(LinkedList* list, MessageBuffer* buffer, const char* data, int length) { // Newest End (Head)
+    Node* new_node = malloc(sizeof(Node));
+    if (!new_node) {
+        perror("List Node Malloc Failed");
+        return 0;
+    }
+
+    bufferRetain(buffer);
+    new_node->buffer = buffer;
+    new_node->message = data;
+    new_node->length = length;
+    new_node->next = list->head;
+    list->head = new_node;
+
+    if (++list->stats.count > list->stats.high_water) list->stats.high_water = list->stats.count;
+    nodeAccount(list, length, 1);
+    pthread_cond_signal(&list->filled);
+    return 1;
+}
+
+static void dropOldest(LinkedList* list) {
+    Node** link = &list->head;
+    if (!*link) return;
+    while ((*link)->next) link = &(*link)->next;
+
+    nodeAccount(list, (*link)->length, -1);
+    nodeFree(*link);
+    *link = NULL;
+    list->stats.count--;
+    list->stats.dropped++;
+}
+
+static void spillClose(LinkedList* list) { // Also Resets The File Once Everything Was Read Back
+    if (list->spill) fclose(list->spill);
+    list->spill = NULL;
+    list->spill_read = 0;
+    list->spill_write = 0;
+    list->stats.spilled = 0;
+}
+
+static int spillWrite(LinkedList* list, const char* data, int length) { // Appends [LENGTH][BYTES] | 0 = Disk Error
+    if (!list->spill && !(list->spill = tmpfile())) return 0;
+
+    if (fseek(list->spill, list->spill_write, SEEK_SET) != 0 ||
+        fwrite(&length, sizeof(length), 1, list->spill) != 1 ||
+        (length > 0 && fwrite(data, length, 1, list->spill) != 1))
+        return 0; // A Partial Record Is Overwritten By The Next One
+
+    list->spill_write += (long)sizeof(length) + length;
+    list->stats.spilled++;
+    return 1;
+}
+
+static void spillRefill(LinkedList* list) { // Moves The Oldest Spilled Message Into The List
+    int length;
+    MessageBuffer* buffer = NULL;
+
+    if (list->stats.spilled == 0) return;
+
+    if (fseek(list->spill, list->spill_read, SEEK_SET) != 0 || fread(&length, sizeof(length), 1, list->spill) != 1 || length < 0 ||
+        !(buffer = bufferAlloc(length)) || (length > 0 && fread(buffer->data, length, 1, list->spill) != 1)) {
+        bufferRelease(buffer); // Unreadable Spill: Everything In It Is Lost
+        list->stats.dropped += list->stats.spilled;
+        spillClose(list);
+        return;
+    }
+
+    list->spill_read += (long)sizeof(length) + length;
+    if (--list->stats.spilled == 0) spillClose(list);
+
+    nodePush(list, buffer, buffer->data, length);
+    bufferRelease(buffer);
+}
+
+static void nodeRemoved(LinkedList* list, int length) { // A Message Left: Make Room For Blocked Producers / Spilled Messages
+    list->stats.count--;
+    nodeAccount(list, length, -1);
+    if (list->policy == LIST_SPILL) spillRefill(list);
+    pthread_cond_broadcast(&list->room);
+}
 
 // Basic Functions
 
 void listInit(LinkedList* list) { // Initialize List
     list->head = NULL;
+    list->notify_fd = -1;
+    list->capacity = 0;
+    list->policy = LIST_UNBOUNDED;
+    list->spill = NULL;
+    list->spill_read = 0;
+    list->spill_write = 0;
+    memset(&list->stats, 0, sizeof(list->stats));
+    pthread_once(&accounts_once, accountsInit);
+    list->account = account_lists;
     pthread_mutex_init(&list->lock, NULL);
+    pthread_cond_init(&list->room, NULL);
+    pthread_cond_init(&list->filled, NULL);
+}
+
+void listSetNotify(LinkedList* list, int fd) { // Wake Up A poll() On fd (eventfd / pipe) Whenever A Message Is Inserted
+    pthread_mutex_lock(&list->lock);
+    list->notify_fd = fd;
+    pthread_mutex_unlock(&list->lock);
+}
+
+void listSetName(LinkedList* list, const char* name) { // Moves What The List Holds Into "list:[NAME]"
+    char account_name[48];
+    snprintf(account_name, sizeof(account_name), "list:%s", name);
+    int account = memoryAccount(account_name);
+
+    pthread_mutex_lock(&list->lock);
+    memoryAdd(list->account, -list->stats.bytes, -list->stats.count);
+    list->account = account;
+    memoryAdd(list->account, list->stats.bytes, list->stats.count);
+    pthread_mutex_unlock(&list->lock);
+}
+
+// Bounds The Messages Kept In Memory (capacity 0 / LIST_UNBOUNDED = No Limit)
+void listSetLimit(LinkedList* list, int capacity, ListPolicy policy) {
+    pthread_mutex_lock(&list->lock);
+    list->capacity = capacity > 0 ? capacity : 0;
+    list->policy = list->capacity ? policy : LIST_UNBOUNDED;
+    pthread_cond_broadcast(&list->room);
+    pthread_mutex_unlock(&list->lock);
+}
+
+ListStats listGetStats(LinkedList* list) {
+    pthread_mutex_lock(&list->lock);
+    ListStats stats = list->stats;
+    pthread_mutex_unlock(&list->lock);
+    return stats;
+}
+
+static const char* const policy_names[] = { "none", "block", "drop", "spill" };
+
+ListPolicy listPolicyParse(const char* name, ListPolicy fallback) { // "none" | "block" | "drop" | "spill"
+    for (int i = 0; name && i < (int)(sizeof(policy_names) / sizeof(policy_names[0])); i++)
+        if (strcmp(name, policy_names[i]) == 0) return (ListPolicy)i;
+    return fallback;
+}
+
+const char* listPolicyName(ListPolicy policy) {
+    return policy_names[policy];
 }
 
 void listDestroy(LinkedList* list) {
@@ -21,31 +319,55 @@ void listDestroy(LinkedList* list) {
     while (curr) {
         Node* temp = curr;
         curr = curr->next;
-        free(temp);
+        nodeAccount(list, temp->length, -1);
+        nodeFree(temp);
     }
+    spillClose(list);
     pthread_mutex_unlock(&list->lock);
+    pthread_cond_destroy(&list->room);
+    pthread_cond_destroy(&list->filled);
     pthread_mutex_destroy(&list->lock);
 }
 
-void listInsert(LinkedList* list, const char* message) {
+void listInsertView(LinkedList* list, MessageBuffer* buffer, const char* data, int length) { // Takes A New Reference To buffer (No Copy)
+    if (!buffer) return;
+
     pthread_mutex_lock(&list->lock);
 
-    Node* new_node = malloc(sizeof(Node));
-    if (!new_node) {
-        perror("List Node Malloc Failed");
-        pthread_mutex_unlock(&list->lock);
-        return;
+    // Full (Or Older Messages Still On Disk): Apply The Policy
+
+    if (list->capacity > 0 && (list->stats.count >= list->capacity || list->stats.spilled > 0)) {
+        if (list->policy == LIST_SPILL && spillWrite(list, data, length)) {
+            listNotify(list);
+            pthread_mutex_unlock(&list->lock);
+            return;
+        }
+
+        if (list->policy == LIST_BLOCK && list->stats.count >= list->capacity) {
+            struct timespec deadline;
+            deadlineAfter(&deadline, LIST_BLOCK_TIMEOUT_MS);
+
+            list->stats.blocked++;
+            while (list->stats.count >= list->capacity && list->capacity > 0)
+                if (pthread_cond_timedwait(&list->room, &list->lock, &deadline) != 0) break;
+        }
+
+        if (list->capacity > 0 && list->stats.count >= list->capacity) dropOldest(list); // Drop Policy / Block Timed Out / Disk Error
     }
 
-    strncpy(new_node->message, message, sizeof(new_node->message) - 1);
-    new_node->message[sizeof(new_node->message) - 1] = '\0'; // Safety
-    new_node->next = list->head;
-    list->head = new_node;
+    if (nodePush(list, buffer, data, length)) listNotify(list);
 
     pthread_mutex_unlock(&list->lock);
 }
 
-char* listGetLast(LinkedList* list) {
+void listInsert(LinkedList* list, const char* message) { // Copies message
+    MessageBuffer* buffer = bufferCopy(message, (int)strlen(message));
+    if (!buffer) return;
+    listInsertView(list, buffer, buffer->data, buffer->length);
+    bufferRelease(buffer);
+}
+
+char* listGetLast(LinkedList* list) { // Oldest Message As A Nul-Terminated Copy, Left Queued (Release With listFreeResult())
     if (!list) return NULL;
 
     pthread_mutex_lock(&list->lock);
@@ -58,58 +380,66 @@ char* listGetLast(LinkedList* list) {
 
     while (curr->next) curr = curr->next;
 
-    char* result = malloc(strlen(curr->message) + 1);
-    if (result) strcpy(result, curr->message);
+    char* result = viewDup(curr->message, curr->length, "listGetLast");
 
     pthread_mutex_unlock(&list->lock);
     return result;
 }
 
-char* listPopLast(LinkedList* list) {
-    if (!list) return NULL;
+static int popOldest(LinkedList* list, MessageView* view) { // List Lock Held
+    Node** link = &list->head;
+    if (!*link) return 0; // empty
 
-    pthread_mutex_lock(&list->lock);
+    while ((*link)->next) link = &(*link)->next;
 
-    Node* curr = list->head;
-    if (!curr) { // empty
-        pthread_mutex_unlock(&list->lock);
-        return NULL;
-    }
+    Node* last = *link;
+    *link = NULL;
 
-    if (!curr->next) { // single node
-        char* result = malloc(strlen(curr->message) + 1);
-        if (result) strcpy(result, curr->message);
-        free(curr);
-        list->head = NULL;
-        pthread_mutex_unlock(&list->lock);
-        return result;
-    }
+    view->buffer = last->buffer;
+    view->data = last->message;
+    view->length = last->length;
+    free(last);
+    nodeRemoved(list, view->length);
+    return 1;
+}
 
-    Node* prev = curr;
-    curr = curr->next;
-    while (curr->next) {
-        prev = curr;
-        curr = curr->next;
-    }
+int listPopView(LinkedList* list, MessageView* view) { // Oldest Message, Reference Handed To The Caller (viewRelease)
+    if (!list) return 0;
 
-    // curr is last, prev is second-last
-    char* result = malloc(strlen(curr->message) + 1);
-    if (result) strcpy(result, curr->message);
+    pthread_mutex_lock(&list->lock);
+    int popped = popOldest(list, view);
+    pthread_mutex_unlock(&list->lock);
+    return popped;
+}
 
-    prev->next = NULL;
-    free(curr);
+int listWaitView(LinkedList* list, MessageView* view, int timeout_ms) { // listPopView, Waiting Up To timeout_ms For A Message
+    struct timespec deadline;
+    deadlineAfter(&deadline, timeout_ms);
 
+    pthread_mutex_lock(&list->lock);
+    while (!list->head)
+        if (pthread_cond_timedwait(&list->filled, &list->lock, &deadline) != 0) break;
+    int popped = popOldest(list, view);
     pthread_mutex_unlock(&list->lock);
+    return popped;
+}
+
+char* listPopLast(LinkedList* list) { // Oldest Message As A Nul-Terminated Copy (Release With listFreeResult())
+    MessageView view;
+    if (!listPopView(list, &view)) return NULL;
+
+    char* result = viewDup(view.data, view.length, "listPopLast");
+    viewRelease(&view);
     return result;
 }
 
 void listPopPrintAll(LinkedList* list) {
     if (!list) return;
 
-    char* msg;
-    while ((msg = listPopLast(list)) != NULL) {
-        printf("%s\n", msg);
-        free(msg);
+    MessageView view;
+    while (listPopView(list, &view)) {
+        printf("%.*s\n", view.length, view.data);
+        viewRelease(&view);
     }
 }
 
@@ -118,12 +448,14 @@ void listDelete(LinkedList* list, const char* message) {
 
     Node *curr = list->head, *prev = NULL;
     while (curr) {
-        if (strcmp(curr->message, message) == 0) {
+        if (viewEquals(curr, message)) {
             if (prev)
                 prev->next = curr->next;
             else
                 list->head = curr->next;
-            free(curr);
+            int length = curr->length;
+            nodeFree(curr);
+            nodeRemoved(list, length);
             break;
         }
         prev = curr;
@@ -141,7 +473,7 @@ int listSearch(LinkedList* list, const char* message) {
     Node* curr = list->head;
     int found = 0;
     while (curr) {
-        if (strcmp(curr->message, message) == 0) {
+        if (viewEquals(curr, message)) {
             found = 1;
             break;
         }
@@ -159,7 +491,7 @@ void listPrint(const LinkedList* list) {
 
     Node* curr = list->head;
     while (curr) {
-        printf("%s\n", curr->message);
+        printf("%.*s\n", curr->length, curr->message);
         curr = curr->next;
     }
 
@@ -175,9 +507,13 @@ void listClear(LinkedList* list) {
     while (curr) {
         Node* tmp = curr;
         curr = curr->next;
-        free(tmp);
+        nodeAccount(list, tmp->length, -1);
+        nodeFree(tmp);
     }
     list->head = NULL;
+    list->stats.count = 0;
+    spillClose(list);
+    pthread_cond_broadcast(&list->room);
 
     pthread_mutex_unlock(&list->lock);
 }
@@ -199,15 +535,12 @@ void listPrintStatus(const LinkedList* list) {
 
     Node* curr = list->head;
     while (curr) {
-        char message[1024];
-        strncpy(message, curr->message, sizeof(message) - 1);
-        message[sizeof(message) - 1] = '\0';  // Ensure Null Termination
-
-        char* username = strtok(message, ":");  // Username
-        char* status = strtok(NULL, ":");       // Status
+        const char *username, *status;
+        int username_len = viewField(curr->message, curr->length, ':', 0, &username); // Username
+        int status_len = viewField(curr->message, curr->length, ':', 1, &status); // Status
 
-        if (username && status) {
-            printf("%s | %s\n", username, status);
+        if (username_len && status_len) {
+            printf("%.*s | %.*s\n", username_len, username, status_len, status);
         }
 
         curr = curr->next;
@@ -223,32 +556,26 @@ void listPrintGroups(const LinkedList* list) {
 
     Node* curr = list->head;
     while (curr) {
-        char message[1024];
-        strncpy(message, curr->message, sizeof(message) - 1);
-        message[sizeof(message) - 1] = '\0';  // Ensure Null Termination
-
-        char* groupname = strtok(message, ":"); // Group Name
-        char* leader = strtok(NULL, ":"); // Group Leader
-        char* members = strtok(NULL, ":"); // Group Members
+        const char *groupname, *leader, *members;
+        int groupname_len = viewField(curr->message, curr->length, ':', 0, &groupname); // Group Name
+        int leader_len = viewField(curr->message, curr->length, ':', 1, &leader); // Group Leader
+        int members_len = viewField(curr->message, curr->length, ':', 2, &members); // Group Members
 
         printf("\n");
 
-        if (groupname) {
-            printf("%s\n", groupname);
+        if (groupname_len) {
+            printf("%.*s\n", groupname_len, groupname);
         }
 
-        if (leader) {
-            printf("Líder: %s\n", leader);
+        if (leader_len) {
+            printf("Líder: %.*s\n", leader_len, leader);
         }
 
         printf("Membros: ");
-        if (members) {
-            char *member = strtok(members, ";");
-            while (member) {
-                printf("%s", member);
-                member = strtok(NULL, ";");
-                if (member) printf(", ");
-            }
+        const char* member;
+        int member_len;
+        for (int i = 0; (member_len = viewField(members, members_len, ';', i, &member)) > 0; i++) {
+            printf(i ? ", %.*s" : "%.*s", member_len, member);
         }
 
         printf("\n");
@@ -266,27 +593,12 @@ void listPrintRequests(const LinkedList* list) {
 
     Node* curr = list->head;
     while (curr) {
-        char message[1024];
-        strncpy(message, curr->message, sizeof(message) - 1);
-        message[sizeof(message) - 1] = '\0';  // Ensure Null Termination
-
-        char* request_type = strtok(message, ":"); // Request Type (USER_REQUEST | GROUP_REQUEST)
-        char* request_body = strtok(NULL, ":"); // User (Sender)
+        Event event; // USER_REQUEST:[USERNAME] | GROUP_REQUEST:[GROUP];[USERNAME]
 
         printf("\n");
 
-        if (request_type && strstr(request_type, "USER_REQUEST") != NULL)
-        {
-            // request_body = [USERNAME]
-            printf("- Solicitação De Conversa Com: %s.", request_body);
-        }
-        if (request_type && strstr(request_type, "GROUP_REQUEST") != NULL)
-        {
-            // request_body = [GROUP];[USERNAME]
-            char* request_group = strtok(request_body, ";");
-            char* request_username = strtok(NULL, ";");
-            printf("- Solicitação De Entrada No Grupo: %s. Pelo Usuário: %s.", request_group, request_username);
-        }
+        if (eventDecode(curr->message, curr->length, &event))
+            eventPrint(&event, EVENT_VIEW_REQUESTS);
 
         printf("\n");
 
@@ -303,88 +615,12 @@ void listPrintHistory(const LinkedList* list, const char *username) {
 
     Node* curr = list->head;
     while (curr) {
-
-        char message[1024];
-        strncpy(message, curr->message, sizeof(message) - 1);
-        message[sizeof(message) - 1] = '\0';  // Ensure Null Termination
-
-        char* request_type = strtok(message, ":"); // (constants.h)
-        char* request_body = strtok(NULL, ":"); // (constants.h)
+        Event event; // (constants.h)
 
         printf("\n");
 
-        if (request_type)
-        {
-            if (strstr(request_type, "GROUP_CREATED") != NULL)
-            {
-                // request_body = [GROUPNAME];[TOPIC]
-                char* request_group = strtok(request_body, ";");
-                char* request_topic = strtok(NULL, ";");
-                printf("- Você Criou O Grupo: %s.", request_group);
-            }
-            if (strstr(request_type, "USER_REQUEST_SENT") != NULL)
-            {
-                // request_body = [USERNAME]
-                printf("- Você Enviou Uma Solicitação De Conversa Para: %s.", request_body);
-            }
-            if (strstr(request_type, "GROUP_REQUEST_SENT") != NULL)
-            {
-                // request_body = [GROUPNAME];[USERNAME]
-                char* request_group = strtok(request_body, ";");
-                char* request_username = strtok(NULL, ";");
-                printf("- Você Enviou Uma Solicitação De Entrada No Grupo: %s. Possuindo O Líder: %s.", request_group, request_username);
-            }
-            if (strstr(request_type, "USER_REQUEST_ACCEPTED") != NULL)
-            {
-                // request_body = [USERNAME];[TOPIC]
-                char* request_username = strtok(request_body, ";");
-                printf("- Solicitação De Conversa Para: %s. Aceita!", request_username);
-            }
-            if (strstr(request_type, "GROUP_REQUEST_ACCEPTED") != NULL)
-            {
-                // request_body = [GROUPNAME];[USERNAME];[TOPIC]
-                char* request_groupname = strtok(request_body, ";");
-                char* request_username = strtok(NULL, ";");
-                printf("- Solicitação De Entrada No Grupo: %s. Possuindo O Líder: %s. Aceita!", request_groupname, request_username);
-            }
-            if (strstr(request_type, "USER_REQUEST_REJECTED") != NULL)
-            {
-                // request_body = [USERNAME]
-                printf("- Solicitação De Conversa Para: %s. Rejeitada.", request_body);
-            }
-            if (strstr(request_type, "GROUP_REQUEST_REJECTED") != NULL)
-            {
-                // request_body = [GROUPNAME];[USERNAME]
-                char* request_groupname = strtok(request_body, ";");
-                char* request_username = strtok(NULL, ";");
-                printf("- Solicitação De Entrada No Grupo: %s. Possuindo O Líder: %s. Rejeitada.", request_groupname, request_username);
-            }
-            if (strstr(request_type, "USER_ACCEPTED") != NULL)
-            {
-                // request_body = [USERNAME];[TOPIC]
-                char* request_username = strtok(request_body, ";");
-                printf("- Você Aceitou A Solicitação De Conversa Com O Usuário: %s. ", request_username);
-            }
-            if (strstr(request_type, "GROUP_ACCEPTED") != NULL)
-            {
-                // request_body = [GROUPNAME];[USERNAME]
-                char* request_groupname = strtok(request_body, ";");
-                char* request_username = strtok(NULL, ";");
-                printf("- Você Aceitou A Solicitação De Entrada No Grupo: %s. Pelo Usuário: %s.", request_groupname, request_username);
-            }
-            if (strstr(request_type, "USER_REJECTED") != NULL)
-            {
-                // request_body = [USERNAME]
-                printf("- Você Rejeitou A Solicitação De Conversa Com O Usuário: %s.", request_body);
-            }
-            if (strstr(request_type, "GROUP_REJECTED") != NULL)
-            {
-                // request_body = [GROUPNAME];[USERNAME]
-                char* request_groupname = strtok(request_body, ";");
-                char* request_username = strtok(NULL, ";");
-                printf("- Você Rejeitou A Solicitação De Entrada No Grupo: %s. Pelo Usuário: %s.", request_groupname, request_username);
-            }
-        }
+        if (eventDecode(curr->message, curr->length, &event))
+            eventPrint(&event, EVENT_VIEW_HISTORY);
 
         printf("\n");
 
@@ -401,29 +637,10 @@ void listPrintChats(const LinkedList* list, const char *username) {
 
     Node* curr = list->head;
     while (curr) {
+        Event event; // Events That Open A Conversation (events.h)
 
-        char message[1024];
-        strncpy(message, curr->message, sizeof(message) - 1);
-        message[sizeof(message) - 1] = '\0';  // Ensure Null Termination
-
-        char* request_type = strtok(message, ":"); // (constants.h)
-        char* request_body = strtok(NULL, ":"); // (constants.h)
-
-        if (request_type)
-        {
-            if (strstr(request_type, "GROUP_CREATED") != NULL || strstr(request_type, "GROUP_REQUEST_ACCEPTED") != NULL)
-            {
-                // request_body = [GROUPNAME];[TOPIC]
-                char* group = strtok(request_body, ";");
-                printf("- Grupo: %s\n", group);
-            }
-            if ((strstr(request_type, "USER_REQUEST_ACCEPTED") != NULL || strstr(request_type, "USER_ACCEPTED") != NULL) && request_body != NULL)
-            {
-                // request_body = [USERNAME];[TOPIC]
-                char* user = strtok(request_body, ";");
-                printf("- Usuário: %s\n", user);
-            }
-        }
+        if (eventDecode(curr->message, curr->length, &event))
+            eventPrint(&event, EVENT_VIEW_CHATS);
 
         curr = curr->next;
     }
@@ -433,60 +650,49 @@ void listPrintChats(const LinkedList* list, const char *username) {
     pthread_mutex_unlock((pthread_mutex_t*)&list->lock);
 }
 
-char* listGetGroup(const LinkedList* groups_list, const char* group, const char* leader)
+char* listGetGroup(const LinkedList* groups_list, const char* group, const char* leader) // Release With listFreeResult()
 {
     pthread_mutex_lock((pthread_mutex_t*)&groups_list->lock);
 
-    char formmated_target[512];
-    char formmated_list[512];
-    snprintf(formmated_target, sizeof(formmated_target), "%s:%s", group, leader);
+    size_t group_len = strlen(group);
+    size_t leader_len = strlen(leader);
 
     Node* curr = groups_list->head;
     while (curr) {
-        char message[1024];
-        strncpy(message, curr->message, sizeof(message) - 1);
-        message[sizeof(message) - 1] = '\0';
-
-        char* list_group = strtok(message, ":");
-        char* list_leader = strtok(NULL, ":");
+        const char *list_group, *list_leader;
+        int list_group_len = viewField(curr->message, curr->length, ':', 0, &list_group);
+        int list_leader_len = viewField(curr->message, curr->length, ':', 1, &list_leader);
 
-        if (list_group && list_leader)
+        if ((size_t)list_group_len == group_len && memcmp(list_group, group, group_len) == 0 &&
+            (size_t)list_leader_len == leader_len && memcmp(list_leader, leader, leader_len) == 0)
         {
-            snprintf(formmated_list, sizeof(formmated_list), "%s:%s", list_group, list_leader);
-
-            if (strcmp(formmated_target, formmated_list) == 0)
-            {
-                char* result = malloc(strlen(curr->message) + 1);
-                strcpy(result, curr->message);
-                pthread_mutex_unlock((pthread_mutex_t*)&groups_list->lock);
-                return result;
-            }
-
-            curr = curr->next;
+            char* result = viewDup(curr->message, curr->length, "listGetGroup");
+            pthread_mutex_unlock((pthread_mutex_t*)&groups_list->lock);
+            return result;
         }
+
+        curr = curr->next;
     }
 
     pthread_mutex_unlock((pthread_mutex_t*)&groups_list->lock);
+    return NULL;
 }
 
-char* listGetGroupLeader(const LinkedList* groups_list, const char* group)
+char* listGetGroupLeader(const LinkedList* groups_list, const char* group) // Release With listFreeResult()
 {
     pthread_mutex_lock((pthread_mutex_t*)&groups_list->lock);
 
+    size_t group_len = strlen(group);
+
     Node* curr = groups_list->head;
     while (curr) {
-        char message[1024];
-        strncpy(message, curr->message, sizeof(message) - 1);
-        message[sizeof(message) - 1] = '\0';
-
-        char* groupname = strtok(message, ":"); // Group Name
-        char* leader = strtok(NULL, ":"); // Group Leader
-        char* members = strtok(NULL, ":"); // Group Members
+        const char *groupname, *leader;
+        int groupname_len = viewField(curr->message, curr->length, ':', 0, &groupname); // Group Name
+        int leader_len = viewField(curr->message, curr->length, ':', 1, &leader); // Group Leader
 
-        if (groupname && leader && strcmp(groupname, group) == 0)
+        if (leader_len && (size_t)groupname_len == group_len && memcmp(groupname, group, group_len) == 0)
         {
-            char* result = malloc(strlen(leader) + 1);
-            strcpy(result, leader);
+            char* result = viewDup(leader, leader_len, "listGetGroupLeader");
             pthread_mutex_unlock((pthread_mutex_t*)&groups_list->lock);
             return result;
         }
@@ -495,87 +701,79 @@ char* listGetGroupLeader(const LinkedList* groups_list, const char* group)
     }
 
     pthread_mutex_unlock((pthread_mutex_t*)&groups_list->lock);
+    return NULL;
 }
 
-char* listGetTopic(const LinkedList* history_list, const char* target)
+char* listGetTopic(const LinkedList* history_list, const char* target) // Release With listFreeResult()
 {
     pthread_mutex_lock((pthread_mutex_t*)&history_list->lock);
 
     Node* curr = history_list->head;
     while (curr) {
-        char message[1024];
-        strncpy(message, curr->message, sizeof(message) - 1);
-        message[sizeof(message) - 1] = '\0';
-
-        char* type = strtok(message, ":");
+        Event event;
 
-        if (type)
+        // GROUP_CREATED / USER_ACCEPTED / USER_REQUEST_ACCEPTED: [NAME];[TOPIC] | GROUP_REQUEST_ACCEPTED: [GROUP];[LEADER];[TOPIC]
+        if (eventDecode(curr->message, curr->length, &event) && event_schema[event.type].chat_link >= 0 && eventFieldIs(&event, 0, target))
         {
-            if (strcmp(type, "GROUP_CREATED") != 0 && strcmp(type, "GROUP_REQUEST_ACCEPTED") != 0 && strcmp(type, "USER_ACCEPTED") != 0 && strcmp(type, "USER_REQUEST_ACCEPTED") != 0)
-            {
-                curr = curr->next;
-                continue;
-            }
-
-            if (strcmp(type, "GROUP_CREATED") == 0 || strcmp(type, "USER_ACCEPTED") == 0 || strcmp(type, "USER_REQUEST_ACCEPTED") == 0)
-            {
-                char* name = strtok(NULL, ";");
-                char* topic = strtok(NULL, ";");
-                
-                if (name && topic)
-                {
-                    if (strcmp(name, target) == 0)
-                    {
-                        char* result = malloc(strlen(topic) + 1);
-                        strcpy(result, topic);
-                        pthread_mutex_unlock((pthread_mutex_t*)&history_list->lock);
-                        return result;
-                    }
-                }
-            }
-            else
-            {
-                char* groupname = strtok(NULL, ";");
-                char* leader = strtok(NULL, ";");
-                char* topic = strtok(NULL, ";");
-                
-                if (groupname && leader && topic)
-                {
-                    if (strcmp(groupname, target) == 0)
-                    {
-                        char* result = malloc(strlen(topic) + 1);
-                        strcpy(result, topic);
-                        pthread_mutex_unlock((pthread_mutex_t*)&history_list->lock);
-                        return result;
-                    }
-                }
-            }
-
-            curr = curr->next; 
+            const EventField* topic = &event.fields[event_schema[event.type].chat_link];
+            char* result = viewDup(topic->ptr, topic->len, "listGetTopic");
+            pthread_mutex_unlock((pthread_mutex_t*)&history_list->lock);
+            return result;
         }
+
+        curr = curr->next;
     }
 
     pthread_mutex_unlock((pthread_mutex_t*)&history_list->lock);
     return NULL;
 }
 
+void listFreeResult(char* result) {
+    if (!result) return;
+    pthread_once(&accounts_once, accountsInit);
+    long* header = (long*)result - 1;
+    memoryUntrack(account_results, result, *header);
+    free(header);
+}
+
 int listSearchFirstParameter(LinkedList* list, const char* target) {
     pthread_mutex_lock(&list->lock);
 
+    size_t target_len = strlen(target);
     Node* curr = list->head;
     int found = 0;
 
     while (curr) {
-        char message[1024];
-        strncpy(message, curr->message, sizeof(message) - 1);
-        message[sizeof(message) - 1] = '\0';
+        const char* first;
+        int first_len = viewField(curr->message, curr->length, ':', 0, &first);
+
+        if (first_len && (size_t)first_len == target_len && memcmp(first, target, target_len) == 0) {
+            found = 1;
+            break;
+        }
+        curr = curr->next;
+    }
+
+    pthread_mutex_unlock(&list->lock);
+    return found;
+}
 
-        char* first = strtok(message, ":");
+int listSearchEvent(LinkedList* list, const char* payload) { // Same Event Stored In Either Wire Format (events.h)
+    Event target;
+    if (!list || !eventDecode(payload, -1, &target)) return 0;
 
-        if (first && strcmp(first, target) == 0) {
+    pthread_mutex_lock(&list->lock);
+
+    Node* curr = list->head;
+    int found = 0;
+    while (curr) {
+        Event event;
+
+        if (eventDecode(curr->message, curr->length, &event) && eventEquals(&event, &target)) {
             found = 1;
             break;
         }
+
         curr = curr->next;
     }
 
@@ -591,21 +789,9 @@ int listSearchConversation(LinkedList* list, const char* target) {
     Node* curr = list->head;
     int found = 0;
     while (curr) {
-        char message[1024];
-        strncpy(message, curr->message, sizeof(message) - 1);
-        message[sizeof(message) - 1] = '\0';
-
-        char* type = strtok(message, ":");
-        if (!type) { curr = curr->next; continue; }
+        Event event;
 
-        if (strcmp(type, "GROUP_CREATED") != 0 && strcmp(type, "GROUP_REQUEST_ACCEPTED") != 0 &&
-            strcmp(type, "USER_ACCEPTED") != 0 && strcmp(type, "USER_REQUEST_ACCEPTED") != 0) {
-            curr = curr->next;
-            continue;
-        }
-
-        char* name = strtok(NULL, ";");
-        if (name && strcmp(name, target) == 0) {
+        if (eventDecode(curr->message, curr->length, &event) && event_schema[event.type].chat_link >= 0 && eventFieldIs(&event, 0, target)) {
             found = 1;
             break;
         }
@@ -626,16 +812,9 @@ int listSearchChat(LinkedList* list) {
     int found = 0;
 
     while (curr) {
-        char message[1024];
-        strncpy(message, curr->message, sizeof(message) - 1);
-        message[sizeof(message) - 1] = '\0';
-
-        char* type = strtok(message, ":");
-        if (type && (
-            strcmp(type, "GROUP_CREATED") == 0 ||
-            strcmp(type, "GROUP_REQUEST_ACCEPTED") == 0 ||
-            strcmp(type, "USER_ACCEPTED") == 0 ||
-            strcmp(type, "USER_REQUEST_ACCEPTED") == 0))
+        Event event;
+
+        if (eventDecode(curr->message, curr->length, &event) && event_schema[event.type].chat_link >= 0)
         {
             found = 1;
             break;
@@ -1,6 +1,7 @@
 #ifndef MESSAGES_H
 #define MESSAGES_H
 
+#include <stdio.h>
 #include <pthread.h>
 
 #ifdef __cplusplus
@@ -8,21 +9,84 @@ extern "C" {
 #endif
 
 /* Data Structures */
+typedef struct MessageBuffer { // Received Payload Shared By Every View Into It (Freed By The Last Release)
+    int refs;
+    char* data;
+    int length;
+    void (*release)(void* owner); // Frees The Storage (NULL = data Was malloc'd Here)
+    void* owner; // e.g. The Adopted MQTTAsync_message
+} MessageBuffer;
+
+typedef struct MessageView { // Bytes Inside A Buffer (Not Nul-Terminated) + The Reference Keeping Them Alive
+    MessageBuffer* buffer;
+    const char* data;
+    int length;
+} MessageView;
+
 typedef struct Node {
-    char message[1024];
+    MessageBuffer* buffer; // Reference Held By The Node
+    const char* message; // View Into buffer (Not Nul-Terminated)
+    int length;
     struct Node* next;
 } Node;
 
+/* Queue Limits */
+#define LIST_BLOCK_TIMEOUT_MS 5000 // LIST_BLOCK: Longest Wait For Room Before The Oldest Message Is Dropped
+
+typedef enum ListPolicy { // What An Insert Does When The List Is Full
+    LIST_UNBOUNDED, // No Limit (Default)
+    LIST_BLOCK, // The Producer Waits For Room (Backpressure Up To The Client Library / Broker)
+    LIST_DROP_OLDEST, // The Oldest Message Is Dropped
+    LIST_SPILL // Overflow Goes To A Temporary File, Read Back In Order As Room Frees Up
+} ListPolicy;
+
+typedef struct ListStats {
+    int count; // Messages In Memory
+    int high_water; // Largest count Reached
+    long bytes; // Nodes + Bytes Viewed In Memory (A Buffer Shared With Other Lists Counts In Each)
+    long bytes_high_water;
+    long spilled; // Messages Waiting On Disk (LIST_SPILL)
+    unsigned long dropped; // Messages Lost To The Limit
+    unsigned long blocked; // Inserts That Had To Wait (LIST_BLOCK)
+} ListStats;
+
 typedef struct LinkedList {
     Node* head;
     pthread_mutex_t lock;
+    int notify_fd; // Written On Every Insert (-1 = Disabled) | Lets Readers poll() Instead Of Polling The List
+    int capacity; // Messages Kept In Memory (0 = Unbounded)
+    ListPolicy policy;
+    pthread_cond_t room; // Signaled Whenever A Message Leaves The List
+    pthread_cond_t filled; // Signaled Whenever A Message Enters The List (listWaitView)
+    FILE* spill; // LIST_SPILL Overflow ([LENGTH][BYTES] Records, Created On First Use)
+    long spill_read; // Offset Of The Oldest Spilled Record
+    long spill_write; // End Of The Last Complete Record
+    ListStats stats;
+    int account; // memory.h Account ("list:[NAME]", listSetName)
 } LinkedList;
 
+/* Buffer Operations */
+MessageBuffer* bufferAdopt(char* data, int length, void (*release)(void* owner), void* owner);
+MessageBuffer* bufferAlloc(int length);
+MessageBuffer* bufferCopy(const char* data, int length);
+void bufferRetain(MessageBuffer* buffer);
+void bufferRelease(MessageBuffer* buffer);
+void viewRelease(MessageView* view);
+
 /* Basic List Operations */
 void listInit(LinkedList* list);
+void listSetNotify(LinkedList* list, int fd);
+void listSetLimit(LinkedList* list, int capacity, ListPolicy policy);
+void listSetName(LinkedList* list, const char* name); // Memory Accounted As "list:[NAME]" (Default "list:other")
+ListStats listGetStats(LinkedList* list);
+ListPolicy listPolicyParse(const char* name, ListPolicy fallback);
+const char* listPolicyName(ListPolicy policy);
 void listDestroy(LinkedList* list);
 void listInsert(LinkedList* list, const char* message);
-char* listPopLast(LinkedList* list);
+void listInsertView(LinkedList* list, MessageBuffer* buffer, const char* data, int length);
+char* listPopLast(LinkedList* list); // Release With listFreeResult()
+int listPopView(LinkedList* list, MessageView* view);
+int listWaitView(LinkedList* list, MessageView* view, int timeout_ms);
 void listPopPrintAll(LinkedList* list);
 void listDelete(LinkedList* list, const char* message);
 int listSearch(LinkedList* list, const char* message);
@@ -36,10 +100,12 @@ void listPrintGroups(const LinkedList* list);
 void listPrintRequests(const LinkedList* list);
 void listPrintHistory(const LinkedList* list, const char *username);
 void listPrintChats(const LinkedList* list, const char *username);
-char* listGetGroup(const LinkedList* groups_list, const char* group, const char* leader);
-char* listGetGroupLeader(const LinkedList* groups_list, const char* group);
-char* listGetTopic(const LinkedList* history_list, const char* target);
+char* listGetGroup(const LinkedList* groups_list, const char* group, const char* leader); // Release With listFreeResult()
+char* listGetGroupLeader(const LinkedList* groups_list, const char* group); // Release With listFreeResult()
+char* listGetTopic(const LinkedList* history_list, const char* target); // Release With listFreeResult()
+void listFreeResult(char* result); // Frees A Copy Returned By listGetGroup() / listGetGroupLeader() / listGetTopic() / listGetLast() / listPopLast() (Never free())
 int listSearchFirstParameter(LinkedList* list, const char* message);
+int listSearchEvent(LinkedList* list, const char* payload);
 int listSearchConversation(LinkedList* list, const char* target);
 int listSearchChat(LinkedList* list);
 
@@ -6,7 +6,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include "MQTTAsync.h"
+#include "transport.h"
 #include "constants.h"
+#include "memory.h"
 
 #if !defined(_WIN32)
 #include <unistd.h>
@@ -25,10 +27,29 @@ typedef struct
     MQTTAsync client;
     char username_p[64];
     char topic_p[1024];
-    char payload_p[1024];
 	int retained;
+    char payload_p[]; // Sized To The Payload (Group Member Lists Grow Past Any Fixed Buffer)
 } Context_p;
 
+// Context Accounting (memory.h)
+
+static int account_context_p = -1; // memoryAccountCached()
+
+static Context_p* newContext_p(const char* payload_p)
+{
+    long size = (long)(sizeof(Context_p) + strlen(payload_p) + 1);
+    Context_p* context = malloc(size);
+    if (context)
+        memoryAdd(memoryAccountCached(&account_context_p, "Context_p"), size, 1);
+    return context;
+}
+
+static void freeContext_p(Context_p* context)
+{
+    memoryAdd(memoryAccountCached(&account_context_p, "Context_p"), -(long)(sizeof(Context_p) + strlen(context->payload_p) + 1), -1);
+    free(context);
+}
+
 // Flags
 
 int finished_p = 0; // Program Finished
@@ -69,7 +90,7 @@ void connectionLost_p(void *context_, char *cause) // Connection Lost
     conn_opts.context = context;
 
 	// Try To Connect Again
-	if ((rc = MQTTAsync_connect(client, &conn_opts)) != MQTTASYNC_SUCCESS)
+	if ((rc = transportConnect(client, &conn_opts)) != MQTTASYNC_SUCCESS)
 	{
 		if (LOG_ENABLED)
 			printf("               [LOG] PUBLISHER: Failed to start connect, return code %d\n", rc);
@@ -107,11 +128,11 @@ void onSendFailure_p(void* context_, MQTTAsync_failureData* response) // Fails T
 	opts.context = context;
 
 	// Disconnect To Broker
-	if ((rc = MQTTAsync_disconnect(client, &opts)) != MQTTASYNC_SUCCESS)
+	if ((rc = transportDisconnect(client, &opts)) != MQTTASYNC_SUCCESS)
 	{
 		if (LOG_ENABLED)
 			printf("               [LOG] PUBLISHER: Failed to start disconnect, return code %d\n", rc);
-        free(context);
+        freeContext_p(context);
 		exit(EXIT_FAILURE);
 	}
 }
@@ -132,11 +153,11 @@ void onSend_p(void* context_, MQTTAsync_successData* response) // Publish Messag
 	opts.context = context;
 
 	// Disconnect To Broker
-	if ((rc = MQTTAsync_disconnect(client, &opts)) != MQTTASYNC_SUCCESS)
+	if ((rc = transportDisconnect(client, &opts)) != MQTTASYNC_SUCCESS)
 	{
 		if (LOG_ENABLED)
 			printf("               [LOG] PUBLISHER: Failed to start disconnect, return code %d\n", rc);
-        free(context);
+        freeContext_p(context);
 		exit(EXIT_FAILURE);
 	}
 }
@@ -171,11 +192,11 @@ void onConnect_p(void* context_, MQTTAsync_successData* response) // Connected S
 	pubmsg.retained = context->retained; // If Message Will Be Retained By The Broker
 
 	// Send Message
-	if ((rc = MQTTAsync_sendMessage(client, context->topic_p, &pubmsg, &opts)) != MQTTASYNC_SUCCESS)
+	if ((rc = transportSendMessage(client, context->topic_p, &pubmsg, &opts)) != MQTTASYNC_SUCCESS)
 	{
 		if (LOG_ENABLED)
 			printf("               [LOG] PUBLISHER: Failed to start sendMessage, return code %d\n", rc);
-        free(context);
+        freeContext_p(context);
 		exit(EXIT_FAILURE);
 	}
 }
@@ -200,7 +221,7 @@ int publisher(const char* username_p, const char* topic_p, const char* payload_p
 
 	// Create Client
 
-	if ((rc = MQTTAsync_create(&client, ADDRESS, username_p, MQTTCLIENT_PERSISTENCE_NONE, NULL)) != MQTTASYNC_SUCCESS)
+	if ((rc = transportCreate(&client, ADDRESS, username_p, MQTTCLIENT_PERSISTENCE_NONE, NULL)) != MQTTASYNC_SUCCESS)
 	{
 		if (LOG_ENABLED)
 			printf("               [LOG] PUBLISHER: Failed to create client object, return code %d\n", rc);
@@ -209,7 +230,7 @@ int publisher(const char* username_p, const char* topic_p, const char* payload_p
 
     // Create Context
 
-    Context_p* context = malloc(sizeof(Context_p));
+    Context_p* context = newContext_p(payload_p);
     context->client = client;
     strcpy(context->username_p, username_p);
     strcpy(context->topic_p, topic_p);
@@ -218,11 +239,11 @@ int publisher(const char* username_p, const char* topic_p, const char* payload_p
 
 	// Set Callbacks
 
-	if ((rc = MQTTAsync_setCallbacks(client, context, connectionLost_p, messageArrived_p, NULL)) != MQTTASYNC_SUCCESS)
+	if ((rc = transportSetCallbacks(client, context, connectionLost_p, messageArrived_p, NULL)) != MQTTASYNC_SUCCESS)
 	{
 		if (LOG_ENABLED)
 			printf("               [LOG] PUBLISHER: Failed to set callback, return code %d\n", rc);
-        free(context);
+        freeContext_p(context);
 		exit(EXIT_FAILURE);
 	}
 
@@ -236,11 +257,11 @@ int publisher(const char* username_p, const char* topic_p, const char* payload_p
 
 	// Connect To Broker
 
-	if ((rc = MQTTAsync_connect(client, &conn_opts)) != MQTTASYNC_SUCCESS)
+	if ((rc = transportConnect(client, &conn_opts)) != MQTTASYNC_SUCCESS)
 	{
 		if (LOG_ENABLED)
 			printf("               [LOG] PUBLISHER: Failed to start connect, return code %d\n", rc);
-        free(context);
+        freeContext_p(context);
 		exit(EXIT_FAILURE);
 	}
 
@@ -257,8 +278,8 @@ int publisher(const char* username_p, const char* topic_p, const char* payload_p
 
     // Exit
 
-	MQTTAsync_destroy(&client);
-    free(context);
+	transportDestroy(&client);
+    freeContext_p(context);
  	return rc;
 }
 
@@ -272,7 +293,7 @@ int publisherDirty(const char* username_p, const char* topic_p, const char* payl
 
 	// Create Client
 
-	if ((rc = MQTTAsync_create(&client, ADDRESS, username_p, MQTTCLIENT_PERSISTENCE_NONE, NULL)) != MQTTASYNC_SUCCESS)
+	if ((rc = transportCreate(&client, ADDRESS, username_p, MQTTCLIENT_PERSISTENCE_NONE, NULL)) != MQTTASYNC_SUCCESS)
 	{
 		if (LOG_ENABLED)
 			printf("               [LOG] PUBLISHER: Failed to create client object, return code %d\n", rc);
@@ -281,7 +302,7 @@ int publisherDirty(const char* username_p, const char* topic_p, const char* payl
 
     // Create Context
 
-    Context_p* context = malloc(sizeof(Context_p));
+    Context_p* context = newContext_p(payload_p);
     context->client = client;
     strcpy(context->username_p, username_p);
     strcpy(context->topic_p, topic_p);
@@ -290,11 +311,11 @@ int publisherDirty(const char* username_p, const char* topic_p, const char* payl
 
 	// Set Callbacks
 
-	if ((rc = MQTTAsync_setCallbacks(client, context, connectionLost_p, messageArrived_p, NULL)) != MQTTASYNC_SUCCESS)
+	if ((rc = transportSetCallbacks(client, context, connectionLost_p, messageArrived_p, NULL)) != MQTTASYNC_SUCCESS)
 	{
 		if (LOG_ENABLED)
 			printf("               [LOG] PUBLISHER: Failed to set callback, return code %d\n", rc);
-        free(context);
+        freeContext_p(context);
 		exit(EXIT_FAILURE);
 	}
 
@@ -308,11 +329,11 @@ int publisherDirty(const char* username_p, const char* topic_p, const char* payl
 
 	// Connect To Broker
 
-	if ((rc = MQTTAsync_connect(client, &conn_opts)) != MQTTASYNC_SUCCESS)
+	if ((rc = transportConnect(client, &conn_opts)) != MQTTASYNC_SUCCESS)
 	{
 		if (LOG_ENABLED)
 			printf("               [LOG] PUBLISHER: Failed to start connect, return code %d\n", rc);
-        free(context);
+        freeContext_p(context);
 		exit(EXIT_FAILURE);
 	}
 
@@ -329,7 +350,7 @@ int publisherDirty(const char* username_p, const char* topic_p, const char* payl
 
     // Exit
 
-	MQTTAsync_destroy(&client);
-    free(context);
+	transportDestroy(&client);
+    freeContext_p(context);
  	return rc;
 }
\ No newline at end of file
@@ -6,7 +6,6 @@ extern "C" {
 #endif
 
 /* Constants */
-#define ADDRESS_P     "tcp://localhost:1883"
 #define QOS_P         2
 #define TIMEOUT_P     10000L
 
@@ -14,10 +13,6 @@ extern "C" {
 int publisher(const char* username_p, const char* topic_p, const char* payload_p, int retained);
 int publisherDirty(const char* username_p, const char* topic_p, const char* payload_p, int retained);
 
-/* Higher Level Functions */
-void setStatus(const char* username, const char* status);
-void setGroup(const char* groupname, const char* username);
-
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,469 @@
+// Simulated User (simuser.h)
+// The Workload Behind loadgen.c And soak.c: Topology, Startup, Requests / Answers On The Control Thread And The Chat Loop
+// The Harnesses Only Add What They Measure (hooks) And When They Stop
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "transport.h"
+#include "events.h"
+#include "conversations.h"
+#include "actions.h"
+#include "simuser.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#else
+#include <windows.h>
+#endif
+
+#if defined(_WRS_KERNEL)
+#include <OsWrapper.h>
+#endif
+
+// Helpers
+
+uint64_t simNowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+void simSleepUs(long us)
+{
+    #if defined(_WIN32)
+        Sleep(us / 1000);
+    #else
+        usleep(us);
+    #endif
+}
+
+#if !defined(_WIN32)
+
+static void timed(SimUser* user, SimOp op, uint64_t t0)
+{
+    if (user->hooks && user->hooks->timed)
+        user->hooks->timed(user, op, simNowNs() - t0);
+}
+
+static int running(const SimUser* user, uint64_t until)
+{
+    return !(user->stop && *user->stop) && (!until || simNowNs() < until);
+}
+
+// Topology
+
+void simUserInit(SimUser* user, const char* run_id, int users, int index, int pairs, int group_size)
+{
+    memset(user, 0, sizeof(*user));
+    user->index = index;
+    user->online = 1;
+    user->tick_us = SIM_TICK_US;
+    pthread_mutex_init(&user->lock, NULL);
+    snprintf(user->username, sizeof(user->username), "%s_u%d", run_id, index);
+
+    // I > I+K | With 2 x K == users, I+K Is Also I-K: Only The Lower Index Asks
+    for (int k = 1; k <= pairs && k <= SIM_MAX_PAIRS && 2 * k <= users; k++)
+    {
+        int next = (index + k) % users;
+        int previous = (index - k + users) % users;
+        int mutual = 2 * k == users;
+
+        if (!mutual || index < next)
+        {
+            SimPeer* peer = &user->peers[user->peer_count++];
+            snprintf(peer->name, sizeof(peer->name), "%s_u%d", run_id, next);
+            peer->outgoing = 1;
+        }
+        if (!mutual || previous < index)
+        {
+            SimPeer* peer = &user->peers[user->peer_count++];
+            snprintf(peer->name, sizeof(peer->name), "%s_u%d", run_id, previous);
+            user->expected_requests++;
+        }
+    }
+
+    if (group_size > 1)
+    {
+        int first = index / group_size * group_size;
+        int members = users - first < group_size ? users - first : group_size;
+        if (members > 1)
+        {
+            SimPeer* peer = &user->peers[user->peer_count++];
+            snprintf(user->group, sizeof(user->group), "%s_g%d", run_id, index / group_size);
+            snprintf(user->leader, sizeof(user->leader), "%s_u%d", run_id, first);
+            snprintf(peer->name, sizeof(peer->name), "%s", user->group);
+            peer->is_group = 1;
+            peer->outgoing = index != first;
+            user->is_leader = index == first;
+            user->group_members = members;
+            if (user->is_leader)
+                user->expected_requests += members - 1;
+        }
+    }
+}
+
+// Control Thread
+
+static void* agentThread_sim(void* user_)
+{
+    SimUser* user = (SimUser*)user_;
+    monitorControl(user->username, &user->online);
+    return NULL;
+}
+
+// Answers One Pending Request As The Menu Does | 1 = Answered, 0 = Try Again Later
+static int acceptRequest(SimUser* user, const Event* event, LinkedList* groups_list)
+{
+    char requester[64], group[64], formatted[512];
+    uint64_t t0 = simNowNs();
+
+    if (event->type == EVENT_USER_REQUEST)
+    {
+        char timestamp[100], link[256];
+        time_t now = time(NULL);
+        struct tm* t = localtime(&now);
+
+        eventField(event, 0, requester, sizeof(requester));
+        eventEncode(formatted, sizeof(formatted), EVENT_USER_REQUEST, requester, NULL, NULL);
+        strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H-%M-%S", t);
+        snprintf(link, sizeof(link), "%s_%s|%s", user->username, requester, timestamp);
+
+        createConversation(user->username, requester, link);
+        if (!conversationsFind(&conversations, requester))
+            user->counters.accept_failed++; // MAX_CONVERSATIONS Reached
+        respondUser(user->username, requester, link, "ACEITAR");
+        processRequest(user->username, formatted);
+    }
+    else
+    {
+        eventField(event, 0, group, sizeof(group));
+        eventField(event, 1, requester, sizeof(requester));
+        eventEncode(formatted, sizeof(formatted), EVENT_GROUP_REQUEST, group, requester, NULL);
+
+        // The Snapshot Must Hold The Latest Member List (Each Answer Appends To It)
+        Conversation* conversation = conversationsFind(&conversations, group);
+        getGroups(user->username, groups_list, 0);
+        char* group_info = listGetGroup(groups_list, group, user->username);
+        int found = group_info != NULL;
+        listFreeResult(group_info);
+        if (!found || !conversation)
+            return 0;
+
+        respondGroup(user->username, group, requester, conversation->topic + strlen("CHATS/"), groups_list, "ACEITAR");
+        processRequest(user->username, formatted);
+    }
+
+    timed(user, SIM_ACCEPT, t0);
+    return 1;
+}
+
+static void* controlThread_sim(void* user_)
+{
+    SimUser* user = (SimUser*)user_;
+    LinkedList requests_list, groups_list;
+    char (*answered)[72] = calloc(user->expected_requests + 1, sizeof(*answered)); // "U:[USER]" / "G:[USER]" Already Answered
+    int answered_count = 0;
+
+    listInit(&requests_list);
+    listSetName(&requests_list, "requests");
+    listInit(&groups_list);
+    listSetName(&groups_list, "groups");
+
+    // Requests
+
+    for (int i = 0; i < user->peer_count; i++)
+    {
+        SimPeer* peer = &user->peers[i];
+        if (!peer->outgoing)
+            continue;
+
+        uint64_t t0 = simNowNs();
+        pthread_mutex_lock(&user->lock);
+        peer->requested_ns = t0;
+        pthread_mutex_unlock(&user->lock);
+
+        if (peer->is_group)
+            requestGroup(user->username, user->leader, user->group);
+        else
+            requestUser(user->username, peer->name);
+        timed(user, SIM_REQUEST, t0);
+    }
+
+    // Answers / Rounds Until The Harness Stops Us
+
+    uint64_t next_round = user->round_ns ? simNowNs() + user->round_ns : 0;
+
+    while (running(user, user->control_until))
+    {
+        int progress = 0;
+
+        if (answered && answered_count < user->expected_requests)
+        {
+            getRequests(user->username, &requests_list, 0);
+
+            MessageView view;
+            while (listPopView(&requests_list, &view))
+            {
+                Event event;
+                char requester[64], key[72];
+
+                if (eventDecode(view.data, view.length, &event) && (event.type == EVENT_USER_REQUEST || event.type == EVENT_GROUP_REQUEST) &&
+                    eventField(&event, event.type == EVENT_USER_REQUEST ? 0 : 1, requester, sizeof(requester)))
+                {
+                    snprintf(key, sizeof(key), "%c:%s", event.type == EVENT_USER_REQUEST ? 'U' : 'G', requester);
+                    int seen = 0;
+                    for (int j = 0; j < answered_count && !seen; j++)
+                        seen = strcmp(answered[j], key) == 0;
+
+                    if (!seen && answered_count < user->expected_requests && acceptRequest(user, &event, &groups_list))
+                    {
+                        snprintf(answered[answered_count++], sizeof(answered[0]), "%s", key);
+                        progress = 1;
+                    }
+                }
+                viewRelease(&view);
+            }
+        }
+
+        if (next_round && simNowNs() >= next_round)
+        {
+            if (user->hooks && user->hooks->round)
+                user->hooks->round(user);
+            next_round += user->round_ns;
+        }
+
+        if (!progress) // Nothing Pending (Or Only Requests Answered Already / Not Answerable Yet)
+            simSleepUs(DELAY_100_MS_US);
+    }
+
+    user->counters.accept_failed += user->expected_requests - answered_count;
+
+    listDestroy(&requests_list);
+    listDestroy(&groups_list);
+    free(answered);
+    return NULL;
+}
+
+// Chat Loop
+
+// Next Chat / Group A Line Can Go To (Round Robin) | NULL = None Open Yet
+static SimPeer* nextPeer(SimUser* user, int* cursor)
+{
+    for (int tried = 0; tried < user->peer_count; tried++)
+    {
+        SimPeer* peer = &user->peers[*cursor];
+        *cursor = (*cursor + 1) % user->peer_count;
+        if (peer->open && (peer->outgoing || peer->is_group || peer->heard))
+            return peer;
+    }
+    return NULL;
+}
+
+static void runChat(SimUser* user)
+{
+    uint64_t interval = (uint64_t)(1e9 / user->rate);
+    unsigned int seed = (unsigned int)(user->index * 2654435761u) ^ (unsigned int)getpid();
+    uint64_t next_send = user->send_from + (uint64_t)rand_r(&seed) % interval;
+    size_t line_size = (size_t)user->bytes + 64;
+    char* line = malloc(line_size);
+    size_t username_len = strlen(user->username);
+    int cursor = 0;
+
+    if (!line)
+        return;
+
+    while (running(user, user->chat_until))
+    {
+        uint64_t now = simNowNs();
+
+        for (int i = 0; i < user->peer_count; i++)
+        {
+            SimPeer* peer = &user->peers[i];
+            Conversation* conversation = conversationsFind(&conversations, peer->name);
+            if (!conversation)
+                continue;
+
+            // Opened (By The Agent, Or By Our Own Answer / setGroup())
+
+            if (!peer->open)
+            {
+                peer->open = 1;
+                pthread_mutex_lock(&user->lock);
+                uint64_t requested = peer->requested_ns;
+                pthread_mutex_unlock(&user->lock);
+                if (requested)
+                    timed(user, peer->is_group ? SIM_GROUP_JOIN : SIM_CHAT_OPEN, requested);
+            }
+
+            // "[SENDER]: [TEXT]" | Our Own Group Lines Come Back Too
+
+            MessageView view;
+            while (conversationsPop(&conversations, conversation, &view))
+            {
+                int own = (size_t)view.length > username_len && memcmp(view.data, user->username, username_len) == 0 && view.data[username_len] == ':';
+                if (!own)
+                {
+                    peer->heard = 1;
+                    if (user->hooks && user->hooks->received)
+                        user->hooks->received(user, peer, &view);
+                }
+                viewRelease(&view);
+            }
+        }
+
+        // Scheduled Lines (Open Loop: Late Slots Are Sent At Once, Stamped With Their Slot)
+
+        while (next_send <= now && (!user->send_until || next_send < user->send_until))
+        {
+            SimPeer* peer = nextPeer(user, &cursor);
+            if (!peer)
+                user->counters.skipped++;
+            else
+            {
+                int len = snprintf(line, line_size, "%s%llu ", user->line_tag ? user->line_tag : "", (unsigned long long)next_send);
+                while (len < user->bytes)
+                    line[len++] = 'x';
+                line[len] = '\0';
+
+                Conversation* conversation = conversationsFind(&conversations, peer->name);
+                uint64_t t0 = simNowNs();
+                int rc = conversation ? conversationsSend(&conversations, conversation, line) : MQTTASYNC_FAILURE;
+                timed(user, SIM_SEND, t0);
+
+                if (rc != MQTTASYNC_SUCCESS)
+                    user->counters.send_failed++;
+                else
+                {
+                    user->counters.sent++;
+                    if (!peer->is_group)
+                        user->counters.sent_direct++;
+                    if (user->hooks && user->hooks->sent)
+                        user->hooks->sent(user, peer, next_send);
+                }
+            }
+            next_send += interval;
+        }
+
+        simSleepUs(user->tick_us);
+    }
+
+    for (int i = 0; i < user->peer_count; i++)
+    {
+        pthread_mutex_lock(&user->lock);
+        int requested = user->peers[i].requested_ns != 0;
+        pthread_mutex_unlock(&user->lock);
+        if (requested && !user->peers[i].open)
+            user->counters.open_failed++;
+    }
+    free(line);
+}
+
+// Main Functions
+
+static pthread_t agent_sim; // One Simulated User Per Process
+
+int simUserStart(SimUser* user)
+{
+    // Same Startup As "./main": Conversations, Then The Agent, Then The Status
+
+    if (conversationsStart(&conversations, user->username) != EXIT_SUCCESS)
+        return 0;
+    if (pthread_create(&agent_sim, NULL, agentThread_sim, user) != 0)
+    {
+        conversationsStop(&conversations);
+        return 0;
+    }
+    simSleepUs(SIM_SETTLE_US);
+
+    uint64_t t0 = simNowNs();
+    setStatus(user->username, "Online");
+    timed(user, SIM_STATUS, t0);
+
+    if (user->is_leader)
+    {
+        t0 = simNowNs();
+        setGroup(user->group, user->username);
+        timed(user, SIM_GROUP_CREATE, t0);
+    }
+    return 1;
+}
+
+void simUserTraffic(SimUser* user)
+{
+    pthread_t control;
+
+    if (user->rate <= 0)
+        return;
+    if (pthread_create(&control, NULL, controlThread_sim, user) == 0)
+    {
+        runChat(user);
+        pthread_join(control, NULL);
+    }
+}
+
+void simUserStop(SimUser* user)
+{
+    uint64_t t0 = simNowNs();
+    setStatus(user->username, "Offline");
+    timed(user, SIM_STATUS, t0);
+
+    user->online = 0;
+    pthread_join(agent_sim, NULL);
+    conversationsStop(&conversations);
+}
+
+static volatile sig_atomic_t broker_stop_sim = 0;
+
+static void onBrokerSignal(int sig)
+{
+    (void)sig;
+    broker_stop_sim = 1;
+}
+
+pid_t simBrokerStart(BrokerCounts* counts, char* uri, size_t size)
+{
+    int pipe_fd[2];
+    int port = 0;
+
+    if (pipe(pipe_fd) != 0)
+        return 0;
+    fflush(stdout);
+
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        signal(SIGTERM, onBrokerSignal);
+        close(pipe_fd[0]);
+        Broker* broker = brokerStart(0);
+        port = broker ? brokerPort(broker) : 0;
+        if (write(pipe_fd[1], &port, sizeof(port)) != (ssize_t)sizeof(port)) { /* Parent Sees The Pipe Closed */ }
+        close(pipe_fd[1]);
+        while (broker && !broker_stop_sim)
+        {
+            if (counts)
+                brokerCounts(broker, counts);
+            simSleepUs(DELAY_100_MS_US);
+        }
+        brokerStop(broker);
+        _exit(EXIT_SUCCESS);
+    }
+
+    close(pipe_fd[1]);
+    if (pid < 0 || read(pipe_fd[0], &port, sizeof(port)) != (ssize_t)sizeof(port) || port <= 0)
+    {
+        close(pipe_fd[0]);
+        if (pid > 0)
+            waitpid(pid, NULL, 0);
+        return 0;
+    }
+    close(pipe_fd[0]);
+    snprintf(uri, size, "tcp://127.0.0.1:%d", port);
+    return pid;
+}
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef SIMUSER_H
+#define SIMUSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "constants.h"
+#include "messages.h"
+#include "broker.h"
+
+#if !defined(_WIN32)
+#include <sys/types.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Simulated User */
+// The Workload Of The Multi-Process Harnesses (loadgen.c, soak.c): One Process Per User Running The Actions "./main" Runs
+// - Topology: Users "[RUN]_u[I]" | Chats I > I+1..I+PAIRS | Groups "[RUN]_g[I / SIZE]" Led By Their First User
+// - Control Thread: The Requests, Answers As The Menu Gives Them, hooks->round Every round_ns (Every publisher() /
+//   subscriberRetained() Of The Process Runs There)
+// - Chat Loop: Conversations Opened By The Agent, Received Lines And "rate" Lines Per Second, Round Robin Over The Open Chats
+//   (Open Loop: Late Slots Are Sent At Once) | Line = "[TAG][SCHEDULED NS] xxx..."
+// Harness: simUserInit() > Traffic Parameters > simUserStart() > (Everyone Ready) > simUserTraffic() > simUserStop()
+
+/* Constants */
+#define SIM_MAX_PAIRS ((MAX_CONVERSATIONS - 2) / 2) // Outgoing + Incoming Chats + The Group Fit In One Manager
+#define SIM_MAX_PEERS (2 * SIM_MAX_PAIRS + 1)
+#define SIM_SETTLE_US 500000L // Agent Subscription Starting Up (Requests Sent Before It Would Be Lost)
+#define SIM_TICK_US   1000L // Default Chat Loop Granularity
+
+typedef enum SimOp // Timed Actions (hooks->timed)
+{
+    SIM_STATUS, // setStatus()
+    SIM_GROUP_CREATE, // setGroup()
+    SIM_REQUEST, // requestUser() / requestGroup()
+    SIM_ACCEPT, // Answering One Request (Every Publish The Menu Does For It)
+    SIM_CHAT_OPEN, // requestUser() Until The Chat Is Open At The Requester
+    SIM_GROUP_JOIN, // requestGroup() Until The Group Is Open At The Requester
+    SIM_SEND, // conversationsSend()
+    SIM_OP_COUNT
+} SimOp;
+
+typedef struct SimPeer // Chat Or Group Of A Simulated User
+{
+    char name[64];
+    int is_group;
+    int outgoing; // We Sent The Request (The Agent Opens It On Our Side)
+    uint64_t requested_ns; // 0 = Not Requested (Or Not By Us)
+    int open; // Conversation Registered
+    int heard; // A Line Arrived From It (Accepted Chats Are Only Written Once The Requester Spoke)
+} SimPeer;
+
+typedef struct SimCounters
+{
+    long sent; // Scheduled Lines Sent
+    long sent_direct;
+    long skipped; // Scheduled Lines With No Open Chat Yet
+    long send_failed;
+    long open_failed; // Requests Whose Chat / Group Never Opened
+    long accept_failed; // Requests Left Unanswered (Group Missing From The Snapshot, Conversation Limit)
+} SimCounters;
+
+typedef struct SimUser SimUser;
+
+typedef struct SimHooks // Any May Be NULL
+{
+    void (*timed)(SimUser* user, SimOp op, uint64_t ns); // Control Thread: SIM_REQUEST / SIM_ACCEPT | Chat Loop: The Rest
+    void (*round)(SimUser* user); // Control Thread, Every round_ns
+    void (*received)(SimUser* user, SimPeer* peer, const MessageView* view); // Chat Loop: A Line From Another User
+    void (*sent)(SimUser* user, SimPeer* peer, uint64_t scheduled); // Chat Loop: A Scheduled Line Went Out
+} SimHooks;
+
+struct SimUser // One Per Process
+{
+    const SimHooks* hooks;
+    void* owner; // Harness Side Of The User
+    int index;
+    char username[64];
+    char group[64]; // Group Led Or Joined ("" = None)
+    char leader[64];
+    int is_leader;
+    int group_members; // Leader Included
+    SimPeer peers[SIM_MAX_PEERS];
+    int peer_count;
+    int expected_requests; // Requests The Other Users Send Us
+
+    // Traffic (Set By The Harness Before simUserTraffic())
+    double rate; // Lines Per Second
+    int bytes; // Line Length
+    const char* line_tag;
+    long tick_us; // Chat Loop Granularity (simUserInit(): SIM_TICK_US)
+    uint64_t send_from; // First Slot (Plus A Random Phase, Users Do Not Send In Lockstep)
+    uint64_t send_until; // No Slot From Here On (0 = Until *stop)
+    uint64_t control_until; // Control Thread Ends (0 = Until *stop)
+    uint64_t chat_until; // Chat Loop Ends (0 = Until *stop)
+    uint64_t round_ns; // Between hooks->round Calls (0 = No Rounds)
+    volatile int* stop; // Set By The Harness (NULL = Only The Time Limits)
+
+    SimCounters counters;
+    pthread_mutex_t lock; // peers[].requested_ns (Control Thread > Chat Loop)
+    volatile int online; // Agent Loop
+};
+
+/* Core Functions */
+uint64_t simNowNs(void); // CLOCK_MONOTONIC (Shared By The User Processes)
+void simSleepUs(long us);
+
+#if !defined(_WIN32) // POSIX Only (One Process Per User, fork())
+void simUserInit(SimUser* user, const char* run_id, int users, int index, int pairs, int group_size); // 2 x pairs <= users
+int simUserStart(SimUser* user); // Same Startup As "./main" + "Online" (+ setGroup() For Leaders) | 0 = Failed
+void simUserTraffic(SimUser* user); // Control Thread + Chat Loop, Until Their Limits
+void simUserStop(SimUser* user); // "Offline", Then The Agent And The Conversations
+
+// Embedded Broker In Its Own Process (The Users Are Forked Without Its Sockets / Threads), Stopped With SIGTERM
+// counts != NULL (Shared Memory): Refreshed Every 100 ms | 0 = Failed
+pid_t simBrokerStart(BrokerCounts* counts, char* uri, size_t size);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIMUSER_H
@@ -0,0 +1,666 @@
+// Compilation Command: "gcc soak.c simuser.c actions.c publisher.c subscriber.c agent.c messages.c events.c conversations.c envelope.c chunk.c attachment.c broker.c transport.c stats.c trace.c memory.c -o soak -lpaho-mqtt3as -pthread"
+// Excecution Command: "./soak [-u USERS] [-r RATE] [-g GROUP_SIZE] [-d MINUTES] [-i SECONDS] [-w MINUTES] [-c SECONDS] [-l BYTES] [-s METRIC=LIMIT,...] [-j]"
+//
+// Soak Test (Leaks That Only Show Up After Hours: Client Churn Per Publish, Lists That Keep Growing, Results Never Released)
+// - Embedded Broker (broker.h) In Its Own Process + One Process Per Simulated User, Running The Actions "./main" Runs For -d Minutes:
+//   A Chat With The Next User And A Group Per -g Users Are Set Up Once, Then -r Lines Per Second Per User And, Every -c Seconds,
+//   Pending Requests Answered, An Offline / Online Toggle (setStatus()) And The Menu Lookups (getUsers(), getGroups() + listGetGroupLeader())
+// - Every -i Seconds: RSS, Open FDs And Threads (/proc) Of The Users (Average Per Process) And Of The Broker, Broker Sessions /
+//   Retained Topics / Pending QoS Messages (brokerCounts()) And List Results Still Held By The Users ("results" Account, memory.h)
+// - Verdict: Least Squares Slope Of Each Metric Over The Samples After -w Minutes, Per Hour | Any Slope Above Its Limit,
+//   Fewer Than SOAK_MIN_SAMPLES After The Warm-Up, A User Process Dying Or Results Left Over At Exit (CHATMQTT_LEAK_CHECK=1) = Exit Code 1
+// Linux Only (fork(), /proc)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include "constants.h"
+#include "transport.h"
+#include "messages.h"
+#include "events.h"
+#include "conversations.h"
+#include "actions.h"
+#include "broker.h"
+#include "memory.h"
+#include "simuser.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <signal.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#else
+#include <windows.h>
+#endif
+
+#if defined(_WRS_KERNEL)
+#include <OsWrapper.h>
+#endif
+
+// Parameters
+
+#define DEFAULT_USERS        10
+#define DEFAULT_RATE         1.0 // Lines Per Second Per User
+#define DEFAULT_GROUP_SIZE   5 // Users Per Group, Leader Included (0 / 1 = No Groups)
+#define DEFAULT_MINUTES      60
+#define DEFAULT_INTERVAL     10 // Seconds Between Samples
+#define DEFAULT_WARMUP       5 // Minutes Left Out Of The Slopes (Heaps, Caches And Tables Filling Up)
+#define DEFAULT_CYCLE        10 // Seconds Between Control Rounds Of Each User
+#define DEFAULT_BYTES        64
+#define SOAK_MAX_USERS       (BROKER_MAX_CLIENTS / 3) // Up To 3 Connections Per User (Agent, Conversations, publisher())
+#define SOAK_MAX_BYTES       16000
+#define SOAK_MIN_SAMPLES     10 // Fewer Samples After The Warm-Up = No Verdict On The Slopes
+#define SOAK_READY_TIMEOUT_S 60 // Longest Wait For Every User To Come Up (The Run Starts Anyway)
+#define SOAK_TICK_US         10000L // Chat Loop Granularity
+#define SOAK_READINGS        10 // Readings Per Sample (The Floor Is Kept)
+#define SOAK_READING_GAP_US  100000L // Broker Counts Are Refreshed Once A Second
+#define SOAK_LINE_TAG        "SK " // "SK [SCHEDULED NS] xxx..."
+
+// Data Structures
+
+typedef enum SoakMetric
+{
+    METRIC_RSS, // Users (Average Per Process)
+    METRIC_FDS,
+    METRIC_THREADS,
+    METRIC_RESULTS,
+    METRIC_BROKER_RSS, // Broker Process
+    METRIC_BROKER_FDS,
+    METRIC_BROKER_THREADS,
+    METRIC_SESSIONS, // Broker State
+    METRIC_RETAINED,
+    METRIC_PENDING,
+    METRIC_COUNT
+} SoakMetric;
+
+static const char* const metric_names[METRIC_COUNT] = {
+    "rss_kb", "fds", "threads", "results", "broker_rss_kb", "broker_fds", "broker_threads", "sessions", "retained", "pending"
+};
+
+static double metric_limits[METRIC_COUNT] = { // Largest Growth Accepted Per Hour (-s Overrides)
+    1024, 1, 0.5, 1, 4096, 1, 0.5, 1, 1, 100
+};
+
+typedef struct // Same For Every User Process
+{
+    char run_id[32]; // Prefix Of Every User / Group Of The Run
+    int users;
+    double rate;
+    int group_size;
+    int minutes;
+    int interval;
+    int warmup;
+    int cycle;
+    int bytes;
+} SoakConfig;
+
+typedef struct // One Per User (Written By Its Process Only)
+{
+    volatile long results; // List Results Held Right Now ("results" Account)
+    volatile long sent;
+    volatile long received;
+    volatile long leaked; // Results Never Released, Found At Exit (MEMORY_LEAK_ENV)
+} SoakSlot;
+
+typedef struct // Shared By The Parent, The Broker And The Users (MAP_SHARED)
+{
+    volatile int ready; // Users With Agent + Conversations Up
+    volatile int failed; // Users That Could Not Start
+    volatile int start; // Set By The Parent Once Everyone Is Ready
+    volatile int stop; // Users Leave Their Loops
+    BrokerCounts broker; // Copied By The Broker Process Every 100 ms (Fields Read One By One, A Straddled Update Is Harmless)
+    SoakSlot users[SOAK_MAX_USERS];
+} SoakShared;
+
+typedef struct // One Simulated User (Its Own Process)
+{
+    SimUser sim; // Workload (simuser.h)
+    SoakSlot* slot;
+    LinkedList status_list; // Periodic Round
+    LinkedList groups_list;
+    int results; // "results" Account
+} SoakUser;
+
+typedef struct // One Sample Of Every Metric
+{
+    double minutes; // Since The Start
+    double values[METRIC_COUNT];
+} SoakSample;
+
+typedef struct
+{
+    long rss_kb;
+    int fds;
+    int threads;
+} ProcessSample;
+
+// Globals
+
+static int json_output = 0;
+
+// Helpers
+
+// "rss_kb=2048,fds=2" | 0 = Unknown Metric
+static int parseLimits(const char* list)
+{
+    for (const char* p = list; *p; )
+    {
+        size_t len = strcspn(p, ",");
+        size_t name_len = strcspn(p, "=");
+        int found = 0;
+
+        if (name_len < len)
+        {
+            for (int m = 0; m < METRIC_COUNT && !found; m++)
+            {
+                if (strlen(metric_names[m]) == name_len && strncmp(p, metric_names[m], name_len) == 0)
+                {
+                    metric_limits[m] = atof(p + name_len + 1);
+                    found = 1;
+                }
+            }
+        }
+        if (!found)
+            return 0;
+        p += len;
+        if (*p == ',')
+            p++;
+    }
+    return 1;
+}
+
+// Least Squares Slope Per Hour Over The Samples After The Warm-Up | 0 = Too Few Samples
+static int slopePerHour(const SoakSample* samples, int count, int metric, double warmup, double* slope)
+{
+    double sum_t = 0, sum_v = 0, sum_tt = 0, sum_tv = 0;
+    int used = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (samples[i].minutes < warmup)
+            continue;
+        double t = samples[i].minutes / 60.0;
+        double v = samples[i].values[metric];
+        sum_t += t;
+        sum_v += v;
+        sum_tt += t * t;
+        sum_tv += t * v;
+        used++;
+    }
+
+    double denominator = used * sum_tt - sum_t * sum_t;
+    if (used < SOAK_MIN_SAMPLES || denominator <= 0)
+        return 0;
+    *slope = (used * sum_tv - sum_t * sum_v) / denominator;
+    return 1;
+}
+
+#if !defined(_WIN32)
+
+// /proc/[PID]: statm (Resident Pages), status ("Threads:"), fd/ (One Entry Per Open Descriptor) | 0 = Gone
+static int sampleProcess(pid_t pid, ProcessSample* sample)
+{
+    char path[64], line[256];
+    long size = 0, resident = 0;
+
+    memset(sample, 0, sizeof(*sample));
+
+    snprintf(path, sizeof(path), "/proc/%d/statm", (int)pid);
+    FILE* file = fopen(path, "r");
+    if (!file)
+        return 0;
+    int parsed = fscanf(file, "%ld %ld", &size, &resident);
+    fclose(file);
+    if (parsed != 2)
+        return 0;
+    sample->rss_kb = resident * (sysconf(_SC_PAGESIZE) / 1024);
+
+    snprintf(path, sizeof(path), "/proc/%d/status", (int)pid);
+    if ((file = fopen(path, "r")))
+    {
+        while (fgets(line, sizeof(line), file))
+            if (strncmp(line, "Threads:", 8) == 0)
+                sample->threads = atoi(line + 8);
+        fclose(file);
+    }
+
+    snprintf(path, sizeof(path), "/proc/%d/fd", (int)pid);
+    DIR* dir = opendir(path);
+    if (dir)
+    {
+        struct dirent* entry;
+        while ((entry = readdir(dir)))
+            if (entry->d_name[0] != '.')
+                sample->fds++;
+        closedir(dir);
+    }
+    return 1;
+}
+
+// ----- Simulated User (Child Process) -----
+
+// Periodic Round: What A User Leaving The Menu Open Does Over And Over
+static void userRound(SimUser* sim)
+{
+    SoakUser* user = (SoakUser*)sim->owner;
+    MemoryUsage usage;
+
+    setStatus(sim->username, "Offline");
+    setStatus(sim->username, "Online");
+    getUsers(sim->username, &user->status_list, 0);
+    if (sim->group[0])
+    {
+        getGroups(sim->username, &user->groups_list, 0);
+        listFreeResult(listGetGroupLeader(&user->groups_list, sim->group));
+    }
+    if (memoryUsage(user->results, &usage))
+        user->slot->results = usage.objects;
+}
+
+static void userReceived(SimUser* sim, SimPeer* peer, const MessageView* view)
+{
+    (void)peer;
+    (void)view;
+    ((SoakUser*)sim->owner)->slot->received++;
+}
+
+static void userSent(SimUser* sim, SimPeer* peer, uint64_t scheduled)
+{
+    (void)peer;
+    (void)scheduled;
+    ((SoakUser*)sim->owner)->slot->sent++;
+}
+
+static const SimHooks soak_hooks = { NULL, userRound, userReceived, userSent };
+
+static void simulateUser(const SoakConfig* config, SoakShared* shared, int index)
+{
+    static SoakUser user; // One Per Process
+
+    memset(&user, 0, sizeof(user));
+    simUserInit(&user.sim, config->run_id, config->users, index, 1, config->group_size); // A Chat With The Next User
+    user.sim.hooks = &soak_hooks;
+    user.sim.owner = &user;
+    user.slot = &shared->users[index];
+    user.results = memoryAccount("results");
+    listInit(&user.status_list);
+    listSetName(&user.status_list, "status");
+    listInit(&user.groups_list);
+    listSetName(&user.groups_list, "groups");
+
+    if (!simUserStart(&user.sim))
+    {
+        __atomic_add_fetch(&shared->failed, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    __atomic_add_fetch(&shared->ready, 1, __ATOMIC_RELAXED);
+    while (!shared->start && !shared->stop)
+        simSleepUs(DELAY_100_MS_US / 10);
+
+    // Until The Parent Stops The Run
+
+    user.sim.rate = config->rate;
+    user.sim.bytes = config->bytes;
+    user.sim.line_tag = SOAK_LINE_TAG;
+    user.sim.tick_us = SOAK_TICK_US;
+    user.sim.send_from = simNowNs();
+    user.sim.round_ns = (uint64_t)config->cycle * 1000000000ull;
+    user.sim.stop = &shared->stop;
+
+    simUserTraffic(&user.sim);
+    simUserStop(&user.sim);
+
+    listDestroy(&user.status_list);
+    listDestroy(&user.groups_list);
+
+    if (memoryLeakCheck())
+        user.slot->leaked = memoryLeakReport();
+    fflush(stdout);
+}
+
+// ----- Parent -----
+
+static volatile sig_atomic_t stop_sk = 0;
+
+static void onSignal(int sig)
+{
+    (void)sig;
+    stop_sk = 1;
+}
+
+// One Sample: Users (Average Over The Live Ones), Broker Process And Broker State | Users Found Dead Are Reaped Here
+// Each Value Is The Floor Of SOAK_READINGS Readings: Sockets / Threads / Sessions Of A publisher() Call In Flight Are Not Leaks,
+// While A Leak Raises The Floor
+static void takeSample(SoakShared* shared, pid_t broker_pid, pid_t* pids, int started, int* dead, SoakSample* sample)
+{
+    ProcessSample* floors = calloc(started + 1, sizeof(ProcessSample)); // [started] = Broker
+    int* seen = calloc(started + 1, sizeof(int));
+    double broker_floor[3] = { 0 }; // Sessions, Retained, Pending
+    int alive = 0;
+    long results = 0;
+
+    memset(sample->values, 0, sizeof(sample->values));
+    if (!floors || !seen)
+    {
+        free(floors);
+        free(seen);
+        return;
+    }
+
+    for (int i = 0; i < started; i++)
+    {
+        if (pids[i] > 0 && waitpid(pids[i], NULL, WNOHANG) == pids[i])
+        {
+            pids[i] = 0;
+            (*dead)++;
+        }
+    }
+
+    for (int reading = 0; reading < SOAK_READINGS; reading++)
+    {
+        if (reading > 0)
+            simSleepUs(SOAK_READING_GAP_US);
+
+        for (int i = 0; i <= started; i++)
+        {
+            ProcessSample process;
+            pid_t pid = i < started ? pids[i] : broker_pid;
+            if (pid <= 0 || !sampleProcess(pid, &process))
+                continue;
+            if (!seen[i] || process.rss_kb < floors[i].rss_kb) floors[i].rss_kb = process.rss_kb;
+            if (!seen[i] || process.fds < floors[i].fds) floors[i].fds = process.fds;
+            if (!seen[i] || process.threads < floors[i].threads) floors[i].threads = process.threads;
+            seen[i] = 1;
+        }
+
+        double broker_now[3] = { shared->broker.sessions, shared->broker.retained, shared->broker.pending };
+        for (int k = 0; k < 3; k++)
+            if (reading == 0 || broker_now[k] < broker_floor[k])
+                broker_floor[k] = broker_now[k];
+    }
+
+    for (int i = 0; i < started; i++)
+    {
+        if (!seen[i])
+            continue;
+        sample->values[METRIC_RSS] += floors[i].rss_kb;
+        sample->values[METRIC_FDS] += floors[i].fds;
+        sample->values[METRIC_THREADS] += floors[i].threads;
+        results += shared->users[i].results;
+        alive++;
+    }
+    if (alive > 0)
+    {
+        sample->values[METRIC_RSS] /= alive;
+        sample->values[METRIC_FDS] /= alive;
+        sample->values[METRIC_THREADS] /= alive;
+        sample->values[METRIC_RESULTS] = (double)results / alive;
+    }
+
+    sample->values[METRIC_BROKER_RSS] = floors[started].rss_kb;
+    sample->values[METRIC_BROKER_FDS] = floors[started].fds;
+    sample->values[METRIC_BROKER_THREADS] = floors[started].threads;
+    sample->values[METRIC_SESSIONS] = broker_floor[0];
+    sample->values[METRIC_RETAINED] = broker_floor[1];
+    sample->values[METRIC_PENDING] = broker_floor[2];
+
+    free(floors);
+    free(seen);
+}
+
+static void printSample(const SoakSample* sample, const SoakShared* shared, int alive)
+{
+    if (json_output)
+    {
+        printf("{\"minutes\":%.2f,\"users\":%d,\"connections\":%d,\"sessions_offline\":%d", sample->minutes, alive,
+               shared->broker.connections, shared->broker.sessions_offline);
+        for (int m = 0; m < METRIC_COUNT; m++)
+            printf(",\"%s\":%.2f", metric_names[m], sample->values[m]);
+        printf("}\n");
+    }
+    else
+        printf("%7.1f %7d %10.0f %6.1f %7.1f %10.2f %12.0f %6.0f %7.0f %8.0f %8.0f %9.0f\n", sample->minutes, alive,
+               sample->values[METRIC_RSS], sample->values[METRIC_FDS], sample->values[METRIC_THREADS], sample->values[METRIC_RESULTS],
+               sample->values[METRIC_BROKER_RSS], sample->values[METRIC_BROKER_FDS], sample->values[METRIC_BROKER_THREADS],
+               sample->values[METRIC_SESSIONS], sample->values[METRIC_RETAINED], sample->values[METRIC_PENDING]);
+    fflush(stdout);
+}
+
+// Slopes Against Their Limits | Metrics Over The Limit Or Without Enough Samples (A Run Too Short Proves Nothing)
+static int verdict(const SoakSample* samples, int count, const SoakConfig* config)
+{
+    int failed = 0;
+
+    if (!json_output)
+        printf("\n%-16s %12s %12s %14s %12s  %s\n", "Métrica", "Início", "Fim", "Inclinação/h", "Limite/h", "Resultado");
+
+    for (int m = 0; m < METRIC_COUNT; m++)
+    {
+        double slope = 0;
+        int known = slopePerHour(samples, count, m, config->warmup, &slope);
+        int over = !known || slope > metric_limits[m];
+        double first = count ? samples[0].values[m] : 0, last = count ? samples[count - 1].values[m] : 0;
+        failed += over;
+
+        if (json_output)
+            printf("{\"metric\":\"%s\",\"first\":%.2f,\"last\":%.2f,\"slope_per_h\":%.3f,\"limit_per_h\":%.3f,\"result\":\"%s\"}\n",
+                   metric_names[m], first, last, slope, metric_limits[m], !known ? "unknown" : over ? "fail" : "ok");
+        else
+            printf("%-16s %12.2f %12.2f %14.3f %12.3f  %s\n", metric_names[m], first, last, slope, metric_limits[m],
+                   !known ? "Amostras Insuficientes" : over ? "FALHOU" : "OK");
+    }
+    return failed;
+}
+
+#endif
+
+// Main Function
+
+int main(int argc, char* argv[])
+{
+    SoakConfig config;
+
+    memset(&config, 0, sizeof(config));
+    config.users = DEFAULT_USERS;
+    config.rate = DEFAULT_RATE;
+    config.group_size = DEFAULT_GROUP_SIZE;
+    config.minutes = DEFAULT_MINUTES;
+    config.interval = DEFAULT_INTERVAL;
+    config.warmup = DEFAULT_WARMUP;
+    config.cycle = DEFAULT_CYCLE;
+    config.bytes = DEFAULT_BYTES;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "-j") == 0)
+            json_output = 1;
+        else if (strcmp(argv[i], "-u") == 0 && value) { config.users = atoi(value); i++; }
+        else if (strcmp(argv[i], "-r") == 0 && value) { config.rate = atof(value); i++; }
+        else if (strcmp(argv[i], "-g") == 0 && value) { config.group_size = atoi(value); i++; }
+        else if (strcmp(argv[i], "-d") == 0 && value) { config.minutes = atoi(value); i++; }
+        else if (strcmp(argv[i], "-i") == 0 && value) { config.interval = atoi(value); i++; }
+        else if (strcmp(argv[i], "-w") == 0 && value) { config.warmup = atoi(value); i++; }
+        else if (strcmp(argv[i], "-c") == 0 && value) { config.cycle = atoi(value); i++; }
+        else if (strcmp(argv[i], "-l") == 0 && value) { config.bytes = atoi(value); i++; }
+        else if (strcmp(argv[i], "-s") == 0 && value && parseLimits(value)) i++;
+        else
+        {
+            printf("Uso: %s [-u USUARIOS] [-r TAXA] [-g TAMANHO] [-d MINUTOS] [-i SEGUNDOS] [-w MINUTOS] [-c SEGUNDOS] [-l BYTES] [-s METRICA=LIMITE,...] [-j]\n"
+                   "  -u  Usuários Simulados (Padrão: %d, Máximo: %d)\n"
+                   "  -r  Mensagens Por Segundo Por Usuário (Padrão: %.1f)\n"
+                   "  -g  Usuários Por Grupo, Líder Incluso (Padrão: %d, 0 = Sem Grupos)\n"
+                   "  -d  Minutos De Execução (Padrão: %d, Ctrl+C Encerra Antes E Ainda Dá O Resultado)\n"
+                   "  -i  Segundos Entre Amostras (Padrão: %d)\n"
+                   "  -w  Minutos Iniciais Fora Das Inclinações (Padrão: %d)\n"
+                   "  -c  Segundos Entre Rodadas De Cada Usuário: Offline / Online, Usuários, Grupos (Padrão: %d)\n"
+                   "  -l  Bytes Por Mensagem (Padrão: %d)\n"
+                   "  -s  Crescimento Máximo Por Hora, Ex.: \"rss_kb=2048,fds=2\" (Métricas: rss_kb, fds, threads, results,\n"
+                   "      broker_rss_kb, broker_fds, broker_threads, sessions, retained, pending)\n"
+                   "  -j  Uma Linha JSON Por Amostra E Por Métrica\n",
+                   argv[0], DEFAULT_USERS, SOAK_MAX_USERS, DEFAULT_RATE, DEFAULT_GROUP_SIZE, DEFAULT_MINUTES, DEFAULT_INTERVAL,
+                   DEFAULT_WARMUP, DEFAULT_CYCLE, DEFAULT_BYTES);
+            return strcmp(argv[i], "-h") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    #if defined(_WIN32)
+        printf("SOAK: Requer fork() E /proc (Linux)\n");
+        return EXIT_FAILURE;
+    #else
+
+    if (config.users < 2) config.users = 2;
+    if (config.users > SOAK_MAX_USERS) config.users = SOAK_MAX_USERS;
+    if (config.rate <= 0) config.rate = DEFAULT_RATE;
+    if (config.minutes <= 0) config.minutes = DEFAULT_MINUTES;
+    if (config.interval <= 0) config.interval = DEFAULT_INTERVAL;
+    if (config.warmup < 0) config.warmup = 0;
+    if (config.cycle <= 0) config.cycle = DEFAULT_CYCLE;
+    if (config.bytes < 32) config.bytes = 32;
+    if (config.bytes > SOAK_MAX_BYTES) config.bytes = SOAK_MAX_BYTES;
+    snprintf(config.run_id, sizeof(config.run_id), "sk%ld", (long)(time(NULL) % 1000000));
+
+    SoakShared* shared = mmap(NULL, sizeof(SoakShared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    pid_t* pids = calloc(config.users, sizeof(pid_t));
+    if (shared == MAP_FAILED || !pids)
+    {
+        printf("SOAK: Memória Insuficiente\n");
+        return EXIT_FAILURE;
+    }
+    memset(shared, 0, sizeof(*shared));
+
+    // Broker: Always Embedded (Its Sessions / Retained Topics Are Part Of The Verdict)
+
+    char uri[64];
+    signal(SIGINT, SIG_IGN); // Inherited By The Broker: Stopped By The Parent, After The Users
+    pid_t broker_pid = simBrokerStart(&shared->broker, uri, sizeof(uri));
+    if (!broker_pid)
+    {
+        printf("SOAK: Falha Ao Iniciar O Broker Embutido\n");
+        return EXIT_FAILURE;
+    }
+    setenv("CHATMQTT_BROKER", uri, 1);
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    if (!json_output)
+        printf("SOAK: Broker %s (Embutido) | %d Usuários | %.2f Msgs/s Por Usuário | %d Min (%d Min De Aquecimento) | Amostra A Cada %d s%s\n",
+               uri, config.users, config.rate, config.minutes, config.warmup, config.interval,
+               getenv(MEMORY_LEAK_ENV) && atoi(getenv(MEMORY_LEAK_ENV)) > 0 ? " | Verificação De Resultados Ligada" : ""); // Not memoryLeakCheck(): The Parent Holds No Results
+    fflush(stdout); // The Children Would Flush Our Buffer Again
+
+    // Users
+
+    int started = 0;
+    for (int i = 0; i < config.users; i++)
+    {
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            signal(SIGINT, SIG_IGN); // Ctrl+C Reaches The Whole Group: The Parent Stops Everyone In Order
+            signal(SIGTERM, SIG_DFL);
+            simulateUser(&config, shared, i);
+            _exit(EXIT_SUCCESS);
+        }
+        if (pid < 0)
+            break;
+        pids[i] = pid;
+        started++;
+    }
+
+    uint64_t ready_deadline = simNowNs() + (uint64_t)SOAK_READY_TIMEOUT_S * 1000000000ull;
+    while (shared->ready + shared->failed < started && simNowNs() < ready_deadline && !stop_sk)
+        simSleepUs(DELAY_100_MS_US);
+    if (!json_output && shared->ready < started)
+        printf("SOAK: %d De %d Usuários Prontos, Iniciando Assim Mesmo\n", shared->ready, started);
+    shared->start = 1;
+
+    // Samples Until -d Minutes (Or A Signal)
+
+    SoakSample* samples = NULL;
+    int count = 0, capacity = 0, dead = 0;
+    uint64_t start = simNowNs();
+    uint64_t end = start + (uint64_t)config.minutes * 60000000000ull;
+    uint64_t next_sample = start;
+
+    if (!json_output)
+        printf("\n%7s %7s %10s %6s %7s %10s %12s %6s %7s %8s %8s %9s\n", "Minuto", "Ativos", "RSS (KB)", "FDs", "Threads", "Resultados",
+               "Broker (KB)", "FDs", "Threads", "Sessões", "Retidos", "Pendentes");
+
+    while (!stop_sk && simNowNs() < end)
+    {
+        if (simNowNs() < next_sample)
+        {
+            simSleepUs(DELAY_100_MS_US);
+            continue;
+        }
+        next_sample += (uint64_t)config.interval * 1000000000ull;
+
+        if (count == capacity)
+        {
+            int grown_capacity = capacity ? capacity * 2 : 256;
+            SoakSample* grown = realloc(samples, grown_capacity * sizeof(SoakSample));
+            if (!grown)
+                break;
+            samples = grown;
+            capacity = grown_capacity;
+        }
+
+        SoakSample* sample = &samples[count++];
+        sample->minutes = (simNowNs() - start) / 60e9;
+        takeSample(shared, broker_pid, pids, started, &dead, sample);
+        printSample(sample, shared, started - dead);
+
+        if (waitpid(broker_pid, NULL, WNOHANG) == broker_pid)
+        {
+            printf("SOAK: O Broker Terminou Durante A Execução\n");
+            broker_pid = 0;
+            break;
+        }
+    }
+
+    // Stop The Users (They Publish Their Offline Status First), Then The Broker
+
+    shared->stop = 1;
+    for (int i = 0; i < started; i++)
+        if (pids[i] > 0)
+            waitpid(pids[i], NULL, 0);
+
+    long sent = 0, received = 0, leaked = 0;
+    for (int i = 0; i < started; i++)
+    {
+        sent += shared->users[i].sent;
+        received += shared->users[i].received;
+        leaked += shared->users[i].leaked;
+    }
+
+    int failed = verdict(samples, count, &config);
+    int ok = broker_pid && failed == 0 && dead == 0 && leaked == 0 && shared->failed == 0;
+
+    if (json_output)
+        printf("{\"users\":%d,\"started\":%d,\"failed_start\":%d,\"died\":%d,\"samples\":%d,\"sent\":%ld,\"received\":%ld,\"leaked_results\":%ld,"
+               "\"metrics_over_limit\":%d,\"result\":\"%s\"}\n",
+               config.users, started, shared->failed, dead, count, sent, received, leaked, failed, ok ? "ok" : "fail");
+    else
+        printf("\nEnviadas: %ld | Recebidas: %ld (Grupos Multiplicam) | Usuários Que Não Iniciaram: %d | Que Terminaram Antes: %d | Resultados Não Liberados: %ld\n"
+               "SOAK: %s\n",
+               sent, received, shared->failed, dead, leaked, ok ? "OK" : "FALHOU");
+
+    if (broker_pid)
+    {
+        kill(broker_pid, SIGTERM);
+        waitpid(broker_pid, NULL, 0);
+    }
+    free(samples);
+    free(pids);
+    munmap(shared, sizeof(SoakShared));
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    #endif
+}
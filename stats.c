@@ -0,0 +1,374 @@
+// Latency Histograms / Counters (stats.h)
+// Every Histogram Is A Fixed Array Of Log-Linear Buckets: Recording Is One Bucket Index (Count Leading Zeros)
+// And A Few Relaxed Atomic Adds, So The Network Callbacks Record Without Locks Or Allocations
+// Percentiles Are Read From A Copy Of The Buckets (Values Within 1 / 2^STATS_SUB_BITS Of The Real Ones)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include "MQTTAsync.h"
+#include "transport.h"
+#include "constants.h"
+#include "stats.h"
+#include "memory.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
+
+#if defined(_WRS_KERNEL)
+#include <OsWrapper.h>
+#endif
+
+// Data Structures
+
+typedef struct
+{
+    uint64_t counts[STATS_BUCKETS];
+    uint64_t failures;
+    uint64_t sum_ns;
+    uint64_t max_ns;
+} StatsHistogram;
+
+typedef struct // Periodic Summary (STATS_TOPIC)
+{
+    MQTTAsync client;
+    char username[64];
+    int interval_s;
+    volatile int running;
+    pthread_t thread;
+} StatsPublisher;
+
+typedef struct // One-Way Latency Of One Conversation / Sender (Allocated On Its First Line, Never Freed)
+{
+    char name[128];
+    StatsHistogram histogram;
+} StatsConversation;
+
+static StatsHistogram histograms[STATS_OP_COUNT];
+static uint64_t counters[STATS_COUNTER_COUNT];
+static StatsConversation* conversations[STATS_CONVERSATIONS]; // Published With Release Once Named
+static int conversation_count = 0;
+static pthread_mutex_t conversation_lock = PTHREAD_MUTEX_INITIALIZER; // Adding Only (Lookups Read Published Entries)
+static StatsPublisher publisher_state;
+
+static const char* op_names[STATS_OP_COUNT] = { "connect", "subscribe", "publish", "disconnect", "retained", "delivery" };
+static const char* op_labels[STATS_OP_COUNT] = { "Conectar", "Inscrever", "Publicar (Ack)", "Desconectar", "Snapshot Retido", "Entrega (Conversa)" };
+
+// Buckets
+
+static int bucketOf(uint64_t ns) // [0, 2^SUB_BITS) Exact, Then 2^SUB_BITS Sub-Buckets Per Power Of Two
+{
+    if (ns >= (1ull << STATS_MAX_BITS))
+        ns = (1ull << STATS_MAX_BITS) - 1;
+    if (ns < (1ull << STATS_SUB_BITS))
+        return (int)ns;
+    int shift = (63 - __builtin_clzll(ns)) - STATS_SUB_BITS;
+    return ((shift + 1) << STATS_SUB_BITS) | (int)((ns >> shift) & ((1u << STATS_SUB_BITS) - 1));
+}
+
+static uint64_t bucketValue(int bucket) // Middle Of The Bucket
+{
+    if (bucket < (1 << STATS_SUB_BITS))
+        return (uint64_t)bucket;
+    int shift = (bucket >> STATS_SUB_BITS) - 1;
+    uint64_t low = ((1ull << STATS_SUB_BITS) | (uint64_t)(bucket & ((1 << STATS_SUB_BITS) - 1))) << shift;
+    return low + ((1ull << shift) >> 1);
+}
+
+// Histograms
+
+static void histogramRecord(StatsHistogram* histogram, uint64_t ns)
+{
+    __atomic_fetch_add(&histogram->counts[bucketOf(ns)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->sum_ns, ns, __ATOMIC_RELAXED);
+
+    uint64_t seen = __atomic_load_n(&histogram->max_ns, __ATOMIC_RELAXED);
+    while (ns > seen && !__atomic_compare_exchange_n(&histogram->max_ns, &seen, ns, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+static void histogramSummary(StatsHistogram* histogram, StatsSummary* summary)
+{
+    memset(summary, 0, sizeof(*summary));
+
+    // Copy First: Percentiles Come From One Consistent Set Of Counts While Other Threads Keep Recording
+
+    uint64_t counts[STATS_BUCKETS]; // ~18 KB Of Stack (Menu / Summary Thread Only)
+    uint64_t total = 0;
+    for (int i = 0; i < STATS_BUCKETS; i++)
+    {
+        counts[i] = __atomic_load_n(&histogram->counts[i], __ATOMIC_RELAXED);
+        total += counts[i];
+    }
+
+    summary->count = total;
+    summary->failures = __atomic_load_n(&histogram->failures, __ATOMIC_RELAXED);
+    if (total == 0)
+        return;
+    summary->mean_us = __atomic_load_n(&histogram->sum_ns, __ATOMIC_RELAXED) / 1000.0 / total;
+    summary->max_us = __atomic_load_n(&histogram->max_ns, __ATOMIC_RELAXED) / 1000.0;
+
+    // Nearest Rank
+
+    const double quantiles[3] = { 0.50, 0.99, 0.999 };
+    double* results[3] = { &summary->p50_us, &summary->p99_us, &summary->p999_us };
+    uint64_t seen = 0;
+    int q = 0;
+    for (int i = 0; i < STATS_BUCKETS && q < 3; i++)
+    {
+        seen += counts[i];
+        while (q < 3 && seen >= (uint64_t)(quantiles[q] * total + 0.999999))
+        {
+            double value = bucketValue(i) / 1000.0;
+            *results[q++] = value < summary->max_us ? value : summary->max_us;
+        }
+    }
+}
+
+static void histogramReset(StatsHistogram* histogram)
+{
+    for (int i = 0; i < STATS_BUCKETS; i++)
+        __atomic_store_n(&histogram->counts[i], 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&histogram->failures, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&histogram->sum_ns, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&histogram->max_ns, 0, __ATOMIC_RELAXED);
+}
+
+// Core Functions
+
+uint64_t statsNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+void statsRecord(StatsOp op, uint64_t ns)
+{
+    if (op >= 0 && op < STATS_OP_COUNT)
+        histogramRecord(&histograms[op], ns);
+}
+
+void statsSince(StatsOp op, uint64_t start_ns)
+{
+    uint64_t now = statsNow();
+    statsRecord(op, now > start_ns ? now - start_ns : 0);
+}
+
+void statsFail(StatsOp op)
+{
+    if (op >= 0 && op < STATS_OP_COUNT)
+        __atomic_fetch_add(&histograms[op].failures, 1, __ATOMIC_RELAXED);
+}
+
+void statsCount(StatsCounter counter, uint64_t amount)
+{
+    if (counter >= 0 && counter < STATS_COUNTER_COUNT)
+        __atomic_fetch_add(&counters[counter], amount, __ATOMIC_RELAXED);
+}
+
+uint64_t statsCounter(StatsCounter counter)
+{
+    if (counter < 0 || counter >= STATS_COUNTER_COUNT)
+        return 0;
+    return __atomic_load_n(&counters[counter], __ATOMIC_RELAXED);
+}
+
+void statsSummary(StatsOp op, StatsSummary* summary)
+{
+    if (op >= 0 && op < STATS_OP_COUNT)
+        histogramSummary(&histograms[op], summary);
+    else
+        memset(summary, 0, sizeof(*summary));
+}
+
+const char* statsOpName(StatsOp op)
+{
+    return (op >= 0 && op < STATS_OP_COUNT) ? op_names[op] : "";
+}
+
+void statsReset(void)
+{
+    for (int op = 0; op < STATS_OP_COUNT; op++)
+        histogramReset(&histograms[op]);
+    int count = __atomic_load_n(&conversation_count, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < count; i++)
+        histogramReset(&conversations[i]->histogram);
+    for (int i = 0; i < STATS_COUNTER_COUNT; i++)
+        __atomic_store_n(&counters[i], 0, __ATOMIC_RELAXED);
+}
+
+static StatsConversation* conversationFind(const char* name, int count)
+{
+    for (int i = 0; i < count; i++)
+        if (strcmp(conversations[i]->name, name) == 0)
+            return conversations[i];
+    return NULL;
+}
+
+void statsConversationRecord(const char* name, uint64_t ns)
+{
+    StatsConversation* conversation = conversationFind(name, __atomic_load_n(&conversation_count, __ATOMIC_ACQUIRE));
+    if (!conversation)
+    {
+        pthread_mutex_lock(&conversation_lock);
+        int count = conversation_count;
+        if (!(conversation = conversationFind(name, count)) && count < STATS_CONVERSATIONS &&
+            (conversation = calloc(1, sizeof(StatsConversation))))
+        {
+            snprintf(conversation->name, sizeof(conversation->name), "%s", name);
+            conversations[count] = conversation;
+            __atomic_store_n(&conversation_count, count + 1, __ATOMIC_RELEASE);
+        }
+        pthread_mutex_unlock(&conversation_lock);
+        if (!conversation)
+            return;
+    }
+    histogramRecord(&conversation->histogram, ns);
+}
+
+int statsConversationSummary(int index, char* name, size_t size, StatsSummary* summary)
+{
+    if (index < 0 || index >= __atomic_load_n(&conversation_count, __ATOMIC_ACQUIRE))
+        return 0;
+    snprintf(name, size, "%s", conversations[index]->name);
+    histogramSummary(&conversations[index]->histogram, summary);
+    return 1;
+}
+
+// Higher Level Functions
+
+void statsPrint(void)
+{
+    printf("%-20s %9s %7s %11s %11s %11s %11s %11s\n", "Operação", "Amostras", "Falhas", "Média (us)", "p50 (us)", "p99 (us)", "p999 (us)", "Máx (us)");
+    for (int op = 0; op < STATS_OP_COUNT; op++)
+    {
+        StatsSummary summary;
+        statsSummary((StatsOp)op, &summary);
+        printf("%-20s %9llu %7llu %11.1f %11.1f %11.1f %11.1f %11.1f\n", op_labels[op], (unsigned long long)summary.count, (unsigned long long)summary.failures,
+               summary.mean_us, summary.p50_us, summary.p99_us, summary.p999_us, summary.max_us);
+    }
+    printf("\nConexões Perdidas: %llu | Recebidas: %llu Mensagens (%llu Bytes) | Enviadas: %llu Mensagens (%llu Bytes)\n",
+           (unsigned long long)statsCounter(STATS_CONNECTION_LOST),
+           (unsigned long long)statsCounter(STATS_MESSAGES_IN), (unsigned long long)statsCounter(STATS_BYTES_IN),
+           (unsigned long long)statsCounter(STATS_MESSAGES_OUT), (unsigned long long)statsCounter(STATS_BYTES_OUT));
+
+    char name[128];
+    StatsSummary summary;
+    for (int i = 0; statsConversationSummary(i, name, sizeof(name), &summary); i++)
+    {
+        if (i == 0)
+            printf("\nLatência De Ida Por Conversa (Envio > Recebimento):\n%-20s %9s %11s %11s %11s %11s %11s\n",
+                   "Conversa", "Amostras", "Média (us)", "p50 (us)", "p99 (us)", "p999 (us)", "Máx (us)");
+        printf("%-20s %9llu %11.1f %11.1f %11.1f %11.1f %11.1f\n", name, (unsigned long long)summary.count,
+               summary.mean_us, summary.p50_us, summary.p99_us, summary.p999_us, summary.max_us);
+    }
+
+    printf("\nMemória:\n");
+    memoryPrint();
+}
+
+// {"user":"[USER]","t":[UNIX],"connect":[N,FAILURES,P50_US,P99_US,P999_US,MAX_US],...,"lost":N,"in":[MSGS,BYTES],"out":[MSGS,BYTES],
+//  "conversations":{"[NAME]":[N,P50_US,P99_US,P999_US,MAX_US],...},"memory":{"[ACCOUNT]":[BYTES,OBJECTS,BYTES_HIGH,OBJECTS_HIGH],...}}
+int statsFormat(char* out, size_t size, const char* username)
+{
+    int written = snprintf(out, size, "{\"user\":\"%s\",\"t\":%ld", username, (long)time(NULL));
+    for (int op = 0; op < STATS_OP_COUNT && written > 0 && (size_t)written < size; op++)
+    {
+        StatsSummary summary;
+        statsSummary((StatsOp)op, &summary);
+        written += snprintf(out + written, size - written, ",\"%s\":[%llu,%llu,%.0f,%.0f,%.0f,%.0f]", op_names[op],
+                            (unsigned long long)summary.count, (unsigned long long)summary.failures,
+                            summary.p50_us, summary.p99_us, summary.p999_us, summary.max_us);
+    }
+    if (written > 0 && (size_t)written < size)
+        written += snprintf(out + written, size - written, ",\"lost\":%llu,\"in\":[%llu,%llu],\"out\":[%llu,%llu],\"conversations\":{",
+                            (unsigned long long)statsCounter(STATS_CONNECTION_LOST),
+                            (unsigned long long)statsCounter(STATS_MESSAGES_IN), (unsigned long long)statsCounter(STATS_BYTES_IN),
+                            (unsigned long long)statsCounter(STATS_MESSAGES_OUT), (unsigned long long)statsCounter(STATS_BYTES_OUT));
+
+    char name[128];
+    StatsSummary summary;
+    for (int i = 0; written > 0 && (size_t)written < size && statsConversationSummary(i, name, sizeof(name), &summary); i++)
+        written += snprintf(out + written, size - written, "%s\"%s\":[%llu,%.0f,%.0f,%.0f,%.0f]", i ? "," : "", name,
+                            (unsigned long long)summary.count, summary.p50_us, summary.p99_us, summary.p999_us, summary.max_us);
+    if (written > 0 && (size_t)written < size)
+        written += snprintf(out + written, size - written, "},\"memory\":");
+    int memory = (written > 0 && (size_t)written < size) ? memoryFormat(out + written, size - written) : 0;
+    if (memory == 0)
+        return 0;
+    written += memory;
+    if ((size_t)written < size)
+        written += snprintf(out + written, size - written, "}");
+    return (written > 0 && (size_t)written < size) ? written : 0;
+}
+
+static void* publishLoop(void* arg)
+{
+    StatsPublisher* state = (StatsPublisher*)arg;
+    char topic[128];
+    char payload[16384]; // Up To STATS_CONVERSATIONS + MEMORY_ACCOUNTS Entries
+    snprintf(topic, sizeof(topic), STATS_TOPIC "%s", state->username);
+
+    while (state->running)
+    {
+        for (int waited = 0; waited < state->interval_s * 1000 && state->running; waited += DELAY_100_MS_MS)
+        {
+            #if defined(_WIN32)
+                Sleep(DELAY_100_MS_MS);
+            #else
+                usleep(DELAY_100_MS_US);
+            #endif
+        }
+        if (!state->running)
+            break;
+
+        int len = statsFormat(payload, sizeof(payload), state->username);
+        if (len == 0)
+            continue;
+
+        MQTTAsync_message pubmsg = MQTTAsync_message_initializer; // Message Object (... = [Default Initializer Macro])
+        pubmsg.payload = payload;
+        pubmsg.payloadlen = len;
+        pubmsg.qos = 0; // A Lost Summary Is Replaced By The Next One
+        pubmsg.retained = 0;
+
+        int rc = transportSendMessage(state->client, topic, &pubmsg, NULL);
+        if (rc != MQTTASYNC_SUCCESS && LOG_ENABLED)
+            printf("               [LOG] STATS: Failed to publish summary, return code %d\n", rc);
+    }
+    return NULL;
+}
+
+int statsPublishStart(void* client, const char* username, int interval_s)
+{
+    if (!client || interval_s <= 0 || publisher_state.running)
+        return 0;
+
+    publisher_state.client = (MQTTAsync)client;
+    snprintf(publisher_state.username, sizeof(publisher_state.username), "%s", username);
+    publisher_state.interval_s = interval_s;
+    publisher_state.running = 1;
+    if (pthread_create(&publisher_state.thread, NULL, publishLoop, &publisher_state) != 0)
+    {
+        publisher_state.running = 0;
+        return 0;
+    }
+
+    if (LOG_ENABLED)
+        printf("               [LOG] STATS: Publishing a summary to " STATS_TOPIC "%s every %d s\n", username, interval_s);
+    return 1;
+}
+
+void statsPublishStop(void)
+{
+    if (!publisher_state.running)
+        return;
+    publisher_state.running = 0;
+    pthread_join(publisher_state.thread, NULL);
+}
@@ -0,0 +1,82 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Constants */
+#define STATS_TOPIC        "CHATMQTT/STATS/" // Periodic Summary: CHATMQTT/STATS/[USER] (QoS 0, Not Retained)
+#define STATS_INTERVAL_ENV "CHATMQTT_STATS" // Seconds Between Summaries (Unset / 0 = Not Published)
+#define STATS_SUB_BITS     6 // Sub-Buckets Per Power Of Two (64 > Values Within ~1.6%)
+#define STATS_MAX_BITS     40 // Largest Value Told Apart: 2^40 ns (~18 Min), Longer Ones Land In The Last Bucket
+#define STATS_BUCKETS      ((STATS_MAX_BITS - STATS_SUB_BITS + 1) << STATS_SUB_BITS)
+#define STATS_PENDING      64 // Own Chat Lines Awaiting Their Echo Per Conversation (Delivery Latency)
+#define STATS_CONVERSATIONS 64 // One-Way Latency Histograms Kept (Pairs Seen After That Are Not Tracked)
+
+/* Latency Histograms */
+// HDR-Style (Log-Linear Buckets Over Nanoseconds), Recorded With Relaxed Atomics From Any Thread (No Lock, No Allocation)
+// - connect / subscribe / publish / disconnect > transport.c: Call Until Its onSuccess (onFailure Counts A Failure)
+// - retained > subscriberRetained(): Call Until The Snapshot Holds Its First Entries (Timeouts Count As Failures)
+// - delivery > conversationsSend() Until Our Own Line Comes Back Through The Broker On The Conversation Topic
+typedef enum StatsOp {
+    STATS_CONNECT,
+    STATS_SUBSCRIBE,
+    STATS_PUBLISH,
+    STATS_DISCONNECT,
+    STATS_RETAINED,
+    STATS_DELIVERY,
+    STATS_OP_COUNT
+} StatsOp;
+
+typedef enum StatsCounter {
+    STATS_CONNECTION_LOST,
+    STATS_MESSAGES_IN,
+    STATS_BYTES_IN,
+    STATS_MESSAGES_OUT,
+    STATS_BYTES_OUT,
+    STATS_COUNTER_COUNT
+} StatsCounter;
+
+typedef struct StatsSummary {
+    uint64_t count;
+    uint64_t failures;
+    double mean_us;
+    double p50_us;
+    double p99_us;
+    double p999_us;
+    double max_us;
+} StatsSummary;
+
+/* Per-Conversation Latency */
+// One-Way Latency Of The Chat Lines Received, From The Send Time In Their Envelope (envelope.h) Until They Arrive Here
+// Keyed By "[USER]" (Direct Conversation) Or "[GROUP]/[SENDER]", So A Slow User Pair Stands Out From The Rest
+
+/* Core Functions */
+uint64_t statsNow(void); // Monotonic Nanoseconds
+void statsRecord(StatsOp op, uint64_t ns);
+void statsSince(StatsOp op, uint64_t start_ns);
+void statsFail(StatsOp op);
+void statsCount(StatsCounter counter, uint64_t amount);
+uint64_t statsCounter(StatsCounter counter);
+void statsSummary(StatsOp op, StatsSummary* summary);
+const char* statsOpName(StatsOp op);
+void statsReset(void);
+
+void statsConversationRecord(const char* name, uint64_t ns);
+int statsConversationSummary(int index, char* name, size_t size, StatsSummary* summary); // 0 = No Histogram At index
+
+/* Higher Level Functions */
+void statsPrint(void); // Hidden Menu Option (Table In Microseconds)
+int statsFormat(char* out, size_t size, const char* username); // Compact JSON Line (Microseconds) | Length Written
+int statsPublishStart(void* client, const char* username, int interval_s); // MQTTAsync Kept Connected By The Caller
+void statsPublishStop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STATS_H
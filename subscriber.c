@@ -4,8 +4,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include "MQTTAsync.h"
+#include "transport.h"
 #include "constants.h"
+#include "memory.h"
 #include "messages.h"
+#include "stats.h"
 
 #if !defined(_WIN32)
 #include <unistd.h>
@@ -27,6 +30,24 @@ typedef struct
     LinkedList* message_list;
 } Context_s;
 
+// Context Accounting (memory.h)
+
+static int account_context_s = -1; // memoryAccountCached()
+
+static Context_s* newContext_s(void)
+{
+    Context_s* context = malloc(sizeof(Context_s));
+    if (context)
+        memoryAdd(memoryAccountCached(&account_context_s, "Context_s"), sizeof(Context_s), 1);
+    return context;
+}
+
+static void freeContext_s(Context_s* context)
+{
+    memoryAdd(memoryAccountCached(&account_context_s, "Context_s"), -(long)sizeof(Context_s), -1);
+    free(context);
+}
+
 // Flags
 
 int disc_finished = 0; // Disconnection Finished
@@ -75,39 +96,42 @@ void connectionLost_s(void *context_, char *cause) // Connection Lost
 	conn_opts.context = context;
 
 	// Try To Connect Again
-	if ((rc = MQTTAsync_connect(client, &conn_opts)) != MQTTASYNC_SUCCESS)
+	if ((rc = transportConnect(client, &conn_opts)) != MQTTASYNC_SUCCESS)
 	{
 		printf("SUBSCRIBER: Failed to start connect, return code %d\n", rc);
 		finished_subscribe = 1;
 	}
 }
 
+static void releaseMessage_s(void* message_) // Last View Released
+{
+    MQTTAsync_message* message = (MQTTAsync_message*)message_;
+    transportFreeMessage(&message);
+}
+
 int messageArrived_s(void *context_, char *topicName, int topicLen, MQTTAsync_message *message) // Message Arrived
 {
     Context_s* context = (Context_s*)context_;
 
-    // Ensure Payload Is Nul-Terminated
-
-    char buf[1024];
-    int len = message->payloadlen;
-    if (len >= (int)sizeof(buf)) len = sizeof(buf) - 1;
-    memcpy(buf, message->payload, len);
-    buf[len] = '\0';
-
     if (LOG_ENABLED)
     {
         printf("\n               [LOG] SUBSCRIBER: Message arrived\n");
         printf("               [LOG]      Topic: %s\n", topicName);
-        printf("               [LOG]    Message: %s\n", buf);
+        printf("               [LOG]    Message: %.*s\n", message->payloadlen, (char*)message->payload);
     }
 
-    // Message Type
-
-    listInsert(context->message_list, buf);
+    // Message Type (The List Keeps The Payload Itself, No Copy)
 
-	// Memory Management
-    MQTTAsync_freeMessage(&message);
-    MQTTAsync_free(topicName);
+    if (context->message_list)
+    {
+        MessageBuffer* buffer = bufferAdopt((char*)message->payload, message->payloadlen, releaseMessage_s, message);
+        listInsertView(context->message_list, buffer, buffer ? buffer->data : NULL, message->payloadlen);
+        bufferRelease(buffer);
+    }
+    else
+    {
+        transportFreeMessage(&message);
+    }
 
     return 1;
 }
@@ -168,7 +192,7 @@ void onConnect_s(void* context_, MQTTAsync_successData* response) // Connected S
     opts.context = context;
 
     // Subscribe To Topic
-    if ((rc = MQTTAsync_subscribe(client, context->topic_s, QOS, &opts)) != MQTTASYNC_SUCCESS)
+    if ((rc = transportSubscribe(client, context->topic_s, QOS, &opts)) != MQTTASYNC_SUCCESS)
     {
         if (LOG_ENABLED)
             printf("               [LOG] SUBSCRIBER: Failed to start subscribe, return code %d\n", rc);
@@ -176,7 +200,7 @@ void onConnect_s(void* context_, MQTTAsync_successData* response) // Connected S
     }
 
     // Subscribe to GROUPS topic
-    // if ((rc = MQTTAsync_subscribe(client, "GROUPS", QOS, &opts)) != MQTTASYNC_SUCCESS) {
+    // if ((rc = transportSubscribe(client, "GROUPS", QOS, &opts)) != MQTTASYNC_SUCCESS) {
     //     printf("               [LOG] SUBSCRIBER: Failed to subscribe to GROUPS, return code %d\n", rc);
     //     finished_subscribe = 1;
     // }
@@ -197,10 +221,11 @@ int subscriberRetained(const char* username_s, const char* topic_s, LinkedList*
 	disc_finished = 0;
 	subscribed = 0;
 	finished_subscribe = 0;
+	uint64_t start_ns = statsNow(); // Snapshot Latency (stats.h)
 
 	// Create Client
 
-    if ((rc = MQTTAsync_create(&client, ADDRESS, username_s, MQTTCLIENT_PERSISTENCE_NONE, NULL)) != MQTTASYNC_SUCCESS)
+    if ((rc = transportCreate(&client, ADDRESS, username_s, MQTTCLIENT_PERSISTENCE_NONE, NULL)) != MQTTASYNC_SUCCESS)
 	{
         if (LOG_ENABLED)
             printf("               [LOG] SUBSCRIBER: Failed to create client, return code %d\n", rc);
@@ -209,9 +234,9 @@ int subscriberRetained(const char* username_s, const char* topic_s, LinkedList*
 
 	// Create Context
 
-    Context_s* context = malloc(sizeof(Context_s));
+    Context_s* context = newContext_s();
     if (!context) {
-        MQTTAsync_destroy(&client);
+        transportDestroy(&client);
         return EXIT_FAILURE;
     }
 
@@ -222,12 +247,12 @@ int subscriberRetained(const char* username_s, const char* topic_s, LinkedList*
 
     // Set Callbacks
 
-    if ((rc = MQTTAsync_setCallbacks(client, context, connectionLost_s, messageArrived_s, NULL)) != MQTTASYNC_SUCCESS)
+    if ((rc = transportSetCallbacks(client, context, connectionLost_s, messageArrived_s, NULL)) != MQTTASYNC_SUCCESS)
 	{
         if (LOG_ENABLED)
             printf("               [LOG] SUBSCRIBER: Failed to set callbacks, return code %d\n", rc);
-        free(context);
-        MQTTAsync_destroy(&client);
+        freeContext_s(context);
+        transportDestroy(&client);
         return EXIT_FAILURE;
     }
 
@@ -241,11 +266,11 @@ int subscriberRetained(const char* username_s, const char* topic_s, LinkedList*
 
 	// Connect To Broker
 
-    if ((rc = MQTTAsync_connect(client, &conn_opts)) != MQTTASYNC_SUCCESS) {
+    if ((rc = transportConnect(client, &conn_opts)) != MQTTASYNC_SUCCESS) {
         if (LOG_ENABLED)
             printf("               [LOG] SUBSCRIBER: Failed to start connect, return code %d\n", rc);
-        free(context);
-        MQTTAsync_destroy(&client);
+        freeContext_s(context);
+        transportDestroy(&client);
         return EXIT_FAILURE;
     }
 
@@ -260,8 +285,8 @@ int subscriberRetained(const char* username_s, const char* topic_s, LinkedList*
     }
 
     if (finished_subscribe) {
-        MQTTAsync_destroy(&client);
-        free(context);
+        transportDestroy(&client);
+        freeContext_s(context);
         return EXIT_FAILURE;
     }
 
@@ -270,9 +295,10 @@ int subscriberRetained(const char* username_s, const char* topic_s, LinkedList*
     int waited_ms = 0;
     const int step_ms = 100; // 0.1 Second
     const int max_ms = 10000; // 10 Seconds
+    int has_msg = 0;
     while (waited_ms < max_ms) {
         pthread_mutex_lock(&context->message_list->lock);
-        int has_msg = (context->message_list->head != NULL);
+        has_msg = (context->message_list->head != NULL);
         pthread_mutex_unlock(&context->message_list->lock);
         if (has_msg) break;
         #if defined(_WIN32)
@@ -283,6 +309,12 @@ int subscriberRetained(const char* username_s, const char* topic_s, LinkedList*
         waited_ms += step_ms;
     }
 
+    if (has_msg) {
+        statsSince(STATS_RETAINED, start_ns);
+    } else {
+        statsFail(STATS_RETAINED); // Empty Directory Or Broker Too Slow: Only The Timeout Was Measured
+    }
+
 	// Disconnection Parameters
 
 	disc_opts.onSuccess = onDisconnect_s;
@@ -290,11 +322,11 @@ int subscriberRetained(const char* username_s, const char* topic_s, LinkedList*
 
 	// Disconnect To Broker
 
-    if ((rc = MQTTAsync_disconnect(client, &disc_opts)) != MQTTASYNC_SUCCESS) {
+    if ((rc = transportDisconnect(client, &disc_opts)) != MQTTASYNC_SUCCESS) {
         if (LOG_ENABLED)
             printf("               [LOG] SUBSCRIBER: Failed to start disconnect, return code %d\n", rc);
-        MQTTAsync_destroy(&client);
-        free(context);
+        transportDestroy(&client);
+        freeContext_s(context);
         return EXIT_FAILURE;
     }
 
@@ -309,8 +341,8 @@ int subscriberRetained(const char* username_s, const char* topic_s, LinkedList*
         #endif
  	}
 
-    MQTTAsync_destroy(&client);
-    free(context);
+    transportDestroy(&client);
+    freeContext_s(context);
     return rc;
 }
 
@@ -330,7 +362,7 @@ int subscriberDirty(const char* username_s, const char* topic_s, LinkedList* sta
 
 	// Create Client
 
-    if ((rc = MQTTAsync_create(&client, ADDRESS, username_s, MQTTCLIENT_PERSISTENCE_NONE, NULL)) != MQTTASYNC_SUCCESS)
+    if ((rc = transportCreate(&client, ADDRESS, username_s, MQTTCLIENT_PERSISTENCE_NONE, NULL)) != MQTTASYNC_SUCCESS)
 	{
         if (LOG_ENABLED)
             printf("               [LOG] SUBSCRIBER: Failed to create client, return code %d\n", rc);
@@ -339,9 +371,9 @@ int subscriberDirty(const char* username_s, const char* topic_s, LinkedList* sta
 
 	// Create Context
 
-    Context_s* context = malloc(sizeof(Context_s));
+    Context_s* context = newContext_s();
     if (!context) {
-        MQTTAsync_destroy(&client);
+        transportDestroy(&client);
         return EXIT_FAILURE;
     }
 
@@ -352,12 +384,12 @@ int subscriberDirty(const char* username_s, const char* topic_s, LinkedList* sta
 
     // Set Callbacks
 
-    if ((rc = MQTTAsync_setCallbacks(client, context, connectionLost_s, messageArrived_s, NULL)) != MQTTASYNC_SUCCESS)
+    if ((rc = transportSetCallbacks(client, context, connectionLost_s, messageArrived_s, NULL)) != MQTTASYNC_SUCCESS)
 	{
         if (LOG_ENABLED)
             printf("               [LOG] SUBSCRIBER: Failed to set callbacks, return code %d\n", rc);
-        free(context);
-        MQTTAsync_destroy(&client);
+        freeContext_s(context);
+        transportDestroy(&client);
         return EXIT_FAILURE;
     }
 
@@ -371,11 +403,11 @@ int subscriberDirty(const char* username_s, const char* topic_s, LinkedList* sta
 
 	// Connect To Broker
 
-    if ((rc = MQTTAsync_connect(client, &conn_opts)) != MQTTASYNC_SUCCESS) {
+    if ((rc = transportConnect(client, &conn_opts)) != MQTTASYNC_SUCCESS) {
         if (LOG_ENABLED)
             printf("               [LOG] SUBSCRIBER: Failed to start connect, return code %d\n", rc);
-        free(context);
-        MQTTAsync_destroy(&client);
+        freeContext_s(context);
+        transportDestroy(&client);
         return EXIT_FAILURE;
     }
 
@@ -390,8 +422,8 @@ int subscriberDirty(const char* username_s, const char* topic_s, LinkedList* sta
     }
 
     if (finished_subscribe) {
-        MQTTAsync_destroy(&client);
-        free(context);
+        transportDestroy(&client);
+        freeContext_s(context);
         return EXIT_FAILURE;
     }
 
@@ -402,11 +434,11 @@ int subscriberDirty(const char* username_s, const char* topic_s, LinkedList* sta
 
 	// Disconnect To Broker
 
-    if ((rc = MQTTAsync_disconnect(client, &disc_opts)) != MQTTASYNC_SUCCESS) {
+    if ((rc = transportDisconnect(client, &disc_opts)) != MQTTASYNC_SUCCESS) {
         if (LOG_ENABLED)
             printf("               [LOG] SUBSCRIBER: Failed to start disconnect, return code %d\n", rc);
-        MQTTAsync_destroy(&client);
-        free(context);
+        transportDestroy(&client);
+        freeContext_s(context);
         return EXIT_FAILURE;
     }
 
@@ -421,8 +453,8 @@ int subscriberDirty(const char* username_s, const char* topic_s, LinkedList* sta
         #endif
  	}
 
-    MQTTAsync_destroy(&client);
-    free(context);
+    transportDestroy(&client);
+    freeContext_s(context);
     return rc;
 }
 
@@ -442,7 +474,7 @@ int subscriberConversation(const char* username_s, const char* topic_s,  LinkedL
 
 	// Create Client
 
-    if ((rc = MQTTAsync_create(&client, ADDRESS, username_s, MQTTCLIENT_PERSISTENCE_NONE, NULL)) != MQTTASYNC_SUCCESS)
+    if ((rc = transportCreate(&client, ADDRESS, username_s, MQTTCLIENT_PERSISTENCE_NONE, NULL)) != MQTTASYNC_SUCCESS)
 	{
         if (LOG_ENABLED)
             printf("               [LOG] SUBSCRIBER: Failed to create client, return code %d\n", rc);
@@ -451,9 +483,9 @@ int subscriberConversation(const char* username_s, const char* topic_s,  LinkedL
 
 	// Create Context
 
-    Context_s* context = malloc(sizeof(Context_s));
+    Context_s* context = newContext_s();
     if (!context) {
-        MQTTAsync_destroy(&client);
+        transportDestroy(&client);
         return EXIT_FAILURE;
     }
 
@@ -464,12 +496,12 @@ int subscriberConversation(const char* username_s, const char* topic_s,  LinkedL
 
     // Set Callbacks
 
-    if ((rc = MQTTAsync_setCallbacks(client, context, connectionLost_s, messageArrived_s, NULL)) != MQTTASYNC_SUCCESS)
+    if ((rc = transportSetCallbacks(client, context, connectionLost_s, messageArrived_s, NULL)) != MQTTASYNC_SUCCESS)
 	{
         if (LOG_ENABLED)
             printf("               [LOG] SUBSCRIBER: Failed to set callbacks, return code %d\n", rc);
-        free(context);
-        MQTTAsync_destroy(&client);
+        freeContext_s(context);
+        transportDestroy(&client);
         return EXIT_FAILURE;
     }
 
@@ -483,11 +515,11 @@ int subscriberConversation(const char* username_s, const char* topic_s,  LinkedL
 
 	// Connect To Broker
 
-    if ((rc = MQTTAsync_connect(client, &conn_opts)) != MQTTASYNC_SUCCESS) {
+    if ((rc = transportConnect(client, &conn_opts)) != MQTTASYNC_SUCCESS) {
         if (LOG_ENABLED)
             printf("               [LOG] SUBSCRIBER: Failed to start connect, return code %d\n", rc);
-        free(context);
-        MQTTAsync_destroy(&client);
+        freeContext_s(context);
+        transportDestroy(&client);
         return EXIT_FAILURE;
     }
 
@@ -510,8 +542,8 @@ int subscriberConversation(const char* username_s, const char* topic_s,  LinkedL
     }
 
     if (finished_subscribe) {
-        MQTTAsync_destroy(&client);
-        free(context);
+        transportDestroy(&client);
+        freeContext_s(context);
         return EXIT_FAILURE;
     }
 
@@ -522,11 +554,11 @@ int subscriberConversation(const char* username_s, const char* topic_s,  LinkedL
 
 	// Disconnect To Broker
 
-    if ((rc = MQTTAsync_disconnect(client, &disc_opts)) != MQTTASYNC_SUCCESS) {
+    if ((rc = transportDisconnect(client, &disc_opts)) != MQTTASYNC_SUCCESS) {
         if (LOG_ENABLED)
             printf("               [LOG] SUBSCRIBER: Failed to start disconnect, return code %d\n", rc);
-        MQTTAsync_destroy(&client);
-        free(context);
+        transportDestroy(&client);
+        freeContext_s(context);
         return EXIT_FAILURE;
     }
 
@@ -541,7 +573,7 @@ int subscriberConversation(const char* username_s, const char* topic_s,  LinkedL
         #endif
  	}
 
-    MQTTAsync_destroy(&client);
-    free(context);
+    transportDestroy(&client);
+    freeContext_s(context);
     return rc;
 }
\ No newline at end of file
@@ -0,0 +1,471 @@
+// Low-Overhead Tracing (trace.h)
+// Each Thread Gets A Ring On Its First Record (Reused From An Exited Thread When One Is Free), The Ring Is Only Written
+// By Its Owner: Slot Sequence Set Busy > Fields > Sequence Set To The Slot Index > Head Advanced (Release)
+// Readers Copy A Slot Between Two Reads Of Its Sequence And Keep It Only When Both Match The Expected Index
+// Dumps Use open() / write() Over A Stack Buffer, So The Same Code Runs From The SIGUSR2 Handler
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <fcntl.h>
+#include "trace.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <signal.h>
+#else
+#include <windows.h>
+#include <io.h>
+#define open _open
+#define write _write
+#define close _close
+#define read _read
+#endif
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#if defined(_WRS_KERNEL)
+#include <OsWrapper.h>
+#endif
+
+#if !defined(O_BINARY)
+#define O_BINARY 0
+#endif
+
+// Data Structures
+
+#define TRACE_SEQ_BUSY  0xFFFFFFFFu // Slot Being Written
+#define TRACE_BATCH     64 // Records Per write() While Dumping
+
+enum
+{
+    RING_FREE, // Owner Exited (Records Kept Until The Ring Is Reused)
+    RING_OWNED
+};
+
+typedef struct
+{
+    uint64_t head; // Records Ever Written (Next Slot = head % TRACE_RING_SIZE)
+    int state;
+    uint32_t thread;
+    TraceRecord records[TRACE_RING_SIZE];
+} TraceRing;
+
+int trace_enabled = 0;
+
+static TraceRing* rings[TRACE_MAX_THREADS];
+static int ring_count = 0;
+static unsigned long dropped = 0;
+static __thread TraceRing* thread_ring = NULL;
+static __thread int thread_refused = 0; // Every Ring Taken: This Thread Only Counts Drops
+static pthread_key_t ring_key;
+static pthread_once_t ring_once = PTHREAD_ONCE_INIT;
+static char trace_path[512] = "";
+
+static const char* op_names[TRACE_OP_COUNT] = {
+    "connect", "subscribe", "publish", "disconnect", "success", "failure", "arrived", "lost", "chat_send", "chat_receive"
+};
+
+// Rings
+
+static void ringRelease(void* ring_) // Thread Exit (pthread Key Destructor)
+{
+    TraceRing* ring = (TraceRing*)ring_;
+    __atomic_store_n(&ring->state, RING_FREE, __ATOMIC_RELEASE);
+}
+
+static void ringKeyCreate(void)
+{
+    pthread_key_create(&ring_key, ringRelease);
+}
+
+static uint32_t threadId(int ring_index)
+{
+    #if defined(__linux__)
+        (void)ring_index;
+        return (uint32_t)syscall(SYS_gettid);
+    #else
+        return (uint32_t)ring_index + 1;
+    #endif
+}
+
+static TraceRing* ringAcquire(void)
+{
+    pthread_once(&ring_once, ringKeyCreate);
+
+    // A Ring Left By An Exited Thread First (Thread Churn Stays Bounded)
+
+    int count = __atomic_load_n(&ring_count, __ATOMIC_ACQUIRE);
+    TraceRing* ring = NULL;
+    int index = -1;
+    for (int i = 0; i < count && !ring; i++)
+    {
+        TraceRing* candidate = __atomic_load_n(&rings[i], __ATOMIC_ACQUIRE);
+        int expected = RING_FREE;
+        if (candidate && __atomic_compare_exchange_n(&candidate->state, &expected, RING_OWNED, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+        {
+            ring = candidate;
+            index = i;
+        }
+    }
+
+    if (!ring)
+    {
+        index = __atomic_fetch_add(&ring_count, 1, __ATOMIC_ACQ_REL);
+        if (index >= TRACE_MAX_THREADS)
+        {
+            __atomic_fetch_sub(&ring_count, 1, __ATOMIC_ACQ_REL);
+            return NULL;
+        }
+        ring = calloc(1, sizeof(TraceRing));
+        if (!ring)
+            return NULL; // Slot Stays NULL (Skipped By Readers)
+        ring->state = RING_OWNED;
+        __atomic_store_n(&rings[index], ring, __ATOMIC_RELEASE);
+    }
+
+    ring->thread = threadId(index);
+    pthread_setspecific(ring_key, ring);
+    return ring;
+}
+
+// Core Functions
+
+void traceRecord(TraceOp op, uint64_t token, int32_t arg)
+{
+    TraceRing* ring = thread_ring;
+    if (!ring)
+    {
+        if (thread_refused || !(ring = thread_ring = ringAcquire()))
+        {
+            thread_refused = 1;
+            __atomic_fetch_add(&dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    uint64_t index = ring->head;
+    TraceRecord* record = &ring->records[index & (TRACE_RING_SIZE - 1)];
+
+    __atomic_store_n(&record->seq, TRACE_SEQ_BUSY, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    record->ns = (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+    record->token = token;
+    record->thread = ring->thread;
+    record->op = (uint16_t)op;
+    record->reserved = 0;
+    record->arg = arg;
+    __atomic_store_n(&record->seq, (uint32_t)index, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring->head, index + 1, __ATOMIC_RELEASE);
+}
+
+void traceEnable(int enabled)
+{
+    __atomic_store_n(&trace_enabled, enabled ? 1 : 0, __ATOMIC_RELAXED);
+}
+
+int traceEnabled(void)
+{
+    return __atomic_load_n(&trace_enabled, __ATOMIC_RELAXED);
+}
+
+static int writeAll(int fd, const void* data, size_t size)
+{
+    const char* p = (const char*)data;
+    while (size > 0)
+    {
+        long written = (long)write(fd, p, size);
+        if (written <= 0)
+            return 0;
+        p += written;
+        size -= (size_t)written;
+    }
+    return 1;
+}
+
+long traceDump(const char* path) // No malloc / stdio: Also Called From The Signal Handler
+{
+    if (!path)
+        path = tracePath();
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+    if (fd < 0)
+        return -1;
+
+    char header[12];
+    uint32_t record_size = sizeof(TraceRecord);
+    memcpy(header, TRACE_MAGIC, 8);
+    memcpy(header + 8, &record_size, sizeof(record_size));
+    if (!writeAll(fd, header, sizeof(header)))
+    {
+        close(fd);
+        return -1;
+    }
+
+    TraceRecord batch[TRACE_BATCH];
+    int batched = 0;
+    long total = 0;
+    int count = __atomic_load_n(&ring_count, __ATOMIC_ACQUIRE);
+
+    for (int i = 0; i < count && i < TRACE_MAX_THREADS; i++)
+    {
+        TraceRing* ring = __atomic_load_n(&rings[i], __ATOMIC_ACQUIRE);
+        if (!ring)
+            continue;
+
+        uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        uint64_t first = head > TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0;
+        for (uint64_t index = first; index < head; index++)
+        {
+            TraceRecord* slot = &ring->records[index & (TRACE_RING_SIZE - 1)];
+            uint32_t before = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+            if (before != (uint32_t)index)
+                continue; // Already Overwritten By A Newer Record
+            batch[batched] = *slot;
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != before)
+                continue; // Overwritten While Copying
+            batch[batched].seq = before;
+            if (++batched == TRACE_BATCH)
+            {
+                if (!writeAll(fd, batch, sizeof(batch)))
+                {
+                    close(fd);
+                    return -1;
+                }
+                total += batched;
+                batched = 0;
+            }
+        }
+    }
+
+    if (batched > 0 && !writeAll(fd, batch, batched * sizeof(TraceRecord)))
+    {
+        close(fd);
+        return -1;
+    }
+    total += batched;
+    close(fd);
+    return total;
+}
+
+const char* tracePath(void)
+{
+    if (!trace_path[0])
+    {
+        const char* path = getenv(TRACE_FILE_ENV);
+        if (path && path[0])
+            snprintf(trace_path, sizeof(trace_path), "%s", path);
+        else
+        {
+            #if !defined(_WIN32)
+                snprintf(trace_path, sizeof(trace_path), "chatmqtt-%ld.trace", (long)getpid());
+            #else
+                snprintf(trace_path, sizeof(trace_path), "chatmqtt-%lu.trace", (unsigned long)GetCurrentProcessId());
+            #endif
+        }
+    }
+    return trace_path;
+}
+
+const char* traceOpName(TraceOp op)
+{
+    return (op >= 0 && op < TRACE_OP_COUNT) ? op_names[op] : "?";
+}
+
+void traceCounts(long* records, int* threads, unsigned long* lost)
+{
+    long held = 0;
+    int used = 0;
+    int count = __atomic_load_n(&ring_count, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < count && i < TRACE_MAX_THREADS; i++)
+    {
+        TraceRing* ring = __atomic_load_n(&rings[i], __ATOMIC_ACQUIRE);
+        if (!ring)
+            continue;
+        uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        held += head < TRACE_RING_SIZE ? (long)head : TRACE_RING_SIZE;
+        used += __atomic_load_n(&ring->state, __ATOMIC_RELAXED) == RING_OWNED;
+    }
+    if (records) *records = held;
+    if (threads) *threads = used;
+    if (lost) *lost = __atomic_load_n(&dropped, __ATOMIC_RELAXED);
+}
+
+// Signals (SIGUSR1 = On / Off, SIGUSR2 = Dump)
+
+#if !defined(_WIN32)
+static void onSignal_t(int signal_number)
+{
+    if (signal_number == SIGUSR1)
+        traceEnable(!traceEnabled());
+    else if (signal_number == SIGUSR2)
+        traceDump(trace_path);
+}
+#endif
+
+void traceInit(void)
+{
+    const char* enabled = getenv(TRACE_ENV);
+    if (enabled && atoi(enabled) > 0)
+        traceEnable(1);
+    tracePath(); // Resolved Here: The Signal Handler Cannot Call getenv / snprintf
+
+    #if !defined(_WIN32)
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = onSignal_t;
+        action.sa_flags = SA_RESTART; // The Menu's scanf() Keeps Waiting
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGUSR1, &action, NULL);
+        sigaction(SIGUSR2, &action, NULL);
+    #endif
+}
+
+// Standalone Reader (gcc -DTRACE_MAIN trace.c -o trace)
+// Merges Every File Given (Processes Of The Same Host Share CLOCK_MONOTONIC), Sorts By Time And Prints One Line Per Record:
+// Calls Are Paired With Their success / failure, Chat Lines Received With Their chat_send (Latency In Microseconds)
+
+#if defined(TRACE_MAIN)
+
+typedef struct
+{
+    uint64_t token;
+    uint64_t ns;
+    int used;
+} TracePending;
+
+static int compareRecords(const void* a, const void* b)
+{
+    const TraceRecord* x = (const TraceRecord*)a;
+    const TraceRecord* y = (const TraceRecord*)b;
+    return (x->ns > y->ns) - (x->ns < y->ns);
+}
+
+static TracePending* pendingSlot(TracePending* table, size_t mask, uint64_t token)
+{
+    size_t slot = (size_t)((token * 0x9E3779B97F4A7C15ull) >> 20) & mask;
+    while (table[slot].used && table[slot].token != token)
+        slot = (slot + 1) & mask;
+    return &table[slot];
+}
+
+static int loadFile(const char* path, TraceRecord** records, size_t* count, size_t* capacity)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return 0;
+
+    char header[12];
+    uint32_t record_size = 0;
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) || memcmp(header, TRACE_MAGIC, 8) != 0)
+    {
+        fclose(file);
+        return 0;
+    }
+    memcpy(&record_size, header + 8, sizeof(record_size));
+    if (record_size != sizeof(TraceRecord))
+    {
+        fclose(file);
+        return 0;
+    }
+
+    TraceRecord record;
+    while (fread(&record, sizeof(record), 1, file) == 1)
+    {
+        if (*count == *capacity)
+        {
+            size_t grown = *capacity ? *capacity * 2 : 4096;
+            TraceRecord* larger = realloc(*records, grown * sizeof(TraceRecord));
+            if (!larger)
+                break;
+            *records = larger;
+            *capacity = grown;
+        }
+        (*records)[(*count)++] = record;
+    }
+    fclose(file);
+    return 1;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        printf("Uso: %s [ARQUIVO]...\n"
+               "  Arquivos Gravados Com SIGUSR2 Ou Pela Opção \"8\" Do Menu (Padrão: chatmqtt-[PID].trace)\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    TraceRecord* records = NULL;
+    size_t count = 0, capacity = 0;
+    for (int i = 1; i < argc; i++)
+        if (!loadFile(argv[i], &records, &count, &capacity))
+            printf("TRACE: Arquivo Inválido: %s\n", argv[i]);
+    if (count == 0)
+    {
+        printf("TRACE: Nenhum Registro\n");
+        free(records);
+        return EXIT_FAILURE;
+    }
+    qsort(records, count, sizeof(TraceRecord), compareRecords);
+
+    size_t slots = 1024;
+    while (slots < count * 2)
+        slots <<= 1;
+    TracePending* pending = calloc(slots, sizeof(TracePending)); // Calls (Token = TimedCall)
+    TracePending* lines = calloc(slots, sizeof(TracePending)); // Chat Lines (Token = Session << 32 | Seq)
+    if (!pending || !lines)
+    {
+        free(pending);
+        free(lines);
+        free(records);
+        return EXIT_FAILURE;
+    }
+
+    printf("%14s %8s %-13s %18s %10s %s\n", "Tempo (us)", "Thread", "Operação", "Token", "Arg", "Latência (us)");
+    for (size_t i = 0; i < count; i++)
+    {
+        const TraceRecord* record = &records[i];
+        double at_us = (record->ns - records[0].ns) / 1000.0;
+        printf("%14.1f %8u %-13s %18llx %10d", at_us, record->thread, traceOpName((TraceOp)record->op),
+               (unsigned long long)record->token, record->arg);
+
+        // Starts Remembered By Token, Ends Print The Time Since (A Freed Call Address May Be Reused Later)
+
+        int chat = record->op == TRACE_CHAT_SEND || record->op == TRACE_CHAT_RECEIVE;
+        TracePending* table = chat ? lines : pending;
+        if (record->op <= TRACE_DISCONNECT || record->op == TRACE_CHAT_SEND)
+        {
+            TracePending* slot = pendingSlot(table, slots - 1, record->token);
+            slot->used = 1;
+            slot->token = record->token;
+            slot->ns = record->ns;
+        }
+        else if (record->op == TRACE_SUCCESS || record->op == TRACE_FAILURE || record->op == TRACE_CHAT_RECEIVE)
+        {
+            TracePending* slot = pendingSlot(table, slots - 1, record->token);
+            if (slot->used && record->ns >= slot->ns)
+            {
+                printf(" %.1f", (record->ns - slot->ns) / 1000.0);
+                if (!chat) // Group Lines Reach Several Receivers
+                    slot->ns = UINT64_MAX;
+            }
+        }
+        printf("\n");
+    }
+
+    free(pending);
+    free(lines);
+    free(records);
+    return EXIT_SUCCESS;
+}
+
+#endif // TRACE_MAIN
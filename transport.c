@@ -0,0 +1,1273 @@
+// MQTT Transport: Paho Or The In-Memory Loopback Bus (Chosen By The Server URI)
+//
+// Loopback Bus (One Per Process):
+// - Sessions By Client Id (cleansession = 0 Keeps Subscriptions And Queues QoS 1/2 Messages While Offline)
+// - Exact Filters Found Through A Hash Table, Wildcard Filters Walked | Retained Messages Stored Per Topic
+// - Each Client Has Its Own Queue And Callback Thread: Publishing Only Copies The Message Into The Queues,
+//   Callbacks May Publish / Subscribe (No Lock Held While They Run)
+// Both: Connect / Subscribe / Publish / Disconnect Are Timed Until Their Callback (stats.h), Messages In / Out Counted
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "MQTTAsync.h"
+#include "broker.h"
+#include "memory.h"
+#include "stats.h"
+#include "trace.h"
+#include "transport.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(_WRS_KERNEL)
+#include <OsWrapper.h>
+#endif
+
+#if !defined(MQTTASYNC_DISCONNECTED)
+#define MQTTASYNC_DISCONNECTED -3
+#endif
+#if !defined(MQTTASYNC_NULL_PARAMETER)
+#define MQTTASYNC_NULL_PARAMETER -6
+#endif
+#if !defined(MQTTASYNC_BAD_QOS)
+#define MQTTASYNC_BAD_QOS -9
+#endif
+#if !defined(MQTTASYNC_BAD_PROTOCOL)
+#define MQTTASYNC_BAD_PROTOCOL -14
+#endif
+
+// Queue Items (Run In Order On The Client's Callback Thread)
+
+enum
+{
+    ITEM_MESSAGE,
+    ITEM_SUCCESS,
+    ITEM_FAILURE,
+    ITEM_DELIVERED,
+    ITEM_LOST
+};
+
+typedef struct LoopItem
+{
+    int type;
+    char* topic;
+    MQTTAsync_message* message; // Loopback Block ("MQTL"): Message + Payload
+    MQTTAsync_onSuccess* on_success;
+    MQTTAsync_onFailure* on_failure;
+    void* context;
+    MQTTAsync_token token;
+    int session_present;
+    struct LoopItem* next;
+} LoopItem;
+
+typedef struct LoopSession LoopSession;
+
+typedef struct LoopSubscription
+{
+    char* filter;
+    int qos;
+    LoopSession* session;
+    struct LoopSubscription* next_session;
+    struct LoopSubscription* next_match;
+} LoopSubscription;
+
+typedef struct Transport
+{
+    int loopback;
+    MQTTAsync paho;
+    void* context;
+    MQTTAsync_connectionLost* connection_lost;
+    MQTTAsync_messageArrived* message_arrived;
+    MQTTAsync_deliveryComplete* delivery_complete;
+    pthread_mutex_t calls_lock;
+    struct TimedCall* calls; // Waiting For Their Callback (Freed With The Client)
+
+    // Loopback
+    char* client_id;
+    LoopSession* session; // Attached While Connected (Bus Lock)
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    LoopItem* head;
+    LoopItem* tail;
+    pthread_t thread;
+    int thread_started;
+    int stopping; // 2 = Destroyed From Its Own Callback (The Thread Frees The Client)
+} Transport;
+
+struct LoopSession
+{
+    char* client_id;
+    int clean;
+    Transport* client; // NULL = Offline
+    LoopSubscription* subscriptions;
+    LoopItem* head; // Offline Queue
+    LoopItem* tail;
+    int queued;
+    unsigned long mark; // Publish Being Routed (One Copy Per Session)
+    int mark_qos;
+    LoopSession* next;
+};
+
+typedef struct LoopEntry
+{
+    char* key;
+    void* value;
+    struct LoopEntry* next;
+} LoopEntry;
+
+typedef struct
+{
+    LoopEntry** buckets;
+    int size;
+    int count;
+} LoopTable;
+
+typedef struct
+{
+    char* payload;
+    int len;
+    int qos;
+} LoopRetained;
+
+typedef struct TimedCall // Caller's Callbacks, Run After The Latency Is Recorded
+{
+    StatsOp op;
+    uint64_t start_ns;
+    MQTTAsync_onSuccess* on_success;
+    MQTTAsync_onFailure* on_failure;
+    void* context;
+    Transport* transport;
+    struct TimedCall* prev;
+    struct TimedCall* next;
+} TimedCall;
+
+static pthread_mutex_t bus_lock = PTHREAD_MUTEX_INITIALIZER;
+static LoopSession* bus_sessions = NULL;
+static LoopTable bus_exact; // Filter > LoopSubscription* (List)
+static LoopSubscription* bus_wildcards = NULL;
+static LoopTable bus_retained; // Topic > LoopRetained*
+static unsigned long bus_publishes = 0;
+static MQTTAsync_token bus_tokens = 0;
+static int bus_msgids = 0;
+
+// Table (String Keys, Chained, Doubles When Full)
+
+static unsigned int hashKey(const char* key) // FNV-1a
+{
+    unsigned int hash = 2166136261u;
+    for (; *key; key++)
+    {
+        hash ^= (unsigned char)*key;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static LoopEntry** tableSlot(LoopTable* table, const char* key)
+{
+    if (!table->buckets)
+        return NULL;
+    LoopEntry** slot = &table->buckets[hashKey(key) & (table->size - 1)];
+    while (*slot && strcmp((*slot)->key, key) != 0)
+        slot = &(*slot)->next;
+    return slot;
+}
+
+static void* tableGet(LoopTable* table, const char* key)
+{
+    LoopEntry** slot = tableSlot(table, key);
+    return (slot && *slot) ? (*slot)->value : NULL;
+}
+
+static int tablePut(LoopTable* table, const char* key, void* value)
+{
+    if (table->count >= table->size)
+    {
+        int size = table->size ? table->size * 2 : 64;
+        LoopEntry** buckets = calloc(size, sizeof(LoopEntry*));
+        if (!buckets)
+            return 0;
+        for (int i = 0; i < table->size; i++)
+        {
+            LoopEntry* entry = table->buckets[i];
+            while (entry)
+            {
+                LoopEntry* next = entry->next;
+                LoopEntry** slot = &buckets[hashKey(entry->key) & (size - 1)];
+                entry->next = *slot;
+                *slot = entry;
+                entry = next;
+            }
+        }
+        free(table->buckets);
+        table->buckets = buckets;
+        table->size = size;
+    }
+
+    LoopEntry** slot = tableSlot(table, key);
+    if (*slot)
+    {
+        (*slot)->value = value;
+        return 1;
+    }
+    LoopEntry* entry = malloc(sizeof(LoopEntry));
+    if (!entry || !(entry->key = strdup(key)))
+    {
+        free(entry);
+        return 0;
+    }
+    entry->value = value;
+    entry->next = NULL;
+    *slot = entry;
+    table->count++;
+    return 1;
+}
+
+static void tableRemove(LoopTable* table, const char* key)
+{
+    LoopEntry** slot = tableSlot(table, key);
+    if (!slot || !*slot)
+        return;
+    LoopEntry* entry = *slot;
+    *slot = entry->next;
+    free(entry->key);
+    free(entry);
+    table->count--;
+}
+
+// Timed Calls
+
+static void timedUnlink(TimedCall* call)
+{
+    Transport* transport = call->transport;
+    pthread_mutex_lock(&transport->calls_lock);
+    if (call->prev)
+        call->prev->next = call->next;
+    else
+        transport->calls = call->next;
+    if (call->next)
+        call->next->prev = call->prev;
+    pthread_mutex_unlock(&transport->calls_lock);
+}
+
+static void onSuccess_t(void* context_, MQTTAsync_successData* response)
+{
+    TimedCall* call = (TimedCall*)context_;
+    MQTTAsync_onSuccess* on_success = call->on_success;
+    void* context = call->context;
+
+    statsSince(call->op, call->start_ns);
+    TRACE_EVENT(TRACE_SUCCESS, success, (uintptr_t)call, call->op);
+    timedUnlink(call);
+    free(call);
+    if (on_success)
+        on_success(context, response);
+}
+
+static void onFailure_t(void* context_, MQTTAsync_failureData* response)
+{
+    TimedCall* call = (TimedCall*)context_;
+    MQTTAsync_onFailure* on_failure = call->on_failure;
+    void* context = call->context;
+
+    statsFail(call->op);
+    TRACE_EVENT(TRACE_FAILURE, failure, (uintptr_t)call, call->op);
+    timedUnlink(call);
+    free(call);
+    if (on_failure)
+        on_failure(context, response);
+}
+
+// Swaps The Caller's Callbacks For The Timing Ones | NULL = Not Timed (Out Of Memory), The Call Goes Out Unchanged
+static TimedCall* timedStart(Transport* transport, StatsOp op, MQTTAsync_onSuccess** on_success, MQTTAsync_onFailure** on_failure, void** context)
+{
+    TimedCall* call = malloc(sizeof(TimedCall));
+    if (!call)
+        return NULL;
+    call->op = op;
+    call->on_success = *on_success;
+    call->on_failure = *on_failure;
+    call->context = *context;
+    call->transport = transport;
+
+    pthread_mutex_lock(&transport->calls_lock);
+    call->prev = NULL;
+    call->next = transport->calls;
+    if (transport->calls)
+        transport->calls->prev = call;
+    transport->calls = call;
+    pthread_mutex_unlock(&transport->calls_lock);
+
+    *on_success = onSuccess_t;
+    *on_failure = onFailure_t;
+    *context = call;
+    call->start_ns = statsNow();
+    return call;
+}
+
+static int timedEnd(TimedCall* call, int rc) // The Call Was Refused: No Callback Will Come
+{
+    if (call && rc != MQTTASYNC_SUCCESS)
+    {
+        statsFail(call->op);
+        TRACE_EVENT(TRACE_FAILURE, failure, (uintptr_t)call, call->op);
+        timedUnlink(call);
+        free(call);
+    }
+    return rc;
+}
+
+static void timedDrop(Transport* transport) // Client Destroyed With Calls Still Pending
+{
+    while (transport->calls)
+    {
+        TimedCall* call = transport->calls;
+        transport->calls = call->next;
+        free(call);
+    }
+    pthread_mutex_destroy(&transport->calls_lock);
+}
+
+// Items
+
+static int account_messages = -1; // "paho:messages" (memoryAccountCached())
+
+static long messageBytes(const MQTTAsync_message* message)
+{
+    return (long)sizeof(MQTTAsync_message) + message->payloadlen;
+}
+
+static MQTTAsync_message* copyMessage(const void* payload, int len, int qos, int retained)
+{
+    MQTTAsync_message* message = malloc(sizeof(MQTTAsync_message) + len + 1);
+    if (!message)
+        return NULL;
+
+    MQTTAsync_message initializer = MQTTAsync_message_initializer;
+    *message = initializer;
+    memcpy(message->struct_id, "MQTL", 4); // Freed By transportFreeMessage() As One Block
+    message->payload = (char*)(message + 1);
+    message->payloadlen = len;
+    message->qos = qos;
+    message->retained = retained;
+    message->msgid = qos > 0 ? (bus_msgids = bus_msgids % 65535 + 1) : 0;
+    if (len > 0)
+        memcpy(message->payload, payload, len);
+    ((char*)message->payload)[len] = '\0';
+    return message;
+}
+
+static LoopItem* newMessageItem(const char* topic, const void* payload, int len, int qos, int retained)
+{
+    LoopItem* item = calloc(1, sizeof(LoopItem));
+    if (!item)
+        return NULL;
+    item->type = ITEM_MESSAGE;
+    item->topic = strdup(topic);
+    item->message = copyMessage(payload, len, qos, retained);
+    if (!item->topic || !item->message)
+    {
+        free(item->topic);
+        free(item->message);
+        free(item);
+        return NULL;
+    }
+    return item;
+}
+
+static void freeItem(LoopItem* item)
+{
+    if (item->message)
+        free(item->message);
+    free(item->topic);
+    free(item);
+}
+
+static void pushItem(Transport* client, LoopItem* item)
+{
+    pthread_mutex_lock(&client->lock);
+    item->next = NULL;
+    if (client->tail)
+        client->tail->next = item;
+    else
+        client->head = item;
+    client->tail = item;
+    pthread_cond_signal(&client->cond);
+    pthread_mutex_unlock(&client->lock);
+}
+
+static void pushResult(Transport* client, int type, MQTTAsync_onSuccess* on_success, MQTTAsync_onFailure* on_failure, void* context, MQTTAsync_token token)
+{
+    if ((type == ITEM_SUCCESS && !on_success) || (type == ITEM_FAILURE && !on_failure))
+        return;
+    LoopItem* item = calloc(1, sizeof(LoopItem));
+    if (!item)
+        return;
+    item->type = type;
+    item->on_success = on_success;
+    item->on_failure = on_failure;
+    item->context = context;
+    item->token = token;
+    pushItem(client, item);
+}
+
+// Sessions (Bus Lock Held)
+
+// Online: Straight To The Client Queue | Offline Persistent: Kept (QoS 1/2 Only, Oldest Dropped) | Otherwise Dropped
+static void deliverSession(LoopSession* session, const char* topic, const void* payload, int len, int qos, int retained)
+{
+    if (!session->client && (session->clean || qos == 0))
+        return;
+
+    LoopItem* item = newMessageItem(topic, payload, len, qos, retained);
+    if (!item)
+        return;
+
+    if (session->client)
+    {
+        pushItem(session->client, item);
+        return;
+    }
+
+    if (session->queued >= TRANSPORT_LOOPBACK_QUEUE_MAX)
+    {
+        LoopItem* oldest = session->head;
+        session->head = oldest->next;
+        if (!session->head)
+            session->tail = NULL;
+        session->queued--;
+        freeItem(oldest);
+    }
+    if (session->tail)
+        session->tail->next = item;
+    else
+        session->head = item;
+    session->tail = item;
+    session->queued++;
+}
+
+static int isWildcard(const char* filter)
+{
+    return strpbrk(filter, "+#") != NULL;
+}
+
+static void unlinkSubscription(LoopSubscription* subscription)
+{
+    if (isWildcard(subscription->filter))
+    {
+        LoopSubscription** link = &bus_wildcards;
+        while (*link && *link != subscription)
+            link = &(*link)->next_match;
+        if (*link)
+            *link = subscription->next_match;
+        return;
+    }
+
+    LoopSubscription* head = tableGet(&bus_exact, subscription->filter);
+    LoopSubscription** link = &head;
+    while (*link && *link != subscription)
+        link = &(*link)->next_match;
+    if (*link)
+        *link = subscription->next_match;
+    if (head)
+        tablePut(&bus_exact, subscription->filter, head);
+    else
+        tableRemove(&bus_exact, subscription->filter);
+}
+
+static void freeSession(LoopSession* session)
+{
+    for (LoopSession** link = &bus_sessions; *link; link = &(*link)->next)
+    {
+        if (*link == session)
+        {
+            *link = session->next;
+            break;
+        }
+    }
+    while (session->subscriptions)
+    {
+        LoopSubscription* subscription = session->subscriptions;
+        session->subscriptions = subscription->next_session;
+        unlinkSubscription(subscription);
+        free(subscription->filter);
+        free(subscription);
+    }
+    while (session->head)
+    {
+        LoopItem* item = session->head;
+        session->head = item->next;
+        freeItem(item);
+    }
+    free(session->client_id);
+    free(session);
+}
+
+static void detachClient(Transport* client)
+{
+    LoopSession* session = client->session;
+    if (!session)
+        return;
+    session->client = NULL;
+    client->session = NULL;
+    if (session->clean)
+        freeSession(session);
+}
+
+static void sendRetained(LoopSession* session, const char* filter, int qos)
+{
+    if (!isWildcard(filter))
+    {
+        LoopRetained* retained = tableGet(&bus_retained, filter);
+        if (retained)
+            deliverSession(session, filter, retained->payload, retained->len, retained->qos < qos ? retained->qos : qos, 1);
+        return;
+    }
+
+    for (int i = 0; i < bus_retained.size; i++)
+    {
+        for (LoopEntry* entry = bus_retained.buckets[i]; entry; entry = entry->next)
+        {
+            LoopRetained* retained = entry->value;
+            if (brokerTopicMatches(filter, entry->key))
+                deliverSession(session, entry->key, retained->payload, retained->len, retained->qos < qos ? retained->qos : qos, 1);
+        }
+    }
+}
+
+static int subscribeFilter(LoopSession* session, const char* filter, int qos)
+{
+    if (!brokerFilterValid(filter) || qos < 0 || qos > 2)
+        return 0;
+
+    LoopSubscription* subscription = session->subscriptions;
+    while (subscription && strcmp(subscription->filter, filter) != 0)
+        subscription = subscription->next_session;
+
+    if (!subscription)
+    {
+        if (!(subscription = calloc(1, sizeof(LoopSubscription))) || !(subscription->filter = strdup(filter)))
+        {
+            free(subscription);
+            return 0;
+        }
+        subscription->session = session;
+        subscription->next_session = session->subscriptions;
+        session->subscriptions = subscription;
+        if (isWildcard(filter))
+        {
+            subscription->next_match = bus_wildcards;
+            bus_wildcards = subscription;
+        }
+        else
+        {
+            subscription->next_match = tableGet(&bus_exact, filter);
+            tablePut(&bus_exact, filter, subscription);
+        }
+    }
+    subscription->qos = qos;
+    return 1;
+}
+
+// Callback Thread (One Per Loopback Client)
+
+static void freeClient(Transport* client) // Items Not Run Yet Are Dropped
+{
+    while (client->head)
+    {
+        LoopItem* item = client->head;
+        client->head = item->next;
+        freeItem(item);
+    }
+    timedDrop(client);
+    pthread_mutex_destroy(&client->lock);
+    pthread_cond_destroy(&client->cond);
+    free(client->client_id);
+    free(client);
+}
+
+static void* clientLoop(void* client_)
+{
+    Transport* client = (Transport*)client_;
+
+    while (1)
+    {
+        pthread_mutex_lock(&client->lock);
+        while (!client->head && !client->stopping)
+            pthread_cond_wait(&client->cond, &client->lock);
+        if (client->stopping)
+        {
+            int orphan = client->stopping == 2;
+            pthread_mutex_unlock(&client->lock);
+            if (orphan)
+                freeClient(client);
+            break;
+        }
+        LoopItem* item = client->head;
+        client->head = item->next;
+        if (!client->head)
+            client->tail = NULL;
+        pthread_mutex_unlock(&client->lock);
+
+        switch (item->type)
+        {
+            case ITEM_MESSAGE:
+                if (client->message_arrived)
+                {
+                    int payload_len = item->message->payloadlen; // The Callback May Free The Message
+                    long bytes = messageBytes(item->message);
+                    TRACE_EVENT(TRACE_ARRIVED, arrived, item->message->msgid, payload_len);
+                    memoryAdd(memoryAccountCached(&account_messages, "paho:messages"), bytes, 1);
+                    if (!client->message_arrived(client->context, item->topic, 0, item->message))
+                    {
+                        memoryAdd(memoryAccountCached(&account_messages, "paho:messages"), -bytes, -1);
+                        // Not Taken: Delivered Again Later (Paho Semantics)
+
+                        pthread_mutex_lock(&client->lock);
+                        item->next = client->head;
+                        client->head = item;
+                        if (!client->tail)
+                            client->tail = item;
+                        pthread_mutex_unlock(&client->lock);
+                        #if defined(_WIN32)
+                            Sleep(10);
+                        #else
+                            usleep(10000L);
+                        #endif
+                        continue;
+                    }
+                    item->message = NULL; // Owned By The Callback Now
+                    statsCount(STATS_MESSAGES_IN, 1);
+                    statsCount(STATS_BYTES_IN, payload_len);
+                }
+                break;
+
+            case ITEM_SUCCESS:
+            {
+                MQTTAsync_successData data;
+                memset(&data, 0, sizeof(data));
+                data.token = item->token;
+                data.alt.connect.sessionPresent = item->session_present;
+                item->on_success(item->context, &data);
+                break;
+            }
+
+            case ITEM_FAILURE:
+            {
+                MQTTAsync_failureData data;
+                memset(&data, 0, sizeof(data));
+                data.token = item->token;
+                data.code = MQTTASYNC_FAILURE;
+                item->on_failure(item->context, &data);
+                break;
+            }
+
+            case ITEM_DELIVERED:
+                if (client->delivery_complete)
+                    client->delivery_complete(client->context, item->token);
+                break;
+
+            case ITEM_LOST:
+                statsCount(STATS_CONNECTION_LOST, 1);
+                TRACE_EVENT(TRACE_LOST, lost, 0, 0);
+                if (client->connection_lost)
+                    client->connection_lost(client->context, NULL);
+                break;
+        }
+        freeItem(item);
+    }
+    return NULL;
+}
+
+// Paho Callbacks (Forwarded With The Caller's Context)
+
+#if !defined(TRANSPORT_NO_PAHO)
+static void connectionLost_t(void* context_, char* cause)
+{
+    Transport* transport = (Transport*)context_;
+    statsCount(STATS_CONNECTION_LOST, 1);
+    TRACE_EVENT(TRACE_LOST, lost, 0, 0);
+    if (transport->connection_lost)
+        transport->connection_lost(transport->context, cause);
+}
+
+static int messageArrived_t(void* context_, char* topicName, int topicLen, MQTTAsync_message* message)
+{
+    Transport* transport = (Transport*)context_;
+    if (!transport->message_arrived)
+    {
+        MQTTAsync_freeMessage(&message);
+        MQTTAsync_free(topicName);
+        return 1;
+    }
+    int payload_len = message->payloadlen; // The Callback May Free message
+    long bytes = messageBytes(message);
+    TRACE_EVENT(TRACE_ARRIVED, arrived, message->msgid, payload_len);
+    memoryAdd(memoryAccountCached(&account_messages, "paho:messages"), bytes, 1); // Before The Call: The Callback May Release It Right Away
+    int rc = transport->message_arrived(transport->context, topicName, topicLen, message);
+    if (!rc)
+        memoryAdd(memoryAccountCached(&account_messages, "paho:messages"), -bytes, -1);
+    if (rc)
+    {
+        statsCount(STATS_MESSAGES_IN, 1);
+        statsCount(STATS_BYTES_IN, payload_len);
+        MQTTAsync_free(topicName);
+    }
+    return rc;
+}
+
+static void deliveryComplete_t(void* context_, MQTTAsync_token token)
+{
+    Transport* transport = (Transport*)context_;
+    if (transport->delivery_complete)
+        transport->delivery_complete(transport->context, token);
+}
+#endif
+
+// Main Functions
+
+int transportIsLoopback(const char* server_uri)
+{
+    return server_uri && strncmp(server_uri, TRANSPORT_LOOPBACK_SCHEME, strlen(TRANSPORT_LOOPBACK_SCHEME)) == 0;
+}
+
+int transportCreate(MQTTAsync* handle, const char* server_uri, const char* client_id, int persistence_type, void* persistence_context)
+{
+    if (!handle || !client_id)
+        return MQTTASYNC_NULL_PARAMETER;
+
+    Transport* transport = calloc(1, sizeof(Transport));
+    if (!transport)
+        return MQTTASYNC_FAILURE;
+    transport->loopback = transportIsLoopback(server_uri);
+
+    if (!transport->loopback)
+    {
+        #if defined(TRANSPORT_NO_PAHO)
+            (void)persistence_type;
+            (void)persistence_context;
+            free(transport);
+            return MQTTASYNC_BAD_PROTOCOL;
+        #else
+            int rc = MQTTAsync_create(&transport->paho, server_uri, client_id, persistence_type, persistence_context);
+            if (rc != MQTTASYNC_SUCCESS)
+            {
+                free(transport);
+                return rc;
+            }
+        #endif
+    }
+    else
+    {
+        if (!(transport->client_id = strdup(client_id)))
+        {
+            free(transport);
+            return MQTTASYNC_FAILURE;
+        }
+        pthread_mutex_init(&transport->lock, NULL);
+        pthread_cond_init(&transport->cond, NULL);
+    }
+    pthread_mutex_init(&transport->calls_lock, NULL);
+
+    *handle = transport;
+    return MQTTASYNC_SUCCESS;
+}
+
+int transportSetCallbacks(MQTTAsync handle, void* context, MQTTAsync_connectionLost* connection_lost, MQTTAsync_messageArrived* message_arrived, MQTTAsync_deliveryComplete* delivery_complete)
+{
+    Transport* transport = (Transport*)handle;
+
+    transport->context = context;
+    transport->connection_lost = connection_lost;
+    transport->message_arrived = message_arrived;
+    transport->delivery_complete = delivery_complete;
+
+    #if !defined(TRANSPORT_NO_PAHO)
+        if (!transport->loopback)
+            return MQTTAsync_setCallbacks(transport->paho, transport, connectionLost_t, messageArrived_t, delivery_complete ? deliveryComplete_t : NULL);
+    #endif
+    return MQTTASYNC_SUCCESS;
+}
+
+static int connectNow(Transport* transport, const MQTTAsync_connectOptions* options)
+{
+    #if !defined(TRANSPORT_NO_PAHO)
+        if (!transport->loopback)
+            return MQTTAsync_connect(transport->paho, options);
+    #endif
+
+    if (!transport->thread_started)
+    {
+        if (pthread_create(&transport->thread, NULL, clientLoop, transport) != 0)
+            return MQTTASYNC_FAILURE;
+        transport->thread_started = 1;
+    }
+
+    pthread_mutex_lock(&bus_lock);
+
+    if (transport->session) // Already Connected
+    {
+        pthread_mutex_unlock(&bus_lock);
+        pushResult(transport, ITEM_SUCCESS, options->onSuccess, NULL, options->context, 0);
+        return MQTTASYNC_SUCCESS;
+    }
+
+    LoopSession* session = bus_sessions;
+    while (session && strcmp(session->client_id, transport->client_id) != 0)
+        session = session->next;
+
+    // Same Client Id Connected Elsewhere: That Connection Is Taken Over (Connection Lost There)
+
+    if (session && session->client)
+    {
+        Transport* previous = session->client;
+        session->client = NULL;
+        previous->session = NULL;
+        LoopItem* lost = calloc(1, sizeof(LoopItem));
+        if (lost)
+        {
+            lost->type = ITEM_LOST;
+            pushItem(previous, lost);
+        }
+    }
+    if (session && options->cleansession)
+    {
+        freeSession(session);
+        session = NULL;
+    }
+
+    int present = session != NULL;
+    if (!session)
+    {
+        if (!(session = calloc(1, sizeof(LoopSession))) || !(session->client_id = strdup(transport->client_id)))
+        {
+            free(session);
+            pthread_mutex_unlock(&bus_lock);
+            pushResult(transport, ITEM_FAILURE, NULL, options->onFailure, options->context, 0);
+            return MQTTASYNC_SUCCESS;
+        }
+        session->next = bus_sessions;
+        bus_sessions = session;
+    }
+    session->clean = options->cleansession;
+    session->client = transport;
+    transport->session = session;
+
+    // CONNACK First, Then What Waited Offline
+
+    LoopItem* connack = calloc(1, sizeof(LoopItem));
+    if (connack && options->onSuccess)
+    {
+        connack->type = ITEM_SUCCESS;
+        connack->on_success = options->onSuccess;
+        connack->context = options->context;
+        connack->session_present = present;
+        pushItem(transport, connack);
+    }
+    else
+        free(connack);
+
+    while (session->head)
+    {
+        LoopItem* item = session->head;
+        session->head = item->next;
+        pushItem(transport, item);
+    }
+    session->tail = NULL;
+    session->queued = 0;
+
+    pthread_mutex_unlock(&bus_lock);
+    return MQTTASYNC_SUCCESS;
+}
+
+static int disconnectNow(Transport* transport, const MQTTAsync_disconnectOptions* options)
+{
+    #if !defined(TRANSPORT_NO_PAHO)
+        if (!transport->loopback)
+            return MQTTAsync_disconnect(transport->paho, options);
+    #endif
+
+    pthread_mutex_lock(&bus_lock);
+    int connected = transport->session != NULL;
+    detachClient(transport);
+    pthread_mutex_unlock(&bus_lock);
+
+    if (!connected)
+        return MQTTASYNC_DISCONNECTED;
+    if (options)
+        pushResult(transport, ITEM_SUCCESS, options->onSuccess, NULL, options->context, 0);
+    return MQTTASYNC_SUCCESS;
+}
+
+static int subscribeNow(Transport* transport, int count, char* const* topics, const int* qos, MQTTAsync_responseOptions* response)
+{
+    #if !defined(TRANSPORT_NO_PAHO)
+        if (!transport->loopback)
+            return MQTTAsync_subscribeMany(transport->paho, count, topics, qos, response);
+    #endif
+
+    pthread_mutex_lock(&bus_lock);
+    LoopSession* session = transport->session;
+    if (!session)
+    {
+        pthread_mutex_unlock(&bus_lock);
+        return MQTTASYNC_DISCONNECTED;
+    }
+
+    int failed = 0;
+    for (int i = 0; i < count; i++)
+        if (!subscribeFilter(session, topics[i], qos[i]))
+            failed = 1;
+
+    // SUBACK First, Then The Retained Messages
+
+    MQTTAsync_token token = ++bus_tokens;
+    if (response)
+    {
+        response->token = token;
+        pushResult(transport, failed ? ITEM_FAILURE : ITEM_SUCCESS, response->onSuccess, response->onFailure, response->context, token);
+    }
+    for (int i = 0; i < count; i++)
+        if (brokerFilterValid(topics[i]))
+            sendRetained(session, topics[i], qos[i]);
+
+    pthread_mutex_unlock(&bus_lock);
+    return MQTTASYNC_SUCCESS;
+}
+
+int transportSubscribeMany(MQTTAsync handle, int count, char* const* topics, const int* qos, MQTTAsync_responseOptions* response)
+{
+    Transport* transport = (Transport*)handle;
+    MQTTAsync_responseOptions timed = MQTTAsync_responseOptions_initializer; // Response Options (... = [Default Initializer Macro])
+    if (response)
+        timed = *response;
+
+    TimedCall* call = timedStart(transport, STATS_SUBSCRIBE, &timed.onSuccess, &timed.onFailure, &timed.context);
+    TRACE_EVENT(TRACE_SUBSCRIBE, subscribe, (uintptr_t)call, count);
+    int rc = timedEnd(call, subscribeNow(transport, count, topics, qos, &timed));
+    if (response)
+        response->token = timed.token;
+    return rc;
+}
+
+int transportSubscribe(MQTTAsync handle, const char* topic, int qos, MQTTAsync_responseOptions* response)
+{
+    #if !defined(TRANSPORT_NO_PAHO)
+        Transport* transport = (Transport*)handle;
+        if (!transport->loopback)
+        {
+            MQTTAsync_responseOptions timed = MQTTAsync_responseOptions_initializer; // Response Options (... = [Default Initializer Macro])
+            if (response)
+                timed = *response;
+
+            TimedCall* call = timedStart(transport, STATS_SUBSCRIBE, &timed.onSuccess, &timed.onFailure, &timed.context);
+            TRACE_EVENT(TRACE_SUBSCRIBE, subscribe, (uintptr_t)call, 1);
+            int rc = timedEnd(call, MQTTAsync_subscribe(transport->paho, topic, qos, &timed));
+            if (response)
+                response->token = timed.token;
+            return rc;
+        }
+    #endif
+
+    char* topics[1] = { (char*)topic };
+    return transportSubscribeMany(handle, 1, topics, &qos, response);
+}
+
+int transportUnsubscribe(MQTTAsync handle, const char* topic, MQTTAsync_responseOptions* response)
+{
+    Transport* transport = (Transport*)handle;
+
+    #if !defined(TRANSPORT_NO_PAHO)
+        if (!transport->loopback)
+            return MQTTAsync_unsubscribe(transport->paho, topic, response);
+    #endif
+
+    pthread_mutex_lock(&bus_lock);
+    LoopSession* session = transport->session;
+    if (!session)
+    {
+        pthread_mutex_unlock(&bus_lock);
+        return MQTTASYNC_DISCONNECTED;
+    }
+
+    LoopSubscription** link = &session->subscriptions;
+    while (*link && strcmp((*link)->filter, topic) != 0)
+        link = &(*link)->next_session;
+    if (*link)
+    {
+        LoopSubscription* subscription = *link;
+        *link = subscription->next_session;
+        unlinkSubscription(subscription);
+        free(subscription->filter);
+        free(subscription);
+    }
+
+    MQTTAsync_token token = ++bus_tokens;
+    if (response)
+    {
+        response->token = token;
+        pushResult(transport, ITEM_SUCCESS, response->onSuccess, NULL, response->context, token);
+    }
+    pthread_mutex_unlock(&bus_lock);
+    return MQTTASYNC_SUCCESS;
+}
+
+static int sendNow(Transport* transport, const char* topic, const MQTTAsync_message* message, MQTTAsync_responseOptions* response)
+{
+    #if !defined(TRANSPORT_NO_PAHO)
+        if (!transport->loopback)
+            return MQTTAsync_sendMessage(transport->paho, topic, message, response);
+    #endif
+
+    if (message->qos < 0 || message->qos > 2)
+        return MQTTASYNC_BAD_QOS;
+
+    pthread_mutex_lock(&bus_lock);
+    if (!transport->session)
+    {
+        pthread_mutex_unlock(&bus_lock);
+        return MQTTASYNC_DISCONNECTED;
+    }
+
+    // Retained Store (Empty Payload Clears The Topic, Still Delivered)
+
+    if (message->retained)
+    {
+        LoopRetained* retained = tableGet(&bus_retained, topic);
+        if (retained)
+        {
+            free(retained->payload);
+            retained->payload = NULL;
+        }
+        if (message->payloadlen == 0)
+        {
+            if (retained)
+            {
+                tableRemove(&bus_retained, topic);
+                free(retained);
+            }
+        }
+        else
+        {
+            if (!retained && (retained = calloc(1, sizeof(LoopRetained))) && !tablePut(&bus_retained, topic, retained))
+            {
+                free(retained);
+                retained = NULL;
+            }
+            if (retained && (retained->payload = malloc(message->payloadlen)))
+            {
+                memcpy(retained->payload, message->payload, message->payloadlen);
+                retained->len = message->payloadlen;
+                retained->qos = message->qos;
+            }
+            else if (retained)
+            {
+                tableRemove(&bus_retained, topic);
+                free(retained);
+            }
+        }
+    }
+
+    // Matching Sessions: Exact Filters, Then Wildcards (One Copy Per Session At The Highest Granted QoS)
+
+    unsigned long seq = ++bus_publishes;
+    LoopSession* targets[64];
+    LoopSession** list = targets;
+    int count = 0, cap = 64;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        LoopSubscription* subscription = pass == 0 ? tableGet(&bus_exact, topic) : bus_wildcards;
+        for (; subscription; subscription = subscription->next_match)
+        {
+            if (pass == 1 && !brokerTopicMatches(subscription->filter, topic))
+                continue;
+            LoopSession* session = subscription->session;
+            int qos = subscription->qos < message->qos ? subscription->qos : message->qos;
+            if (session->mark == seq)
+            {
+                if (session->mark_qos < qos)
+                    session->mark_qos = qos;
+                continue;
+            }
+            if (count == cap)
+            {
+                LoopSession** grown = malloc(cap * 2 * sizeof(LoopSession*));
+                if (!grown)
+                    continue;
+                memcpy(grown, list, count * sizeof(LoopSession*));
+                if (list != targets)
+                    free(list);
+                list = grown;
+                cap *= 2;
+            }
+            session->mark = seq;
+            session->mark_qos = qos;
+            list[count++] = session;
+        }
+    }
+    for (int i = 0; i < count; i++)
+        deliverSession(list[i], topic, message->payload, message->payloadlen, list[i]->mark_qos, 0);
+    if (list != targets)
+        free(list);
+
+    MQTTAsync_token token = ++bus_tokens;
+    if (response)
+    {
+        response->token = token;
+        pushResult(transport, ITEM_SUCCESS, response->onSuccess, NULL, response->context, token);
+    }
+    if (message->qos > 0 && transport->delivery_complete)
+    {
+        LoopItem* delivered = calloc(1, sizeof(LoopItem));
+        if (delivered)
+        {
+            delivered->type = ITEM_DELIVERED;
+            delivered->token = token;
+            pushItem(transport, delivered);
+        }
+    }
+
+    pthread_mutex_unlock(&bus_lock);
+    return MQTTASYNC_SUCCESS;
+}
+
+int transportConnect(MQTTAsync handle, const MQTTAsync_connectOptions* options)
+{
+    Transport* transport = (Transport*)handle;
+    MQTTAsync_connectOptions timed = *options;
+
+    TimedCall* call = timedStart(transport, STATS_CONNECT, &timed.onSuccess, &timed.onFailure, &timed.context);
+    TRACE_EVENT(TRACE_CONNECT, connect, (uintptr_t)call, 0);
+    return timedEnd(call, connectNow(transport, &timed));
+}
+
+int transportDisconnect(MQTTAsync handle, const MQTTAsync_disconnectOptions* options)
+{
+    Transport* transport = (Transport*)handle;
+    if (!options) // Nobody Waits For It: Not Timed
+        return disconnectNow(transport, NULL);
+    MQTTAsync_disconnectOptions timed = *options;
+
+    TimedCall* call = timedStart(transport, STATS_DISCONNECT, &timed.onSuccess, &timed.onFailure, &timed.context);
+    TRACE_EVENT(TRACE_DISCONNECT, disconnect, (uintptr_t)call, 0);
+    return timedEnd(call, disconnectNow(transport, &timed));
+}
+
+int transportSendMessage(MQTTAsync handle, const char* topic, const MQTTAsync_message* message, MQTTAsync_responseOptions* response)
+{
+    Transport* transport = (Transport*)handle;
+    MQTTAsync_responseOptions timed = MQTTAsync_responseOptions_initializer; // Response Options (... = [Default Initializer Macro])
+    if (response)
+        timed = *response;
+
+    TimedCall* call = timedStart(transport, STATS_PUBLISH, &timed.onSuccess, &timed.onFailure, &timed.context);
+    TRACE_EVENT(TRACE_PUBLISH, publish, (uintptr_t)call, message->payloadlen);
+    int rc = timedEnd(call, sendNow(transport, topic, message, &timed));
+    if (response)
+        response->token = timed.token;
+    if (rc == MQTTASYNC_SUCCESS)
+    {
+        statsCount(STATS_MESSAGES_OUT, 1);
+        statsCount(STATS_BYTES_OUT, message->payloadlen);
+    }
+    return rc;
+}
+
+void transportFreeMessage(MQTTAsync_message** message)
+{
+    if (!message || !*message)
+        return;
+    memoryAdd(memoryAccountCached(&account_messages, "paho:messages"), -messageBytes(*message), -1);
+
+    if (memcmp((*message)->struct_id, "MQTL", 4) == 0) // Loopback Block
+    {
+        free(*message);
+        *message = NULL;
+        return;
+    }
+
+    #if !defined(TRANSPORT_NO_PAHO)
+        MQTTAsync_freeMessage(message);
+    #endif
+}
+
+void transportDestroy(MQTTAsync* handle)
+{
+    if (!handle || !*handle)
+        return;
+    Transport* transport = (Transport*)*handle;
+    *handle = NULL;
+
+    #if !defined(TRANSPORT_NO_PAHO)
+        if (!transport->loopback)
+        {
+            MQTTAsync_destroy(&transport->paho);
+            timedDrop(transport);
+            free(transport);
+            return;
+        }
+    #endif
+
+    pthread_mutex_lock(&bus_lock);
+    detachClient(transport);
+    pthread_mutex_unlock(&bus_lock);
+
+    // Callback Thread Stopped, Then The Client Freed (By The Thread Itself When Destroyed From A Callback)
+
+    if (transport->thread_started)
+    {
+        int self = pthread_equal(pthread_self(), transport->thread);
+
+        pthread_mutex_lock(&transport->lock);
+        transport->stopping = self ? 2 : 1;
+        pthread_cond_signal(&transport->cond);
+        pthread_mutex_unlock(&transport->lock);
+
+        if (self)
+        {
+            pthread_detach(transport->thread);
+            return;
+        }
+        pthread_join(transport->thread, NULL);
+    }
+    freeClient(transport);
+}
+
+void transportLoopbackClear(void)
+{
+    pthread_mutex_lock(&bus_lock);
+
+    LoopSession** link = &bus_sessions;
+    while (*link)
+    {
+        if (!(*link)->client)
+            freeSession(*link); // Unlinks Itself
+        else
+            link = &(*link)->next;
+    }
+
+    for (int i = 0; i < bus_retained.size; i++)
+    {
+        LoopEntry* entry = bus_retained.buckets[i];
+        while (entry)
+        {
+            LoopEntry* next = entry->next;
+            LoopRetained* retained = entry->value;
+            free(retained->payload);
+            free(retained);
+            free(entry->key);
+            free(entry);
+            entry = next;
+        }
+    }
+    free(bus_retained.buckets);
+    memset(&bus_retained, 0, sizeof(bus_retained));
+
+    pthread_mutex_unlock(&bus_lock);
+}
@@ -0,0 +1,41 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include "MQTTAsync.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Constants */
+#define TRANSPORT_LOOPBACK_SCHEME "loop://" // CHATMQTT_BROKER=loop:// > Every Client Of The Process Joins The In-Memory Bus
+#define TRANSPORT_LOOPBACK_QUEUE_MAX 100000 // Messages Kept For An Offline Persistent Session (Oldest Dropped)
+
+/* Transport */
+// Every Module Talks MQTT Through These Calls (Same Signatures / Types As The Paho Ones They Replace)
+// - Paho: Server URI "tcp://..." / "ssl://..." | Compiled Out With -DTRANSPORT_NO_PAHO (Loopback Only, No libpaho Needed)
+// - Loopback: Server URI "loop://..." | Same Retained, Wildcard ("+" / "#") And Session (cleansession = 0) Semantics,
+//   Callbacks Run On One Thread Per Client (Like Paho's), No Sockets, No Broker
+// messageArrived(): The Topic Name Is Lent For The Callback Only (The Transport Frees It) | The Message Is Owned By The Callback (transportFreeMessage())
+
+/* Core Functions */
+int transportCreate(MQTTAsync* handle, const char* server_uri, const char* client_id, int persistence_type, void* persistence_context);
+int transportSetCallbacks(MQTTAsync handle, void* context, MQTTAsync_connectionLost* connection_lost, MQTTAsync_messageArrived* message_arrived, MQTTAsync_deliveryComplete* delivery_complete);
+int transportConnect(MQTTAsync handle, const MQTTAsync_connectOptions* options);
+int transportDisconnect(MQTTAsync handle, const MQTTAsync_disconnectOptions* options);
+int transportSubscribe(MQTTAsync handle, const char* topic, int qos, MQTTAsync_responseOptions* response);
+int transportSubscribeMany(MQTTAsync handle, int count, char* const* topics, const int* qos, MQTTAsync_responseOptions* response);
+int transportUnsubscribe(MQTTAsync handle, const char* topic, MQTTAsync_responseOptions* response);
+int transportSendMessage(MQTTAsync handle, const char* topic, const MQTTAsync_message* message, MQTTAsync_responseOptions* response);
+void transportFreeMessage(MQTTAsync_message** message);
+void transportDestroy(MQTTAsync* handle);
+
+/* Loopback Functions */
+int transportIsLoopback(const char* server_uri);
+void transportLoopbackClear(void); // Drops Retained Messages And Offline Sessions (Between Benchmark Runs, No Clients Left)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRANSPORT_H